@@ -77,7 +77,8 @@ typedef enum {
     IR_CALL_STMT,       // 函数调用语句
     IR_RETURN_STMT,     // 返回语句
     IR_READ_STMT,       // 读语句
-    IR_WRITE_STMT       // 写语句
+    IR_WRITE_STMT,      // 写语句
+    IR_PHI_STMT         // φ 函数 (仅在 SSA 形式中出现)
 } IR_stmt_type;
 
 typedef struct IR_stmt IR_stmt, *IR_stmt_ptr; // IR语句结构体及其指针类型
@@ -310,9 +311,25 @@ typedef enum {
     IR_OP_ADD, // 加法
     IR_OP_SUB, // 减法
     IR_OP_MUL, // 乘法
-    IR_OP_DIV  // 除法
+    IR_OP_DIV, // 除法
+    // 以下运算只在扩展输出方言 (IR_OUT_EXTENDED_OPS) 下由降级产生，输入IR中也可以出现
+    IR_OP_MOD, // 取模（余数符号与被除数相同）
+    IR_OP_SHL, // 左移
+    IR_OP_SHR, // 逻辑右移
+    IR_OP_SAR, // 算术右移
+    IR_OP_AND, // 按位与
+    IR_OP_OR,  // 按位或
+    IR_OP_XOR, // 按位异或
+    IR_OP_MULH // 有符号乘法结果的高 32 位
 } IR_OP_TYPE;
 
+/**
+ * @brief 判断二元运算是否满足交换律。
+ * @param op 操作类型。
+ * @return 交换两个操作数结果不变时返回 true。
+ */
+extern bool IR_OP_is_commutative(IR_OP_TYPE op);
+
 /**
  * @brief IR操作语句 (rd := rs1 op rs2)。
  */
@@ -408,6 +425,21 @@ typedef enum {
     IR_RELOP_LE  // 小于等于 (<=)
 } IR_RELOP_TYPE;
 
+/**
+ * @brief 关系运算取反：!(a relop b) 等价于 a relop' b。
+ */
+extern IR_RELOP_TYPE IR_RELOP_negate(IR_RELOP_TYPE relop);
+
+/**
+ * @brief 交换两个操作数：a relop b 等价于 b relop' a。
+ */
+extern IR_RELOP_TYPE IR_RELOP_swap(IR_RELOP_TYPE relop);
+
+/**
+ * @brief 对两个常量求关系运算的值。
+ */
+extern bool IR_RELOP_eval(IR_RELOP_TYPE relop, int a, int b);
+
 /**
  * @brief IR条件跳转语句 (IF rs1 relop rs2 GOTO true_label ELSE GOTO false_label)。
  */
@@ -531,10 +563,58 @@ typedef struct {
  */
 extern void IR_write_stmt_init(IR_write_stmt *write_stmt, IR_val rs);
 
+/**
+ * @brief IR φ 函数 (rd := PHI(argv[0], argv[1], ...))。
+ * 只出现在 SSA 形式的基本块开头，argv[i] 是控制流从 preds[i] 到达本块时 rd 的取值。
+ */
+typedef struct {
+    CLASS_IR_stmt       // 继承自IR_stmt的通用字段
+    IR_var rd;          // 目标变量
+    unsigned argc;      // 参数个数（等于所在块的前驱个数）
+    IR_val *argv;       // 参数值数组 (动态分配)
+    IR_block **preds;   // 每个参数对应的前驱块 (动态分配)
+} IR_phi_stmt;
+
+/**
+ * @brief 初始化一个IR φ 函数。
+ * @param phi_stmt 指向要初始化的IR_phi_stmt的指针。
+ * @param rd 目标变量。
+ * @param argc 参数个数。
+ * @param argv 参数值数组 (所有权转移给语句)。
+ * @param preds 参数对应的前驱块数组 (所有权转移给语句)。
+ */
+extern void IR_phi_stmt_init(IR_phi_stmt *phi_stmt, IR_var rd,
+                             unsigned argc, IR_val *argv, IR_block **preds);
+
 // 创建一个新的无条件跳转语句，目标为指定基本块
 IR_stmt *IR_goto_new(IR_block *target);
 
 // 替换pred块中的某个后继（old_succ）为新的后继（new_succ）
 void replace_successor(IR_block *pred, IR_block *old_succ, IR_block *new_succ);
 
+// 在CFG边 pred -> succ 上插入一个新的基本块（拆分关键边），同步更新跳转语句与前驱/后继表
+// 返回新块；若该边无法拆分（如RETURN边、两个分支指向同一块）则返回NULL
+IR_block *IR_function_split_edge(IR_function *func, IR_block *pred, IR_block *succ);
+
+// 复制一条语句（call的参数表、φ的参数与前驱表一并复制），跳转语句的目标块指针需重建CFG后才有效
+IR_stmt *IR_stmt_clone(IR_stmt *stmt);
+
+// 按当前的基本块链表与跳转语句重新构建前驱/后继表与标签表，用于改写控制流之后
+void IR_function_rebuild_graph(IR_function *func);
+
+// 若blk末尾的跳转指向标签为label的块（即链表中的下一块），去掉该跳转或将IF的假分支改为顺序执行；CFG不变
+void IR_block_strip_jump_to(IR_block *blk, IR_label label);
+
+// 删除从入口不可达的块（出口块保留），有块被删除时去掉由此变为跳向下一块的跳转并重建CFG；返回是否删除了块
+bool IR_function_remove_unreachable_blocks(IR_function *func);
+
+// 块没有标签时分配新标签并登记到函数的标签表，返回块的标签
+IR_label IR_function_ensure_label(IR_function *func, IR_block *blk);
+
+// 把块末尾的顺序执行改为显式跳转（IF补上假分支标签，其余追加GOTO），使块在链表中的位置可以任意调整；需要CFG有效
+void IR_function_make_fallthrough_explicit(IR_function *func, IR_block *blk);
+
+// 跳向链表中下一块（或越过若干空块后的块）的跳转改为顺序执行，然后重建CFG
+void IR_function_strip_redundant_jumps(IR_function *func);
+
 #endif //CODE_IR_H
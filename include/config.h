@@ -5,4 +5,9 @@
 
 #define IR_IN_APPEND_EOL 1
 
+// 输出方言是否支持取模、移位与按位运算；为 0 时优化不会产生这些运算，输出与原有方言兼容
+#ifndef IR_OUT_EXTENDED_OPS
+#define IR_OUT_EXTENDED_OPS 0
+#endif
+
 #endif //CODE_CONFIG_H
@@ -0,0 +1,24 @@
+//
+// Created by Assistant
+// 去除跳向相邻块的跳转 (Strip Jump To Next Block)
+//
+
+#include <IR.h>
+
+// 块在链表中的下一块标签为 label 时, 去掉末尾跳向它的 GOTO, 或把 IF 的假分支改为顺序执行
+void IR_block_strip_jump_to(IR_block *blk, IR_label label) {
+    if (label == IR_LABEL_NONE || blk->stmts.tail == NULL) return;
+    IR_stmt *last_stmt = blk->stmts.tail->val;
+    if (last_stmt->stmt_type == IR_GOTO_STMT) {
+        if (((IR_goto_stmt*)last_stmt)->label == label) {
+            RDELETE(IR_stmt, last_stmt);
+            List_IR_stmt_ptr_pop_back(&blk->stmts);
+        }
+    } else if (last_stmt->stmt_type == IR_IF_STMT) {
+        IR_if_stmt *if_stmt = (IR_if_stmt*)last_stmt;
+        if (if_stmt->true_label == label && if_stmt->false_label != IR_LABEL_NONE)
+            IR_if_stmt_flip(if_stmt);
+        if (if_stmt->false_label == label)
+            if_stmt->false_label = IR_LABEL_NONE;
+    }
+}
@@ -30,20 +30,8 @@ void IR_function_push_stmt(IR_function *ir_func, IR_stmt *stmt) {
     VCALL(last_blk->stmts, push_back, stmt);
 }
 
-static inline IR_RELOP_TYPE IR_RELOP_NEG(IR_RELOP_TYPE relop) {
-    switch (relop) {
-        case IR_RELOP_EQ: return IR_RELOP_NE;
-        case IR_RELOP_NE: return IR_RELOP_EQ;
-        case IR_RELOP_LT: return IR_RELOP_GE;
-        case IR_RELOP_GT: return IR_RELOP_LE;
-        case IR_RELOP_LE: return IR_RELOP_GT;
-        case IR_RELOP_GE: return IR_RELOP_LT;
-        default: assert(0);
-    }
-}
-
 void IR_if_stmt_flip(IR_if_stmt *if_stmt) {
-    if_stmt->relop = IR_RELOP_NEG(if_stmt->relop);
+    if_stmt->relop = IR_RELOP_negate(if_stmt->relop);
     IR_label t = if_stmt->true_label;
     if_stmt->true_label = if_stmt->false_label;
     if_stmt->false_label = t;
@@ -56,3 +56,18 @@ void IR_function_build_graph(IR_function *ir_func) {
     }
 }
 
+
+// 丢弃已有的前驱/后继表与标签表, 按当前的基本块链表与跳转语句重新构建CFG
+void IR_function_rebuild_graph(IR_function *ir_func) {
+    for_map(IR_block_ptr, List_ptr_IR_block_ptr, i, ir_func->blk_pred)
+        DELETE(i->val);
+    for_map(IR_block_ptr, List_ptr_IR_block_ptr, i, ir_func->blk_succ)
+        DELETE(i->val);
+    Map_IR_label_IR_block_ptr_teardown(&ir_func->map_blk_label);
+    Map_IR_block_ptr_List_ptr_IR_block_ptr_teardown(&ir_func->blk_pred);
+    Map_IR_block_ptr_List_ptr_IR_block_ptr_teardown(&ir_func->blk_succ);
+    Map_IR_label_IR_block_ptr_init(&ir_func->map_blk_label);
+    Map_IR_block_ptr_List_ptr_IR_block_ptr_init(&ir_func->blk_pred);
+    Map_IR_block_ptr_List_ptr_IR_block_ptr_init(&ir_func->blk_succ);
+    IR_function_build_graph(ir_func);
+}
@@ -0,0 +1,15 @@
+//
+// Created by Assistant
+// 确保块有标签 (Ensure Block Label)
+//
+
+#include <IR.h>
+
+// 块没有标签时分配新标签并登记到标签表, 返回块的标签
+IR_label IR_function_ensure_label(IR_function *func, IR_block *blk) {
+    if (blk->label == IR_LABEL_NONE) {
+        blk->label = ir_label_generator();
+        VCALL(func->map_blk_label, insert, blk->label, blk);
+    }
+    return blk->label;
+}
@@ -0,0 +1,23 @@
+//
+// Created by Assistant
+// 顺序执行改为显式跳转 (Make Fallthrough Explicit)
+//
+
+#include <IR.h>
+
+// 把块末尾的顺序执行改为显式跳转 (IF 补上假分支标签, 其余追加 GOTO), 使块在链表中的位置可以任意调整
+void IR_function_make_fallthrough_explicit(IR_function *func, IR_block *blk) {
+    IR_stmt *last = blk->stmts.tail ? blk->stmts.tail->val : NULL;
+    if (last && (last->stmt_type == IR_GOTO_STMT || last->stmt_type == IR_RETURN_STMT))
+        return;
+    if (last && last->stmt_type == IR_IF_STMT) {
+        IR_if_stmt *if_stmt = (IR_if_stmt*)last;
+        if (if_stmt->false_label == IR_LABEL_NONE)
+            if_stmt->false_label = IR_function_ensure_label(func, if_stmt->false_blk);
+        return;
+    }
+    List_IR_block_ptr *succs = VCALL(func->blk_succ, get, blk);
+    IR_block *next = succs->head->val;
+    IR_function_ensure_label(func, next);
+    VCALL(blk->stmts, push_back, IR_goto_new(next));
+}
@@ -0,0 +1,44 @@
+//
+// Created by Assistant
+// 删除不可达块 (Remove Unreachable Blocks)
+//
+
+#include <IR.h>
+#include <container/treap.h>
+
+DEF_SET(IR_block_ptr)
+
+// 从入口沿后继表遍历, 删除未到达的块 (出口块除外); 有块被删除时去掉多余的跳转并重建CFG
+bool IR_function_remove_unreachable_blocks(IR_function *func) {
+    Set_IR_block_ptr reached;
+    Set_IR_block_ptr_init(&reached);
+    List_IR_block_ptr worklist;
+    List_IR_block_ptr_init(&worklist);
+    VCALL(reached, insert, func->entry);
+    VCALL(worklist, push_back, func->entry);
+    while (worklist.head) {
+        IR_block *blk = worklist.head->val;
+        VCALL(worklist, delete, worklist.head);
+        for_list(IR_block_ptr, i, *VCALL(func->blk_succ, get, blk))
+            if (VCALL(reached, insert, i->val)) VCALL(worklist, push_back, i->val);
+    }
+    List_IR_block_ptr_teardown(&worklist);
+
+    bool removed = false;
+    for (ListNode_IR_block_ptr *node = func->blocks.head; node;) {
+        IR_block *blk = node->val;
+        if (blk == func->exit || VCALL(reached, exist, blk)) {
+            node = node->nxt;
+            continue;
+        }
+        node = VCALL(func->blocks, delete, node);
+        RDELETE(IR_block, blk);
+        removed = true;
+    }
+    Set_IR_block_ptr_teardown(&reached);
+    if (!removed) return false;
+
+    // 原本越过被删除块的跳转可能变为跳向下一块 (或越过若干空块后的块), 改为顺序执行
+    IR_function_strip_redundant_jumps(func);
+    return true;
+}
@@ -0,0 +1,113 @@
+//
+// Created by Assistant
+// 拆分边 (Split Edge)
+//
+
+#include "IR.h"
+#include <stddef.h>
+
+static void replace_block_in_list(List_IR_block_ptr *list, IR_block *old_blk, IR_block *new_blk) {
+    for_list(IR_block_ptr, i, *list) {
+        if (i->val == old_blk) {
+            i->val = new_blk;
+            return;
+        }
+    }
+}
+
+// 判断基本块执行完最后一条语句后是否会顺序执行到链表中的下一个块
+static bool block_falls_through(IR_block *blk) {
+    if (!blk->stmts.tail) return true;
+    IR_stmt *last = blk->stmts.tail->val;
+    switch (last->stmt_type) {
+        case IR_GOTO_STMT:
+        case IR_RETURN_STMT:
+            return false;
+        case IR_IF_STMT:
+            return ((IR_if_stmt*)last)->false_label == IR_LABEL_NONE;
+        default:
+            return true;
+    }
+}
+
+// 在CFG边 pred -> succ 上插入一个新的基本块, 返回新块; 无法拆分时返回NULL
+IR_block *IR_function_split_edge(IR_function *func, IR_block *pred, IR_block *succ) {
+    if (!func || !pred || !succ || succ == func->exit) return NULL;
+    ListNode_IR_block_ptr *pred_node = NULL;
+    for_list(IR_block_ptr, i, func->blocks) {
+        if (i->val == pred) {
+            pred_node = i;
+            break;
+        }
+    }
+    if (!pred_node) return NULL;
+
+    // 确定该边是顺序执行边还是跳转边
+    bool is_jump_edge = false;
+    IR_stmt *last = pred->stmts.tail ? pred->stmts.tail->val : NULL;
+    if (last && last->stmt_type == IR_RETURN_STMT) return NULL;
+    if (last && last->stmt_type == IR_GOTO_STMT) {
+        is_jump_edge = true;
+    } else if (last && last->stmt_type == IR_IF_STMT) {
+        IR_if_stmt *if_stmt = (IR_if_stmt*)last;
+        bool true_hit = if_stmt->true_label == succ->label;
+        bool false_hit = if_stmt->false_label == IR_LABEL_NONE ?
+                         (pred_node->nxt && pred_node->nxt->val == succ) :
+                         if_stmt->false_label == succ->label;
+        if (true_hit && false_hit) return NULL; // 两个分支指向同一块, 无法区分
+        if (!true_hit && !false_hit) return NULL;
+        is_jump_edge = true_hit || if_stmt->false_label != IR_LABEL_NONE;
+    }
+    if (!is_jump_edge && !(pred_node->nxt && pred_node->nxt->val == succ)) return NULL;
+    if (is_jump_edge && succ->label == IR_LABEL_NONE) return NULL;
+
+    IR_block *mid;
+    if (!is_jump_edge) {
+        // 顺序执行边: 新块直接放在 pred 与 succ 之间, 不需要跳转
+        mid = NEW(IR_block, IR_LABEL_NONE);
+        VCALL(func->blocks, insert_back, pred_node, mid);
+    } else {
+        // 跳转边: 新块以 GOTO succ 结尾, 放在一个不会顺序执行到它的位置
+        ListNode_IR_block_ptr *pos = NULL;
+        if (!block_falls_through(pred)) pos = pred_node;
+        else {
+            rfor_list(IR_block_ptr, i, func->blocks) {
+                if (i->val != func->exit && !block_falls_through(i->val)) {
+                    pos = i;
+                    break;
+                }
+            }
+        }
+        if (!pos) return NULL;
+        mid = NEW(IR_block, ir_label_generator());
+        VCALL(mid->stmts, push_back, IR_goto_new(succ));
+        VCALL(func->blocks, insert_back, pos, mid);
+        VCALL(func->map_blk_label, insert, mid->label, mid);
+        // 重定向 pred 的跳转目标
+        if (last->stmt_type == IR_GOTO_STMT) {
+            IR_goto_stmt *goto_stmt = (IR_goto_stmt*)last;
+            goto_stmt->label = mid->label;
+            goto_stmt->blk = mid;
+        } else {
+            IR_if_stmt *if_stmt = (IR_if_stmt*)last;
+            if (if_stmt->true_label == succ->label) {
+                if_stmt->true_label = mid->label;
+                if_stmt->true_blk = mid;
+            } else {
+                if_stmt->false_label = mid->label;
+                if_stmt->false_blk = mid;
+            }
+        }
+    }
+
+    // 维护CFG: pred -> mid -> succ
+    List_IR_block_ptr *mid_preds = NEW(List_IR_block_ptr);
+    List_IR_block_ptr *mid_succs = NEW(List_IR_block_ptr);
+    VCALL(*mid_preds, push_back, pred);
+    VCALL(*mid_succs, push_back, succ);
+    VCALL(func->blk_pred, insert, mid, mid_preds);
+    VCALL(func->blk_succ, insert, mid, mid_succs);
+    replace_block_in_list(VCALL(func->blk_succ, get, pred), succ, mid);
+    replace_block_in_list(VCALL(func->blk_pred, get, succ), pred, mid);
+    return mid;
+}
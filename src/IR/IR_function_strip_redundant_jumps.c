@@ -0,0 +1,18 @@
+//
+// Created by Assistant
+// 去掉多余的跳转 (Strip Redundant Jumps)
+//
+
+#include <IR.h>
+
+// 跳向链表中下一块的跳转改为顺序执行后重建CFG
+void IR_function_strip_redundant_jumps(IR_function *func) {
+    for_list(IR_block_ptr, i, func->blocks) {
+        // 中间的空块顺序执行, 跳向其中任何一块都等价于顺序执行
+        for (ListNode_IR_block_ptr *next = i->nxt; next; next = next->nxt) {
+            IR_block_strip_jump_to(i->val, next->val->label);
+            if (next->val->stmts.head) break;
+        }
+    }
+    IR_function_rebuild_graph(func);
+}
@@ -14,9 +14,17 @@ static void IR_call_stmt_teardown(IR_stmt *stmt) {
     free(call_stmt->argv);
 }
 
+static void IR_phi_stmt_teardown(IR_stmt *stmt) {
+    IR_phi_stmt *phi_stmt = (IR_phi_stmt*)stmt;
+    free(phi_stmt->argv);
+    free(phi_stmt->preds);
+}
+
 void IR_stmt_teardown(IR_stmt *stmt) {
     if(stmt->stmt_type == IR_CALL_STMT)
         IR_call_stmt_teardown(stmt);
+    else if(stmt->stmt_type == IR_PHI_STMT)
+        IR_phi_stmt_teardown(stmt);
 }
 
 //// ==================================== print ====================================
@@ -34,6 +42,14 @@ static void IR_OP_TYPE_print(IR_OP_TYPE ir_op_type, FILE *out) {
         case IR_OP_SUB: fprintf(out, " - "); break;
         case IR_OP_MUL: fprintf(out, " * "); break;
         case IR_OP_DIV: fprintf(out, " / "); break;
+        case IR_OP_MOD: fprintf(out, " %% "); break;
+        case IR_OP_SHL: fprintf(out, " << "); break;
+        case IR_OP_SHR: fprintf(out, " >>> "); break;
+        case IR_OP_SAR: fprintf(out, " >> "); break;
+        case IR_OP_AND: fprintf(out, " & "); break;
+        case IR_OP_OR:  fprintf(out, " | "); break;
+        case IR_OP_XOR: fprintf(out, " ^ "); break;
+        case IR_OP_MULH: fprintf(out, " MULH "); break;
         default: assert(0);
     }
 }
@@ -93,6 +109,16 @@ static void IR_call_stmt_print(IR_stmt *stmt, FILE *out) {
             call_stmt->rd, call_stmt->func_name);
 }
 
+static void IR_phi_stmt_print(IR_stmt *stmt, FILE *out) {
+    IR_phi_stmt *phi_stmt = (IR_phi_stmt*)stmt;
+    fprintf(out, "v%u := PHI(", phi_stmt->rd);
+    for(unsigned i = 0; i != phi_stmt->argc; i ++) {
+        if(i) fprintf(out, ", ");
+        IR_val_print(phi_stmt->argv[i], out);
+    }
+    fprintf(out, ")\n");
+}
+
 static void IR_if_stmt_print(IR_stmt *stmt, FILE *out) {
     IR_if_stmt *if_stmt = (IR_if_stmt*)stmt;
     fprintf(out, "IF ");
@@ -158,6 +184,10 @@ static IR_var IR_call_stmt_get_def(IR_stmt *stmt) {
     return call_stmt->rd;
 }
 
+static IR_var IR_phi_stmt_get_def(IR_stmt *stmt) {
+    IR_phi_stmt *phi_stmt = (IR_phi_stmt*)stmt;
+    return phi_stmt->rd;
+}
 
 static IR_var IR_read_stmt_get_def(IR_stmt *stmt) {
     IR_read_stmt *read_stmt = (IR_read_stmt*)stmt;
@@ -213,6 +243,12 @@ static IR_use IR_call_stmt_get_use(IR_stmt *stmt) {
                      .use_vec = call_stmt->argv};
 }
 
+static IR_use IR_phi_stmt_get_use(IR_stmt *stmt) {
+    IR_phi_stmt *phi_stmt = (IR_phi_stmt*)stmt;
+    return (IR_use) {.use_cnt = phi_stmt->argc,
+                     .use_vec = phi_stmt->argv};
+}
+
 static IR_use IR_write_stmt_get_use(IR_stmt *stmt) {
     IR_write_stmt *write_stmt = (IR_write_stmt*)stmt;
     return (IR_use) {.use_cnt = 1,
@@ -239,6 +275,16 @@ void IR_op_stmt_init(IR_op_stmt *op_stmt, IR_OP_TYPE op,
     op_stmt->rs2 = rs2;
 }
 
+bool IR_OP_is_commutative(IR_OP_TYPE op) {
+    switch (op) {
+        case IR_OP_ADD: case IR_OP_MUL: case IR_OP_MULH:
+        case IR_OP_AND: case IR_OP_OR: case IR_OP_XOR:
+            return true;
+        default:
+            return false;
+    }
+}
+
 void IR_assign_stmt_init(IR_assign_stmt *assign_stmt, IR_var rd, IR_val rs) {
     const static struct IR_stmt_virtualTable vTable = {
             .teardown = IR_stmt_teardown_default,
@@ -318,6 +364,38 @@ void IR_if_stmt_init(IR_if_stmt *if_stmt, IR_RELOP_TYPE relop,
     if_stmt->true_blk = if_stmt->false_blk = NULL;
 }
 
+IR_RELOP_TYPE IR_RELOP_negate(IR_RELOP_TYPE relop) {
+    switch (relop) {
+        case IR_RELOP_EQ: return IR_RELOP_NE;
+        case IR_RELOP_NE: return IR_RELOP_EQ;
+        case IR_RELOP_GT: return IR_RELOP_LE;
+        case IR_RELOP_GE: return IR_RELOP_LT;
+        case IR_RELOP_LT: return IR_RELOP_GE;
+        default: return IR_RELOP_GT;
+    }
+}
+
+IR_RELOP_TYPE IR_RELOP_swap(IR_RELOP_TYPE relop) {
+    switch (relop) {
+        case IR_RELOP_GT: return IR_RELOP_LT;
+        case IR_RELOP_GE: return IR_RELOP_LE;
+        case IR_RELOP_LT: return IR_RELOP_GT;
+        case IR_RELOP_LE: return IR_RELOP_GE;
+        default: return relop;
+    }
+}
+
+bool IR_RELOP_eval(IR_RELOP_TYPE relop, int a, int b) {
+    switch (relop) {
+        case IR_RELOP_EQ: return a == b;
+        case IR_RELOP_NE: return a != b;
+        case IR_RELOP_GT: return a > b;
+        case IR_RELOP_GE: return a >= b;
+        case IR_RELOP_LT: return a < b;
+        default: return a <= b;
+    }
+}
+
 void IR_goto_stmt_init(IR_goto_stmt *goto_stmt, IR_label label) {
     const static struct IR_stmt_virtualTable vTable = {
             .teardown = IR_stmt_teardown_default,
@@ -369,4 +447,21 @@ void IR_write_stmt_init(IR_write_stmt *write_stmt, IR_val rs) {
     write_stmt->stmt_type = IR_WRITE_STMT;
     write_stmt->dead = false;
     write_stmt->rs = rs;
-}
\ No newline at end of file
+}
+
+void IR_phi_stmt_init(IR_phi_stmt *phi_stmt, IR_var rd,
+                      unsigned argc, IR_val *argv, IR_block **preds) {
+    const static struct IR_stmt_virtualTable vTable = {
+            .teardown = IR_phi_stmt_teardown,
+            .print = IR_phi_stmt_print,
+            .get_def = IR_phi_stmt_get_def,
+            .get_use_vec = IR_phi_stmt_get_use,
+    };
+    phi_stmt->vTable = &vTable;
+    phi_stmt->stmt_type = IR_PHI_STMT;
+    phi_stmt->dead = false;
+    phi_stmt->rd = rd;
+    phi_stmt->argc = argc;
+    phi_stmt->argv = argv;
+    phi_stmt->preds = preds;
+}
@@ -0,0 +1,68 @@
+//
+// Created by Assistant
+// 语句复制 (Statement Clone)
+//
+
+#include <IR.h>
+#include <stdlib.h>
+#include <string.h>
+
+// 复制一条语句, 跳转目标的基本块指针留空, 由重建CFG时重新填充
+IR_stmt *IR_stmt_clone(IR_stmt *stmt) {
+    switch (stmt->stmt_type) {
+        case IR_OP_STMT: {
+            IR_op_stmt *s = (IR_op_stmt*)stmt;
+            return (IR_stmt*)NEW(IR_op_stmt, s->op, s->rd, s->rs1, s->rs2);
+        }
+        case IR_ASSIGN_STMT: {
+            IR_assign_stmt *s = (IR_assign_stmt*)stmt;
+            return (IR_stmt*)NEW(IR_assign_stmt, s->rd, s->rs);
+        }
+        case IR_LOAD_STMT: {
+            IR_load_stmt *s = (IR_load_stmt*)stmt;
+            return (IR_stmt*)NEW(IR_load_stmt, s->rd, s->rs_addr);
+        }
+        case IR_STORE_STMT: {
+            IR_store_stmt *s = (IR_store_stmt*)stmt;
+            return (IR_stmt*)NEW(IR_store_stmt, s->rd_addr, s->rs);
+        }
+        case IR_IF_STMT: {
+            IR_if_stmt *s = (IR_if_stmt*)stmt;
+            return (IR_stmt*)NEW(IR_if_stmt, s->relop, s->rs1, s->rs2, s->true_label, s->false_label);
+        }
+        case IR_GOTO_STMT: {
+            IR_goto_stmt *s = (IR_goto_stmt*)stmt;
+            return (IR_stmt*)NEW(IR_goto_stmt, s->label);
+        }
+        case IR_CALL_STMT: {
+            IR_call_stmt *s = (IR_call_stmt*)stmt;
+            IR_val *argv = NULL;
+            if (s->argc) {
+                argv = (IR_val*)malloc(sizeof(IR_val) * s->argc);
+                memcpy(argv, s->argv, sizeof(IR_val) * s->argc);
+            }
+            return (IR_stmt*)NEW(IR_call_stmt, s->rd, s->func_name, s->argc, argv);
+        }
+        case IR_RETURN_STMT: {
+            IR_return_stmt *s = (IR_return_stmt*)stmt;
+            return (IR_stmt*)NEW(IR_return_stmt, s->rs);
+        }
+        case IR_READ_STMT: {
+            IR_read_stmt *s = (IR_read_stmt*)stmt;
+            return (IR_stmt*)NEW(IR_read_stmt, s->rd);
+        }
+        case IR_WRITE_STMT: {
+            IR_write_stmt *s = (IR_write_stmt*)stmt;
+            return (IR_stmt*)NEW(IR_write_stmt, s->rs);
+        }
+        case IR_PHI_STMT: {
+            IR_phi_stmt *s = (IR_phi_stmt*)stmt;
+            IR_val *argv = (IR_val*)malloc(sizeof(IR_val) * s->argc);
+            IR_block **preds = (IR_block**)malloc(sizeof(IR_block*) * s->argc);
+            memcpy(argv, s->argv, sizeof(IR_val) * s->argc);
+            memcpy(preds, s->preds, sizeof(IR_block*) * s->argc);
+            return (IR_stmt*)NEW(IR_phi_stmt, s->rd, s->argc, argv, preds);
+        }
+    }
+    return NULL;
+}
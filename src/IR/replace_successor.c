@@ -4,6 +4,7 @@
 
 // 替换pred块中的某个后继（old_succ）为新的后继（new_succ）
 // 假设pred的最后一条语句是跳转（GOTO/IF），修改其目标即可
+// IF 顺序执行到 old_succ 时只更新 false_blk，调用者需把 new_succ 放在 pred 之后
 void replace_successor(IR_block *pred, IR_block *old_succ, IR_block *new_succ) {
     if (!pred || !old_succ || !new_succ) return;
     if (!pred->stmts.tail) return;
@@ -19,13 +20,16 @@ void replace_successor(IR_block *pred, IR_block *old_succ, IR_block *new_succ) {
         }
         case IR_IF_STMT: {
             IR_if_stmt *if_stmt = (IR_if_stmt*)last;
+            if (if_stmt->false_label == IR_LABEL_NONE && if_stmt->false_blk == old_succ)
+                if_stmt->false_blk = new_succ;
+            if (old_succ->label == IR_LABEL_NONE) break;
             if (if_stmt->true_label == old_succ->label) {
                 if_stmt->true_label = new_succ->label;
-                // 可选: if_stmt->true_blk = new_succ;
+                if_stmt->true_blk = new_succ;
             }
             if (if_stmt->false_label == old_succ->label) {
                 if_stmt->false_label = new_succ->label;
-                // 可选: if_stmt->false_blk = new_succ;
+                if_stmt->false_blk = new_succ;
             }
             break;
         }
@@ -7,11 +7,23 @@
 #include <live_variable_analysis.h>
 #include <constant_propagation.h>
 #include <available_expressions_analysis.h>
-#include <copy_propagation.h>
+#include <partial_redundancy_elimination.h>
+#include <copy_coalescing.h>
+#include <redundant_load_elimination.h>
+#include <dead_code_elimination.h>
+#include <def_use_chain.h>
 #include <dominance_analysis.h>
 #include <loop_analysis.h>
 #include <induction_variable_analysis.h>
+#include <loop_rotate.h>
+#include <loop_unroll.h>
+#include <loop_deletion.h>
+#include <loop_unswitch.h>
+#include <loop_peel.h>
+#include <scalar_promotion.h>
+#include <arith_lowering.h>
 #include <container/treap.h>
+#include <config.h>
 
 #include <licm.h>
 #include <stdio.h>
@@ -45,82 +57,31 @@ void _IR_block_print(IR_block *block, FILE *out) {
     for_list(IR_stmt_ptr, i, block->stmts)
         VCALL(*i->val, print, out);
 }
-bool is_single_use_in_block(IR_function *func, IR_var var, ListNode_IR_stmt_ptr *start_from) {
-    #ifdef DEBUG
-    printf("CHECKING for v%d\n", var);
-    #endif
-    int use_count = 0;
-    for_list(IR_block_ptr, blk_ptr, func->blocks) {
-        IR_block_ptr blk = blk_ptr->val;
-        for_list(IR_stmt_ptr, i, blk->stmts) {
-            if (i == start_from) continue; // 跳过定义点
-            
-            IR_stmt_ptr stmt = i->val;
-            
-            // 检查所有使用该变量的地方
-            if (stmt->stmt_type == IR_ASSIGN_STMT) {
-                IR_assign_stmt *assign = (IR_assign_stmt*)stmt;
-                if (!assign->rs.is_const && assign->rs.var == var) {
-                    use_count++;
-                }
-            } else if (stmt->stmt_type == IR_OP_STMT) {
-                IR_op_stmt *op = (IR_op_stmt*)stmt;
-                if (!op->rs1.is_const && op->rs1.var == var) use_count++;
-                if (!op->rs2.is_const && op->rs2.var == var) use_count++;
-            } else if (stmt->stmt_type == IR_IF_STMT) {
-                IR_if_stmt *if_stmt = (IR_if_stmt*)stmt;
-                if (!if_stmt->rs1.is_const && if_stmt->rs1.var == var) use_count++;
-                if (!if_stmt->rs2.is_const && if_stmt->rs2.var == var) use_count++;
-            } else if (stmt->stmt_type == IR_WRITE_STMT) {
-                IR_write_stmt *write_stmt = (IR_write_stmt*)stmt;
-                if (!write_stmt->rs.is_const && write_stmt->rs.var == var) use_count++;
-            } else if (stmt->stmt_type == IR_RETURN_STMT) {
-                IR_return_stmt *ret_stmt = (IR_return_stmt*)stmt;
-                if (!ret_stmt->rs.is_const && ret_stmt->rs.var == var) use_count++;
-            }
-            
-            // 如果使用次数超过1，可以提前返回false，提高效率
-            if (use_count > 1) {
-                return false;
-            }
-        }
-        if (use_count > 1) {
-            return false;
-        }
-    }
-    #ifdef DEBUG
-    printf("v%d:%d\n", var, use_count);
-    #endif
-    return use_count == 1;
-}
 
-// 在 IR_optimize.c 中添加
+// 将 t := a op b; x := t (t 在整个函数中只有这一次使用) 合并为 x := a op b
 void eliminate_single_use_temps(IR_function *func) {
+    DefUseChain def_use;
+    DefUseChain_init(&def_use, func);
     for_list(IR_block_ptr, i, func->blocks) {
         IR_block *blk = i->val;
-        for_list(IR_stmt_ptr, j, blk->stmts) {
-            IR_stmt_ptr stmt = j->val;
-            if (stmt->stmt_type == IR_OP_STMT) {
-                IR_op_stmt *op_stmt = (IR_op_stmt*)stmt;
-                IR_var temp_var = op_stmt->rd;
-
-                // printf("TEMP VAR:v%d\n", temp_var);
-                
-                // 查找下一个语句是否是对这个临时变量的简单赋值
-                if (j->nxt && j->nxt->val->stmt_type == IR_ASSIGN_STMT) {
-                    IR_assign_stmt *assign = (IR_assign_stmt*)j->nxt->val;
-                    if (!assign->rs.is_const && assign->rs.var == temp_var) {
-                        if (is_single_use_in_block(func, temp_var, j)) {
-                            // 直接修改op_stmt的目标变量
-                            op_stmt->rd = assign->rd;
-                            assign->dead = true;
-                        }
-                    }
-                }
-            }
+        for(ListNode_IR_stmt_ptr *j = blk->stmts.head; j; j = j->nxt) {
+            if (j->val->stmt_type != IR_OP_STMT) continue;
+            IR_op_stmt *op_stmt = (IR_op_stmt*)j->val;
+            IR_var temp_var = op_stmt->rd;
+
+            // printf("TEMP VAR:v%d\n", temp_var);
+
+            // 查找下一个语句是否是对这个临时变量的简单赋值
+            if (!j->nxt || j->nxt->val->stmt_type != IR_ASSIGN_STMT) continue;
+            IR_assign_stmt *assign = (IR_assign_stmt*)j->nxt->val;
+            if (assign->rs.is_const || assign->rs.var != temp_var) continue;
+            if (DefUseChain_use_count(&def_use, temp_var) != 1) continue;
+            // 直接修改op_stmt的目标变量
+            DefUseChain_set_def(&def_use, (IR_stmt*)op_stmt, assign->rd);
+            DefUseChain_erase_stmt(&def_use, (IR_stmt*)assign);
         }
-        remove_dead_stmt(blk);
     }
+    DefUseChain_teardown(&def_use);
 }
 
 
@@ -132,7 +93,6 @@ void IR_optimize() {
     
     ConstantPropagation *constantPropagation;
     AvailableExpressionsAnalysis *availableExpressionsAnalysis;
-    CopyPropagation *copyPropagation;
     LiveVariableAnalysis *liveVariableAnalysis;
 
     for_vec(IR_function_ptr, i, ir_program_global->functions) {
@@ -148,11 +108,38 @@ void IR_optimize() {
         LoopAnalyzer_build_loop_hierarchy(&loop_analyzer);
         
         LoopAnalyzer_create_preheaders(&loop_analyzer);
+        LoopAnalyzer_refresh_dominators(&loop_analyzer);
+
+        //// Loop Deletion (出口值改为闭式后删除没有副作用的循环)
+
+        perform_loop_deletion(func, &dom_analyzer, &loop_analyzer);
+
+        //// Loop Rotation (while 循环改为守卫 + do-while, 每次迭代少执行一次跳转)
+
+        perform_loop_rotation(func, &dom_analyzer, &loop_analyzer);
+
+        //// Loop Peeling (剥离首次迭代, 使循环头处只在进入时为常量的变量在剩余循环中也能被化简)
+
+        perform_loop_peeling(func, &dom_analyzer, &loop_analyzer);
+
+        //// Loop Unrolling (重建被展开的循环所在函数的支配关系与循环信息)
+
+        perform_loop_unrolling(func, &dom_analyzer, &loop_analyzer);
         
-        // LICMAnalyzer licm_analyzer;
-        // LICMAnalyzer_init(&licm_analyzer, func, &loop_analyzer, &dom_analyzer);
-        // bool licm_modified = LICMAnalyzer_optimize(&licm_analyzer);
-        // LICMAnalyzer_teardown(&licm_analyzer);
+        //// Loop Invariant Code Motion (不变语句外提到预备首部)
+
+        LICMAnalyzer licm_analyzer;
+        LICMAnalyzer_init(&licm_analyzer, func, &loop_analyzer, &dom_analyzer);
+        LICMAnalyzer_optimize(&licm_analyzer);
+        LICMAnalyzer_teardown(&licm_analyzer);
+
+        //// Loop Unswitching (循环不变条件外提到预备首部, 复制出两个特化的循环)
+
+        perform_loop_unswitching(func, &dom_analyzer, &loop_analyzer);
+
+        //// Scalar Promotion (循环内只经不变地址访问的 DEC 位置改存到变量中)
+
+        perform_scalar_promotion(func, &dom_analyzer, &loop_analyzer);
             
         perform_strength_reduction_for_function(func, &loop_analyzer);
         
@@ -161,6 +148,14 @@ void IR_optimize() {
 
 
         {
+            //// Redundant Load Elimination (同一常量偏移位置上已有可用值的 LOAD 改为复制)
+
+            RedundantLoadElimination *redundantLoadElimination = NEW(RedundantLoadElimination, func);
+            worklist_solver((DataflowAnalysis*)redundantLoadElimination, func);
+            // VCALL(*redundantLoadElimination, printResult, func);
+            RedundantLoadElimination_replace_redundant_load(redundantLoadElimination, func);
+            DELETE(redundantLoadElimination);
+
             //// Constant Propagation
 
             constantPropagation = NEW(ConstantPropagation);
@@ -178,13 +173,22 @@ void IR_optimize() {
             AvailableExpressionsAnalysis_remove_available_expr_def(availableExpressionsAnalysis, func);
             DELETE(availableExpressionsAnalysis);
 
-            //// Copy Propagation
+            //// Partial Redundancy Elimination (Lazy Code Motion)
+
+            PartialRedundancyElimination pre;
+            PartialRedundancyElimination_init(&pre, func);
+            PartialRedundancyElimination_lazy_code_motion(&pre);
+            PartialRedundancyElimination_teardown(&pre);
 
-            copyPropagation = NEW(CopyPropagation);
-            worklist_solver((DataflowAnalysis*)copyPropagation, func);
-            // VCALL(*copyPropagation, printResult, func);
-            CopyPropagation_replace_available_use_copy(copyPropagation, func);
-            DELETE(copyPropagation);
+            //// Copy Coalescing
+
+            while(true) { // 合并后活跃范围改变, 可能暴露出新的可合并复制
+                CopyCoalescing copyCoalescing;
+                CopyCoalescing_init(&copyCoalescing, func);
+                bool updated = CopyCoalescing_coalesce(&copyCoalescing);
+                CopyCoalescing_teardown(&copyCoalescing);
+                if(!updated) break;
+            }
         }
         
 
@@ -196,9 +200,19 @@ void IR_optimize() {
         ConstantPropagation_constant_folding(constantPropagation, func);
         DELETE(constantPropagation);
 
+#if IR_OUT_EXTENDED_OPS
+        //// Arithmetic Lowering (输出方言支持移位与按位运算时, 乘除常量改为更便宜的序列)
+
+        perform_arith_lowering(func);
+#endif
+
+        //// Aggressive Dead Code Elimination
+
+        AggressiveDeadCodeElimination(func);
+
         //// Live Variable Analysis
 
-        while(true) {
+        while(true) { // 删除被覆盖的定义等流敏感的死代码
             liveVariableAnalysis = NEW(LiveVariableAnalysis);
             worklist_solver((DataflowAnalysis*)liveVariableAnalysis, func); // 将子类强制转化为父类
             // VCALL(*liveVariableAnalysis, printResult, func);
@@ -0,0 +1,208 @@
+//
+// Created by Assistant
+// 乘除常量降级 (Arithmetic Lowering)
+//
+
+#include <arith_lowering.h>
+#include <stdio.h>
+
+#define NAF_MAX_TERMS 33    // 32 位常量的非相邻形式最多 17 个非零位
+
+//// ================================== 代价模型 ==================================
+
+unsigned ArithLowering_op_cost(IR_OP_TYPE op) {
+    switch (op) {
+        case IR_OP_MUL:
+        case IR_OP_MULH: return LOWERING_COST_MUL;
+        case IR_OP_DIV:
+        case IR_OP_MOD: return LOWERING_COST_DIV;
+        default: return LOWERING_COST_ALU;
+    }
+}
+
+//// ================================== 语句生成 ==================================
+
+static IR_val var_val(IR_var var) {
+    return (IR_val){.is_const = false, .var = var};
+}
+
+static IR_val const_val(int value) {
+    return (IR_val){.is_const = true, .const_val = value};
+}
+
+// 在 pos 之前插入 t := rs1 op rs2, t 为新的临时变量
+static IR_val emit(IR_block *blk, ListNode_IR_stmt_ptr *pos, IR_OP_TYPE op, IR_val rs1, IR_val rs2) {
+    IR_var t = ir_var_generator();
+    VCALL(blk->stmts, insert_front, pos, (IR_stmt*)NEW(IR_op_stmt, op, t, rs1, rs2));
+    return var_val(t);
+}
+
+// 最后插入的语句改为定义原语句的目标变量, 删除原语句
+static void finish(IR_block *blk, ListNode_IR_stmt_ptr *node) {
+    IR_op_stmt *stmt = (IR_op_stmt*)node->val;
+    IR_op_stmt *last = (IR_op_stmt*)node->pre->val;
+    last->rd = stmt->rd;
+    VCALL(blk->stmts, delete, node);
+    RDELETE(IR_stmt, (IR_stmt*)stmt);
+}
+
+//// ================================== 乘常量 ==================================
+
+// 常量(模 2^32)的非相邻形式, 正的项排在前面; 返回非零位数
+static unsigned naf_terms(unsigned c, int sign[], unsigned shift[]) {
+    int raw_sign[NAF_MAX_TERMS];
+    unsigned raw_shift[NAF_MAX_TERMS], raw_cnt = 0;
+    unsigned long long n = c;
+    for (unsigned k = 0; n; k++, n >>= 1) {
+        if (!(n & 1)) continue;
+        int d = 2 - (int)(n & 3);   // n % 4 == 1 取 +1, n % 4 == 3 取 -1
+        if (k < 32) {               // 2^32 及以上的位模 2^32 为 0
+            raw_sign[raw_cnt] = d;
+            raw_shift[raw_cnt++] = k;
+        }
+        if (d > 0) n--; else n++;
+    }
+    unsigned cnt = 0;
+    for (unsigned i = 0; i < raw_cnt; i++)
+        if (raw_sign[i] > 0) sign[cnt] = 1, shift[cnt++] = raw_shift[i];
+    for (unsigned i = 0; i < raw_cnt; i++)
+        if (raw_sign[i] < 0) sign[cnt] = -1, shift[cnt++] = raw_shift[i];
+    return cnt;
+}
+
+// rd := x * c, 展开为各项 ±(x << s) 的和; 所有项都为负时先求和再取反
+static bool lower_mul(IR_block *blk, ListNode_IR_stmt_ptr *node, IR_var x, int c) {
+    int sign[NAF_MAX_TERMS];
+    unsigned shift[NAF_MAX_TERMS];
+    unsigned cnt = naf_terms((unsigned)c, sign, shift);
+    if (cnt == 0) return false;
+    bool negate = sign[0] < 0;
+    unsigned cost = (cnt - 1) + negate;
+    for (unsigned i = 0; i < cnt; i++) if (shift[i]) cost++;
+    if (cost == 0 || cost * LOWERING_COST_ALU >= ArithLowering_op_cost(IR_OP_MUL)) return false;
+
+    IR_val acc;
+    for (unsigned i = 0; i < cnt; i++) {
+        IR_val term = shift[i] ? emit(blk, node, IR_OP_SHL, var_val(x), const_val((int)shift[i])) : var_val(x);
+        if (i == 0) acc = term;
+        else acc = emit(blk, node, negate || sign[i] > 0 ? IR_OP_ADD : IR_OP_SUB, acc, term);
+    }
+    if (negate) emit(blk, node, IR_OP_SUB, const_val(0), acc);
+    finish(blk, node);
+    return true;
+}
+
+//// ================================== 除以 2 的幂 ==================================
+
+// 负的被除数加上 2^k - 1, 使之后的右移与按位与向零取整
+static IR_val round_toward_zero(IR_block *blk, ListNode_IR_stmt_ptr *node, IR_var x, unsigned k) {
+    IR_val bias = k == 1 ? emit(blk, node, IR_OP_SHR, var_val(x), const_val(31))
+            : emit(blk, node, IR_OP_SHR, emit(blk, node, IR_OP_SAR, var_val(x), const_val(31)), const_val((int)(32 - k)));
+    return emit(blk, node, IR_OP_ADD, var_val(x), bias);
+}
+
+// rd := x / c 或 rd := x % c, |c| = 2^k 且 k >= 1
+static bool lower_div_pow2(IR_block *blk, ListNode_IR_stmt_ptr *node, IR_OP_TYPE op, IR_var x, int c) {
+    unsigned magnitude = c < 0 ? -(unsigned)c : (unsigned)c;
+    if (magnitude < 2 || (magnitude & (magnitude - 1))) return false;
+    unsigned k = 0;
+    while (!(magnitude >> k & 1)) k++;
+    // 除法 3~5 条, 取模 4~5 条, 都远小于除法的代价
+    IR_val biased = round_toward_zero(blk, node, x, k);
+    if (op == IR_OP_DIV) {
+        IR_val quotient = emit(blk, node, IR_OP_SAR, biased, const_val((int)k));
+        if (c < 0) emit(blk, node, IR_OP_SUB, const_val(0), quotient);
+    } else { // 余数符号与被除数相同, 与除数符号无关
+        IR_val multiple = emit(blk, node, IR_OP_AND, biased, const_val((int)(~0u << k)));
+        emit(blk, node, IR_OP_SUB, var_val(x), multiple);
+    }
+    finish(blk, node);
+    return true;
+}
+
+//// ================================== 除以一般常量 ==================================
+
+// 有符号除以 d (|d| >= 2 且不是 2 的幂) 的魔数 m 与移位量 s: 对所有 32 位 x,
+// x / d 等于 (mulh(m, x) (+/- x)) >> s 再对负的结果加 1 (Hacker's Delight 10-1)
+static void signed_magic(int d, int *magic, unsigned *shift) {
+    const unsigned two31 = 0x80000000u;
+    unsigned ad = d < 0 ? -(unsigned)d : (unsigned)d;
+    unsigned t = two31 + ((unsigned)d >> 31);
+    unsigned anc = t - 1 - t % ad;     // |nc|, nc 为最大的使 nc % d == d - 1 的值
+    unsigned q1 = two31 / anc, r1 = two31 - q1 * anc;
+    unsigned q2 = two31 / ad, r2 = two31 - q2 * ad;
+    unsigned p = 31, delta;
+    do {
+        p++;
+        q1 *= 2, r1 *= 2;
+        if (r1 >= anc) q1++, r1 -= anc;
+        q2 *= 2, r2 *= 2;
+        if (r2 >= ad) q2++, r2 -= ad;
+        delta = ad - r2;
+    } while (q1 < delta || (q1 == delta && r1 == 0));
+    unsigned m = q2 + 1;
+    *magic = (int)(d < 0 ? 0u - m : m);
+    *shift = p - 32;
+}
+
+// rd := x / c 或 rd := x % c, |c| >= 2 且不是 2 的幂; 取模再算 x - (x / c) * c
+static bool lower_div_magic(IR_block *blk, ListNode_IR_stmt_ptr *node, IR_OP_TYPE op, IR_var x, int c) {
+    int magic;
+    unsigned shift;
+    signed_magic(c, &magic, &shift);
+    // 除法 4~6 条, 取模再多 2 条, 其中一到两条乘法
+    IR_val q = emit(blk, node, IR_OP_MULH, const_val(magic), var_val(x));
+    if (c > 0 && magic < 0) q = emit(blk, node, IR_OP_ADD, q, var_val(x));
+    if (c < 0 && magic > 0) q = emit(blk, node, IR_OP_SUB, q, var_val(x));
+    if (shift) q = emit(blk, node, IR_OP_SAR, q, const_val((int)shift));
+    IR_val sign = emit(blk, node, IR_OP_SHR, q, const_val(31)); // 结果为负时加 1, 向零取整
+    q = emit(blk, node, IR_OP_ADD, q, sign);
+    if (op == IR_OP_MOD) {
+        IR_val multiple = emit(blk, node, IR_OP_MUL, q, const_val(c));
+        emit(blk, node, IR_OP_SUB, var_val(x), multiple);
+    }
+    finish(blk, node);
+    return true;
+}
+
+//// ================================== 降级 ==================================
+
+bool ArithLowering_lower_stmt(IR_block *blk, ListNode_IR_stmt_ptr *node) {
+    if (node->val->stmt_type != IR_OP_STMT) return false;
+    IR_op_stmt *stmt = (IR_op_stmt*)node->val;
+    IR_val rs1 = stmt->rs1, rs2 = stmt->rs2;
+    switch (stmt->op) {
+        case IR_OP_MUL:
+            if (rs1.is_const && !rs2.is_const) return lower_mul(blk, node, rs2.var, rs1.const_val);
+            if (!rs1.is_const && rs2.is_const) return lower_mul(blk, node, rs1.var, rs2.const_val);
+            return false;
+        case IR_OP_DIV:
+        case IR_OP_MOD:
+            if (rs1.is_const || !rs2.is_const) return false;
+            if (rs2.const_val >= -1 && rs2.const_val <= 1) return false;
+            return lower_div_pow2(blk, node, stmt->op, rs1.var, rs2.const_val)
+                    || lower_div_magic(blk, node, stmt->op, rs1.var, rs2.const_val);
+        default:
+            return false;
+    }
+}
+
+//// ================================== 高层接口 ==================================
+
+bool perform_arith_lowering(IR_function *func) {
+    bool changed = false;
+    for_list(IR_block_ptr, i, func->blocks) {
+        IR_block *blk = i->val;
+        for (ListNode_IR_stmt_ptr *j = blk->stmts.head; j;) {
+            ListNode_IR_stmt_ptr *nxt = j->nxt;
+            if (ArithLowering_lower_stmt(blk, j)) {
+#ifdef DEBUG
+                printf("lower arithmetic in L%u\n", blk->label);
+#endif
+                changed = true;
+            }
+            j = nxt;
+        }
+    }
+    return changed;
+}
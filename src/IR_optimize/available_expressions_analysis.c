@@ -260,6 +260,45 @@ bool simple_expr_optimize(IR_stmt **stmt_ptr_ptr) {
             }
             break;
         }
+        case IR_OP_SHL:
+        case IR_OP_SHR:
+        case IR_OP_SAR: {
+            if(op_stmt->rs2.is_const && op_stmt->rs2.const_val == 0) {
+                *stmt_ptr_ptr = (IR_stmt*)NEW(IR_assign_stmt, op_stmt->rd, op_stmt->rs1);
+                RDELETE(IR_stmt, stmt);
+                return true;
+            }
+            break;
+        }
+        case IR_OP_OR:
+        case IR_OP_XOR: {
+            if(op_stmt->rs1.is_const && op_stmt->rs1.const_val == 0) {
+                *stmt_ptr_ptr = (IR_stmt*)NEW(IR_assign_stmt, op_stmt->rd, op_stmt->rs2);
+                RDELETE(IR_stmt, stmt);
+                return true;
+            }
+            if(op_stmt->rs2.is_const && op_stmt->rs2.const_val == 0) {
+                *stmt_ptr_ptr = (IR_stmt*)NEW(IR_assign_stmt, op_stmt->rd, op_stmt->rs1);
+                RDELETE(IR_stmt, stmt);
+                return true;
+            }
+            break;
+        }
+        case IR_OP_AND: {
+            if(op_stmt->rs1.is_const && op_stmt->rs1.const_val == -1) {
+                *stmt_ptr_ptr = (IR_stmt*)NEW(IR_assign_stmt, op_stmt->rd, op_stmt->rs2);
+                RDELETE(IR_stmt, stmt);
+                return true;
+            }
+            if(op_stmt->rs2.is_const && op_stmt->rs2.const_val == -1) {
+                *stmt_ptr_ptr = (IR_stmt*)NEW(IR_assign_stmt, op_stmt->rd, op_stmt->rs1);
+                RDELETE(IR_stmt, stmt);
+                return true;
+            }
+            break;
+        }
+        default:
+            break;
     }
     return false;
 }
@@ -276,7 +315,7 @@ void AvailableExpressionsAnalysis_merge_common_expr(AvailableExpressionsAnalysis
                 IR_op_stmt *op_stmt = (IR_op_stmt*)stmt;
                 if(simple_expr_optimize(&j->val)) continue;
                 Expr expr = {.op = op_stmt->op, .rs1 = op_stmt->rs1, .rs2 = op_stmt->rs2};
-                if(expr.op == IR_OP_ADD || expr.op == IR_OP_MUL) {
+                if(IR_OP_is_commutative(expr.op)) {
                     if(IR_val_CMP(expr.rs1, expr.rs2) == 0) {
                         IR_val tmp = expr.rs1;
                         expr.rs1 = expr.rs2;
@@ -65,6 +65,17 @@ static CPValue calculateValue(IR_OP_TYPE IR_op_type, CPValue v1, CPValue v2) {
         case IR_OP_DIV:
             if(c2 == 0) return get_UNDEF(); // 除以0，结果未定义
             result = c1 / c2; break;
+        case IR_OP_MOD:
+            if(c2 == 0) return get_UNDEF(); // 对0取模，结果未定义
+            result = c2 == -1 ? 0 : c1 % c2; break;
+        // 移位量取低5位，移位在无符号数上进行以免溢出
+        case IR_OP_SHL: result = (int)((unsigned)c1 << (c2 & 31)); break;
+        case IR_OP_SHR: result = (int)((unsigned)c1 >> (c2 & 31)); break;
+        case IR_OP_SAR: result = c1 >> (c2 & 31); break;
+        case IR_OP_AND: result = c1 & c2; break;
+        case IR_OP_OR:  result = c1 | c2; break;
+        case IR_OP_XOR: result = c1 ^ c2; break;
+        case IR_OP_MULH: result = (int)(((long long)c1 * c2) >> 32); break;
         default: assert(0); // 不支持的操作类型
     }
     return get_CONST(result); 
@@ -373,12 +384,34 @@ static void block_constant_folding (ConstantPropagation *t, IR_block *blk) {
     RDELETE(Map_IR_var_CPValue, current_fact_for_folding); // 释放临时的fact
 }
 
+// （辅助函数）块末尾的 IF 两个操作数都是常量时，改为跳向确定的分支；
+// 不跳转的一侧为顺序执行时直接去掉 IF。返回块是否被修改。
+static bool block_fold_branch (IR_block *blk) {
+    if (blk->stmts.tail == NULL || blk->stmts.tail->val->stmt_type != IR_IF_STMT) return false;
+    IR_if_stmt *if_stmt = (IR_if_stmt*)blk->stmts.tail->val;
+    if (!if_stmt->rs1.is_const || !if_stmt->rs2.is_const) return false;
+    bool taken = IR_RELOP_eval(if_stmt->relop, if_stmt->rs1.const_val, if_stmt->rs2.const_val);
+    IR_label target = taken ? if_stmt->true_label : if_stmt->false_label;
+    RDELETE(IR_stmt, (IR_stmt*)if_stmt);
+    VCALL(blk->stmts, pop_back);
+    if (target != IR_LABEL_NONE)
+        VCALL(blk->stmts, push_back, (IR_stmt*)NEW(IR_goto_stmt, target));
+    return true;
+}
+
 // 对整个函数执行常量折叠优化。
 // 遍历函数中的所有基本块，并对每个块调用block_constant_folding。
+// 条件变为常量的 IF 随后改为无条件跳转，删除由此不可达的块并重建CFG。
 // 此函数需要在常量传播数据流分析求解完毕后调用。
 void ConstantPropagation_constant_folding (ConstantPropagation *t, IR_function *func) {
     for_list(IR_block_ptr, j, func->blocks) { // 遍历所有基本块
         IR_block *blk = j->val;
         block_constant_folding(t, blk); // 对每个块执行常量折叠
     }
+    bool folded = false;
+    for_list(IR_block_ptr, j, func->blocks)
+        if (block_fold_branch(j->val)) folded = true;
+    if (!folded) return;
+    IR_function_rebuild_graph(func);
+    IR_function_remove_unreachable_blocks(func);
 }
@@ -0,0 +1,218 @@
+//
+// Created by Assistant
+// 复制合并实现 (Copy Coalescing Implementation)
+//
+
+#include <copy_coalescing.h>
+
+//// ================================== 并查集 ==================================
+
+IR_var CopyCoalescing_find(CopyCoalescing *t, IR_var var) {
+    IR_var root = var;
+    while (VCALL(t->parent, exist, root))
+        root = VCALL(t->parent, get, root);
+    // 路径压缩
+    while (var != root) {
+        IR_var next = VCALL(t->parent, get, var);
+        VCALL(t->parent, set, var, root);
+        var = next;
+    }
+    return root;
+}
+
+static Set_IR_var *interference_of(CopyCoalescing *t, IR_var var) {
+    if (VCALL(t->interference, exist, var)) return VCALL(t->interference, get, var);
+    Set_IR_var *set = NEW(Set_IR_var);
+    VCALL(t->interference, insert, var, set);
+    return set;
+}
+
+static void add_interference(CopyCoalescing *t, IR_var a, IR_var b) {
+    if (a == b) return;
+    VCALL(*interference_of(t, a), insert, b);
+    VCALL(*interference_of(t, b), insert, a);
+}
+
+// 将 from 所在类并入代表变量 to, 冲突集合随之合并
+static void union_into(CopyCoalescing *t, IR_var from, IR_var to) {
+    VCALL(t->parent, insert, from, to);
+    if (!VCALL(t->interference, exist, from)) return;
+    Set_IR_var *from_set = VCALL(t->interference, get, from);
+    Set_IR_var *to_set = interference_of(t, to);
+    for_set(IR_var, i, *from_set) {
+        Set_IR_var *neighbor = interference_of(t, i->key);
+        VCALL(*neighbor, delete, from);
+        VCALL(*neighbor, insert, to);
+    }
+    VCALL(*to_set, union_with, from_set);
+    VCALL(t->interference, delete, from);
+    RDELETE(Set_IR_var, from_set);
+}
+
+//// ================================== 冲突关系 ==================================
+
+static bool is_var_copy(IR_stmt *stmt) {
+    return stmt->stmt_type == IR_ASSIGN_STMT && !((IR_assign_stmt*)stmt)->rs.is_const;
+}
+
+/**
+ * @brief 计算每个变量的"值来源": 若 x 只有一处定义且为 x := s, 而 s 也只有一处定义 (或为固定变量),
+ * 则在二者同时活跃的任意位置 x 与 s 的值必然相同, 它们的来源相同, 无需视为冲突。
+ * 这样同一个值的多份复制 (y := t; z := t; ...) 可以全部合并。
+ */
+static void compute_value_source(CopyCoalescing *t, Set_IR_var *entry_live, Map_IR_var_IR_var *source) {
+    Set_IR_var defined, defined_multi;
+    Set_IR_var_init(&defined);
+    Set_IR_var_init(&defined_multi);
+    Map_IR_var_IR_var copy_of;
+    Map_IR_var_IR_var_init(&copy_of);
+    for_list(IR_block_ptr, i, t->func->blocks) {
+        for_list(IR_stmt_ptr, j, i->val->stmts) {
+            IR_var def = VCALL(*j->val, get_def);
+            if (def == IR_VAR_NONE) continue;
+            if (!VCALL(defined, insert, def) || VCALL(t->pinned, exist, def))
+                VCALL(defined_multi, insert, def);
+            if (is_var_copy(j->val)) VCALL(copy_of, insert, def, ((IR_assign_stmt*)j->val)->rs.var);
+        }
+    }
+    for_map(IR_var, IR_var, i, copy_of) {
+        IR_var var = i->key, src = var;
+        // 沿单定义复制链向上追溯, 步数上限防止不可达代码中的复制环
+        for (unsigned steps = 0; steps < 64; steps++) {
+            if (VCALL(defined_multi, exist, src) || !VCALL(copy_of, exist, src)) break;
+            IR_var next = VCALL(copy_of, get, src);
+            if (VCALL(defined_multi, exist, next)) break;
+            src = next;
+        }
+        // 入口处活跃说明可能先使用后定义, 此时单定义不代表值相同
+        if (VCALL(*entry_live, exist, var) || (VCALL(*entry_live, exist, src) && !VCALL(t->pinned, exist, src)))
+            continue;
+        if (src != var) VCALL(*source, insert, var, src);
+    }
+    Map_IR_var_IR_var_teardown(&copy_of);
+    Set_IR_var_teardown(&defined);
+    Set_IR_var_teardown(&defined_multi);
+}
+
+static IR_var value_source_of(Map_IR_var_IR_var *source, IR_var var) {
+    return VCALL(*source, exist, var) ? VCALL(*source, get, var) : var;
+}
+
+static void build_interference(CopyCoalescing *t, LiveVariableAnalysis *live) {
+    IR_function *func = t->func;
+    Set_IR_var *entry_live = VCALL(*live, getInFact, func->entry);
+    Map_IR_var_IR_var source;
+    Map_IR_var_IR_var_init(&source);
+    compute_value_source(t, entry_live, &source);
+    for_list(IR_block_ptr, i, func->blocks) {
+        IR_block *blk = i->val;
+        Set_IR_var *live_out = VCALL(*live, getOutFact, blk);
+        Set_IR_var *live_now = NEW(Set_IR_var);
+        VCALL(*live_now, union_with, live_out);
+        rfor_list(IR_stmt_ptr, j, blk->stmts) {
+            IR_stmt *stmt = j->val;
+            IR_var def = VCALL(*stmt, get_def);
+            if (def != IR_VAR_NONE) {
+                IR_var copy_src = is_var_copy(stmt) ? ((IR_assign_stmt*)stmt)->rs.var : IR_VAR_NONE;
+                IR_var def_source = value_source_of(&source, def);
+                for_set(IR_var, v, *live_now)
+                    if (v->key != copy_src && value_source_of(&source, v->key) != def_source)
+                        add_interference(t, def, v->key);
+            }
+            LiveVariableAnalysis_transferStmt(live, stmt, live_now);
+        }
+        DELETE(live_now);
+    }
+    // 固定变量在函数入口同时获得定义, 与入口处活跃的变量冲突, 彼此之间也冲突
+    for_set(IR_var, p, t->pinned) {
+        for_set(IR_var, v, *entry_live)
+            add_interference(t, p->key, v->key);
+        for_set(IR_var, q, t->pinned)
+            add_interference(t, p->key, q->key);
+    }
+    Map_IR_var_IR_var_teardown(&source);
+}
+
+//// ================================== 重写 ==================================
+
+static void stmt_set_def(IR_stmt *stmt, IR_var var) {
+    switch (stmt->stmt_type) {
+        case IR_OP_STMT: ((IR_op_stmt*)stmt)->rd = var; break;
+        case IR_ASSIGN_STMT: ((IR_assign_stmt*)stmt)->rd = var; break;
+        case IR_LOAD_STMT: ((IR_load_stmt*)stmt)->rd = var; break;
+        case IR_CALL_STMT: ((IR_call_stmt*)stmt)->rd = var; break;
+        case IR_READ_STMT: ((IR_read_stmt*)stmt)->rd = var; break;
+        default: break;
+    }
+}
+
+static void rewrite_function(CopyCoalescing *t) {
+    for_list(IR_block_ptr, i, t->func->blocks) {
+        IR_block *blk = i->val;
+        for_list(IR_stmt_ptr, j, blk->stmts) {
+            IR_stmt *stmt = j->val;
+            IR_var def = VCALL(*stmt, get_def);
+            if (def != IR_VAR_NONE) stmt_set_def(stmt, CopyCoalescing_find(t, def));
+            IR_use use = VCALL(*stmt, get_use_vec);
+            for (unsigned k = 0; k < use.use_cnt; k++)
+                if (!use.use_vec[k].is_const)
+                    use.use_vec[k].var = CopyCoalescing_find(t, use.use_vec[k].var);
+            if (is_var_copy(stmt) && ((IR_assign_stmt*)stmt)->rs.var == ((IR_assign_stmt*)stmt)->rd)
+                stmt->dead = true;
+        }
+        remove_dead_stmt(blk);
+    }
+}
+
+//// ================================== 优化入口 ==================================
+
+bool CopyCoalescing_coalesce(CopyCoalescing *t) {
+    IR_function *func = t->func;
+    LiveVariableAnalysis *live = NEW(LiveVariableAnalysis);
+    worklist_solver((DataflowAnalysis*)live, func);
+    build_interference(t, live);
+    DELETE(live);
+
+    bool updated = false;
+    for_list(IR_block_ptr, i, func->blocks) {
+        for_list(IR_stmt_ptr, j, i->val->stmts) {
+            if (!is_var_copy(j->val)) continue;
+            IR_assign_stmt *copy = (IR_assign_stmt*)j->val;
+            IR_var rd = CopyCoalescing_find(t, copy->rd);
+            IR_var rs = CopyCoalescing_find(t, copy->rs.var);
+            if (rd == rs) continue;
+            if (VCALL(*interference_of(t, rd), exist, rs)) continue;
+            bool rd_pinned = VCALL(t->pinned, exist, rd), rs_pinned = VCALL(t->pinned, exist, rs);
+            if (rd_pinned && rs_pinned) continue;
+            // 固定变量必须作为代表, 保证参数与 DEC 的名字不变
+            if (rd_pinned) union_into(t, rs, rd);
+            else union_into(t, rd, rs);
+            updated = true;
+        }
+    }
+    if (updated) rewrite_function(t);
+    return updated;
+}
+
+//// ================================== 构造与析构 ==================================
+
+void CopyCoalescing_init(CopyCoalescing *t, IR_function *func) {
+    t->func = func;
+    Map_IR_var_IR_var_init(&t->parent);
+    Map_IR_var_Set_ptr_IR_var_init(&t->interference);
+    Set_IR_var_init(&t->pinned);
+    for_vec(IR_var, i, func->params)
+        VCALL(t->pinned, insert, *i);
+    for_map(IR_var, IR_Dec, i, func->map_dec) {
+        VCALL(t->pinned, insert, i->key);
+        VCALL(t->pinned, insert, i->val.dec_addr);
+    }
+}
+
+void CopyCoalescing_teardown(CopyCoalescing *t) {
+    for_map(IR_var, Set_ptr_IR_var, i, t->interference)
+        RDELETE(Set_IR_var, i->val);
+    Map_IR_var_Set_ptr_IR_var_teardown(&t->interference);
+    Map_IR_var_IR_var_teardown(&t->parent);
+    Set_IR_var_teardown(&t->pinned);
+}
@@ -0,0 +1,67 @@
+//
+// Created by Assistant
+// 激进死代码消除实现 (Aggressive Dead Code Elimination Implementation)
+//
+
+#include <dead_code_elimination.h>
+
+// 具有副作用或决定控制流的语句不可删除, 作为标记的根
+static bool is_root_stmt(IR_stmt *stmt) {
+    switch (stmt->stmt_type) {
+        case IR_OP_STMT:
+        case IR_ASSIGN_STMT:
+        case IR_LOAD_STMT:
+            return false;
+        default:
+            return true;
+    }
+}
+
+bool AggressiveDeadCodeElimination(IR_function *func) {
+    DefUseChain def_use;
+    DefUseChain_init(&def_use, func);
+    Set_IR_stmt_ptr live;
+    Set_IR_stmt_ptr_init(&live);
+    List_IR_stmt_ptr worklist;
+    List_IR_stmt_ptr_init(&worklist);
+
+    //// 标记: 从根出发沿使用 -> 定义传播
+    for_list(IR_block_ptr, i, func->blocks)
+        for_list(IR_stmt_ptr, j, i->val->stmts)
+            if (is_root_stmt(j->val)) {
+                VCALL(live, insert, j->val);
+                VCALL(worklist, push_back, j->val);
+            }
+    while (worklist.head) {
+        IR_stmt *stmt = worklist.head->val;
+        VCALL(worklist, delete, worklist.head);
+        IR_use use = VCALL(*stmt, get_use_vec);
+        for (unsigned k = 0; k < use.use_cnt; k++) {
+            if (use.use_vec[k].is_const) continue;
+            Set_IR_stmt_ptr *defs = DefUseChain_get_defs(&def_use, use.use_vec[k].var);
+            if (!defs) continue;
+            for_set(IR_stmt_ptr, d, *defs)
+                if (VCALL(live, insert, d->key))
+                    VCALL(worklist, push_back, d->key);
+        }
+    }
+
+    //// 清除: 删除所有未标记的语句
+    bool updated = false;
+    for_list(IR_block_ptr, i, func->blocks) {
+        IR_block *blk = i->val;
+        bool blk_updated = false;
+        for_list(IR_stmt_ptr, j, blk->stmts)
+            if (!VCALL(live, exist, j->val)) {
+                j->val->dead = true;
+                blk_updated = true;
+            }
+        if (blk_updated) remove_dead_stmt(blk);
+        updated |= blk_updated;
+    }
+
+    List_IR_stmt_ptr_teardown(&worklist);
+    Set_IR_stmt_ptr_teardown(&live);
+    DefUseChain_teardown(&def_use);
+    return updated;
+}
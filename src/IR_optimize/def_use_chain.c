@@ -0,0 +1,202 @@
+//
+// Created by Assistant
+// 定义-使用链索引实现 (Def-Use Chain Index Implementation)
+//
+
+#include <def_use_chain.h>
+
+//// ================================== 索引维护 ==================================
+
+static void var_set_insert(Map_IR_var_Set_ptr_IR_stmt_ptr *map, IR_var var, IR_stmt *stmt) {
+    Set_IR_stmt_ptr *set;
+    if (VCALL(*map, exist, var)) set = VCALL(*map, get, var);
+    else {
+        set = NEW(Set_IR_stmt_ptr);
+        VCALL(*map, insert, var, set);
+    }
+    VCALL(*set, insert, stmt);
+}
+
+static void var_set_delete(Map_IR_var_Set_ptr_IR_stmt_ptr *map, IR_var var, IR_stmt *stmt) {
+    if (!VCALL(*map, exist, var)) return;
+    Set_IR_stmt_ptr *set = VCALL(*map, get, var);
+    VCALL(*set, delete, stmt);
+    if (set->root == NULL) {
+        VCALL(*map, delete, var);
+        RDELETE(Set_IR_stmt_ptr, set);
+    }
+}
+
+static void index_stmt(DefUseChain *t, IR_block *blk, ListNode_IR_stmt_ptr *node) {
+    IR_stmt *stmt = node->val;
+    VCALL(t->sites, set, stmt, ((IR_stmt_site){.blk = blk, .node = node}));
+    IR_var def = VCALL(*stmt, get_def);
+    if (def != IR_VAR_NONE) var_set_insert(&t->defs, def, stmt);
+    IR_use use = VCALL(*stmt, get_use_vec);
+    for (unsigned i = 0; i < use.use_cnt; i++)
+        if (!use.use_vec[i].is_const) var_set_insert(&t->uses, use.use_vec[i].var, stmt);
+}
+
+static void unindex_stmt(DefUseChain *t, IR_stmt *stmt) {
+    IR_var def = VCALL(*stmt, get_def);
+    if (def != IR_VAR_NONE) var_set_delete(&t->defs, def, stmt);
+    IR_use use = VCALL(*stmt, get_use_vec);
+    for (unsigned i = 0; i < use.use_cnt; i++)
+        if (!use.use_vec[i].is_const) var_set_delete(&t->uses, use.use_vec[i].var, stmt);
+    VCALL(t->sites, delete, stmt);
+}
+
+static void var_set_map_teardown(Map_IR_var_Set_ptr_IR_stmt_ptr *map) {
+    for_map(IR_var, Set_ptr_IR_stmt_ptr, i, *map)
+        RDELETE(Set_IR_stmt_ptr, i->val);
+    Map_IR_var_Set_ptr_IR_stmt_ptr_teardown(map);
+}
+
+//// ================================== 构造与析构 ==================================
+
+void DefUseChain_init(DefUseChain *t, IR_function *func) {
+    t->func = func;
+    Map_IR_var_Set_ptr_IR_stmt_ptr_init(&t->defs);
+    Map_IR_var_Set_ptr_IR_stmt_ptr_init(&t->uses);
+    Map_IR_stmt_ptr_IR_stmt_site_init(&t->sites);
+    for_list(IR_block_ptr, i, func->blocks)
+        for_list(IR_stmt_ptr, j, i->val->stmts)
+            index_stmt(t, i->val, j);
+}
+
+void DefUseChain_teardown(DefUseChain *t) {
+    var_set_map_teardown(&t->defs);
+    var_set_map_teardown(&t->uses);
+    Map_IR_stmt_ptr_IR_stmt_site_teardown(&t->sites);
+}
+
+//// ================================== 查询 ==================================
+
+Set_IR_stmt_ptr *DefUseChain_get_uses(DefUseChain *t, IR_var var) {
+    return VCALL(t->uses, exist, var) ? VCALL(t->uses, get, var) : NULL;
+}
+
+Set_IR_stmt_ptr *DefUseChain_get_defs(DefUseChain *t, IR_var var) {
+    return VCALL(t->defs, exist, var) ? VCALL(t->defs, get, var) : NULL;
+}
+
+unsigned DefUseChain_use_count(DefUseChain *t, IR_var var) {
+    Set_IR_stmt_ptr *uses = DefUseChain_get_uses(t, var);
+    if (!uses) return 0;
+    unsigned cnt = 0;
+    for_set(IR_stmt_ptr, i, *uses) {
+        IR_use use = VCALL(*i->key, get_use_vec);
+        for (unsigned k = 0; k < use.use_cnt; k++)
+            if (!use.use_vec[k].is_const && use.use_vec[k].var == var) cnt++;
+    }
+    return cnt;
+}
+
+unsigned DefUseChain_def_count(DefUseChain *t, IR_var var) {
+    Set_IR_stmt_ptr *defs = DefUseChain_get_defs(t, var);
+    return defs ? defs->root->size : 0;
+}
+
+IR_stmt *DefUseChain_single_def(DefUseChain *t, IR_var var) {
+    Set_IR_stmt_ptr *defs = DefUseChain_get_defs(t, var);
+    if (!defs || defs->root->size != 1) return NULL;
+    return ((SetNode_IR_stmt_ptr*)defs->root)->key;
+}
+
+IR_stmt_site *DefUseChain_site_of(DefUseChain *t, IR_stmt *stmt) {
+    MapNode_IR_stmt_ptr_IR_stmt_site *node = (MapNode_IR_stmt_ptr_IR_stmt_site*)
+            TreapNodeBase_find_iter(t->sites.root, TREAP_CONTENT_OFFSET(MapNode_IR_stmt_ptr_IR_stmt_site),
+                                    MapNode_IR_stmt_ptr_IR_stmt_site_cmp_func, &stmt);
+    return node ? &node->val : NULL;
+}
+
+//// ================================== 改写 ==================================
+
+unsigned DefUseChain_replace_use(DefUseChain *t, IR_stmt *stmt, IR_var old_var, IR_val new_val) {
+    unsigned cnt = 0;
+    IR_use use = VCALL(*stmt, get_use_vec);
+    for (unsigned i = 0; i < use.use_cnt; i++) {
+        if (use.use_vec[i].is_const || use.use_vec[i].var != old_var) continue;
+        use.use_vec[i] = new_val;
+        cnt++;
+    }
+    if (cnt == 0) return 0;
+    var_set_delete(&t->uses, old_var, stmt);
+    if (!new_val.is_const) var_set_insert(&t->uses, new_val.var, stmt);
+    return cnt;
+}
+
+void DefUseChain_set_def(DefUseChain *t, IR_stmt *stmt, IR_var new_var) {
+    IR_var def = VCALL(*stmt, get_def);
+    if (def == IR_VAR_NONE) return;
+    switch (stmt->stmt_type) {
+        case IR_OP_STMT: ((IR_op_stmt*)stmt)->rd = new_var; break;
+        case IR_ASSIGN_STMT: ((IR_assign_stmt*)stmt)->rd = new_var; break;
+        case IR_LOAD_STMT: ((IR_load_stmt*)stmt)->rd = new_var; break;
+        case IR_CALL_STMT: ((IR_call_stmt*)stmt)->rd = new_var; break;
+        case IR_READ_STMT: ((IR_read_stmt*)stmt)->rd = new_var; break;
+        default: return;
+    }
+    var_set_delete(&t->defs, def, stmt);
+    var_set_insert(&t->defs, new_var, stmt);
+}
+
+void DefUseChain_erase_stmt(DefUseChain *t, IR_stmt *stmt) {
+    IR_stmt_site *site = DefUseChain_site_of(t, stmt);
+    if (!site) return;
+    IR_block *blk = site->blk;
+    ListNode_IR_stmt_ptr *node = site->node;
+    unindex_stmt(t, stmt);
+    VCALL(blk->stmts, delete, node);
+    RDELETE(IR_stmt, stmt);
+}
+
+void DefUseChain_insert_after(DefUseChain *t, IR_stmt *pos, IR_stmt *stmt) {
+    IR_stmt_site *site = DefUseChain_site_of(t, pos);
+    if (!site) return;
+    IR_block *blk = site->blk;
+    VCALL(blk->stmts, insert_back, site->node, stmt);
+    index_stmt(t, blk, site->node->nxt);
+}
+
+void DefUseChain_insert_before(DefUseChain *t, IR_stmt *pos, IR_stmt *stmt) {
+    IR_stmt_site *site = DefUseChain_site_of(t, pos);
+    if (!site) return;
+    IR_block *blk = site->blk;
+    VCALL(blk->stmts, insert_front, site->node, stmt);
+    index_stmt(t, blk, site->node->pre);
+}
+
+void DefUseChain_push_back(DefUseChain *t, IR_block *blk, IR_stmt *stmt) {
+    VCALL(blk->stmts, push_back, stmt);
+    index_stmt(t, blk, blk->stmts.tail);
+}
+
+void DefUseChain_push_front(DefUseChain *t, IR_block *blk, IR_stmt *stmt) {
+    VCALL(blk->stmts, push_front, stmt);
+    index_stmt(t, blk, blk->stmts.head);
+}
+
+// 把 stmt 放到 blk 末尾的跳转或返回语句之前, 返回它所在的链表结点
+static ListNode_IR_stmt_ptr *insert_before_terminator(IR_block *blk, IR_stmt *stmt) {
+    ListNode_IR_stmt_ptr *tail = blk->stmts.tail;
+    IR_stmt_type tail_type = tail ? tail->val->stmt_type : IR_OP_STMT;
+    if (tail_type == IR_GOTO_STMT || tail_type == IR_IF_STMT || tail_type == IR_RETURN_STMT) {
+        VCALL(blk->stmts, insert_front, tail, stmt);
+        return tail->pre;
+    }
+    VCALL(blk->stmts, push_back, stmt);
+    return blk->stmts.tail;
+}
+
+void DefUseChain_append(DefUseChain *t, IR_block *blk, IR_stmt *stmt) {
+    index_stmt(t, blk, insert_before_terminator(blk, stmt));
+}
+
+void DefUseChain_move_to_end(DefUseChain *t, IR_stmt *stmt, IR_block *blk) {
+    IR_stmt_site *site = DefUseChain_site_of(t, stmt);
+    if (!site) return;
+    VCALL(site->blk->stmts, delete, site->node);
+    site->node = insert_before_terminator(blk, stmt);
+    site->blk = blk;
+}
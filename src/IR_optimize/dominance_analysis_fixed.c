@@ -11,23 +11,52 @@
 
 void DominanceInfo_init(DominanceInfo *info, IR_block_ptr block) {
     info->block = block;
-    Set_IR_block_ptr_init(&info->dominators);
+    info->rpo_index = -1;
+    info->linked_to_root = false;
     info->immediate_dominator = NULL;
     Set_IR_block_ptr_init(&info->dominated_blocks);
     List_IR_block_ptr_init(&info->children_in_dom_tree);
 }
 
 void DominanceInfo_teardown(DominanceInfo *info) {
-    Set_IR_block_ptr_teardown(&info->dominators);
     Set_IR_block_ptr_teardown(&info->dominated_blocks);
     List_IR_block_ptr_teardown(&info->children_in_dom_tree);
 }
 
+/**
+ * @brief 获取基本块支配信息在映射中的地址，便于原地修改
+ */
+static DominanceInfo *dom_info_of(DominanceAnalyzer *analyzer, IR_block_ptr block) {
+    MapNode_IR_block_ptr_DominanceInfo *node = (MapNode_IR_block_ptr_DominanceInfo*)
+            TreapNodeBase_find_iter(analyzer->dom_info.root,
+                                    TREAP_CONTENT_OFFSET(MapNode_IR_block_ptr_DominanceInfo),
+                                    MapNode_IR_block_ptr_DominanceInfo_cmp_func, &block);
+    return node ? &node->val : NULL;
+}
+
+static int rpo_index_of(DominanceAnalyzer *analyzer, IR_block_ptr block) {
+    DominanceInfo *info = dom_info_of(analyzer, block);
+    return info ? info->rpo_index : -1;
+}
+
 //// ================================== 支配节点分析器操作 ==================================
 
 void DominanceAnalyzer_init(DominanceAnalyzer *analyzer, IR_function *func) {
     analyzer->function = func;
+    analyzer->post_dominance = false;
     Map_IR_block_ptr_DominanceInfo_init(&analyzer->dom_info);
+    analyzer->block_cnt = 0;
+    analyzer->rpo_blocks = NULL;
+    analyzer->idom = NULL;
+    analyzer->dom_pre = NULL;
+    analyzer->dom_post = NULL;
+    analyzer->df_start = NULL;
+    analyzer->df = NULL;
+    analyzer->cd_start = NULL;
+    analyzer->cd = NULL;
+    analyzer->idf_stamp = NULL;
+    analyzer->idf_generation = 0;
+    analyzer->algorithm = DOMINANCE_ALGO_AUTO;
     
     // 找到入口基本块
     if (func->entry) {
@@ -51,224 +80,556 @@ void DominanceAnalyzer_init(DominanceAnalyzer *analyzer, IR_function *func) {
     }
 }
 
+void DominanceAnalyzer_init_post(DominanceAnalyzer *analyzer, IR_function *func) {
+    DominanceAnalyzer_init(analyzer, func);
+    if (!analyzer->entry_block) return;
+    analyzer->post_dominance = true;
+    analyzer->entry_block = func->exit;
+}
+
 void DominanceAnalyzer_teardown(DominanceAnalyzer *analyzer) {
     // 析构每个基本块的支配信息
     for_map(IR_block_ptr, DominanceInfo, i, analyzer->dom_info) {
         DominanceInfo_teardown(&i->val);
     }
     Map_IR_block_ptr_DominanceInfo_teardown(&analyzer->dom_info);
+    free(analyzer->rpo_blocks);
+    free(analyzer->idom);
+    free(analyzer->dom_pre);
+    free(analyzer->dom_post);
+    free(analyzer->df_start);
+    free(analyzer->df);
+    free(analyzer->cd_start);
+    free(analyzer->cd);
+    free(analyzer->idf_stamp);
 }
 
-//// ================================== 支配节点计算 - 修复版本 ==================================
+//// ================================== 深度优先编号与前驱索引 ==================================
 
 /**
- * @brief 简化的支配节点计算算法
- * 使用正确的数据流方程：Dom(n) = {n} ∪ (∩ Dom(p) for all predecessors p of n)
+ * @brief 支配节点计算所需的图表示，所有下标均为整数编号
  */
-void DominanceAnalyzer_compute_dominators(DominanceAnalyzer *analyzer) {
+typedef struct {
+    unsigned *pred_start;   // 块 b (RPO 编号) 的前驱为 pred_rpo[pred_start[b] .. pred_start[b+1])
+    int *pred_rpo;          // 前驱的 RPO 编号 (只保留可达前驱)
+    int *rpo_to_pre;        // RPO 编号 -> DFS 先序编号
+    int *pre_to_rpo;        // DFS 先序编号 -> RPO 编号
+    int *pre_parent;        // DFS 生成树中父节点的先序编号 (入口为 -1)
+} DominatorGraph;
+
+static void DominatorGraph_teardown(DominatorGraph *g) {
+    free(g->pred_start);
+    free(g->pred_rpo);
+    free(g->rpo_to_pre);
+    free(g->pre_to_rpo);
+    free(g->pre_parent);
+}
+
+// 正向分析沿后继走, 后支配分析在反向 CFG 上沿前驱走
+static Map_IR_block_ptr_List_ptr_IR_block_ptr *succ_map_of(DominanceAnalyzer *analyzer) {
+    return analyzer->post_dominance ? &analyzer->function->blk_pred : &analyzer->function->blk_succ;
+}
+
+static Map_IR_block_ptr_List_ptr_IR_block_ptr *pred_map_of(DominanceAnalyzer *analyzer) {
+    return analyzer->post_dominance ? &analyzer->function->blk_succ : &analyzer->function->blk_pred;
+}
+
+/**
+ * @brief 从根出发做非递归 DFS，求可达块的先序、生成树父节点与逆后序，并按逆后序编号
+ * 显式栈保存 (块, 先序编号, 下一个待访问后继) ，避免大函数上递归过深。
+ * 后支配分析时根为虚拟出口 (RPO 编号 0, 块指针为 NULL)，它的后继依次是函数出口，
+ * 以及每个无法到达出口的区域 (无限循环) 中取出的一个块，保证每个块都有后支配节点。
+ */
+static void compute_reverse_postorder(DominanceAnalyzer *analyzer, DominatorGraph *g) {
     IR_function *func = analyzer->function;
-    bool changed = true;
-    int iteration = 0;
-    const int MAX_ITERATIONS = 100; // 降低最大迭代次数进行测试
-    
-    // printf("Starting simplified dominance analysis for function: %s\n", func->func_name);
-    
-    // 步骤1：初始化支配集合
-    for_list(IR_block_ptr, i, func->blocks) {
-        DominanceInfo info = VCALL(analyzer->dom_info, get, i->val);
-        
-        if (i->val == analyzer->entry_block) {
-            // 入口节点只被自己支配
-            VCALL(info.dominators, insert, i->val);
-            // printf("Entry block %p: dominators = {self}\n", i->val);
-        } else {
-            // 其他节点初始化为被所有节点支配
-            for_list(IR_block_ptr, j, func->blocks) {
-                VCALL(info.dominators, insert, j->val);
+    Map_IR_block_ptr_List_ptr_IR_block_ptr *succ_map = succ_map_of(analyzer);
+    bool virtual_root = analyzer->post_dominance;
+    unsigned n = virtual_root ? 1 : 0;
+    for_list(IR_block_ptr, i, func->blocks) n++;
+
+    IR_block_ptr *postorder = (IR_block_ptr*)malloc(n * sizeof(IR_block_ptr));
+    int *post_pre = (int*)malloc(n * sizeof(int));
+    g->pre_parent = (int*)malloc(n * sizeof(int));
+    IR_block_ptr *stack_blk = (IR_block_ptr*)malloc(n * sizeof(IR_block_ptr));
+    int *stack_pre = (int*)malloc(n * sizeof(int));
+    ListNode_IR_block_ptr **stack_it = (ListNode_IR_block_ptr**)malloc(n * sizeof(ListNode_IR_block_ptr*));
+    unsigned post_cnt = 0, pre_cnt = 0, top = 0;
+
+    // rpo_index 暂作访问标记: -1 未访问, -2 已访问
+    for_map(IR_block_ptr, DominanceInfo, i, analyzer->dom_info) {
+        i->val.rpo_index = -1;
+        i->val.linked_to_root = false;
+    }
+    int root_pre = -1;
+    if (virtual_root) g->pre_parent[root_pre = (int)pre_cnt++] = -1;
+
+    ListNode_IR_block_ptr *unvisited_cursor = func->blocks.tail; // 从后向前寻找尚未访问的块
+    for (IR_block_ptr root = analyzer->entry_block; root != NULL; ) {
+        DominanceInfo *root_info = dom_info_of(analyzer, root);
+        root_info->rpo_index = -2;
+        root_info->linked_to_root = virtual_root;
+        g->pre_parent[pre_cnt] = root_pre;
+        stack_blk[top] = root;
+        stack_pre[top] = (int)pre_cnt++;
+        stack_it[top++] = VCALL(*succ_map, get, root)->head;
+        while (top > 0) {
+            ListNode_IR_block_ptr *it = stack_it[top - 1];
+            if (it == NULL) {
+                top--;
+                post_pre[post_cnt] = stack_pre[top];
+                postorder[post_cnt++] = stack_blk[top];
+                continue;
             }
-            // printf("Block %p: dominators = {all blocks}\n", i->val);
+            stack_it[top - 1] = it->nxt;
+            DominanceInfo *succ_info = dom_info_of(analyzer, it->val);
+            if (!succ_info || succ_info->rpo_index != -1) continue;
+            succ_info->rpo_index = -2;
+            g->pre_parent[pre_cnt] = stack_pre[top - 1];
+            stack_blk[top] = it->val;
+            stack_pre[top] = (int)pre_cnt++;
+            stack_it[top++] = VCALL(*succ_map, get, it->val)->head;
         }
-        
-        VCALL(analyzer->dom_info, set, i->val, info);
+        root = NULL;
+        if (!virtual_root) break;
+        for (; unvisited_cursor; unvisited_cursor = unvisited_cursor->pre)
+            if (rpo_index_of(analyzer, unvisited_cursor->val) == -1) {
+                root = unvisited_cursor->val;
+                break;
+            }
     }
-    
-    // 步骤2：迭代计算直到收敛
-    while (changed && iteration < MAX_ITERATIONS) {
+    if (virtual_root) {
+        post_pre[post_cnt] = root_pre;
+        postorder[post_cnt++] = NULL;
+    }
+
+    free(analyzer->rpo_blocks);
+    analyzer->block_cnt = post_cnt;
+    analyzer->rpo_blocks = (IR_block_ptr*)malloc(post_cnt * sizeof(IR_block_ptr));
+    g->rpo_to_pre = (int*)malloc(post_cnt * sizeof(int));
+    g->pre_to_rpo = (int*)malloc(post_cnt * sizeof(int));
+    for (unsigned k = 0; k < post_cnt; k++) {
+        IR_block_ptr blk = postorder[post_cnt - 1 - k];
+        analyzer->rpo_blocks[k] = blk;
+        if (blk) dom_info_of(analyzer, blk)->rpo_index = (int)k;
+        g->rpo_to_pre[k] = post_pre[post_cnt - 1 - k];
+        g->pre_to_rpo[g->rpo_to_pre[k]] = (int)k;
+    }
+    free(postorder);
+    free(post_pre);
+    free(stack_blk);
+    free(stack_pre);
+    free(stack_it);
+}
+
+/**
+ * @brief 按 RPO 编号建立前驱下标数组 (CSR 格式)，只保留可达的前驱
+ * 后支配分析中与虚拟出口相连的块额外以虚拟出口 (编号 0) 为前驱
+ */
+static void build_pred_index(DominanceAnalyzer *analyzer, DominatorGraph *g) {
+    Map_IR_block_ptr_List_ptr_IR_block_ptr *pred_map = pred_map_of(analyzer);
+    unsigned cnt = analyzer->block_cnt, edge_cnt = 0;
+    g->pred_start = (unsigned*)malloc((cnt + 1) * sizeof(unsigned));
+    for (unsigned b = 0; b < cnt; b++) {
+        if (analyzer->rpo_blocks[b] == NULL) continue;
+        edge_cnt++;
+        for_list(IR_block_ptr, p, *VCALL(*pred_map, get, analyzer->rpo_blocks[b]))
+            edge_cnt++;
+    }
+    g->pred_rpo = (int*)malloc((edge_cnt ? edge_cnt : 1) * sizeof(int));
+    unsigned k = 0;
+    for (unsigned b = 0; b < cnt; b++) {
+        g->pred_start[b] = k;
+        IR_block_ptr blk = analyzer->rpo_blocks[b];
+        if (blk == NULL) continue;
+        if (dom_info_of(analyzer, blk)->linked_to_root) g->pred_rpo[k++] = 0;
+        for_list(IR_block_ptr, p, *VCALL(*pred_map, get, blk)) {
+            int q = rpo_index_of(analyzer, p->val);
+            if (q >= 0) g->pred_rpo[k++] = q;
+        }
+    }
+    g->pred_start[cnt] = k;
+}
+
+static void build_dominator_graph(DominanceAnalyzer *analyzer, DominatorGraph *g) {
+    compute_reverse_postorder(analyzer, g);
+    build_pred_index(analyzer, g);
+}
+
+//// ================================== 迭代算法 (Cooper-Harvey-Kennedy) ==================================
+
+/**
+ * @brief 双指针求交：沿 idom 链上移编号较大的一方，直到两者相遇
+ */
+static int intersect(const int *idom, int a, int b) {
+    while (a != b) {
+        while (a > b) a = idom[a];
+        while (b > a) b = idom[b];
+    }
+    return a;
+}
+
+/**
+ * @brief 计算直接支配节点数组
+ * idom[b] = 所有已处理前驱的 idom 链的最近公共祖先，按 RPO 迭代至不动点
+ * （无环图一轮即收敛，一般 CFG 通常只需两三轮）
+ */
+static void compute_idom_iterative(DominanceAnalyzer *analyzer, DominatorGraph *g, int *idom) {
+    unsigned cnt = analyzer->block_cnt;
+    for (unsigned b = 0; b < cnt; b++) idom[b] = -1;
+    idom[0] = 0;
+
+    bool changed = true;
+    while (changed) {
         changed = false;
-        iteration++;
-        // printf("\n=== Iteration %d ===\n", iteration);
-        
-        for_list(IR_block_ptr, i, func->blocks) {
-            if (i->val == analyzer->entry_block) {
-                continue; // 跳过入口节点
-            }
-            
-            // printf("Processing block %p:\n", i->val);
-            
-            DominanceInfo current_info = VCALL(analyzer->dom_info, get, i->val);
-            
-            // 创建新的支配集合，开始时只包含节点本身
-            Set_IR_block_ptr new_dominators;
-            Set_IR_block_ptr_init(&new_dominators);
-            VCALL(new_dominators, insert, i->val);
-            // printf("INSERTED:%p", i->val);
-            
-            // 获取前驱节点
-            List_IR_block_ptr *predecessors = VCALL(func->blk_pred, get, i->val);
-            
-            if (predecessors && predecessors->head) {
-                // printf("  Has predecessors, computing intersection...\n");
-                
-                // 初始化交集为第一个前驱的支配集合
-                bool first_pred = true;
-                for_list(IR_block_ptr, pred, *predecessors) {
-                    DominanceInfo pred_info = VCALL(analyzer->dom_info, get, pred->val);
-                    
-                    if (first_pred) {
-                        // 第一个前驱：复制其支配集合
-                        for_set(IR_block_ptr, dom_block, pred_info.dominators) {
-                            VCALL(new_dominators, insert, dom_block->key);
-                            // printf("INSERTED:%p\n", dom_block->key);
-                        }
-                        first_pred = false;
-                        // printf("    Initialized with pred %p dominators\n", pred->val);
-                    } else {
-                        // 后续前驱：计算交集
-                        Set_IR_block_ptr intersection;
-                        Set_IR_block_ptr_init(&intersection);
-                        
-                        for_set(IR_block_ptr, dom_block, new_dominators) {
-                            if (VCALL(pred_info.dominators, exist, dom_block->key)) {
-                                VCALL(intersection, insert, dom_block->key);
-                            }
-                        }
-                        
-                        Set_IR_block_ptr_teardown(&new_dominators);
-                        new_dominators = intersection;
-                        // printf("    Intersected with pred %p dominators\n", pred->val);
-                    }
-                }
-                
-                // 确保包含节点本身
-                VCALL(new_dominators, insert, i->val);
-            } else {
-                // printf("  No predecessors found\n");
-            }
-            
-            // 检查是否有变化
-            bool sets_equal = true;
-            
-            // 计算两个集合的大小（手动计数）
-            int old_count = 0, new_count = 0;
-            for_set(IR_block_ptr, block, current_info.dominators) { old_count++; }
-            for_set(IR_block_ptr, block, new_dominators) { new_count++; }
-            
-            if (old_count != new_count) {
-                sets_equal = false;
-            } else {
-                // 大小相等，检查内容
-                for_set(IR_block_ptr, block, new_dominators) {
-                    if(!VCALL(current_info.dominators, exist, block->key)){
-                        sets_equal = false;
-                        break;
-                    }                
-                }
+        for (unsigned b = 1; b < cnt; b++) {
+            int new_idom = -1;
+            for (unsigned k = g->pred_start[b]; k < g->pred_start[b + 1]; k++) {
+                int p = g->pred_rpo[k];
+                if (idom[p] < 0) continue; // 前驱尚未处理
+                new_idom = new_idom < 0 ? p : intersect(idom, p, new_idom);
             }
-            
-            if (!sets_equal) {
+            if (idom[b] != new_idom) {
+                idom[b] = new_idom;
                 changed = true;
-                // printf("  Dominance set changed (old_size=%d, new_size=%d)\n", old_count, new_count);
-                
-                // 更新支配集合
-                Set_IR_block_ptr_teardown(&current_info.dominators);
-                current_info.dominators = new_dominators;
-                VCALL(analyzer->dom_info, set, i->val, current_info);
-            } else {
-                // printf("  Dominance set unchanged (size=%d)\n", old_count);
-                Set_IR_block_ptr_teardown(&new_dominators);
             }
         }
-        // 打印每次迭代后的支配集合
-        // printf("当前各基本块的支配集合：\n");
-        // for_list(IR_block_ptr, blk, func->blocks) {
-        //     DominanceInfo info = VCALL(analyzer->dom_info, get, blk->val);
-        //     printf("  Block %p [L%u] in SET: { ", blk->val, blk->val->label);
-        //     for_set(IR_block_ptr, dom, info.dominators) {
-        //         printf("%p ", dom->key);
-        //     }
-        //     printf("}\n");
-        // }
     }
-    
-    // printf("\nDominance analysis completed after %d iterations\n", iteration);
-    // if (iteration >= MAX_ITERATIONS) {
-    //     printf("WARNING: Reached maximum iterations - may not have converged\n");
-    // }
 }
 
-// ================================== 支配关系查询接口 ==================================
+//// ================================== 半支配点算法 (Semi-NCA) ==================================
 
+/**
+ * @brief Lengauer-Tarjan 的 EVAL 操作 (带路径压缩)
+ * 返回 v 到其所在森林树根 (不含根) 路径上半支配点最小的节点。
+ * 路径压缩用显式栈完成，避免深链上的递归。
+ */
+static int semi_nca_eval(int v, int *ancestor, int *label, const int *semi, int *stack) {
+    if (ancestor[v] < 0) return v;
+    int top = 0, x = v;
+    while (ancestor[ancestor[x]] >= 0) {
+        stack[top++] = x;
+        x = ancestor[x];
+    }
+    while (top > 0) {
+        int y = stack[--top], a = ancestor[y];
+        if (semi[label[a]] < semi[label[y]]) label[y] = label[a];
+        ancestor[y] = ancestor[a];
+    }
+    return label[v];
+}
 
 /**
- * @brief 找到最接近的支配节点（直接支配节点）
- * 直接支配节点是支配集合中除了节点本身外，不被其他支配节点支配的节点
+ * @brief 用 Semi-NCA 算法计算直接支配节点数组
+ * 1. 按 DFS 先序逆序，以 Lengauer-Tarjan 的 link/eval 求每个块的半支配点 semi；
+ * 2. 按先序顺序，idom[w] 为 DFS 父节点沿 idom 链上移到编号不大于 semi[w] 的祖先。
+ * 时间复杂度 O(m log n)，与 CFG 的形状无关，不需要多轮迭代。
  */
-static IR_block_ptr find_immediate_dominator(DominanceAnalyzer *analyzer, IR_block_ptr block) {
-    if (block == analyzer->entry_block) {
-        return NULL; // 入口节点没有直接支配节点
+static void compute_idom_semi_nca(DominanceAnalyzer *analyzer, DominatorGraph *g, int *idom) {
+    unsigned cnt = analyzer->block_cnt;
+    int *semi = (int*)malloc(cnt * sizeof(int));
+    int *label = (int*)malloc(cnt * sizeof(int));
+    int *ancestor = (int*)malloc(cnt * sizeof(int));
+    int *idom_pre = (int*)malloc(cnt * sizeof(int));
+    int *stack = (int*)malloc(cnt * sizeof(int));
+    for (unsigned w = 0; w < cnt; w++) {
+        semi[w] = label[w] = (int)w;
+        ancestor[w] = -1;
     }
-    
-    DominanceInfo info = VCALL(analyzer->dom_info, get, block);
-    IR_block_ptr immediate_dom = NULL;
-    
-    // 在支配集合中找到直接支配节点
-    for_set(IR_block_ptr, dom_block, info.dominators) {
-        if (dom_block->key == block) {
-            continue; // 跳过节点本身
+    for (int w = (int)cnt - 1; w > 0; w--) {
+        int b = g->pre_to_rpo[w];
+        for (unsigned k = g->pred_start[b]; k < g->pred_start[b + 1]; k++) {
+            int u = semi_nca_eval(g->rpo_to_pre[g->pred_rpo[k]], ancestor, label, semi, stack);
+            if (semi[u] < semi[w]) semi[w] = semi[u];
         }
-        
-        // 检查这个支配节点是否是直接支配节点
-        bool is_immediate = true;
-        for_set(IR_block_ptr, other_dom, info.dominators) {
-            if (other_dom->key == block || other_dom->key == dom_block->key) {
-                continue;
-            }
-            
-            // 如果存在另一个支配节点支配当前候选节点，那么当前候选节点不是直接支配节点
-            DominanceInfo other_info = VCALL(analyzer->dom_info, get, other_dom->key);
-            if (VCALL(other_info.dominators, exist, dom_block->key)) {
-                is_immediate = false;
-                break;
-            }
+        ancestor[w] = g->pre_parent[w]; // LINK(parent[w], w)
+    }
+    idom_pre[0] = 0;
+    for (unsigned w = 1; w < cnt; w++) {
+        int d = g->pre_parent[w];
+        while (d > semi[w]) d = idom_pre[d];
+        idom_pre[w] = d;
+    }
+    for (unsigned w = 0; w < cnt; w++)
+        idom[g->pre_to_rpo[w]] = g->pre_to_rpo[idom_pre[w]];
+    free(semi);
+    free(label);
+    free(ancestor);
+    free(idom_pre);
+    free(stack);
+}
+
+//// ================================== 支配树区间编号 ==================================
+
+/**
+ * @brief 对支配树做非递归 DFS，为每个块记录进入与离开时的序号
+ * a 支配 b 当且仅当 b 的区间 [dom_pre, dom_post] 嵌套在 a 的区间之内
+ */
+static void number_dominator_tree(DominanceAnalyzer *analyzer) {
+    unsigned cnt = analyzer->block_cnt;
+    const int *idom = analyzer->idom;
+    // 以 CSR 格式建立孩子表: 块 b 的孩子为 child[child_start[b] .. child_start[b+1])
+    unsigned *child_start = (unsigned*)calloc(cnt + 1, sizeof(unsigned));
+    int *child = (int*)malloc((cnt ? cnt : 1) * sizeof(int));
+    for (unsigned b = 1; b < cnt; b++) child_start[idom[b] + 1]++;
+    for (unsigned b = 0; b < cnt; b++) child_start[b + 1] += child_start[b];
+    unsigned *fill = (unsigned*)malloc((cnt ? cnt : 1) * sizeof(unsigned));
+    for (unsigned b = 0; b < cnt; b++) fill[b] = child_start[b];
+    for (unsigned b = 1; b < cnt; b++) child[fill[idom[b]]++] = (int)b;
+
+    free(analyzer->dom_pre);
+    free(analyzer->dom_post);
+    analyzer->dom_pre = (unsigned*)malloc((cnt ? cnt : 1) * sizeof(unsigned));
+    analyzer->dom_post = (unsigned*)malloc((cnt ? cnt : 1) * sizeof(unsigned));
+    // 复用 fill 作为每个栈上节点下一个待访问孩子的位置
+    int *stack = (int*)malloc((cnt ? cnt : 1) * sizeof(int));
+    unsigned top = 0, clock = 0;
+    for (unsigned b = 0; b < cnt; b++) fill[b] = child_start[b];
+    if (cnt > 0) {
+        analyzer->dom_pre[0] = clock++;
+        stack[top++] = 0;
+    }
+    while (top > 0) {
+        int b = stack[top - 1];
+        if (fill[b] == child_start[b + 1]) {
+            analyzer->dom_post[b] = clock++;
+            top--;
+            continue;
         }
-        
-        if (is_immediate) {
-            immediate_dom = dom_block->key;
-            break;
+        int c = child[fill[b]++];
+        analyzer->dom_pre[c] = clock++;
+        stack[top++] = c;
+    }
+    free(child_start);
+    free(child);
+    free(fill);
+    free(stack);
+}
+
+//// ================================== 支配节点计算 ==================================
+
+void DominanceAnalyzer_compute_dominators(DominanceAnalyzer *analyzer) {
+    if (!analyzer->entry_block) return;
+    DominatorGraph g;
+    build_dominator_graph(analyzer, &g);
+
+    unsigned cnt = analyzer->block_cnt;
+    free(analyzer->idom);
+    analyzer->idom = (int*)malloc(cnt * sizeof(int));
+    DominanceAlgorithm algorithm = analyzer->algorithm;
+    if (algorithm == DOMINANCE_ALGO_AUTO)
+        algorithm = cnt >= DOMINANCE_SEMI_NCA_THRESHOLD ? DOMINANCE_ALGO_SEMI_NCA : DOMINANCE_ALGO_ITERATIVE;
+    if (algorithm == DOMINANCE_ALGO_SEMI_NCA)
+        compute_idom_semi_nca(analyzer, &g, analyzer->idom);
+    else
+        compute_idom_iterative(analyzer, &g, analyzer->idom);
+    DominatorGraph_teardown(&g);
+
+    for (unsigned b = 0; b < cnt; b++)
+        if (analyzer->rpo_blocks[b])
+            dom_info_of(analyzer, analyzer->rpo_blocks[b])->immediate_dominator =
+                    b == 0 ? NULL : analyzer->rpo_blocks[analyzer->idom[b]];
+    number_dominator_tree(analyzer);
+#ifdef DEBUG
+    assert(DominanceAnalyzer_verify(analyzer));
+#endif
+}
+
+bool DominanceAnalyzer_verify(DominanceAnalyzer *analyzer) {
+    if (!analyzer->entry_block || !analyzer->idom) return true;
+    DominatorGraph g;
+    build_dominator_graph(analyzer, &g); // DFS 顺序确定, 编号与计算时一致
+    unsigned cnt = analyzer->block_cnt;
+    int *iterative = (int*)malloc(cnt * sizeof(int));
+    int *semi_nca = (int*)malloc(cnt * sizeof(int));
+    compute_idom_iterative(analyzer, &g, iterative);
+    compute_idom_semi_nca(analyzer, &g, semi_nca);
+    bool ok = true;
+    for (unsigned b = 0; b < cnt && ok; b++) {
+        if (iterative[b] != semi_nca[b] || iterative[b] != analyzer->idom[b]) {
+            fprintf(stderr, "dominance mismatch in %s at #%u: iterative #%d, semi-NCA #%d, stored #%d\n",
+                    analyzer->function->func_name, b, iterative[b], semi_nca[b], analyzer->idom[b]);
+            ok = false;
         }
     }
-    
-    return immediate_dom;
+    free(iterative);
+    free(semi_nca);
+    DominatorGraph_teardown(&g);
+    return ok;
 }
 
+//// ================================== 支配树构建 ==================================
+
 void DominanceAnalyzer_build_dominator_tree(DominanceAnalyzer *analyzer) {
-    IR_function *func = analyzer->function;
-    
-    // 为每个节点找到直接支配节点
-    for_list(IR_block_ptr, i, func->blocks) {
-        DominanceInfo info = VCALL(analyzer->dom_info, get, i->val);
-        info.immediate_dominator = find_immediate_dominator(analyzer, i->val);
-        
-        // 如果有直接支配节点，建立父子关系
-        if (info.immediate_dominator) {
-            DominanceInfo parent_info = VCALL(analyzer->dom_info, get, info.immediate_dominator);
-            VCALL(parent_info.children_in_dom_tree, push_back, i->val);
-            VCALL(parent_info.dominated_blocks, insert, i->val);
-            VCALL(analyzer->dom_info, set, info.immediate_dominator, parent_info);
+    // 清空旧的支配树, 允许重复调用
+    for_map(IR_block_ptr, DominanceInfo, i, analyzer->dom_info) {
+        DominanceInfo_teardown(&i->val);
+        Set_IR_block_ptr_init(&i->val.dominated_blocks);
+        List_IR_block_ptr_init(&i->val.children_in_dom_tree);
+    }
+    // 按 RPO 顺序挂到直接支配节点之下, 使子节点顺序确定
+    for (unsigned b = 1; b < analyzer->block_cnt; b++) {
+        IR_block_ptr block = analyzer->rpo_blocks[b], parent = analyzer->rpo_blocks[analyzer->idom[b]];
+        if (parent == NULL) continue; // 后支配树中虚拟出口的孩子
+        DominanceInfo *parent_info = dom_info_of(analyzer, parent);
+        VCALL(parent_info->children_in_dom_tree, push_back, block);
+        VCALL(parent_info->dominated_blocks, insert, block);
+    }
+}
+
+//// ================================== 支配边界 ==================================
+
+static int cmp_int(const void *a, const void *b) {
+    int x = *(const int*)a, y = *(const int*)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief 用汇合点方法计算支配边界 (Cytron et al. / Cooper-Harvey-Kennedy)
+ * 对每个至少有两个可达前驱的块 b，从每个前驱沿 idom 链上行到 idom[b] 为止，
+ * 途经的每个块的支配边界都包含 b。结果以 RPO 编号存成 CSR 数组，每块的边界按编号升序。
+ */
+void DominanceAnalyzer_compute_frontiers(DominanceAnalyzer *analyzer) {
+    if (!analyzer->entry_block || !analyzer->idom) return;
+    unsigned cnt = analyzer->block_cnt;
+    const int *idom = analyzer->idom;
+    DominatorGraph g = {0};
+    build_pred_index(analyzer, &g);
+
+    // 先收集 (runner, b) 对, 再按 runner 计数排序; b 递增处理, 故每块的边界自然有序
+    unsigned pair_cap = cnt ? cnt : 1, pair_cnt = 0;
+    int *pair_runner = (int*)malloc(pair_cap * sizeof(int));
+    int *pair_join = (int*)malloc(pair_cap * sizeof(int));
+    int *last_join = (int*)malloc((cnt ? cnt : 1) * sizeof(int)); // 去重: 上一次加入 runner 边界的块
+    for (unsigned b = 0; b < cnt; b++) last_join[b] = -1;
+    for (unsigned b = 0; b < cnt; b++) {
+        // 入口块有前驱时, 与函数入口的虚拟边一起构成汇合点; 它没有 idom, 需一直上行到根
+        unsigned pred_cnt = g.pred_start[b + 1] - g.pred_start[b];
+        if (pred_cnt < (b == 0 ? 1 : 2)) continue;
+        int stop = b == 0 ? -1 : idom[b];
+        for (unsigned k = g.pred_start[b]; k < g.pred_start[b + 1]; k++) {
+            for (int runner = g.pred_rpo[k]; runner != stop && last_join[runner] != (int)b;
+                 runner = runner == 0 ? -1 : idom[runner]) {
+                last_join[runner] = (int)b;
+                if (pair_cnt == pair_cap) {
+                    pair_cap *= 2;
+                    pair_runner = (int*)realloc(pair_runner, pair_cap * sizeof(int));
+                    pair_join = (int*)realloc(pair_join, pair_cap * sizeof(int));
+                }
+                pair_runner[pair_cnt] = runner;
+                pair_join[pair_cnt++] = (int)b;
+            }
         }
-        
-        VCALL(analyzer->dom_info, set, i->val, info);
     }
+
+    free(analyzer->df_start);
+    free(analyzer->df);
+    analyzer->df_start = (unsigned*)calloc(cnt + 1, sizeof(unsigned));
+    analyzer->df = (int*)malloc((pair_cnt ? pair_cnt : 1) * sizeof(int));
+    for (unsigned k = 0; k < pair_cnt; k++) analyzer->df_start[pair_runner[k] + 1]++;
+    for (unsigned b = 0; b < cnt; b++) analyzer->df_start[b + 1] += analyzer->df_start[b];
+    for (unsigned b = 0; b < cnt; b++) last_join[b] = (int)analyzer->df_start[b]; // 复用为填充位置
+    for (unsigned k = 0; k < pair_cnt; k++) analyzer->df[last_join[pair_runner[k]]++] = pair_join[k];
+
+    free(analyzer->idf_stamp);
+    analyzer->idf_stamp = (unsigned*)calloc(cnt ? cnt : 1, sizeof(unsigned));
+    analyzer->idf_generation = 0;
+    free(pair_runner);
+    free(pair_join);
+    free(last_join);
+    DominatorGraph_teardown(&g);
+}
+
+void DominanceAnalyzer_get_frontier(DominanceAnalyzer *analyzer, IR_block_ptr block, List_IR_block_ptr *out) {
+    int b = rpo_index_of(analyzer, block);
+    if (b < 0 || !analyzer->df_start) return;
+    for (unsigned k = analyzer->df_start[b]; k < analyzer->df_start[b + 1]; k++)
+        if (analyzer->rpo_blocks[analyzer->df[k]]) // 跳过虚拟出口
+            VCALL(*out, push_back, analyzer->rpo_blocks[analyzer->df[k]]);
+}
+
+/**
+ * @brief 迭代支配边界 DF+(S)
+ * 以 S 为初始工作表，不断把工作表中块的支配边界加入结果，新加入的块再入表，直到不动点。
+ * 用按查询递增的时间戳标记已入结果/已入表的块，避免每次查询清空 O(N) 的数组。
+ */
+void DominanceAnalyzer_iterated_frontier(DominanceAnalyzer *analyzer, Set_IR_block_ptr *def_blocks,
+                                         List_IR_block_ptr *out) {
+    if (!analyzer->df_start) return;
+    unsigned cnt = analyzer->block_cnt;
+    // 每次查询占用两个时间戳: 基数表示已入工作表, 基数+1 表示已入结果 (已入结果必已入工作表)
+    if (analyzer->idf_generation >= (unsigned)-3) {
+        for (unsigned b = 0; b < cnt; b++) analyzer->idf_stamp[b] = 0;
+        analyzer->idf_generation = 0;
+    }
+    unsigned queued = analyzer->idf_generation += 2, in_result = queued + 1;
+    unsigned *stamp = analyzer->idf_stamp;
+
+    int *worklist = (int*)malloc((cnt ? cnt : 1) * sizeof(int));
+    int *result = (int*)malloc((cnt ? cnt : 1) * sizeof(int));
+    unsigned top = 0, result_cnt = 0;
+    for_set(IR_block_ptr, i, *def_blocks) {
+        int b = rpo_index_of(analyzer, i->key);
+        if (b < 0 || stamp[b] >= queued) continue;
+        stamp[b] = queued;
+        worklist[top++] = b;
+    }
+    while (top > 0) {
+        int x = worklist[--top];
+        for (unsigned k = analyzer->df_start[x]; k < analyzer->df_start[x + 1]; k++) {
+            int y = analyzer->df[k];
+            if (stamp[y] == in_result) continue;
+            bool was_queued = stamp[y] == queued;
+            stamp[y] = in_result;
+            result[result_cnt++] = y;
+            if (!was_queued) worklist[top++] = y;
+        }
+    }
+    qsort(result, result_cnt, sizeof(int), cmp_int); // 按 RPO 顺序输出, 结果与指针地址无关
+    for (unsigned k = 0; k < result_cnt; k++)
+        if (analyzer->rpo_blocks[result[k]])
+            VCALL(*out, push_back, analyzer->rpo_blocks[result[k]]);
+    free(worklist);
+    free(result);
+}
+
+//// ================================== 控制依赖图 ==================================
+
+/**
+ * @brief 由后支配边界构建控制依赖图
+ * Y 控制依赖于 X 当且仅当 X 属于 Y 的后支配边界 PDF(Y)：X 的某个分支必然到达 Y，另一个分支可能绕过 Y。
+ * PDF 即控制 Y 的块；这里再把它反转成 X -> 依赖于 X 的块，同样以 CSR 数组保存。
+ */
+void DominanceAnalyzer_compute_control_dependence(DominanceAnalyzer *analyzer) {
+    assert(analyzer->post_dominance);
+    if (!analyzer->idom) return;
+    if (!analyzer->df_start) DominanceAnalyzer_compute_frontiers(analyzer);
+    unsigned cnt = analyzer->block_cnt, edge_cnt = analyzer->df_start[cnt];
+    free(analyzer->cd_start);
+    free(analyzer->cd);
+    analyzer->cd_start = (unsigned*)calloc(cnt + 1, sizeof(unsigned));
+    analyzer->cd = (int*)malloc((edge_cnt ? edge_cnt : 1) * sizeof(int));
+    for (unsigned k = 0; k < edge_cnt; k++) analyzer->cd_start[analyzer->df[k] + 1]++;
+    for (unsigned b = 0; b < cnt; b++) analyzer->cd_start[b + 1] += analyzer->cd_start[b];
+    unsigned *fill = (unsigned*)malloc((cnt ? cnt : 1) * sizeof(unsigned));
+    for (unsigned b = 0; b < cnt; b++) fill[b] = analyzer->cd_start[b];
+    // 按 Y 递增遍历, 故每个 X 的依赖块按 RPO 编号有序
+    for (unsigned y = 0; y < cnt; y++)
+        for (unsigned k = analyzer->df_start[y]; k < analyzer->df_start[y + 1]; k++)
+            analyzer->cd[fill[analyzer->df[k]]++] = (int)y;
+    free(fill);
+}
+
+void DominanceAnalyzer_get_controlling_blocks(DominanceAnalyzer *analyzer, IR_block_ptr block,
+                                              List_IR_block_ptr *out) {
+    DominanceAnalyzer_get_frontier(analyzer, block, out);
+}
+
+void DominanceAnalyzer_get_dependent_blocks(DominanceAnalyzer *analyzer, IR_block_ptr block,
+                                            List_IR_block_ptr *out) {
+    int x = rpo_index_of(analyzer, block);
+    if (x < 0 || !analyzer->cd_start) return;
+    for (unsigned k = analyzer->cd_start[x]; k < analyzer->cd_start[x + 1]; k++)
+        VCALL(*out, push_back, analyzer->rpo_blocks[analyzer->cd[k]]);
 }
 
 //// ================================== 查询接口 ==================================
@@ -276,32 +637,37 @@ void DominanceAnalyzer_build_dominator_tree(DominanceAnalyzer *analyzer) {
 bool DominanceAnalyzer_dominates(DominanceAnalyzer *analyzer, 
                                  IR_block_ptr dominator, 
                                  IR_block_ptr dominated) {
-    DominanceInfo info = VCALL(analyzer->dom_info, get, dominated);
-    return VCALL(info.dominators, exist, dominator);
+    if (dominator == dominated) return true;
+    int a = rpo_index_of(analyzer, dominator), b = rpo_index_of(analyzer, dominated);
+    if (a < 0 || b < 0) return false;
+    return analyzer->dom_pre[a] <= analyzer->dom_pre[b] && analyzer->dom_post[b] <= analyzer->dom_post[a];
 }
 
 IR_block_ptr DominanceAnalyzer_get_immediate_dominator(DominanceAnalyzer *analyzer, 
                                                        IR_block_ptr block) {
-    DominanceInfo info = VCALL(analyzer->dom_info, get, block);
-    return info.immediate_dominator;
+    DominanceInfo *info = dom_info_of(analyzer, block);
+    return info ? info->immediate_dominator : NULL;
 }
 
-Set_IR_block_ptr* DominanceAnalyzer_get_dominators(DominanceAnalyzer *analyzer, 
-                                                   IR_block_ptr block) {
-    // Note: This function returns a pointer to the internal set, which is problematic
-    // with the current Map API. For now, we'll have to work around this limitation.
-    // A better approach would be to copy the set or use a different API design.
-    static DominanceInfo temp_info;
-    temp_info = VCALL(analyzer->dom_info, get, block);
-    return &temp_info.dominators;
+DominatorIterator DominanceAnalyzer_dominators_begin(DominanceAnalyzer *analyzer, IR_block_ptr block) {
+    return (DominatorIterator){.analyzer = analyzer, .block = block, .rpo_index = rpo_index_of(analyzer, block)};
+}
+
+IR_block_ptr DominatorIterator_next(DominatorIterator *it) {
+    IR_block_ptr block = it->block;
+    if (block == NULL) return NULL;
+    if (it->rpo_index <= 0) { // 到达入口或不可达块
+        it->block = NULL;
+    } else {
+        it->rpo_index = it->analyzer->idom[it->rpo_index];
+        it->block = it->analyzer->rpo_blocks[it->rpo_index];
+    }
+    return block;
 }
 
 Set_IR_block_ptr* DominanceAnalyzer_get_dominated_blocks(DominanceAnalyzer *analyzer, 
                                                         IR_block_ptr block) {
-    // Same issue as above - returning pointer to internal data
-    static DominanceInfo temp_info;
-    temp_info = VCALL(analyzer->dom_info, get, block);
-    return &temp_info.dominated_blocks;
+    return &dom_info_of(analyzer, block)->dominated_blocks;
 }
 
 //// ================================== 结果输出 ==================================
@@ -325,11 +691,11 @@ void DominanceAnalyzer_print_result(DominanceAnalyzer *analyzer, FILE *out) {
         }
         fprintf(out, ":\n");
         
-        // 打印支配集合（只显示label）
+        // 打印支配节点（沿直接支配节点链, 只显示label）
         fprintf(out, "  支配节点: { ");
-        for_set(IR_block_ptr, dom, info.dominators) {
-            fprintf(out, "L%u ", dom->key->label);
-        }
+        DominatorIterator it = DominanceAnalyzer_dominators_begin(analyzer, i->val);
+        for (IR_block_ptr dom; (dom = DominatorIterator_next(&it)) != NULL; )
+            fprintf(out, "L%u ", dom->label);
         fprintf(out, "}\n");
         
         // 打印直接支配节点
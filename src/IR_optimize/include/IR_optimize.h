@@ -5,6 +5,13 @@
 #ifndef CODE_IR_OPTIMIZE_H
 #define CODE_IR_OPTIMIZE_H
 
+#include <IR.h>
+
 extern void IR_optimize();
 
+/**
+ * @brief 将 t := a op b; x := t (t 在整个函数中只有这一次使用) 合并为 x := a op b
+ */
+extern void eliminate_single_use_temps(IR_function *func);
+
 #endif //CODE_IR_OPTIMIZE_H
@@ -0,0 +1,47 @@
+//
+// Created by Assistant
+// 乘除常量降级 (Arithmetic Lowering)
+//
+
+#ifndef CODE_ARITH_LOWERING_H
+#define CODE_ARITH_LOWERING_H
+
+#include <IR.h>
+
+//// ================================== 代价模型 ==================================
+
+#define LOWERING_COST_ALU 1         // 加减、移位与按位运算
+#define LOWERING_COST_MUL 3         // 乘法
+#define LOWERING_COST_DIV 20        // 除法与取模
+
+/**
+ * @brief 一条二元运算语句的代价。
+ * @param op 操作类型。
+ * @return 代价模型中的代价。
+ */
+extern unsigned ArithLowering_op_cost(IR_OP_TYPE op);
+
+//// ================================== 降级 ==================================
+
+/**
+ * @brief 代价更低时把乘除常量的语句改写为移位与加减的序列。
+ * 乘常量按常量的非相邻形式 (NAF) 展开为若干项 x << s 的和差；
+ * 除以与对 ±2^k 取模先把负的被除数加上 2^k - 1 使结果向零取整，再算术右移或按位与。
+ * 除以与对其他常量取模用魔数乘法取高位 (IR_OP_MULH) 后算术右移并修正负的商，取模再减去商与除数之积。
+ * 新语句插入在原语句之前并使用新的临时变量，最后一条定义原语句的目标变量，原语句被删除。
+ * @param blk 语句所在的块。
+ * @param node 要改写的语句所在的链表节点。
+ * @return 语句是否被改写（改写后 node 失效）。
+ */
+extern bool ArithLowering_lower_stmt(IR_block *blk, ListNode_IR_stmt_ptr *node);
+
+//// ================================== 高层接口 ==================================
+
+/**
+ * @brief 改写函数中所有值得降级的乘除常量语句，只应在输出方言支持扩展运算 (IR_OUT_EXTENDED_OPS) 时调用。
+ * @param func 要优化的函数。
+ * @return 函数是否被修改。
+ */
+extern bool perform_arith_lowering(IR_function *func);
+
+#endif //CODE_ARITH_LOWERING_H
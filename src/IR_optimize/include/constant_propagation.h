@@ -205,6 +205,7 @@ extern void ConstantPropagation_print_result (ConstantPropagation *t, IR_functio
  * @brief 根据常量传播分析的结果，执行常量折叠 (Constant Folding) 优化。
  * 将表达式中的常量操作数替换为其值，并预计算结果。
  * 将变量的use替换为已知的常量值。
+ * 条件变为常量的 IF 改为无条件跳转（或顺序执行），之后删除不可达的块并重建CFG。
  * @param t 指向 ConstantPropagation 实例的指针 (应已包含分析结果)。
  * @param func 指向要优化的 IR_function 的指针。
  */
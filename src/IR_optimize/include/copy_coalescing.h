@@ -0,0 +1,60 @@
+//
+// Created by Assistant
+// 复制合并 (Copy Coalescing)
+//
+
+#ifndef CODE_COPY_COALESCING_H
+#define CODE_COPY_COALESCING_H
+
+#include <dataflow_analysis.h>
+#include <var_map.h>
+#include <live_variable_analysis.h>
+
+// 定义从代表变量到其冲突代表变量集合的映射 (Map_IR_var_Set_ptr_IR_var)
+DEF_MAP(IR_var, Set_ptr_IR_var)
+
+/**
+ * @brief 复制合并的状态。
+ * 对每条复制语句 x := y，若 x 与 y 所在的等价类活跃范围互不冲突，
+ * 则用并查集将两者合并为同一个变量，随后统一重写所有定义与使用并删除复制语句。
+ * 冲突关系由活跃变量分析得到：语句定义 d 时，d 与此处所有其他活跃变量冲突
+ * （复制语句 d := s 中的 s 除外，二者此时值相同）。
+ */
+typedef struct CopyCoalescing {
+    IR_function *func;                       // 当前处理的函数
+    Map_IR_var_IR_var parent;                // 并查集父指针，不在表中的变量自成一类
+    Map_IR_var_Set_ptr_IR_var interference;  // 代表变量 -> 与之冲突的代表变量集合
+    Set_IR_var pinned;                       // 不能被改名的变量（函数参数、DEC 变量及其地址变量）
+} CopyCoalescing;
+
+/**
+ * @brief 初始化复制合并的状态。
+ * @param t 指向要初始化的 CopyCoalescing 实例的指针。
+ * @param func 要优化的函数。
+ */
+extern void CopyCoalescing_init(CopyCoalescing *t, IR_function *func);
+
+/**
+ * @brief 析构复制合并的状态。
+ * @param t 指向要析构的 CopyCoalescing 实例的指针。
+ */
+extern void CopyCoalescing_teardown(CopyCoalescing *t);
+
+/**
+ * @brief 查找变量所在等价类的代表变量（带路径压缩）。
+ * @param t 指向 CopyCoalescing 实例的指针。
+ * @param var 要查找的变量。
+ * @return 代表变量。
+ */
+extern IR_var CopyCoalescing_find(CopyCoalescing *t, IR_var var);
+
+/**
+ * @brief 对函数执行复制合并：建立冲突关系，合并不冲突的复制相关变量，
+ * 重写所有定义与使用并删除变为 x := x 的复制语句。
+ * 需要在 CFG 已构建的函数上调用；内部会自行求解一次活跃变量分析。
+ * @param t 指向已初始化的 CopyCoalescing 实例的指针。
+ * @return 如果函数被修改返回 true。
+ */
+extern bool CopyCoalescing_coalesce(CopyCoalescing *t);
+
+#endif //CODE_COPY_COALESCING_H
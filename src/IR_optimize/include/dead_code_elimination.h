@@ -0,0 +1,24 @@
+//
+// Created by Assistant
+// 激进死代码消除 (Aggressive Dead Code Elimination)
+//
+
+#ifndef CODE_DEAD_CODE_ELIMINATION_H
+#define CODE_DEAD_CODE_ELIMINATION_H
+
+#include <def_use_chain.h>
+#include <dataflow_analysis.h>       // remove_dead_stmt
+
+/**
+ * @brief 标记-清除式的激进死代码消除。
+ * 以具有副作用的语句（WRITE、READ、RETURN、CALL、STORE 以及跳转语句）为根，
+ * 沿定义-使用链把它们的操作数的所有定义传递地标记为活跃，
+ * 最后一次性删除所有未被标记的语句。
+ * 与基于活跃变量分析的删除不同，只在循环中自我使用（如 i := i + 1 而 i 无其他用途）
+ * 的计算也会被删除；但一个变量只要有一处活跃使用，它的所有定义都会被保留。
+ * @param func 要优化的函数。
+ * @return 如果删除了任何语句返回 true。
+ */
+extern bool AggressiveDeadCodeElimination(IR_function *func);
+
+#endif //CODE_DEAD_CODE_ELIMINATION_H
@@ -0,0 +1,138 @@
+//
+// Created by Assistant
+// 定义-使用链索引 (Def-Use Chain Index)
+//
+
+#ifndef CODE_DEF_USE_CHAIN_H
+#define CODE_DEF_USE_CHAIN_H
+
+#include <IR.h>
+#include <container/treap.h>
+
+//// ================================== 数据结构 ==================================
+
+DEF_SET(IR_stmt_ptr)       // 语句集合
+typedef Set_IR_stmt_ptr *Set_ptr_IR_stmt_ptr;
+DEF_MAP(IR_var, Set_ptr_IR_stmt_ptr)  // 变量 -> 语句集合
+
+/**
+ * @brief 语句在函数中的位置：所在基本块以及在块语句链表中的结点。
+ */
+typedef struct {
+    IR_block_ptr blk;
+    ListNode_IR_stmt_ptr *node;
+} IR_stmt_site;
+DEF_MAP(IR_stmt_ptr, IR_stmt_site)
+
+/**
+ * @brief 函数级的定义-使用索引。
+ * 对每个变量记录定义它的语句集合与使用它的语句集合，对每条语句记录其位置。
+ * 通过本模块提供的改写接口修改代码时索引同步更新，
+ * 直接修改语句或链表的代码需要自行保证不再使用该索引。
+ */
+typedef struct DefUseChain {
+    IR_function *func;
+    Map_IR_var_Set_ptr_IR_stmt_ptr defs;   // 变量 -> 定义它的语句
+    Map_IR_var_Set_ptr_IR_stmt_ptr uses;   // 变量 -> 使用它的语句
+    Map_IR_stmt_ptr_IR_stmt_site sites;    // 语句 -> 所在位置
+} DefUseChain;
+
+//// ================================== 构造与析构 ==================================
+
+/**
+ * @brief 扫描函数的所有语句，建立定义-使用索引。
+ * @param t 指向要初始化的 DefUseChain 实例的指针。
+ * @param func 要建立索引的函数。
+ */
+extern void DefUseChain_init(DefUseChain *t, IR_function *func);
+
+/**
+ * @brief 析构定义-使用索引（不修改函数本身）。
+ * @param t 指向要析构的 DefUseChain 实例的指针。
+ */
+extern void DefUseChain_teardown(DefUseChain *t);
+
+//// ================================== 查询 ==================================
+
+/**
+ * @brief 获取使用变量 var 的语句集合。
+ * @return 语句集合；若变量没有任何使用返回 NULL。
+ */
+extern Set_IR_stmt_ptr *DefUseChain_get_uses(DefUseChain *t, IR_var var);
+
+/**
+ * @brief 获取定义变量 var 的语句集合。
+ * @return 语句集合；若变量没有任何定义返回 NULL。
+ */
+extern Set_IR_stmt_ptr *DefUseChain_get_defs(DefUseChain *t, IR_var var);
+
+/**
+ * @brief 统计变量 var 的使用次数（同一语句中出现多次按多次计）。
+ */
+extern unsigned DefUseChain_use_count(DefUseChain *t, IR_var var);
+
+/**
+ * @brief 统计变量 var 的定义语句条数。
+ */
+extern unsigned DefUseChain_def_count(DefUseChain *t, IR_var var);
+
+/**
+ * @brief 若变量 var 恰有一条定义语句则返回它，否则返回 NULL。
+ */
+extern IR_stmt *DefUseChain_single_def(DefUseChain *t, IR_var var);
+
+/**
+ * @brief 获取语句所在的位置（基本块与链表结点）。
+ * @return 指向位置信息的指针；若语句不在索引中返回 NULL。
+ */
+extern IR_stmt_site *DefUseChain_site_of(DefUseChain *t, IR_stmt *stmt);
+
+//// ================================== 改写 ==================================
+
+/**
+ * @brief 将语句 stmt 中对 old_var 的所有使用替换为 new_val（可以是常量）。
+ * @return 被替换的使用个数。
+ */
+extern unsigned DefUseChain_replace_use(DefUseChain *t, IR_stmt *stmt, IR_var old_var, IR_val new_val);
+
+/**
+ * @brief 修改语句 stmt 定义的变量（仅对有定义的语句有效）。
+ */
+extern void DefUseChain_set_def(DefUseChain *t, IR_stmt *stmt, IR_var new_var);
+
+/**
+ * @brief 从所在基本块中删除语句 stmt 并释放它。
+ */
+extern void DefUseChain_erase_stmt(DefUseChain *t, IR_stmt *stmt);
+
+/**
+ * @brief 在语句 pos 之后插入新语句 stmt。
+ */
+extern void DefUseChain_insert_after(DefUseChain *t, IR_stmt *pos, IR_stmt *stmt);
+
+/**
+ * @brief 在语句 pos 之前插入新语句 stmt。
+ */
+extern void DefUseChain_insert_before(DefUseChain *t, IR_stmt *pos, IR_stmt *stmt);
+
+/**
+ * @brief 在基本块 blk 末尾追加新语句 stmt。
+ */
+extern void DefUseChain_push_back(DefUseChain *t, IR_block *blk, IR_stmt *stmt);
+
+/**
+ * @brief 在基本块 blk 开头插入新语句 stmt。
+ */
+extern void DefUseChain_push_front(DefUseChain *t, IR_block *blk, IR_stmt *stmt);
+
+/**
+ * @brief 在基本块 blk 末尾追加新语句 stmt；blk 以跳转或返回语句结尾时放在其之前。
+ */
+extern void DefUseChain_append(DefUseChain *t, IR_block *blk, IR_stmt *stmt);
+
+/**
+ * @brief 把语句 stmt 从所在位置移动到基本块 blk 末尾；blk 以跳转或返回语句结尾时放在其之前。
+ */
+extern void DefUseChain_move_to_end(DefUseChain *t, IR_stmt *stmt, IR_block *blk);
+
+#endif //CODE_DEF_USE_CHAIN_H
@@ -22,27 +22,66 @@ DEF_SET(IR_block_ptr)
 
 /**
  * @brief 支配节点分析结果结构体
- * 记录每个基本块的支配信息
+ * 记录每个基本块的支配信息。支配集合不再显式存储，由直接支配节点链隐式表示。
  */
 typedef struct DominanceInfo {
     IR_block_ptr block;                    // 当前基本块
-    Set_IR_block_ptr dominators;           // 支配当前块的所有基本块集合
+    int rpo_index;                         // 逆后序 (RPO) 编号，从入口不可达的块为 -1
+    bool linked_to_root;                   // 后支配分析中与虚拟出口直接相连（函数出口或无限循环中的块）
     IR_block_ptr immediate_dominator;      // 直接支配节点 (immediate dominator)
-    Set_IR_block_ptr dominated_blocks;     // 被当前块支配的基本块集合
+    Set_IR_block_ptr dominated_blocks;     // 被当前块直接支配的基本块集合
     List_IR_block_ptr children_in_dom_tree; // 在支配树中的直接子节点
 } DominanceInfo;
 
 DEF_MAP(IR_block_ptr, DominanceInfo)   // 定义从基本块到支配信息的映射
 
+/**
+ * @brief 计算直接支配节点所用的算法
+ */
+typedef enum {
+    DOMINANCE_ALGO_AUTO,        // 按可达基本块数自动选择
+    DOMINANCE_ALGO_ITERATIVE,   // Cooper-Harvey-Kennedy 迭代算法，小函数上常数小
+    DOMINANCE_ALGO_SEMI_NCA,    // Lengauer-Tarjan 半支配点 + NCA，大函数上近线性
+} DominanceAlgorithm;
+
+// 可达基本块数不少于该值时, DOMINANCE_ALGO_AUTO 选用 Semi-NCA 算法
+#define DOMINANCE_SEMI_NCA_THRESHOLD 1024
+
 /**
  * @brief 支配节点分析器
+ * 以 RPO 编号为下标保存直接支配节点数组 idom，入口块编号为 0 且 idom[0] = 0。
+ * 任一可达块的直接支配节点的编号严格小于它自身的编号。
+ * 用 DominanceAnalyzer_init_post 初始化时在反向 CFG 上计算后支配关系：根为虚拟出口
+ * (RPO 编号 0，rpo_blocks[0] 为 NULL)，其后继为函数出口以及每个无法到达出口的无限循环中的一个块，
+ * 此时所有"支配"查询都表示后支配，支配边界即后支配边界。
  */
 typedef struct DominanceAnalyzer {
     IR_function *function;                      // 当前分析的函数
+    bool post_dominance;                        // 是否为后支配分析
     Map_IR_block_ptr_DominanceInfo dom_info;   // 每个基本块的支配信息映射
     IR_block_ptr entry_block;                  // 入口基本块
+    unsigned block_cnt;                        // 从入口可达的基本块数
+    IR_block_ptr *rpo_blocks;                  // RPO 编号 -> 基本块
+    int *idom;                                 // RPO 编号 -> 直接支配节点的 RPO 编号
+    unsigned *dom_pre, *dom_post;              // RPO 编号 -> 支配树 DFS 的进入/离开序号
+    unsigned *df_start;                        // 支配边界 (CSR)：块 b 的边界为 df[df_start[b] .. df_start[b+1])
+    int *df;                                   // 支配边界中块的 RPO 编号，每块内升序
+    unsigned *cd_start;                        // 控制依赖 (CSR，仅后支配)：依赖于块 x 的块为 cd[cd_start[x] .. cd_start[x+1])
+    int *cd;
+    unsigned *idf_stamp, idf_generation;       // 迭代支配边界查询的访问时间戳
+    DominanceAlgorithm algorithm;              // 计算所用算法，init 时为 AUTO，可在计算前修改
 } DominanceAnalyzer;
 
+/**
+ * @brief 沿直接支配节点链向上遍历支配节点的迭代器
+ * 依次给出块自身、其直接支配节点、……、入口块；可重入，不分配内存
+ */
+typedef struct DominatorIterator {
+    DominanceAnalyzer *analyzer;
+    IR_block_ptr block;     // 下一个要返回的块，遍历结束为 NULL
+    int rpo_index;          // block 的 RPO 编号
+} DominatorIterator;
+
 //// ================================== 支配节点分析 API ==================================
 
 /**
@@ -52,6 +91,14 @@ typedef struct DominanceAnalyzer {
  */
 extern void DominanceAnalyzer_init(DominanceAnalyzer *analyzer, IR_function *func);
 
+/**
+ * @brief 初始化后支配节点分析器，以函数出口为根在反向 CFG 上分析
+ * 之后的 compute_dominators / compute_frontiers / 查询接口均按后支配含义工作
+ * @param analyzer 指向要初始化的分析器的指针
+ * @param func 要分析的函数
+ */
+extern void DominanceAnalyzer_init_post(DominanceAnalyzer *analyzer, IR_function *func);
+
 /**
  * @brief 析构支配节点分析器，释放相关资源
  * @param analyzer 指向要析构的分析器的指针
@@ -60,11 +107,71 @@ extern void DominanceAnalyzer_teardown(DominanceAnalyzer *analyzer);
 
 /**
  * @brief 计算函数中所有基本块的支配关系
- * 使用数据流方程求解支配集合
+ * 按 analyzer->algorithm 选择 Cooper-Harvey-Kennedy 迭代算法或 Semi-NCA 算法得到 idom 数组，
+ * 并填写每个块的 immediate_dominator。定义 DEBUG 时会用 DominanceAnalyzer_verify 自检
  * @param analyzer 支配节点分析器
  */
 extern void DominanceAnalyzer_compute_dominators(DominanceAnalyzer *analyzer);
 
+/**
+ * @brief 差分检查：用两种算法分别重新计算 idom，并与已保存的结果逐块比较
+ * 不一致时向 stderr 输出第一个不一致的块
+ * @param analyzer 已计算过支配关系的分析器
+ * @return 三者完全一致返回 true
+ */
+extern bool DominanceAnalyzer_verify(DominanceAnalyzer *analyzer);
+
+/**
+ * @brief 计算所有可达块的支配边界 (Dominance Frontier)
+ * 在 compute_dominators 之后调用；DF(x) 为 x 支配其某个前驱但不严格支配的块的集合
+ * @param analyzer 支配节点分析器
+ */
+extern void DominanceAnalyzer_compute_frontiers(DominanceAnalyzer *analyzer);
+
+/**
+ * @brief 获取基本块的支配边界
+ * @param analyzer 已计算支配边界的分析器
+ * @param block 目标基本块
+ * @param out 结果按 RPO 顺序追加到该链表末尾
+ */
+extern void DominanceAnalyzer_get_frontier(DominanceAnalyzer *analyzer, IR_block_ptr block,
+                                           List_IR_block_ptr *out);
+
+/**
+ * @brief 计算一组块的迭代支配边界 DF+(S)，即放置 phi 函数的位置
+ * 耗时与访问到的支配边界大小成正比，不随函数总块数增长
+ * @param analyzer 已计算支配边界的分析器
+ * @param def_blocks 块集合 S（如某变量的所有定义所在块）
+ * @param out 结果按 RPO 顺序追加到该链表末尾
+ */
+extern void DominanceAnalyzer_iterated_frontier(DominanceAnalyzer *analyzer, Set_IR_block_ptr *def_blocks,
+                                                List_IR_block_ptr *out);
+
+/**
+ * @brief 由后支配边界构建控制依赖图（仅用于后支配分析器）
+ * 块 Y 控制依赖于块 X 当且仅当 X 属于 PDF(Y)；若尚未计算后支配边界会先计算
+ * @param analyzer 已计算后支配关系的分析器
+ */
+extern void DominanceAnalyzer_compute_control_dependence(DominanceAnalyzer *analyzer);
+
+/**
+ * @brief 获取控制块 Y 是否执行的分支块，即 Y 所控制依赖的块 (PDF(Y))
+ * @param analyzer 已构建控制依赖图的后支配分析器
+ * @param block 块 Y
+ * @param out 结果按 RPO 顺序追加到该链表末尾（不含虚拟出口）
+ */
+extern void DominanceAnalyzer_get_controlling_blocks(DominanceAnalyzer *analyzer, IR_block_ptr block,
+                                                     List_IR_block_ptr *out);
+
+/**
+ * @brief 获取控制依赖于分支块 X 的所有块
+ * @param analyzer 已构建控制依赖图的后支配分析器
+ * @param block 块 X
+ * @param out 结果按 RPO 顺序追加到该链表末尾
+ */
+extern void DominanceAnalyzer_get_dependent_blocks(DominanceAnalyzer *analyzer, IR_block_ptr block,
+                                                   List_IR_block_ptr *out);
+
 /**
  * @brief 构建支配树 (Dominator Tree)
  * 在计算支配关系后调用，构建支配树结构
@@ -74,6 +181,7 @@ extern void DominanceAnalyzer_build_dominator_tree(DominanceAnalyzer *analyzer);
 
 /**
  * @brief 检查节点A是否支配节点B
+ * 比较两者在支配树 DFS 中的进入/离开序号，O(1)；从入口不可达的块只被自身支配
  * @param analyzer 支配节点分析器
  * @param dominator 潜在的支配节点A
  * @param dominated 被支配的节点B
@@ -93,16 +201,24 @@ extern IR_block_ptr DominanceAnalyzer_get_immediate_dominator(DominanceAnalyzer
                                                               IR_block_ptr block);
 
 /**
- * @brief 获取基本块的所有支配节点
+ * @brief 创建遍历基本块所有支配节点的迭代器
+ * 用法: for (IR_block_ptr d; (d = DominatorIterator_next(&it)) != NULL; ) ...
  * @param analyzer 支配节点分析器
  * @param block 目标基本块
- * @return 支配节点集合的指针
+ * @return 指向 block 自身的迭代器
+ */
+extern DominatorIterator DominanceAnalyzer_dominators_begin(DominanceAnalyzer *analyzer, 
+                                                            IR_block_ptr block);
+
+/**
+ * @brief 返回迭代器当前的支配节点并上移到其直接支配节点
+ * @param it 迭代器
+ * @return 当前支配节点，遍历结束返回NULL
  */
-extern Set_IR_block_ptr* DominanceAnalyzer_get_dominators(DominanceAnalyzer *analyzer, 
-                                                          IR_block_ptr block);
+extern IR_block_ptr DominatorIterator_next(DominatorIterator *it);
 
 /**
- * @brief 获取被指定基本块支配的所有基本块
+ * @brief 获取被指定基本块直接支配的所有基本块（需先构建支配树）
  * @param analyzer 支配节点分析器
  * @param block 支配节点
  * @return 被支配基本块集合的指针
@@ -9,22 +9,46 @@
 
 #include <IR.h>
 #include <loop_analysis.h>
+#include <def_use_chain.h>
 #include <container/list.h>
 #include <container/treap.h>
 #include <stdio.h>
 
+//// ================================== 线性形式与定义点索引 ==================================
+
+#define LINEAR_FORM_MAX_TERMS 3         // 线性形式中变量项的最大个数
+
+/**
+ * @brief 线性形式 constant + Σ coefficient[k] * var[k]
+ * 记录定义语句所定义的值时，各变量取该语句执行前的当前值
+ */
+typedef struct LinearForm {
+    bool known;                                 // 能否表示为线性形式
+    unsigned term_cnt;                          // 变量项个数
+    IR_var var[LINEAR_FORM_MAX_TERMS];          // 各项的变量（互不相同）
+    int coefficient[LINEAR_FORM_MAX_TERMS];     // 各项的系数（非零）
+    int constant;                               // 常数项
+} LinearForm;
+
+DEF_MAP(IR_var, LinearForm)                     // 变量 -> 线性形式
+DEF_MAP(IR_stmt_ptr, LinearForm)                // 定义语句 -> 所定义值的线性形式
+typedef List_IR_stmt_ptr *List_ptr_IR_stmt_ptr;
+DEF_MAP(IR_var, List_ptr_IR_stmt_ptr)           // 变量 -> 循环内的定义语句
+
 //// ================================== 归纳变量数据结构 ==================================
 
 /**
  * @brief 基本归纳变量结构体
- * 表示形如 i = i + c 或 i = i - c 的循环变量
+ * 表示循环内的每个定义都形如 i = i + c（可以经过临时变量与复制）的循环变量，
+ * 一次迭代中可以有多个增量，增量也可以位于分支或内层循环中
  */
 typedef struct BasicInductionVariable {
     IR_var variable;                    // 归纳变量
-    IR_block_ptr increment_block;       // 增量操作所在的基本块
-    IR_stmt *increment_stmt;            // 增量操作语句 (i = i + c)
-    int step;                           // 步长值 (正数表示递增，负数表示递减)
-    bool is_increment;                  // true: i = i + c, false: i = i - c
+    IR_block_ptr increment_block;       // 第一条增量语句所在的基本块
+    IR_stmt *increment_stmt;            // 第一条增量语句
+    List_IR_stmt_ptr increment_stmts;   // 循环内的全部增量语句（各自的步长见其线性形式的常数项）
+    int step;                           // 各增量步长之和，每条增量每次迭代恰好执行一次时即每次迭代的步长
+    bool is_increment;                  // step 是否为正
 } BasicInductionVariable;
 
 typedef BasicInductionVariable* BasicInductionVariable_ptr;
@@ -34,13 +58,18 @@ DEF_MAP(IR_var, BasicInductionVariable_ptr)  // 定义变量到基本归纳变
 
 /**
  * @brief 派生归纳变量结构体  
- * 表示形如 j = c1 * i + c2 的变量，其中 i 是基本归纳变量
+ * 表示循环内一条定义 j = c1 * i + c2，其中 i 是基本归纳变量、取该定义执行前的当前值；
+ * 地址归纳变量形如 j = base + c1 * i + c2 (+ inv)，base 为循环不变的基址（如 &array），
+ * inv 为下标中可选的一个循环不变项（如外层循环的行偏移）。
+ * 同一变量在循环内的多个定义各自对应一个派生归纳变量
  */
 typedef struct DerivedInductionVariable {
     IR_var variable;                    // 派生归纳变量
     BasicInductionVariable_ptr basic_iv; // 对应的基本归纳变量
     int coefficient;                    // 系数 c1
     int constant;                       // 常数项 c2
+    IR_var base;                        // 循环不变的基址，普通派生归纳变量为 IR_VAR_NONE
+    IR_var invariant;                   // 地址归纳变量下标中的循环不变项，没有时为 IR_VAR_NONE
     IR_stmt *definition_stmt;           // 定义语句
 } DerivedInductionVariable;
 
@@ -60,12 +89,15 @@ typedef struct LoopInductionVariables {
     
     // 快速查找映射
     Map_IR_var_BasicInductionVariable_ptr basic_iv_map;
-    Map_IR_var_DerivedInductionVariable_ptr derived_iv_map;
+    Map_IR_var_DerivedInductionVariable_ptr derived_iv_map;    // 只含循环内唯一定义的派生归纳变量
+    
+    Map_IR_var_List_ptr_IR_stmt_ptr def_sites;  // 变量 -> 循环内（含内层循环）的定义语句
 } LoopInductionVariables;
 
 typedef LoopInductionVariables* LoopInductionVariables_ptr;
 
 DEF_LIST(LoopInductionVariables_ptr)    // 定义循环归纳变量信息列表类型
+DEF_MAP(Loop_ptr, LoopInductionVariables_ptr)  // 循环 -> 归纳变量信息
 
 /**
  * @brief 归纳变量分析器
@@ -74,8 +106,11 @@ DEF_LIST(LoopInductionVariables_ptr)    // 定义循环归纳变量信息列表
 typedef struct InductionVariableAnalyzer {
     IR_function *function;              // 当前分析的函数
     LoopAnalyzer *loop_analyzer;        // 循环分析器（必需）
+    DefUseChain def_use;                // 函数的定义-使用索引，强度削减改写代码时同步维护
+    Map_IR_stmt_ptr_LinearForm forms;   // 循环内的定义语句 -> 所定义值的线性形式（分析开始时一次求出）
     
     List_LoopInductionVariables_ptr loop_ivs;  // 所有循环的归纳变量信息
+    Map_Loop_ptr_LoopInductionVariables_ptr loop_iv_map;  // 循环 -> 归纳变量信息（只含可约循环）
     
     // 全局映射（跨所有循环）
     Map_IR_var_BasicInductionVariable_ptr global_basic_iv_map;
@@ -102,13 +137,31 @@ extern void InductionVariableAnalyzer_teardown(InductionVariableAnalyzer *analyz
 
 /**
  * @brief 执行归纳变量分析
- * 识别函数中所有循环的基本和派生归纳变量
+ * 先一次求出所有循环内定义语句的线性形式，再由内向外建立各循环的定义点索引（每个块只扫描一次，
+ * 外层循环合并内层循环的索引）并识别基本和派生归纳变量，不随候选变量个数重复扫描循环
  * @param analyzer 归纳变量分析器
  */
 extern void InductionVariableAnalyzer_analyze(InductionVariableAnalyzer *analyzer);
 
+/**
+ * @brief 求出所有位于循环内的定义语句所定义值的线性形式
+ * 每个基本块内顺序执行一遍：块内已定义的变量记为块入口值的线性形式（类似块内的 SSA 重命名），
+ * 到达定义语句时再把各项换算为语句执行前的当前值；块内被非线性地重新定义过的变量使形式未知
+ * @param analyzer 归纳变量分析器
+ */
+extern void InductionVariableAnalyzer_compute_linear_forms(InductionVariableAnalyzer *analyzer);
+
+/**
+ * @brief 获取定义语句所定义值的线性形式（变量取语句执行前的当前值）
+ * @return 语句不在循环内或不能表示为线性形式时返回 false
+ */
+extern bool InductionVariableAnalyzer_get_linear_form(InductionVariableAnalyzer *analyzer,
+                                                     IR_stmt *stmt, LinearForm *form);
+
 /**
  * @brief 分析单个循环中的基本归纳变量
+ * 循环内每个定义的线性形式都是 i + c 的变量 i 构成一个递推（对应 SSA 中循环头 phi 所在的强连通定义），
+ * 各个定义即为增量，步长之和不为零
  * @param analyzer 归纳变量分析器
  * @param loop 要分析的循环
  * @param loop_ivs 循环归纳变量信息结构体
@@ -119,6 +172,7 @@ extern void InductionVariableAnalyzer_analyze_basic_ivs(InductionVariableAnalyze
 
 /**
  * @brief 分析单个循环中的派生归纳变量
+ * 线性形式恰为 c1 * i + c2（i 为基本归纳变量，c1 不为 0）的定义
  * @param analyzer 归纳变量分析器
  * @param loop 要分析的循环
  * @param loop_ivs 循环归纳变量信息结构体
@@ -127,6 +181,18 @@ extern void InductionVariableAnalyzer_analyze_derived_ivs(InductionVariableAnaly
                                                           Loop_ptr loop,
                                                           LoopInductionVariables_ptr loop_ivs);
 
+/**
+ * @brief 分析单个循环中的地址归纳变量
+ * 线性形式为 base + c1 * i + c2（至多再加一个循环不变项 inv）的定义，base 与 inv 在循环内没有定义且系数为 1；
+ * 只记录至少被一条 LOAD/STORE 用作地址的变量
+ * @param analyzer 归纳变量分析器
+ * @param loop 要分析的循环
+ * @param loop_ivs 循环归纳变量信息结构体（已完成派生归纳变量分析）
+ */
+extern void InductionVariableAnalyzer_analyze_address_ivs(InductionVariableAnalyzer *analyzer,
+                                                          Loop_ptr loop,
+                                                          LoopInductionVariables_ptr loop_ivs);
+
 //// ================================== 查询接口 ==================================
 
 /**
@@ -213,8 +279,8 @@ typedef struct StrengthReductionVariable {
     DerivedInductionVariable_ptr original_derived_iv;  // 原始的派生归纳变量
     int increment_value;                // 每次循环的增量值 (coefficient * basic_step)
     IR_stmt *initialization_stmt;       // 在preheader中的初始化语句
-    IR_stmt *increment_stmt;           // 在循环体中的增量语句
-    IR_block_ptr increment_block;      // 增量语句所在的块
+    IR_stmt *increment_stmt;           // 在循环体中的第一条增量语句（基本归纳变量的每条增量之后各有一条）
+    IR_block_ptr increment_block;      // 第一条增量语句所在的块
 } StrengthReductionVariable;
 
 typedef StrengthReductionVariable* StrengthReductionVariable_ptr;
@@ -223,7 +289,8 @@ DEF_LIST(StrengthReductionVariable_ptr)  // 定义强度削减变量列表类型
 
 /**
  * @brief 对循环执行强度削减优化
- * 将派生归纳变量的乘法操作替换为增量操作
+ * 将派生归纳变量的乘法操作替换为增量操作：派生归纳变量的定义改为读取强度削减变量，
+ * 系数与基址相同、只有常数项不同的定义共用一个强度削减变量
  * @param analyzer 归纳变量分析器
  * @param loop_ivs 循环归纳变量信息
  * @return 创建的强度削减变量列表
@@ -258,16 +325,20 @@ extern StrengthReductionVariable_ptr create_strength_reduction_variable(
     LoopInductionVariables_ptr loop_ivs);
 
 /**
- * @brief 替换派生归纳变量的使用
- * 将对派生归纳变量的使用替换为强度削减变量
- * @param derived_iv 派生归纳变量
- * @param sr_var 强度削减变量
+ * @brief 对循环执行线性函数测试替换 (Linear Function Test Replacement)
+ * 基本归纳变量 i 在循环内除自身增量外只被 IF i relop n（n 循环不变）使用、离开循环后也不再被读取时，
+ * 用它的一个强度削减变量 sr = c1 * i + c2 改写测试为 IF sr relop' c1 * n + c2（c1 < 0 时比较方向相反），
+ * 然后删除 i 的增量语句；被删除的增量在所有循环的基本归纳变量中记为 NULL。
+ * 只有由标量演化得到 i 的常量初值与常量执行次数，并证明 c1 * i + c2 在 i 的取值范围内与 c1 * n + c2 都不回绕时才改写
+ * @param analyzer 归纳变量分析器（提供定义-使用索引）
  * @param loop_ivs 循环归纳变量信息
+ * @param sr_vars 该循环刚创建的强度削减变量
+ * @return 是否有测试被改写
  */
-extern void replace_derived_variable_uses(
-    DerivedInductionVariable_ptr derived_iv,
-    StrengthReductionVariable_ptr sr_var,
-    LoopInductionVariables_ptr loop_ivs);
+extern bool perform_linear_function_test_replacement(
+    InductionVariableAnalyzer *analyzer,
+    LoopInductionVariables_ptr loop_ivs,
+    List_StrengthReductionVariable_ptr sr_vars);
 
 /**
  * @brief 打印强度削减变量信息
@@ -10,26 +10,31 @@
 #include <loop_analysis.h>
 #include <dominance_analysis.h>
 #include <container/treap.h>
+#include <def_use_chain.h>      // Set_IR_stmt_ptr, 语句 -> (基本块, 链表结点) 索引
 
 //// ================================== 容器类型定义 ==================================
 
-// 定义LICM需要的容器类型
-DEF_MAP(IR_stmt_ptr, int)  // 语句到int映射，用于缓存 (int: 0=false, 1=true)
-DEF_SET(IR_stmt_ptr)       // 语句集合，用于记录已移动的语句
+DEF_MAP(IR_var, unsigned)                           // 变量 -> 循环内的定义次数
+typedef Map_IR_var_unsigned *Map_ptr_IR_var_unsigned;
+DEF_MAP(Loop_ptr, Map_ptr_IR_var_unsigned)          // 循环 -> 定义次数表
+DEF_MAP(Loop_ptr, List_ptr_IR_block_ptr)            // 循环 -> 直接属于它的块
 
 //// ================================== LICM数据结构 ==================================
 
 /**
  * @brief LICM分析器
- * 管理循环不变代码的检测和外提
+ * 初始化时按逆后序扫描一遍函数，把块归入其所在的最内层循环；
+ * 每个循环的定义次数表（含内层循环）在初始化时自内向外一次求出，外提语句时同步更新；
+ * 语句所在位置由定义-使用索引给出，查询与移动都不需要扫描循环。
  */
 typedef struct LICMAnalyzer {
     IR_function *function;                      // 当前分析的函数
     LoopAnalyzer *loop_analyzer;                // 循环分析器
     DominanceAnalyzer *dom_analyzer;            // 支配分析器
-    
-    // 缓存信息用于快速查询
-    Map_IR_stmt_ptr_int invariant_cache;        // 语句不变性缓存 (用int: 0=false, 1=true)
+
+    DefUseChain def_use;                        // 定义-使用索引与语句位置
+    Map_Loop_ptr_Map_ptr_IR_var_unsigned def_counts; // 循环 -> (变量 -> 循环内定义次数)
+    Map_Loop_ptr_List_ptr_IR_block_ptr own_blocks;   // 循环 -> 不属于内层循环的块，按逆后序排列
     Set_IR_stmt_ptr moved_stmts;                // 已移动的语句集合
 } LICMAnalyzer;
 
@@ -37,13 +42,15 @@ typedef struct LICMAnalyzer {
 
 /**
  * @brief 初始化LICM分析器
+ * 只读取支配关系，不修改调用方的支配分析器；支配关系必须已包含预备首部
+ * （创建预备首部后调用 LoopAnalyzer_refresh_dominators，或由 LoopAnalyzer_recompute 得到）
  * @param analyzer 指向要初始化的LICM分析器的指针
  * @param func 要分析的函数
- * @param loop_analyzer 已完成分析的循环分析器
- * @param dom_analyzer 已完成分析的支配分析器
+ * @param loop_analyzer 已完成分析并创建了预备首部的循环分析器
+ * @param dom_analyzer 循环分析器所用的、包含预备首部的支配分析器
  */
-extern void LICMAnalyzer_init(LICMAnalyzer *analyzer, 
-                              IR_function *func, 
+extern void LICMAnalyzer_init(LICMAnalyzer *analyzer,
+                              IR_function *func,
                               LoopAnalyzer *loop_analyzer,
                               DominanceAnalyzer *dom_analyzer);
 
@@ -55,7 +62,7 @@ extern void LICMAnalyzer_teardown(LICMAnalyzer *analyzer);
 
 /**
  * @brief 执行循环不变代码外提优化
- * 对函数中的所有循环执行LICM优化
+ * 自内向外处理所有循环，外提到内层预备首部的语句在处理外层循环时还可以继续外提
  * @param analyzer LICM分析器
  * @return 如果有代码被移动返回true，否则返回false
  */
@@ -63,6 +70,8 @@ extern bool LICMAnalyzer_optimize(LICMAnalyzer *analyzer);
 
 /**
  * @brief 对单个循环执行LICM优化
+ * 按支配顺序（逆后序）访问只属于该循环的块（不扫描其他块），一遍即可达到不动点：
+ * 不变语句的操作数若在循环内定义，其唯一定义支配该语句，已先被外提
  * @param analyzer LICM分析器
  * @param loop 要优化的循环
  * @return 如果有代码被移动返回true，否则返回false
@@ -73,26 +82,34 @@ extern bool LICMAnalyzer_optimize_loop(LICMAnalyzer *analyzer, Loop *loop);
 
 /**
  * @brief 检查语句是否为循环不变的
+ * 语句是没有副作用的计算（不会除零），且所有操作数在循环内都没有定义
  * @param analyzer LICM分析器
  * @param stmt 要检查的语句
  * @param loop 循环指针
  * @return 如果语句是循环不变的返回true，否则返回false
  */
-extern bool LICMAnalyzer_is_loop_invariant(LICMAnalyzer *analyzer, 
-                                           IR_stmt_ptr stmt, 
+extern bool LICMAnalyzer_is_loop_invariant(LICMAnalyzer *analyzer,
+                                           IR_stmt_ptr stmt,
                                            Loop *loop);
 
 /**
  * @brief 检查语句是否可以安全地移动到循环外
+ * 除循环不变外，被定义的变量在循环内只有这一次定义，循环内对它的使用都被该语句支配，
+ * 并且语句支配所有退出块或者变量在循环外没有使用
  * @param analyzer LICM分析器
  * @param stmt 要检查的语句
  * @param loop 循环指针
  * @return 如果语句可以安全移动返回true，否则返回false
  */
-extern bool LICMAnalyzer_is_safe_to_move(LICMAnalyzer *analyzer, 
-                                         IR_stmt_ptr stmt, 
+extern bool LICMAnalyzer_is_safe_to_move(LICMAnalyzer *analyzer,
+                                         IR_stmt_ptr stmt,
                                          Loop *loop);
 
+/**
+ * @brief 获取变量在循环（含内层循环）中的定义次数，查表 O(log n)
+ */
+extern unsigned LICMAnalyzer_def_count_in_loop(LICMAnalyzer *analyzer, IR_var var, Loop *loop);
+
 /**
  * @brief 检查变量是否在循环中被修改
  * @param analyzer LICM分析器
@@ -100,8 +117,8 @@ extern bool LICMAnalyzer_is_safe_to_move(LICMAnalyzer *analyzer,
  * @param loop 循环指针
  * @return 如果变量在循环中被修改返回true，否则返回false
  */
-extern bool LICMAnalyzer_is_var_modified_in_loop(LICMAnalyzer *analyzer, 
-                                                 IR_var var, 
+extern bool LICMAnalyzer_is_var_modified_in_loop(LICMAnalyzer *analyzer,
+                                                 IR_var var,
                                                  Loop *loop);
 
 //// ================================== 调试和打印接口 ==================================
@@ -119,8 +136,8 @@ extern void LICMAnalyzer_print_result(LICMAnalyzer *analyzer, FILE *out);
  * @param loop 循环指针
  * @param out 输出文件流
  */
-extern void LICMAnalyzer_print_invariant_stmts(LICMAnalyzer *analyzer, 
-                                               Loop *loop, 
+extern void LICMAnalyzer_print_invariant_stmts(LICMAnalyzer *analyzer,
+                                               Loop *loop,
                                                FILE *out);
 
 #endif //CODE_LICM_H
@@ -114,6 +114,9 @@ typedef struct LiveVariableAnalysis {
     // 存储每个基本块的IN和OUT事实的映射。
     // Fact 为变量的集合 (Set_IR_var)。
     Map_IR_block_ptr_Set_ptr_IR_var mapInFact, mapOutFact;
+    // 每个基本块的向上暴露使用集合 UEVar 与定值集合 VarKill，
+    // 在第一次对该块调用传递函数时计算一次，之后的迭代直接复用。
+    Map_IR_block_ptr_Set_ptr_IR_var mapUEVar, mapVarKill;
 } LiveVariableAnalysis;
 
 /**
@@ -138,6 +141,7 @@ extern void LiveVariableAnalysis_transferStmt (LiveVariableAnalysis *t,
 /**
  * @brief （具体实现）执行传递函数，根据基本块的 OUT 集合计算其 IN 集合。
  * 这是 LiveVariableAnalysis_virtualTable 中 transferBlock 指针的实际函数。
+ * 使用预先计算的块摘要：IN[B] = UEVar[B] U (OUT[B] - VarKill[B])，不再逐条语句模拟。
  * @param t 指向 LiveVariableAnalysis 实例的指针。
  * @param block 指向当前处理的 IR_block 的指针。
  * @param in_fact 指向 IN[B] 的指针 (此集合会被计算和修改)。
@@ -159,6 +163,8 @@ extern void LiveVariableAnalysis_print_result (LiveVariableAnalysis *t, IR_funct
 /**
  * @brief 根据活跃变量分析的结果，移除函数中的死定义 (dead definitions)。
  * 如果一个变量被定义了，但在其定义点之后不再活跃（即不在OUT集合中），则该定义是死代码。
+ * 每个块只做一次逐语句的反向扫描；被判为死代码的语句不再使其操作数活跃，
+ * 因此块内成串的死定义在一次扫描中即可全部删除。
  * @param t 指向 LiveVariableAnalysis 实例的指针 (应已包含分析结果)。
  * @param func 指向要优化的 IR_function 的指针。
  * @return 如果成功移除了任何死代码则返回 true，否则返回 false。
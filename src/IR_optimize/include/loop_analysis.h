@@ -50,14 +50,19 @@ typedef struct Loop {
     // 循环预备首部（可选，用于优化）
     IR_block_ptr preheader;                 // 循环的预备首部（插入循环不变代码的位置）
     
+    // 循环出口
+    List_IR_block_ptr exit_blocks;          // 退出块：循环内有后继在循环外的块
+    List_IR_block_ptr exit_targets;         // 外部后继：循环外有前驱在循环内的块
+    
     // 循环深度和其他属性
     int depth;                              // 循环嵌套深度（从1开始）
-    bool is_reducible;                      // 是否为可约循环
+    bool is_reducible;                      // 是否为可约循环（不可约循环有多个入口，header 为 DFS 最先到达的入口）
 } Loop;
 
 /**
  * @brief 循环分析器
- * 管理整个函数的循环检测和分析
+ * 管理整个函数的循环检测和分析。循环由 Havlak 算法在一次 DFS 上构造为循环嵌套森林，
+ * all_loops 中内层循环排在外层循环之前；不可约区域也作为循环给出，is_reducible 为 false
  */
 typedef struct LoopAnalyzer {
     IR_function *function;                  // 当前分析的函数
@@ -88,25 +93,41 @@ extern void LoopAnalyzer_teardown(LoopAnalyzer *analyzer);
 
 /**
  * @brief 执行循环检测分析
- * 识别函数中的所有自然循环
- * @param analyzer 循环分析器
+ * 识别函数中的所有循环并建立嵌套关系、块到最内层循环的映射以及每个循环的出口
+ * @param analyzer 循环分析器（其支配节点分析器需已计算支配关系，用于给可达块编号）
  */
 extern void LoopAnalyzer_detect_loops(LoopAnalyzer *analyzer);
 
 /**
  * @brief 构建循环嵌套层次结构
- * 在检测到循环后调用，建立循环间的父子关系
+ * 层次结构已由 LoopAnalyzer_detect_loops 建立，保留此接口以兼容原有调用顺序
  * @param analyzer 循环分析器
  */
 extern void LoopAnalyzer_build_loop_hierarchy(LoopAnalyzer *analyzer);
 
 /**
  * @brief 为循环创建预备首部
- * 为需要的循环插入预备首部基本块
+ * 为需要的可约循环插入以 GOTO 循环头结尾的预备首部基本块，并把外部前驱的跳转重定向到它；
+ * 新块加入外层循环的块集合，各循环的外部后继随之更新。不可约循环不创建预备首部
  * @param analyzer 循环分析器
  */
 extern void LoopAnalyzer_create_preheaders(LoopAnalyzer *analyzer);
 
+/**
+ * @brief 原地重新计算循环分析器所用的支配关系，使之包含新插入的预备首部
+ * 预备首部在支配关系计算之后插入，依赖支配关系的循环变换（如 LICM）要求调用方在创建预备首部后调用；
+ * 循环信息只引用基本块，不受影响
+ * @param analyzer 已创建预备首部的循环分析器
+ */
+extern void LoopAnalyzer_refresh_dominators(LoopAnalyzer *analyzer);
+
+/**
+ * @brief 控制流被改写后，原地重新计算支配关系与循环信息（包括预备首部），最后的支配关系包含预备首部
+ * 沿用分析器原有的函数与支配节点分析器，之前得到的 Loop 指针全部失效
+ * @param analyzer 已初始化的循环分析器
+ */
+extern void LoopAnalyzer_recompute(LoopAnalyzer *analyzer);
+
 //// ================================== 查询接口 ==================================
 
 /**
@@ -149,6 +170,23 @@ extern void Loop_get_exit_blocks(Loop *loop, List_IR_block_ptr *exits);
  */
 extern void Loop_get_exit_targets(Loop *loop, List_IR_block_ptr *exit_targets);
 
+/**
+ * @brief 统计循环（含内层循环）中的语句数，用作变换的代价
+ * @param loop 循环指针
+ * @return 循环所有块的语句总数
+ */
+extern unsigned Loop_stmt_count(Loop *loop);
+
+/**
+ * @brief 按函数块链表中的顺序收集循环的块
+ * @param func 循环所在的函数
+ * @param loop 循环指针
+ * @param n 输出块数
+ * @param last_node 不为NULL时输出链表中最后一个循环块所在的结点
+ * @return 块数组，由调用者释放
+ */
+extern IR_block_ptr *Loop_collect_blocks(IR_function *func, Loop *loop, unsigned *n, ListNode_IR_block_ptr **last_node);
+
 //// ================================== 结果输出 ==================================
 
 /**
@@ -0,0 +1,91 @@
+//
+// Created by Assistant
+// 循环删除 (Loop Deletion)
+//
+
+#ifndef CODE_LOOP_DELETION_H
+#define CODE_LOOP_DELETION_H
+
+#include <IR.h>
+#include <dominance_analysis.h>
+#include <loop_analysis.h>
+#include <induction_variable_analysis.h>
+#include <scalar_evolution.h>
+
+//// ================================== 出口值 ==================================
+
+/**
+ * @brief 循环内定义的变量在离开循环时的值（闭式）：coefficient * source + constant，
+ * source 为基本归纳变量进入循环时的值。
+ */
+typedef struct ExitValue {
+    IR_var variable;        // 循环内定义、出口处活跃的变量
+    IR_var source;          // 对应的基本归纳变量
+    int coefficient;
+    int constant;
+} ExitValue;
+
+/**
+ * @brief 由递推与执行次数求出变量的出口值。
+ * 基本归纳变量的每条增量须位于循环本身（不在内层循环）且每次迭代都执行，
+ * 最后一次迭代在退出块处离开循环，位于退出块之前的增量执行 trip_count 次，其余执行 trip_count - 1 次；
+ * 派生归纳变量 j = c1 * i + c2 须在循环内只有一个定义，且定义在最后一次迭代中先于退出执行。
+ * @param iv_analyzer 已完成分析的归纳变量分析器。
+ * @param loop_ivs 循环的归纳变量信息。
+ * @param exiting 唯一的退出块。
+ * @param trip_count 循环头的执行次数。
+ * @param var 要求值的变量。
+ * @param value 输出的出口值。
+ * @return 能求出闭式时返回 true。
+ */
+extern bool LoopDeletion_exit_value(InductionVariableAnalyzer *iv_analyzer, LoopInductionVariables_ptr loop_ivs,
+                                    IR_block_ptr exiting, unsigned trip_count, IR_var var, ExitValue *value);
+
+//// ================================== 删除方案 ==================================
+
+/**
+ * @brief 单个循环的删除方案，在修改函数之前确定。
+ */
+typedef struct DeletionPlan {
+    Loop_ptr loop;
+    IR_block_ptr exit_target;   // 唯一的出口目标，删除后预备首部直接跳到这里
+    unsigned trip_count;        // 循环头的执行次数
+    unsigned value_cnt;
+    ExitValue *values;          // 出口处活跃的循环内定义的变量及其出口值
+} DeletionPlan;
+
+/**
+ * @brief 判断循环能否删除并确定删除方案。
+ * 要求循环是可约的最内层循环、有预备首部、只有一个以 IF 结尾的退出块和一个出口目标，
+ * 循环内没有 WRITE/STORE/CALL/READ 等副作用，一次迭代内除回边外没有环，执行次数为常量；
+ * 并且循环内定义、在出口目标入口处活跃的变量都能求出出口值。
+ * 执行次数来自标量演化，只在 IV 退出前不会回绕时给出，因此不终止的循环不会被删除。
+ * @param se 标量演化分析器，用于求执行次数。
+ * @param iv_analyzer 已完成分析的归纳变量分析器。
+ * @param live_in 出口目标入口处的活跃变量，为 NULL 时视为全部活跃。
+ * @param loop 要删除的循环。
+ * @param plan 输出的删除方案，成功时 values 由调用者释放。
+ * @return 可以删除时返回 true。
+ */
+extern bool LoopDeletion_plan(ScalarEvolution *se, InductionVariableAnalyzer *iv_analyzer,
+                              Set_IR_var *live_in, Loop_ptr loop, DeletionPlan *plan);
+
+/**
+ * @brief 按方案删除循环：在预备首部末尾按闭式计算各出口值，改为跳到出口目标，
+ * 删除循环的所有块后重建函数的CFG。调用后 loop 以及依赖CFG的分析结果全部失效。
+ */
+extern void LoopDeletion_delete(IR_function *func, const DeletionPlan *plan);
+
+//// ================================== 高层接口 ==================================
+
+/**
+ * @brief 反复删除函数中满足条件的最内层循环，外层循环在内层被删除后可能继续满足条件。
+ * 有循环被删除时，原地重新计算支配关系与循环信息（包括预备首部）。
+ * @param func 要优化的函数。
+ * @param dom_analyzer 已完成计算的支配节点分析器。
+ * @param loop_analyzer 已完成检测并创建了预备首部的循环分析器。
+ * @return 函数是否被修改。
+ */
+extern bool perform_loop_deletion(IR_function *func, DominanceAnalyzer *dom_analyzer, LoopAnalyzer *loop_analyzer);
+
+#endif //CODE_LOOP_DELETION_H
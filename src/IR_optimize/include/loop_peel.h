@@ -0,0 +1,65 @@
+//
+// Created by Assistant
+// 循环剥离 (Loop Peeling)
+//
+
+#ifndef CODE_LOOP_PEEL_H
+#define CODE_LOOP_PEEL_H
+
+#include <IR.h>
+#include <dominance_analysis.h>
+#include <loop_analysis.h>
+#include <constant_propagation.h>
+
+//// ================================== 参数 ==================================
+
+#define LOOP_PEEL_MAX_COUNT 2       // 最多剥离的迭代数
+#define LOOP_PEEL_THRESHOLD 32      // 被剥离的循环语句数上限
+#define LOOP_PEEL_BUDGET 96         // 每个函数因剥离增加的语句总数上限
+
+//// ================================== 剥离方案 ==================================
+
+/**
+ * @brief 单个循环的剥离方案，在修改函数之前确定。
+ */
+typedef struct PeelPlan {
+    Loop_ptr loop;
+    unsigned count;         // 剥离的迭代数
+    unsigned size;          // 循环的语句数，剥离增加 count * size 条语句
+} PeelPlan;
+
+/**
+ * @brief 在循环头寻找类似 φ 的汇合并确定剥离方案。
+ * 汇合变量在循环头入口处活跃，从预备首部进入时是常量，在循环头入口处因回边上的值而不是常量，
+ * 并且循环内的定义不依赖它自己（排除归纳变量与累加变量）。剥离一次迭代后这类变量在首次迭代中是常量；
+ * 定义为另一个汇合变量的值时，需要再多剥离一次。
+ * 要求循环是有预备首部的可约最内层循环，剥离增加的语句数不超过阈值与剩余的预算。
+ * @param cp 已求解的常量传播分析。
+ * @param live_in 循环头入口处的活跃变量。
+ * @param loop 要剥离的循环。
+ * @param budget 剩余可增加的语句数。
+ * @param plan 输出的剥离方案。
+ * @return 值得剥离时返回 true。
+ */
+extern bool LoopPeel_plan(ConstantPropagation *cp, Set_IR_var *live_in, Loop_ptr loop, unsigned budget, PeelPlan *plan);
+
+/**
+ * @brief 按方案剥离循环的前 count 次迭代：循环体复制 count 份放在预备首部之后并使用新的标签，
+ * 第 k 份的回边跳向第 k+1 份的循环头，最后一份跳回原循环头，跳出循环的目标不变；
+ * 预备首部改为跳向第一份。之后重建函数的CFG，调用后依赖CFG的分析结果全部失效。
+ */
+extern void LoopPeel_peel(IR_function *func, const PeelPlan *plan);
+
+//// ================================== 高层接口 ==================================
+
+/**
+ * @brief 剥离函数中所有值得剥离的最内层循环，剥离后由常量传播化简首次迭代与之后的循环体。
+ * 有循环被剥离时，原地重新计算支配关系与循环信息（包括预备首部）。
+ * @param func 要优化的函数。
+ * @param dom_analyzer 已完成计算的支配节点分析器。
+ * @param loop_analyzer 已完成检测并创建了预备首部的循环分析器。
+ * @return 函数是否被修改。
+ */
+extern bool perform_loop_peeling(IR_function *func, DominanceAnalyzer *dom_analyzer, LoopAnalyzer *loop_analyzer);
+
+#endif //CODE_LOOP_PEEL_H
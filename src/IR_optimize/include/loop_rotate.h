@@ -0,0 +1,51 @@
+//
+// Created by Assistant
+// 循环旋转 (Loop Rotation)
+//
+
+#ifndef CODE_LOOP_ROTATE_H
+#define CODE_LOOP_ROTATE_H
+
+#include <IR.h>
+#include <dominance_analysis.h>
+#include <loop_analysis.h>
+#include <scalar_evolution.h>
+
+//// ================================== 参数 ==================================
+
+#define LOOP_ROTATE_HEADER_THRESHOLD 8   // 可被复制的循环头语句数上限（含 IF）
+
+//// ================================== 单个循环 ==================================
+
+/**
+ * @brief 判断循环能否旋转为"守卫 + do-while"形式。
+ * 要求循环可约、有预备首部、只有一个回边源且回边源不是退出块（尚未是底部判断）；
+ * 循环头不超过阈值、以 IF 结尾，一个分支留在循环内、另一个分支离开循环，
+ * 且循环头的前驱恰为预备首部与回边源，循环内的后继只有循环头一个前驱。
+ */
+extern bool LoopRotate_can_rotate(IR_function *func, Loop_ptr loop);
+
+/**
+ * @brief 判断第一次执行循环头时 IF 是否必然进入循环体（两个操作数在第 0 次迭代都是常量）。
+ */
+extern bool LoopRotate_always_entered(ScalarEvolution *se, Loop_ptr loop);
+
+/**
+ * @brief 旋转循环：把循环头复制到预备首部末尾作为守卫、复制到回边源之后作为底部判断，然后删除原循环头。
+ * 原循环头在循环内的后继成为新的循环头，守卫与它之间插入新的预备首部；
+ * blk_pred/blk_succ 与跳转语句同步维护，调用后支配关系与循环信息失效。
+ * @param always_entered 第一次判断必然进入循环时不生成守卫，原预备首部直接跳到新的循环头。
+ * @return 回边无法拆分时返回 false，此时函数没有被修改。
+ */
+extern bool LoopRotate_rotate(IR_function *func, Loop_ptr loop, bool always_entered);
+
+//// ================================== 高层接口 ==================================
+
+/**
+ * @brief 旋转函数中所有满足条件的循环。
+ * 每旋转一个循环后原地重新计算支配关系与循环信息（包括预备首部），新的预备首部即守卫之后插入的块。
+ * @return 函数是否被修改。
+ */
+extern bool perform_loop_rotation(IR_function *func, DominanceAnalyzer *dom_analyzer, LoopAnalyzer *loop_analyzer);
+
+#endif //CODE_LOOP_ROTATE_H
@@ -0,0 +1,65 @@
+//
+// Created by Assistant
+// 循环展开 (Loop Unrolling)
+//
+
+#ifndef CODE_LOOP_UNROLL_H
+#define CODE_LOOP_UNROLL_H
+
+#include <IR.h>
+#include <dominance_analysis.h>
+#include <loop_analysis.h>
+#include <scalar_evolution.h>
+
+//// ================================== 参数 ==================================
+
+#define LOOP_UNROLL_FULL_THRESHOLD 200     // 完全展开后循环体语句总数的上限
+#define LOOP_UNROLL_PARTIAL_THRESHOLD 64   // 部分展开后循环体语句总数的上限
+#define LOOP_UNROLL_MAX_FACTOR 4           // 部分展开的最大份数
+
+//// ================================== 展开方案 ==================================
+
+/**
+ * @brief 单个循环的展开方案，在修改函数之前确定。
+ */
+typedef struct UnrollPlan {
+    Loop_ptr loop;
+    IR_block_ptr exiting;   // 唯一的退出块，以 IF 结尾且每次迭代都执行
+    unsigned trip_count;    // 循环头的执行次数
+    unsigned factor;        // 循环体的份数（完全展开时等于 trip_count）
+    bool full;              // 是否完全展开
+} UnrollPlan;
+
+/**
+ * @brief 判断循环能否展开并确定展开方案。
+ * 要求循环是可约的最内层循环、只有一个回边源、只有一个以 IF 结尾的退出块，并且执行次数为常量；
+ * 展开后的语句数不超过阈值时完全展开，否则在阈值内按最大份数部分展开。
+ * 执行次数来自标量演化，只在 IV 退出前不会回绕时给出，不终止的循环不会被展开成直线代码。
+ * @param se 标量演化分析器，用于求执行次数。
+ * @param loop 要展开的循环。
+ * @param plan 输出的展开方案。
+ * @return 可以展开时返回 true。
+ */
+extern bool LoopUnroll_plan(ScalarEvolution *se, Loop_ptr loop, UnrollPlan *plan);
+
+/**
+ * @brief 按方案展开循环，之后重建函数的CFG。
+ * 循环体复制在原循环之后，复制块使用新的标签。部分展开时只在第 (trip_count-1) mod factor 份保留出口判断，
+ * 其余各份的判断必然不退出，直接跳到下一份，因此不需要余数循环；完全展开时去掉全部判断与回边。
+ * 调用后 loop 以及依赖CFG的分析结果全部失效。
+ */
+extern void LoopUnroll_unroll(IR_function *func, const UnrollPlan *plan);
+
+//// ================================== 高层接口 ==================================
+
+/**
+ * @brief 展开函数中所有满足条件的最内层循环。
+ * 有循环被展开时，原地重新计算支配关系与循环信息（包括预备首部）。
+ * @param func 要优化的函数。
+ * @param dom_analyzer 已完成计算的支配节点分析器。
+ * @param loop_analyzer 已完成检测的循环分析器。
+ * @return 函数是否被修改。
+ */
+extern bool perform_loop_unrolling(IR_function *func, DominanceAnalyzer *dom_analyzer, LoopAnalyzer *loop_analyzer);
+
+#endif //CODE_LOOP_UNROLL_H
@@ -0,0 +1,62 @@
+//
+// Created by Assistant
+// 循环不变条件外提 (Loop Unswitching)
+//
+
+#ifndef CODE_LOOP_UNSWITCH_H
+#define CODE_LOOP_UNSWITCH_H
+
+#include <IR.h>
+#include <dominance_analysis.h>
+#include <loop_analysis.h>
+#include <licm.h>
+
+//// ================================== 参数 ==================================
+
+#define LOOP_UNSWITCH_THRESHOLD 48      // 被复制的循环语句数上限
+#define LOOP_UNSWITCH_BUDGET 160        // 每个函数因复制循环增加的语句总数上限
+
+//// ================================== 外提方案 ==================================
+
+/**
+ * @brief 单个循环的外提方案，在修改函数之前确定。
+ */
+typedef struct UnswitchPlan {
+    Loop_ptr loop;
+    IR_block_ptr branch;    // 以不变条件 IF 结尾的循环块，两个目标都在循环内
+    unsigned size;          // 循环的语句数，即复制增加的语句数
+} UnswitchPlan;
+
+/**
+ * @brief 在循环中寻找可以外提的不变条件并确定外提方案。
+ * 要求循环可约且有预备首部，IF 的两个目标不同且都在循环内，操作数在循环（含内层循环）内都没有定义，
+ * 循环的语句数不超过阈值与剩余的预算。
+ * @param licm 已建立定义次数表的 LICM 分析器，用于判断操作数是否循环不变。
+ * @param loop 要外提条件的循环。
+ * @param budget 剩余可增加的语句数。
+ * @param plan 输出的外提方案。
+ * @return 找到可外提的条件时返回 true。
+ */
+extern bool LoopUnswitch_plan(LICMAnalyzer *licm, Loop_ptr loop, unsigned budget, UnswitchPlan *plan);
+
+/**
+ * @brief 按方案外提条件：复制整个循环，原循环中的条件改为跳向真分支，副本中改为跳向假分支（判断同一条件的其他 IF 同样处理），
+ * 预备首部末尾判断一次条件选择进入哪个版本。复制块放在原循环之后并使用新的标签，
+ * 之后删除两个版本中不再可达的块并重建函数的CFG（前驱/后继表与标签表）。
+ * 调用后 loop 以及依赖CFG的分析结果全部失效。
+ */
+extern void LoopUnswitch_unswitch(IR_function *func, const UnswitchPlan *plan);
+
+//// ================================== 高层接口 ==================================
+
+/**
+ * @brief 反复在函数的循环中外提不变条件（自内向外选择第一个可外提的循环），直到没有可外提的条件或预算用尽。
+ * 每次外提后原地重新计算支配关系与循环信息（包括预备首部）。
+ * @param func 要优化的函数。
+ * @param dom_analyzer 已完成计算的支配节点分析器。
+ * @param loop_analyzer 已完成检测并创建了预备首部的循环分析器。
+ * @return 函数是否被修改。
+ */
+extern bool perform_loop_unswitching(IR_function *func, DominanceAnalyzer *dom_analyzer, LoopAnalyzer *loop_analyzer);
+
+#endif //CODE_LOOP_UNSWITCH_H
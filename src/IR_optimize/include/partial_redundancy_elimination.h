@@ -0,0 +1,135 @@
+//
+// Created by Assistant
+// 部分冗余消除 (Partial Redundancy Elimination) - 惰性代码移动 (Lazy Code Motion)
+//
+
+#ifndef CODE_PARTIAL_REDUNDANCY_ELIMINATION_H
+#define CODE_PARTIAL_REDUNDANCY_ELIMINATION_H
+
+#include <dataflow_analysis.h>
+#include <available_expressions_analysis.h> // 复用 Expr / Fact_set_var / mapExprKill 等类型
+#include <dominance_analysis.h>             // Set_IR_block_ptr
+
+//// ================================== 数据结构 ==================================
+
+// 定义从表达式的代表变量 (IR_var) 到表达式 (Expr) 的映射，用于在插入点重新生成计算语句
+DEF_MAP(IR_var, Expr)
+
+/**
+ * @brief 部分冗余消除的全局状态。
+ * 每个表达式 e 对应唯一的代表变量 t_e，所有对 e 的计算都写入 t_e（形如 t_e := a op b），
+ * 因此数据流事实可以直接用 t_e 的集合 (Fact_set_var) 表示。
+ * 局部属性与各轮数据流分析的结果都以“基本块 -> 表达式集合”的形式保存，
+ * 供后续分析与最终的插入/删除阶段使用。
+ */
+typedef struct PartialRedundancyElimination {
+    IR_function *func;                       // 当前处理的函数
+
+    Map_Expr_IR_var mapExpr;                 // 表达式 -> 代表变量 t_e
+    Map_IR_var_Expr mapVarExpr;              // 代表变量 t_e -> 表达式
+    Map_IR_var_Vec_ptr_IR_var mapExprKill;   // 变量 v -> 以 v 为操作数的表达式（v 被定义时被 kill）
+    Set_IR_var universe;                     // 全部表达式（全集，用于处理 TOP 与求补）
+
+    Set_IR_block_ptr reachable;              // 从入口可达的基本块
+    Set_IR_block_ptr reach_exit;             // 可以到达出口的基本块（保证插入的向下安全性）
+
+    // 局部属性
+    Map_IR_block_ptr_Set_ptr_IR_var e_use;   // 块内向上暴露的表达式计算 (ANTLOC)
+    Map_IR_block_ptr_Set_ptr_IR_var e_kill;  // 块内有操作数被重新定义的表达式 (¬TRANSP)
+
+    // 各轮分析的结果
+    Map_IR_block_ptr_Set_ptr_IR_var anticipated_in;  // 预期表达式 IN
+    Map_IR_block_ptr_Set_ptr_IR_var earliest;        // earliest[B] = anticipated.in[B] - available.in[B]
+    Map_IR_block_ptr_Set_ptr_IR_var postponable_in;  // 可后延表达式 IN
+    Map_IR_block_ptr_Set_ptr_IR_var latest;          // latest[B]
+    Map_IR_block_ptr_Set_ptr_IR_var used_out;        // 被使用表达式 OUT
+
+    List_IR_block_ptr split_blocks;          // 拆分关键边时新建的基本块
+} PartialRedundancyElimination;
+
+/**
+ * @brief 初始化部分冗余消除的状态。
+ * @param t 指向要初始化的 PartialRedundancyElimination 实例的指针。
+ * @param func 要优化的函数。
+ */
+extern void PartialRedundancyElimination_init(PartialRedundancyElimination *t, IR_function *func);
+
+/**
+ * @brief 析构部分冗余消除的状态，释放所有集合与映射。
+ * @param t 指向要析构的 PartialRedundancyElimination 实例的指针。
+ */
+extern void PartialRedundancyElimination_teardown(PartialRedundancyElimination *t);
+
+//// ================================== 惰性代码移动的数据流分析 ==================================
+
+typedef struct LazyCodeMotionAnalysis LazyCodeMotionAnalysis;
+
+/**
+ * @brief 惰性代码移动各轮数据流分析的公共结构。
+ * 四轮分析（预期表达式、可用表达式、可后延表达式、被使用表达式）共享同一布局，
+ * 只有虚函数表中的方向、meet 与传递函数不同。事实类型均为 Fact_set_var。
+ */
+struct LazyCodeMotionAnalysis {
+    struct LazyCodeMotionAnalysis_virtualTable {
+        void (*teardown) (LazyCodeMotionAnalysis *t);
+        bool (*isForward) (LazyCodeMotionAnalysis *t);
+        Fact_set_var *(*newBoundaryFact) (LazyCodeMotionAnalysis *t, IR_function *func);
+        Fact_set_var *(*newInitialFact) (LazyCodeMotionAnalysis *t);
+        void (*setInFact) (LazyCodeMotionAnalysis *t, IR_block *blk, Fact_set_var *fact);
+        void (*setOutFact) (LazyCodeMotionAnalysis *t, IR_block *blk, Fact_set_var *fact);
+        Fact_set_var *(*getInFact) (LazyCodeMotionAnalysis *t, IR_block *blk);
+        Fact_set_var *(*getOutFact) (LazyCodeMotionAnalysis *t, IR_block *blk);
+        bool (*meetInto) (LazyCodeMotionAnalysis *t, Fact_set_var *fact, Fact_set_var *target);
+        bool (*transferBlock) (LazyCodeMotionAnalysis *t, IR_block *block, Fact_set_var *in_fact, Fact_set_var *out_fact);
+        void (*printResult) (LazyCodeMotionAnalysis *t, IR_function *func);
+    } const *vTable;
+
+    PartialRedundancyElimination *pre;                 // 共享的局部属性与前几轮结果
+    Map_IR_block_ptr_Fact_set_var_ptr mapInFact, mapOutFact;
+};
+
+typedef LazyCodeMotionAnalysis AnticipatedExpressionsAnalysis;
+typedef LazyCodeMotionAnalysis WillBeAvailableExpressionsAnalysis;
+typedef LazyCodeMotionAnalysis PostponableExpressionsAnalysis;
+typedef LazyCodeMotionAnalysis UsedExpressionsAnalysis;
+
+/**
+ * @brief 预期表达式分析（后向，must）。
+ * IN[B] = e_use[B] ∪ (OUT[B] - e_kill[B])，OUT[B] = ∩ IN[S]。
+ * 无法到达出口的块（死循环）视 OUT 为空集，以保证插入的向下安全性。
+ */
+extern void AnticipatedExpressionsAnalysis_init(AnticipatedExpressionsAnalysis *t, PartialRedundancyElimination *pre);
+
+/**
+ * @brief “将可用”表达式分析（前向，must）。
+ * OUT[B] = (anticipated.in[B] ∪ IN[B]) - e_kill[B]，IN[B] = ∩ OUT[P]。
+ */
+extern void WillBeAvailableExpressionsAnalysis_init(WillBeAvailableExpressionsAnalysis *t, PartialRedundancyElimination *pre);
+
+/**
+ * @brief 可后延表达式分析（前向，must）。
+ * OUT[B] = (earliest[B] ∪ IN[B]) - e_use[B]，IN[B] = ∩ OUT[P]。
+ */
+extern void PostponableExpressionsAnalysis_init(PostponableExpressionsAnalysis *t, PartialRedundancyElimination *pre);
+
+/**
+ * @brief 被使用表达式分析（后向，may）。
+ * IN[B] = (e_use[B] ∪ OUT[B]) - latest[B]，OUT[B] = ∪ IN[S]。
+ */
+extern void UsedExpressionsAnalysis_init(UsedExpressionsAnalysis *t, PartialRedundancyElimination *pre);
+
+//// ================================== 优化入口 ==================================
+
+/**
+ * @brief 对函数执行基于惰性代码移动的部分冗余消除。
+ * 1. 规范化：保证每个表达式的所有计算都写入同一代表变量 t_e；
+ * 2. 拆分关键边；
+ * 3. 依次求解预期、可用、可后延、被使用四轮数据流，计算 earliest/latest；
+ * 4. 在 latest[B] ∩ used.out[B] 处插入 t_e := e，删除已被覆盖的向上暴露计算；
+ * 5. 撤销未插入任何代码的关键边拆分。
+ * @param t 指向已初始化的 PartialRedundancyElimination 实例的指针。
+ * @return 如果函数被修改返回 true。
+ */
+extern bool PartialRedundancyElimination_lazy_code_motion(PartialRedundancyElimination *t);
+
+#endif //CODE_PARTIAL_REDUNDANCY_ELIMINATION_H
@@ -0,0 +1,87 @@
+//
+// Created by Assistant
+// 冗余加载消除 (Redundant Load Elimination)
+//
+
+#ifndef CODE_REDUNDANT_LOAD_ELIMINATION_H
+#define CODE_REDUNDANT_LOAD_ELIMINATION_H
+
+#include <dataflow_analysis.h>
+#include <scalar_promotion.h>       // MemLocation, 地址解析与别名判断
+
+/**
+ * @brief 内存位置：某个 DEC 声明的地址变量加常量字节偏移。
+ */
+typedef struct {
+    IR_var base;            // DEC 声明的地址变量 (dec_addr)
+    int offset;             // 相对基址的字节偏移
+} MemKey;
+
+/**
+ * @brief 比较两个 MemKey，约定与 Expr_CMP 相同：相等返回 -1。
+ */
+extern int MemKey_CMP(MemKey a, MemKey b);
+
+// 内存位置 -> 该位置当前保存的值（常量或保存该值的变量）
+DEF_MAP_CMP(MemKey, IR_val, MemKey_CMP)
+
+/**
+ * @brief 可用内存值分析的数据流事实。
+ * 表中的 key -> val 表示在此处 *key 的值一定等于 val。
+ * is_top = true 表示全集 (TOP)，此时表为空。
+ */
+typedef struct {
+    bool is_top;
+    Map_MemKey_IR_val values;
+} Fact_mem_value, *Fact_mem_value_ptr;
+
+extern void Fact_mem_value_init(Fact_mem_value *fact, bool is_top);
+
+extern void Fact_mem_value_teardown(Fact_mem_value *fact);
+
+DEF_MAP(IR_block_ptr, Fact_mem_value_ptr)
+
+typedef struct RedundantLoadElimination RedundantLoadElimination;
+
+/**
+ * @brief 可用内存值分析（前向、must 分析，meet 为值相同的表项取交集）。
+ * STORE 写入常量偏移的位置时生成 位置 -> 写入的值，LOAD 读取没有可用值的位置时生成 位置 -> 读到的变量；
+ * 可能与之重叠的 STORE 杀死表项，函数调用杀死基址逃逸的表项，重新定义保存值的变量同样杀死表项。
+ * 地址解析与别名判断使用标量提升器的函数级逃逸信息。
+ */
+typedef struct RedundantLoadElimination {
+    struct RedundantLoadElimination_virtualTable {
+        void (*teardown) (RedundantLoadElimination *t);
+        bool (*isForward) (RedundantLoadElimination *t);
+        Fact_mem_value *(*newBoundaryFact) (RedundantLoadElimination *t, IR_function *func);
+        Fact_mem_value *(*newInitialFact) (RedundantLoadElimination *t);
+        void (*setInFact) (RedundantLoadElimination *t, IR_block *blk, Fact_mem_value *fact);
+        void (*setOutFact) (RedundantLoadElimination *t, IR_block *blk, Fact_mem_value *fact);
+        Fact_mem_value *(*getInFact) (RedundantLoadElimination *t, IR_block *blk);
+        Fact_mem_value *(*getOutFact) (RedundantLoadElimination *t, IR_block *blk);
+        bool (*meetInto) (RedundantLoadElimination *t, Fact_mem_value *fact, Fact_mem_value *target);
+        bool (*transferBlock) (RedundantLoadElimination *t, IR_block *block, Fact_mem_value *in_fact, Fact_mem_value *out_fact);
+        void (*printResult) (RedundantLoadElimination *t, IR_function *func);
+    } const *vTable;
+    ScalarPromoter promoter;                                // 地址解析与别名判断
+    Map_IR_block_ptr_Fact_mem_value_ptr mapInFact, mapOutFact;
+} RedundantLoadElimination;
+
+/**
+ * @brief 初始化分析，为函数建立地址解析所需的定义-使用索引与逃逸信息。
+ */
+extern void RedundantLoadElimination_init(RedundantLoadElimination *t, IR_function *func);
+
+/**
+ * @brief 单条语句对数据流事实的影响。
+ */
+extern void RedundantLoadElimination_transferStmt(RedundantLoadElimination *t, IR_stmt *stmt, Fact_mem_value *fact);
+
+/**
+ * @brief 根据分析结果把位置上已有可用值的 LOAD 改为复制语句 x := val。
+ * 先找出所有可替换的 LOAD 再统一替换，替换时不再解析地址。
+ * @return 是否有 LOAD 被替换。
+ */
+extern bool RedundantLoadElimination_replace_redundant_load(RedundantLoadElimination *t, IR_function *func);
+
+#endif //CODE_REDUNDANT_LOAD_ELIMINATION_H
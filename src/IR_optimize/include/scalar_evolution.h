@@ -0,0 +1,171 @@
+//
+// Created by Assistant
+// 标量演化分析 (Scalar Evolution Analysis)
+//
+
+#ifndef CODE_SCALAR_EVOLUTION_H
+#define CODE_SCALAR_EVOLUTION_H
+
+#include <IR.h>
+#include <dataflow_analysis.h>
+#include <def_use_chain.h>
+#include <loop_analysis.h>
+
+//// ================================== 表达式 ==================================
+
+typedef enum {
+    SCEV_CONSTANT,           // 整数常量
+    SCEV_UNKNOWN,            // 变量在所处最外层循环入口处的值，在整个循环嵌套内不变
+    SCEV_ADD,                // op1 + op2
+    SCEV_MUL,                // op1 * op2
+    SCEV_ADD_REC,            // 加法递推 {op1, +, op2}<loop>：第 k 次迭代的值为 op1 + op2 的前 k 项之和
+    SCEV_RECURRENCE,         // 正在求解的循环头值的占位，只在分析内部出现
+    SCEV_COULD_NOT_COMPUTE   // 无法用上述形式表示
+} SCEV_kind;
+
+/**
+ * @brief 标量演化表达式。
+ * 结点由 ScalarEvolution 统一分配与释放，彼此共享，调用者不应修改。
+ * 加法与乘法在构造时折叠：常量合并，循环不变量并入最内层递推的初值，
+ * 与常量或循环不变量的乘法分配到递推的初值与步长上。
+ */
+typedef struct SCEV SCEV, *SCEV_ptr;
+struct SCEV {
+    SCEV_kind kind;
+    int value;                // SCEV_CONSTANT 的值
+    IR_var var;               // SCEV_UNKNOWN / SCEV_RECURRENCE 对应的变量
+    SCEV *op1, *op2;          // SCEV_ADD / SCEV_MUL 的操作数；SCEV_ADD_REC 的初值与步长
+    Loop_ptr loop;            // SCEV_ADD_REC / SCEV_RECURRENCE 所属的循环
+};
+
+DEF_LIST(SCEV_ptr)
+DEF_MAP(IR_var, SCEV_ptr)       // 变量 -> 表达式
+DEF_MAP(IR_stmt_ptr, SCEV_ptr)  // 定义语句 -> 所定义的值
+
+//// ================================== 分析器 ==================================
+
+/**
+ * @brief 单个循环的分析结果缓存。
+ */
+typedef struct LoopSCEVInfo {
+    Map_IR_var_SCEV_ptr header_values;  // 变量 -> 每次迭代开始（进入循环头）时的值
+    Map_IR_var_SCEV_ptr in_progress;    // 正在求解的变量 -> 代表其自身的占位
+    bool trip_count_computed;           // 下面两项是否已计算
+    SCEV_ptr backedge_taken;            // 回边执行次数，未知时为 SCEV_COULD_NOT_COMPUTE
+    int max_backedge_taken;             // 回边执行次数的上界，-1 表示未知
+} LoopSCEVInfo, *LoopSCEVInfo_ptr;
+
+DEF_MAP(Loop_ptr, LoopSCEVInfo_ptr)
+
+/**
+ * @brief 标量演化分析器。
+ * 在非 SSA 的 IR 上按需求值：查询某点的变量值时，在当前循环一次迭代内（不经过循环头）向上寻找到达定义，
+ * 唯一到达定义递归求值，没有定义到达则取循环头值；循环头值由各回边源末尾的值识别为 {初值, +, 步长}，
+ * 初值在外层循环中求出，因此内层递推的初值可以是外层递推，步长可以是非常量的循环不变量。
+ * 顶层（不在任何循环内）只做常量求值，其余一律视为 SCEV_UNKNOWN。
+ * 结果按循环缓存，分析期间函数不能被修改；假设归纳变量不发生有符号溢出。
+ */
+typedef struct ScalarEvolution {
+    IR_function *function;
+    LoopAnalyzer *loop_analyzer;              // 已完成的循环分析（需要其支配信息）
+    Map_Loop_ptr_LoopSCEVInfo_ptr loop_info;  // 循环 -> 分析结果
+    Map_IR_stmt_ptr_SCEV_ptr stmt_values;     // 定义语句 -> 所定义的值（不含占位的结果才缓存）
+    Set_IR_stmt_ptr evaluating;               // 正在求值的定义语句，用于截断不可达代码中的环
+    List_SCEV_ptr nodes;                      // 所有分配的结点
+    SCEV could_not_compute;                   // 共享的 SCEV_COULD_NOT_COMPUTE 结点
+} ScalarEvolution;
+
+//// ================================== 构造与析构 ==================================
+
+/**
+ * @brief 初始化标量演化分析器，不做任何计算。
+ * @param se 分析器。
+ * @param func 要分析的函数。
+ * @param loop_analyzer 已检测出循环的循环分析器。
+ */
+extern void ScalarEvolution_init(ScalarEvolution *se, IR_function *func, LoopAnalyzer *loop_analyzer);
+
+/**
+ * @brief 释放分析器及其分配的所有表达式结点。
+ */
+extern void ScalarEvolution_teardown(ScalarEvolution *se);
+
+//// ================================== 表达式构造 ==================================
+
+extern SCEV *ScalarEvolution_get_constant(ScalarEvolution *se, int value);
+
+extern SCEV *ScalarEvolution_get_add(ScalarEvolution *se, SCEV *a, SCEV *b);
+
+extern SCEV *ScalarEvolution_get_minus(ScalarEvolution *se, SCEV *a, SCEV *b);
+
+extern SCEV *ScalarEvolution_get_mul(ScalarEvolution *se, SCEV *a, SCEV *b);
+
+/**
+ * @brief 构造 {start, +, step}<loop>；步长为 0 时直接返回初值。
+ */
+extern SCEV *ScalarEvolution_get_add_rec(ScalarEvolution *se, SCEV *start, SCEV *step, Loop_ptr loop);
+
+//// ================================== 查询 ==================================
+
+/**
+ * @brief 获取变量在循环每次迭代开始时的值。
+ * @return 循环内没有定义时为进入循环时的值；是递推时为 SCEV_ADD_REC；否则为 SCEV_COULD_NOT_COMPUTE。
+ */
+extern SCEV *ScalarEvolution_get_header_value(ScalarEvolution *se, Loop_ptr loop, IR_var var);
+
+/**
+ * @brief 获取变量在语句 stmt 执行前的值。
+ * @param blk stmt 所在的基本块。
+ * @param stmt 查询位置；为 NULL 表示基本块末尾。
+ */
+extern SCEV *ScalarEvolution_get_value_at(ScalarEvolution *se, IR_block_ptr blk, IR_stmt *stmt, IR_var var);
+
+/**
+ * @brief 获取循环回边的执行次数（循环头执行次数减一）。
+ * 由每次迭代都执行的退出块末尾的 IF 比较计算：一侧为常量步长的递推、另一侧为循环不变量。
+ * 多个出口时取各出口的最小值，此时只有全部出口都能算出常量才给出精确结果。
+ * 非常量的结果仅在步长为 ±1 时给出，并且只在循环至少回边一次时成立，使用者需要自行保证。
+ * @return 回边次数；无法计算时为 SCEV_COULD_NOT_COMPUTE。
+ */
+extern SCEV *ScalarEvolution_get_backedge_taken_count(ScalarEvolution *se, Loop_ptr loop);
+
+/**
+ * @brief 获取循环的常量执行次数（循环头执行的次数）。
+ * @return 能确定为常量时返回 true 并写入 trip_count。
+ */
+extern bool ScalarEvolution_get_constant_trip_count(ScalarEvolution *se, Loop_ptr loop, unsigned *trip_count);
+
+/**
+ * @brief 获取循环执行次数的常量上界，精确次数未知时也可能存在（如多个出口中的一个可计算）。
+ * @return 存在上界时返回 true 并写入 trip_count。
+ */
+extern bool ScalarEvolution_get_max_trip_count(ScalarEvolution *se, Loop_ptr loop, unsigned *trip_count);
+
+/**
+ * @brief 计算仿射递推在第 iteration 次迭代（从 0 开始）时的值。
+ * @return rec 不是以循环不变量为步长的递推时，若 rec 本身在该循环内不变则原样返回，否则为 SCEV_COULD_NOT_COMPUTE。
+ */
+extern SCEV *ScalarEvolution_evaluate_at_iteration(ScalarEvolution *se, SCEV *rec, Loop_ptr loop, SCEV *iteration);
+
+//// ================================== 表达式性质 ==================================
+
+/**
+ * @brief 判断表达式在循环 loop 内是否不变（不含该循环及其内层循环的递推）。
+ */
+extern bool SCEV_is_invariant(SCEV *scev, Loop_ptr loop);
+
+/**
+ * @brief 判断两个表达式结构是否相同。
+ */
+extern bool SCEV_equal(SCEV *a, SCEV *b);
+
+//// ================================== 结果输出 ==================================
+
+extern void SCEV_print(SCEV *scev, FILE *out);
+
+/**
+ * @brief 打印每个循环的回边次数以及循环内被定义变量的循环头值。
+ */
+extern void ScalarEvolution_print_result(ScalarEvolution *se, FILE *out);
+
+#endif //CODE_SCALAR_EVOLUTION_H
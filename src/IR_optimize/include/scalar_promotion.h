@@ -0,0 +1,86 @@
+//
+// Created by Assistant
+// 标量提升 (Scalar Promotion)
+//
+
+#ifndef CODE_SCALAR_PROMOTION_H
+#define CODE_SCALAR_PROMOTION_H
+
+#include <IR.h>
+#include <dataflow_analysis.h>
+#include <dominance_analysis.h>
+#include <loop_analysis.h>
+#include <def_use_chain.h>
+
+//// ================================== 地址解析 ==================================
+
+/**
+ * @brief 访存地址沿唯一定义链解析的结果：基址为某个 DEC 声明的地址变量，偏移可能未知。
+ * 基址未知时该访问可能指向任何逃逸的声明，或者地址由某个声明推导而来。
+ */
+typedef struct {
+    bool known_base;        // 是否解析到 DEC 基址
+    bool known_offset;      // 偏移是否为常量
+    IR_var base;            // DEC 声明的地址变量 (dec_addr)
+    int offset;             // 相对基址的字节偏移
+} MemLocation;
+
+/**
+ * @brief 标量提升器
+ * 函数级的别名信息：一个声明的地址被作为值存入内存、作为实参传递或返回时视为逃逸，
+ * 从声明地址出发经计算得到的变量记为"可能指向声明"。
+ */
+typedef struct ScalarPromoter {
+    IR_function *function;                  // 当前处理的函数
+    LoopAnalyzer *loop_analyzer;            // 循环分析器（已创建预备首部）
+    DefUseChain def_use;                    // 定义-使用索引
+    Map_IR_var_IR_Dec addr_dec;             // 声明的地址变量 -> 声明信息
+    Set_IR_var escaped;                     // 地址逃逸的声明（以地址变量表示）
+    Set_IR_var derived;                     // 可能指向某个声明的变量（含地址变量本身）
+    bool split_edges;                       // 是否拆分过退出边（循环信息需要重新计算）
+} ScalarPromoter;
+
+/**
+ * @brief 初始化标量提升器，建立定义-使用索引与函数级的逃逸信息
+ */
+extern void ScalarPromoter_init(ScalarPromoter *t, IR_function *func, LoopAnalyzer *loop_analyzer);
+
+/**
+ * @brief 析构标量提升器
+ */
+extern void ScalarPromoter_teardown(ScalarPromoter *t);
+
+/**
+ * @brief 沿唯一定义链（赋值、加减常量、加变量偏移）解析地址 addr 指向的位置
+ */
+extern MemLocation ScalarPromoter_resolve(ScalarPromoter *t, IR_val addr);
+
+/**
+ * @brief 判断两个访问位置是否可能重叠（每次访问 4 字节）
+ */
+extern bool ScalarPromoter_may_alias(ScalarPromoter *t, MemLocation a, IR_val a_addr,
+                                     MemLocation b, IR_val b_addr);
+
+//// ================================== 单个循环 ==================================
+
+/**
+ * @brief 提升循环中所有可提升的内存位置。
+ * 位置须是某个声明内的常量偏移，循环内的其他访存都不可能与它重叠，
+ * 循环内有函数调用时声明不能逃逸。提升后在预备首部读入新变量，
+ * 循环内的读写改为对该变量的赋值，有写入时在每条退出边上写回（必要时拆分退出边）。
+ * 循环需要有预备首部。
+ * @return 是否有位置被提升。
+ */
+extern bool ScalarPromoter_promote_loop(ScalarPromoter *t, Loop_ptr loop);
+
+//// ================================== 高层接口 ==================================
+
+/**
+ * @brief 自内向外对函数中所有循环执行标量提升。
+ * 内层循环的读入与写回位于外层循环内，可以在外层继续被提升。
+ * 拆分过退出边时原地重新计算支配关系与循环信息（包括预备首部）。
+ * @return 函数是否被修改。
+ */
+extern bool perform_scalar_promotion(IR_function *func, DominanceAnalyzer *dom_analyzer, LoopAnalyzer *loop_analyzer);
+
+#endif //CODE_SCALAR_PROMOTION_H
@@ -0,0 +1,41 @@
+//
+// Created by Assistant
+// 静态单赋值形式 (Static Single Assignment Form)
+//
+
+#ifndef CODE_SSA_H
+#define CODE_SSA_H
+
+#include <IR.h>
+#include <dataflow_analysis.h>
+#include <dominance_analysis.h>
+#include <live_variable_analysis.h>
+#include <var_map.h>
+#include <available_expressions_analysis.h>   // Map_IR_var_Vec_ptr_IR_var
+
+typedef Set_IR_block_ptr *Set_ptr_IR_block_ptr;
+DEF_MAP(IR_var, Set_ptr_IR_block_ptr)  // 变量 -> 定义它的基本块集合
+
+/**
+ * @brief 将函数转换为剪枝 SSA 形式。
+ * 对每个被定义的变量，在其定义块集合的迭代支配边界中、且该变量在块入口活跃的位置插入 φ 函数，
+ * 然后沿支配树先序遍历为每个定义分配新名字并改写使用。
+ * 函数参数与未定义即使用的变量以原名作为初始版本；DEC 变量及其地址变量不参与改名。
+ * 转换后的函数含有 IR_PHI_STMT，除本模块外的优化遍均不识别 φ 函数，
+ * 在运行它们之前必须先调用 SSA_destruct。需要在 CFG 已构建的函数上调用。
+ * @param func 要转换的函数。
+ * @return 插入的 φ 函数个数。
+ */
+extern unsigned SSA_construct(IR_function *func);
+
+/**
+ * @brief 将 SSA 形式的函数转换回普通形式。
+ * 对每个含 φ 函数的块的每条入边，把该边上的 φ 参数作为一组并行复制插入前驱末尾
+ * （前驱有多个后继时先拆分该边，避免复制影响其他后继），
+ * 按依赖顺序串行化为 IR_assign_stmt，遇到循环依赖时引入临时变量，最后删除所有 φ 函数。
+ * 产生的多余复制留给复制传播与复制合并清理。
+ * @param func 要转换的函数。
+ */
+extern void SSA_destruct(IR_function *func);
+
+#endif //CODE_SSA_H
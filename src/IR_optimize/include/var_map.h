@@ -0,0 +1,15 @@
+//
+// Created by Assistant
+// 变量映射 (Variable Map)
+//
+
+#ifndef CODE_VAR_MAP_H
+#define CODE_VAR_MAP_H
+
+#include <IR.h>
+
+// 定义从 IR_var 到 IR_var 的映射 (Map_IR_var_IR_var)
+// 复制合并用它表示并查集的父结点与值来源, SSA 用它记录新变量对应的原变量
+DEF_MAP(IR_var, IR_var)
+
+#endif //CODE_VAR_MAP_H
@@ -47,6 +47,8 @@ void BasicInductionVariable_init(BasicInductionVariable_ptr basic_iv,
     basic_iv->increment_stmt = increment_stmt;
     basic_iv->step = step;
     basic_iv->is_increment = is_increment;
+    List_IR_stmt_ptr_init(&basic_iv->increment_stmts);
+    if (increment_stmt) VCALL(basic_iv->increment_stmts, push_back, increment_stmt);
 }
 
 void DerivedInductionVariable_init(DerivedInductionVariable_ptr derived_iv,
@@ -61,6 +63,8 @@ void DerivedInductionVariable_init(DerivedInductionVariable_ptr derived_iv,
     derived_iv->basic_iv = basic_iv;
     derived_iv->coefficient = coefficient;
     derived_iv->constant = constant;
+    derived_iv->base = IR_VAR_NONE;
+    derived_iv->invariant = IR_VAR_NONE;
     derived_iv->definition_stmt = definition_stmt;
 }
 
@@ -72,6 +76,7 @@ void LoopInductionVariables_init(LoopInductionVariables_ptr loop_ivs, Loop_ptr l
     List_DerivedInductionVariable_ptr_init(&loop_ivs->derived_ivs);
     Map_IR_var_BasicInductionVariable_ptr_init(&loop_ivs->basic_iv_map);
     Map_IR_var_DerivedInductionVariable_ptr_init(&loop_ivs->derived_iv_map);
+    Map_IR_var_List_ptr_IR_stmt_ptr_init(&loop_ivs->def_sites);
 }
 
 void LoopInductionVariables_teardown(LoopInductionVariables_ptr loop_ivs) {
@@ -80,6 +85,7 @@ void LoopInductionVariables_teardown(LoopInductionVariables_ptr loop_ivs) {
     // 释放基本归纳变量
     ListNode_BasicInductionVariable_ptr *basic_node = loop_ivs->basic_ivs.head;
     while (basic_node) {
+        List_IR_stmt_ptr_teardown(&basic_node->val->increment_stmts);
         free(basic_node->val);
         basic_node = basic_node->nxt;
     }
@@ -96,6 +102,13 @@ void LoopInductionVariables_teardown(LoopInductionVariables_ptr loop_ivs) {
     Map_IR_var_BasicInductionVariable_ptr_teardown(&loop_ivs->basic_iv_map);
     Map_IR_var_DerivedInductionVariable_ptr_teardown(&loop_ivs->derived_iv_map);
     
+    // 释放定义点索引
+    for_map(IR_var, List_ptr_IR_stmt_ptr, site_node, loop_ivs->def_sites) {
+        List_IR_stmt_ptr_teardown(site_node->val);
+        free(site_node->val);
+    }
+    Map_IR_var_List_ptr_IR_stmt_ptr_teardown(&loop_ivs->def_sites);
+    
     loop_ivs->loop = NULL;
 }
 
@@ -108,10 +121,13 @@ void InductionVariableAnalyzer_init(InductionVariableAnalyzer *analyzer,
     
     analyzer->function = func;
     analyzer->loop_analyzer = loop_analyzer;
+    DefUseChain_init(&analyzer->def_use, func);
     
     List_LoopInductionVariables_ptr_init(&analyzer->loop_ivs);
+    Map_Loop_ptr_LoopInductionVariables_ptr_init(&analyzer->loop_iv_map);
     Map_IR_var_BasicInductionVariable_ptr_init(&analyzer->global_basic_iv_map);
     Map_IR_var_DerivedInductionVariable_ptr_init(&analyzer->global_derived_iv_map);
+    Map_IR_stmt_ptr_LinearForm_init(&analyzer->forms);
 }
 
 void InductionVariableAnalyzer_teardown(InductionVariableAnalyzer *analyzer) {
@@ -126,496 +142,347 @@ void InductionVariableAnalyzer_teardown(InductionVariableAnalyzer *analyzer) {
     }
     
     List_LoopInductionVariables_ptr_teardown(&analyzer->loop_ivs);
+    Map_Loop_ptr_LoopInductionVariables_ptr_teardown(&analyzer->loop_iv_map);
     Map_IR_var_BasicInductionVariable_ptr_teardown(&analyzer->global_basic_iv_map);
     Map_IR_var_DerivedInductionVariable_ptr_teardown(&analyzer->global_derived_iv_map);
+    Map_IR_stmt_ptr_LinearForm_teardown(&analyzer->forms);
+    DefUseChain_teardown(&analyzer->def_use);
     
     analyzer->function = NULL;
     analyzer->loop_analyzer = NULL;
 }
 
-//// ================================== 基本归纳变量识别 ==================================
+//// ================================== 线性形式 ==================================
+
+static LinearForm LinearForm_unknown() {
+    LinearForm form = {.known = false};
+    return form;
+}
+
+static LinearForm LinearForm_constant(int value) {
+    LinearForm form = {.known = true, .term_cnt = 0, .constant = value};
+    return form;
+}
+
+static LinearForm LinearForm_variable(IR_var var) {
+    LinearForm form = {.known = true, .term_cnt = 1, .constant = 0};
+    form.var[0] = var;
+    form.coefficient[0] = 1;
+    return form;
+}
 
 /**
- * @brief 检查语句是否为基本归纳变量的增量操作
- * 形如 i = i + c 或 i = i - c，或者通过临时变量的间接更新
+ * @brief form += scale * other，项数超过上限时形式未知
  */
-static bool is_basic_induction_increment(IR_stmt *stmt, 
-                                        IR_var *variable, 
-                                        int *step, 
-                                        bool *is_increment) {
-    if (!stmt) return false;
-    
-    // 情况1: 直接的算术操作 i = i + c 或 i = i - c
-    if (stmt->stmt_type == IR_OP_STMT) {
-        IR_op_stmt *op_stmt = (IR_op_stmt*)stmt;
-        
-        // 检查操作类型是否为加法或减法
-        if (op_stmt->op != IR_OP_ADD && op_stmt->op != IR_OP_SUB) return false;
-        
-        // 检查左操作数是否为变量且与目标变量相同
-        if (op_stmt->rs1.is_const || op_stmt->rs1.var != op_stmt->rd) return false;
-        
-        // 检查右操作数是否为常数
-        if (!op_stmt->rs2.is_const) return false;
-        
-        *variable = op_stmt->rd;
-        *step = op_stmt->rs2.const_val;
-        *is_increment = (op_stmt->op == IR_OP_ADD);
-        
-        // 如果是减法，步长应为负数
-        if (!(*is_increment)) {
-            *step = -(*step);
-        }
-        
-        return true;
+static void LinearForm_add_scaled(LinearForm *form, LinearForm other, int scale) {
+    if (!form->known || !other.known) {
+        form->known = false;
+        return;
     }
-    // 情况2: 赋值语句 i = temp（需要检查temp是否来自i的增量）
-    else if (stmt->stmt_type == IR_ASSIGN_STMT) {
-        IR_assign_stmt *assign_stmt = (IR_assign_stmt*)stmt;
-        
-        // 必须是变量赋值，不能是常量赋值
-        if (assign_stmt->rs.is_const) return false;
-        
-        *variable = assign_stmt->rd;
-        // 标记这是一个可能的间接更新，需要进一步检查
-        // 这里返回false，让调用者去检查是否存在对应的增量操作
-        return false;
+    form->constant += scale * other.constant;
+    for (unsigned k = 0; k < other.term_cnt; k++) {
+        unsigned j = 0;
+        while (j < form->term_cnt && form->var[j] != other.var[k]) j++;
+        if (j == form->term_cnt) {
+            if (form->term_cnt == LINEAR_FORM_MAX_TERMS) {
+                form->known = false;
+                return;
+            }
+            form->var[j] = other.var[k];
+            form->coefficient[j] = 0;
+            form->term_cnt++;
+        }
+        form->coefficient[j] += scale * other.coefficient[k];
+        if (form->coefficient[j] == 0) {    // 系数抵消为 0 时删除该项
+            form->term_cnt--;
+            form->var[j] = form->var[form->term_cnt];
+            form->coefficient[j] = form->coefficient[form->term_cnt];
+        }
     }
-    
-    return false;
 }
 
 /**
- * @brief 检查是否存在间接的归纳变量更新模式
- * 形如 temp := var + c; var := temp
+ * @brief 操作数在块内当前位置的值，用块入口值的线性形式表示
+ */
+static LinearForm block_value(Map_IR_var_LinearForm *block_forms, IR_val val) {
+    if (val.is_const) return LinearForm_constant(val.const_val);
+    if (VCALL(*block_forms, exist, val.var)) return VCALL(*block_forms, get, val.var);
+    return LinearForm_variable(val.var);
+}
+
+/**
+ * @brief 定义语句所定义的值，用块入口值的线性形式表示
  */
-static bool is_indirect_induction_update(IR_block_ptr block, 
-                                        IR_stmt *assign_stmt,
-                                        IR_var *variable,
-                                        int *step,
-                                        bool *is_increment) {
-    if (!assign_stmt || assign_stmt->stmt_type != IR_ASSIGN_STMT) return false;
-    
-    IR_assign_stmt *assignment = (IR_assign_stmt*)assign_stmt;
-    if (assignment->rs.is_const) return false;
-    
-    IR_var target_var = assignment->rd;
-    IR_var temp_var = assignment->rs.var;
-    
-    // 在同一个基本块中向前查找temp_var的定义
-    ListNode_IR_stmt_ptr *current = NULL;
-    
-    // 找到当前赋值语句在列表中的位置
-    for (ListNode_IR_stmt_ptr *node = block->stmts.head; node; node = node->nxt) {
-        if (node->val == assign_stmt) {
-            current = node;
+static LinearForm block_definition_value(Map_IR_var_LinearForm *block_forms, IR_stmt *stmt) {
+    if (stmt->stmt_type == IR_ASSIGN_STMT)
+        return block_value(block_forms, ((IR_assign_stmt*)stmt)->rs);
+    if (stmt->stmt_type != IR_OP_STMT) return LinearForm_unknown();
+    
+    IR_op_stmt *op_stmt = (IR_op_stmt*)stmt;
+    LinearForm lhs = block_value(block_forms, op_stmt->rs1);
+    LinearForm rhs = block_value(block_forms, op_stmt->rs2);
+    LinearForm result = LinearForm_constant(0);
+    switch (op_stmt->op) {
+        case IR_OP_ADD:
+            LinearForm_add_scaled(&result, lhs, 1);
+            LinearForm_add_scaled(&result, rhs, 1);
+            break;
+        case IR_OP_SUB:
+            LinearForm_add_scaled(&result, lhs, 1);
+            LinearForm_add_scaled(&result, rhs, -1);
+            break;
+        case IR_OP_MUL:
+            // 只允许与常量相乘
+            if (lhs.known && lhs.term_cnt == 0) LinearForm_add_scaled(&result, rhs, lhs.constant);
+            else if (rhs.known && rhs.term_cnt == 0) LinearForm_add_scaled(&result, lhs, rhs.constant);
+            else result.known = false;
+            break;
+        case IR_OP_SHL:
+            // 左移常量位等价于乘 2 的幂
+            if (rhs.known && rhs.term_cnt == 0 && rhs.constant >= 0 && rhs.constant < 31)
+                LinearForm_add_scaled(&result, lhs, 1 << rhs.constant);
+            else result.known = false;
+            break;
+        default:
+            result.known = false;
             break;
-        }
     }
-    
-    if (!current) return false;
-    
-    // 向前查找temp_var的定义（在当前语句之前）
-    for (ListNode_IR_stmt_ptr *node = block->stmts.head; node != current; node = node->nxt) {
-        IR_stmt *stmt = node->val;
+    return result;
+}
+
+/**
+ * @brief 把块入口值的线性形式换算为当前值的线性形式
+ * 每一项的变量在块内没有被定义过，或者当前值为 入口值 + d 时才能换算
+ */
+static LinearForm to_current_values(Map_IR_var_LinearForm *block_forms, LinearForm form) {
+    if (!form.known) return form;
+    for (unsigned k = 0; k < form.term_cnt; k++) {
+        if (!VCALL(*block_forms, exist, form.var[k])) continue;
+        LinearForm current = VCALL(*block_forms, get, form.var[k]);
+        if (!current.known || current.term_cnt != 1 ||
+            current.var[0] != form.var[k] || current.coefficient[0] != 1)
+            return LinearForm_unknown();
+        form.constant -= form.coefficient[k] * current.constant;   // 入口值 = 当前值 - d
+    }
+    return form;
+}
+
+void InductionVariableAnalyzer_compute_linear_forms(InductionVariableAnalyzer *analyzer) {
+    Map_IR_var_LinearForm block_forms;
+    for_list(IR_block_ptr, block_node, analyzer->function->blocks) {
+        IR_block_ptr block = block_node->val;
+        if (!VCALL(analyzer->loop_analyzer->block_to_loop, exist, block)) continue;
         
-        if (stmt->stmt_type == IR_OP_STMT) {
-            IR_op_stmt *op_stmt = (IR_op_stmt*)stmt;
-            
-            // 检查是否是temp := target_var + c或temp := target_var - c
-            if (op_stmt->rd == temp_var && 
-                (op_stmt->op == IR_OP_ADD || op_stmt->op == IR_OP_SUB)) {
-                
-                // 检查左操作数是否为目标变量
-                if (!op_stmt->rs1.is_const && op_stmt->rs1.var == target_var &&
-                    op_stmt->rs2.is_const) {
-                    
-                    *variable = target_var;
-                    *step = op_stmt->rs2.const_val;
-                    *is_increment = (op_stmt->op == IR_OP_ADD);
-                    
-                    if (!(*is_increment)) {
-                        *step = -(*step);
-                    }
-                    
-                    return true;
-                }
-                // 检查右操作数是否为目标变量（交换律：c + target_var）
-                else if (op_stmt->op == IR_OP_ADD && 
-                        op_stmt->rs1.is_const && !op_stmt->rs2.is_const &&
-                        op_stmt->rs2.var == target_var) {
-                    
-                    *variable = target_var;
-                    *step = op_stmt->rs1.const_val;
-                    *is_increment = true;
-                    
-                    return true;
-                }
-            }
+        Map_IR_var_LinearForm_init(&block_forms);
+        for_list(IR_stmt_ptr, stmt_node, block->stmts) {
+            IR_stmt *stmt = stmt_node->val;
+            IR_var def = VCALL(*stmt, get_def);
+            if (def == IR_VAR_NONE) continue;
+            LinearForm value = block_definition_value(&block_forms, stmt);
+            VCALL(analyzer->forms, set, stmt, to_current_values(&block_forms, value));
+            VCALL(block_forms, set, def, value);
         }
+        Map_IR_var_LinearForm_teardown(&block_forms);
     }
-    
-    return false;
+}
+
+bool InductionVariableAnalyzer_get_linear_form(InductionVariableAnalyzer *analyzer,
+                                              IR_stmt *stmt, LinearForm *form) {
+    if (!VCALL(analyzer->forms, exist, stmt)) return false;
+    *form = VCALL(analyzer->forms, get, stmt);
+    return form->known;
+}
+
+//// ================================== 定义点索引 ==================================
+
+// 把定义语句记入循环的定义点索引
+static void add_def_site(LoopInductionVariables_ptr loop_ivs, IR_var def, IR_stmt *stmt) {
+    if (!VCALL(loop_ivs->def_sites, exist, def)) {
+        List_IR_stmt_ptr *sites = malloc(sizeof(List_IR_stmt_ptr));
+        List_IR_stmt_ptr_init(sites);
+        VCALL(loop_ivs->def_sites, insert, def, sites);
+    }
+    VCALL(*VCALL(loop_ivs->def_sites, get, def), push_back, stmt);
 }
 
 /**
- * @brief 检查变量在循环中是否只有一个定义点
+ * @brief 为每个循环创建归纳变量信息，一次扫描函数把每条定义记入其所在块的最内层循环的定义点索引
  */
-static bool has_single_definition_in_loop(Loop_ptr loop, IR_var variable, IR_stmt **def_stmt, IR_block_ptr *def_block) {
-    int def_count = 0;
-    IR_stmt *found_stmt = NULL;
-    IR_block_ptr found_block = NULL;
-    
-    // printf("  检查变量 v%u 在循环中的定义...\n", variable);
-    
-    // 遍历循环中的所有基本块
-    for_set(IR_block_ptr, block_node, loop->blocks) {
-        IR_block_ptr block = block_node->key;
-        
-        // 遍历基本块中的所有语句
-        for (ListNode_IR_stmt_ptr *stmt_node = block->stmts.head;
-             stmt_node != NULL; stmt_node = stmt_node->nxt) {
-            
-            IR_stmt *stmt = stmt_node->val;
-            
-            // 检查语句是否定义了该变量
-            bool defines_variable = false;
-            
-            switch (stmt->stmt_type) {
-                case IR_OP_STMT: {
-                    IR_op_stmt *op_stmt = (IR_op_stmt*)stmt;
-                    if (op_stmt->rd == variable) {
-                        defines_variable = true;
-                    }
-                    break;
-                }
-                case IR_ASSIGN_STMT: {
-                    IR_assign_stmt *assign_stmt = (IR_assign_stmt*)stmt;
-                    if (assign_stmt->rd == variable) {
-                        defines_variable = true;
-                    }
-                    break;
-                }
-                case IR_CALL_STMT: {
-                    IR_call_stmt *call_stmt = (IR_call_stmt*)stmt;
-                    if (call_stmt->rd == variable) {
-                        defines_variable = true;
-                    }
-                    break;
-                }
-                case IR_LOAD_STMT: {
-                    IR_load_stmt *load_stmt = (IR_load_stmt*)stmt;
-                    if (load_stmt->rd == variable) {
-                        defines_variable = true;
-                    }
-                    break;
-                }
-                default:
-                    // 其他语句类型不定义变量
-                    break;
-            }
-            
-            if (defines_variable) {
-                def_count++;
-                found_stmt = stmt;
-                found_block = block;
-                
-                // printf("    在基本块 B%u 发现变量 v%u 的定义\n", block->label, variable);
-                
-                // 如果已经有超过一个定义，直接返回false
-                if (def_count > 1) {
-                    // printf("    变量 v%u 有多个定义点，不是归纳变量\n", variable);
-                    return false;
-                }
-            }
+static void build_own_def_sites(InductionVariableAnalyzer *analyzer, Map_Loop_ptr_LoopInductionVariables_ptr *all_ivs) {
+    for_list(Loop_ptr, loop_node, analyzer->loop_analyzer->all_loops) {
+        LoopInductionVariables_ptr loop_ivs = (LoopInductionVariables_ptr)malloc(sizeof(LoopInductionVariables));
+        LoopInductionVariables_init(loop_ivs, loop_node->val);
+        VCALL(*all_ivs, insert, loop_node->val, loop_ivs);
+    }
+    for_list(IR_block_ptr, block_node, analyzer->function->blocks) {
+        Loop_ptr loop = LoopAnalyzer_get_innermost_loop(analyzer->loop_analyzer, block_node->val);
+        if (!loop) continue;
+        LoopInductionVariables_ptr loop_ivs = VCALL(*all_ivs, get, loop);
+        for_list(IR_stmt_ptr, stmt_node, block_node->val->stmts) {
+            IR_var def = VCALL(*stmt_node->val, get_def);
+            if (def != IR_VAR_NONE) add_def_site(loop_ivs, def, stmt_node->val);
         }
     }
-    
-    if (def_count == 1) {
-        *def_stmt = found_stmt;
-        *def_block = found_block;
-        // printf("    变量 v%u 在循环中只有一个定义点\n", variable);
-        return true;
+}
+
+/**
+ * @brief 把各内层循环（已建好）的定义点索引并入循环自己的索引，得到循环内（含内层循环）的全部定义
+ */
+static void merge_nested_def_sites(Map_Loop_ptr_LoopInductionVariables_ptr *all_ivs, LoopInductionVariables_ptr loop_ivs) {
+    for_list(Loop_ptr, child_node, loop_ivs->loop->nested_loops) {
+        LoopInductionVariables_ptr child_ivs = VCALL(*all_ivs, get, child_node->val);
+        for_map(IR_var, List_ptr_IR_stmt_ptr, site_node, child_ivs->def_sites)
+            for_list(IR_stmt_ptr, stmt_node, *site_node->val)
+                add_def_site(loop_ivs, site_node->key, stmt_node->val);
     }
-    
-    // printf("    变量 v%u 在循环中没有定义点\n", variable);
-    return false;
 }
 
 /**
- * @brief 检查变量是否在循环头支配的路径上被定义
+ * @brief 检查变量在循环内是否没有定义（循环不变）
  */
-static bool is_defined_on_dominated_path(Loop_ptr loop, 
-                                        DominanceAnalyzer *dom_analyzer,
-                                        IR_var variable, 
-                                        IR_stmt *def_stmt, 
-                                        IR_block_ptr def_block) {
-    // 检查定义块是否被循环头支配
-    return DominanceAnalyzer_dominates(dom_analyzer, loop->header, def_block);
+static bool is_invariant_in_loop(LoopInductionVariables_ptr loop_ivs, IR_var variable) {
+    return !VCALL(loop_ivs->def_sites, exist, variable);
 }
 
+//// ================================== 基本归纳变量识别 ==================================
+
 void InductionVariableAnalyzer_analyze_basic_ivs(InductionVariableAnalyzer *analyzer,
                                                 Loop_ptr loop,
                                                 LoopInductionVariables_ptr loop_ivs) {
     if (!analyzer || !loop || !loop_ivs) return;
     
-    // printf("=== 分析循环 B%u 的基本归纳变量 ===\n", loop->header->label);
-    
-    // 遍历循环中的所有基本块和语句
-    for_set(IR_block_ptr, block_node, loop->blocks) {
-        IR_block_ptr block = block_node->key;
-        
-        // printf("  分析基本块 B%u 中的语句...\n", block->label);
+    for_map(IR_var, List_ptr_IR_stmt_ptr, site_node, loop_ivs->def_sites) {
+        IR_var variable = site_node->key;
         
-        for (ListNode_IR_stmt_ptr *stmt_node = block->stmts.head;
-             stmt_node != NULL; stmt_node = stmt_node->nxt) {
-            
-            IR_stmt *stmt = stmt_node->val;
-            IR_var variable;
-            int step;
-            bool is_increment;
-            
-            // 首先检查直接的归纳变量增量模式
-            if (is_basic_induction_increment(stmt, &variable, &step, &is_increment)) {
-                printf("  发现潜在基本归纳变量 v%u, 步长: %d\n", variable, step);
-                
-                // 检查该变量在循环中是否只有一个定义点
-                IR_stmt *def_stmt;
-                IR_block_ptr def_block;
-                if (has_single_definition_in_loop(loop, variable, &def_stmt, &def_block)) {
-                    // 检查定义是否在循环头支配的路径上
-                    if (is_defined_on_dominated_path(loop, analyzer->loop_analyzer->dom_analyzer, 
-                                                    variable, def_stmt, def_block)) {
-                        
-                        // 检查是否已经存在
-                        if (!VCALL(loop_ivs->basic_iv_map, exist, variable)) {
-                            // 创建基本归纳变量
-                            BasicInductionVariable_ptr basic_iv = 
-                                (BasicInductionVariable_ptr)malloc(sizeof(BasicInductionVariable));
-                            BasicInductionVariable_init(basic_iv, variable, block, 
-                                                      stmt, step, is_increment);
-                            
-                            // 添加到循环归纳变量信息中
-                            VCALL(loop_ivs->basic_ivs, push_back, basic_iv);
-                            VCALL(loop_ivs->basic_iv_map, set, variable, basic_iv);
-                            VCALL(analyzer->global_basic_iv_map, set, variable, basic_iv);
-                            
-                            printf("  确认基本归纳变量 v%u, 步长: %d (%s)\n", 
-                                   variable, step, is_increment ? "递增" : "递减");
-                        }
-                    } else {
-                        // printf("  变量 v%u 的定义不在循环头支配的路径上\n", variable);
-                    }
-                }
-            }
-            // 如果不是直接模式，检查是否是间接的归纳变量更新
-            else if (stmt->stmt_type == IR_ASSIGN_STMT) {
-                if (is_indirect_induction_update(block, stmt, &variable, &step, &is_increment)) {
-                    #ifdef DEBUG
-                    printf("  发现间接基本归纳变量 v%u, 步长: %d\n", variable, step);
-                    #endif
-                    // 检查该变量在循环中是否只有一个定义点（应该就是当前的赋值语句）
-                    IR_stmt *def_stmt;
-                    IR_block_ptr def_block;
-                    if (has_single_definition_in_loop(loop, variable, &def_stmt, &def_block)) {
-                        // 检查定义是否在循环头支配的路径上
-                        if (is_defined_on_dominated_path(loop, analyzer->loop_analyzer->dom_analyzer, 
-                                                        variable, def_stmt, def_block)) {
-                            
-                            // 检查是否已经存在
-                            if (!VCALL(loop_ivs->basic_iv_map, exist, variable)) {
-                                // 创建基本归纳变量（使用赋值语句作为增量语句）
-                                BasicInductionVariable_ptr basic_iv = 
-                                    (BasicInductionVariable_ptr)malloc(sizeof(BasicInductionVariable));
-                                BasicInductionVariable_init(basic_iv, variable, block, 
-                                                          stmt, step, is_increment);
-                                
-                                // 添加到循环归纳变量信息中
-                                VCALL(loop_ivs->basic_ivs, push_back, basic_iv);
-                                VCALL(loop_ivs->basic_iv_map, set, variable, basic_iv);
-                                VCALL(analyzer->global_basic_iv_map, set, variable, basic_iv);
-                                #ifdef DEBUG
-                                printf("  确认间接基本归纳变量 v%u, 步长: %d (%s)\n", 
-                                       variable, step, is_increment ? "递增" : "递减");
-                                #endif 
-                            }
-                        } else {
-                            // printf("  变量 v%u 的定义不在循环头支配的路径上\n", variable);
-                        }
-                    }
-                }
+        // 每个定义都必须是 i = i + c
+        int step = 0;
+        bool recurrence = true;
+        for_list(IR_stmt_ptr, def_node, *site_node->val) {
+            LinearForm form;
+            if (!InductionVariableAnalyzer_get_linear_form(analyzer, def_node->val, &form) ||
+                form.term_cnt != 1 || form.var[0] != variable || form.coefficient[0] != 1) {
+                recurrence = false;
+                break;
             }
+            step += form.constant;
         }
+        if (!recurrence || step == 0) continue;
+        
+        IR_stmt *first_stmt = site_node->val->head->val;
+        BasicInductionVariable_ptr basic_iv = 
+            (BasicInductionVariable_ptr)malloc(sizeof(BasicInductionVariable));
+        BasicInductionVariable_init(basic_iv, variable, DefUseChain_site_of(&analyzer->def_use, first_stmt)->blk,
+                                    first_stmt, step, step > 0);
+        for_list(IR_stmt_ptr, def_node, *site_node->val)
+            if (def_node->val != first_stmt) VCALL(basic_iv->increment_stmts, push_back, def_node->val);
+        
+        VCALL(loop_ivs->basic_ivs, push_back, basic_iv);
+        VCALL(loop_ivs->basic_iv_map, set, variable, basic_iv);
+        VCALL(analyzer->global_basic_iv_map, set, variable, basic_iv);
+        #ifdef DEBUG
+        printf("  确认基本归纳变量 v%u, 步长: %d, 增量 %u 处\n", variable, step,
+               (unsigned)(site_node->val->head == site_node->val->tail ? 1 : 2));
+        #endif
     }
-    
-    // 统计结果
-    int basic_count = 0;
-    for (ListNode_BasicInductionVariable_ptr *node = loop_ivs->basic_ivs.head;
-         node != NULL; node = node->nxt) {
-        basic_count++;
-    }
-    
-    // printf("=== 循环 B%u 基本归纳变量分析完成，发现 %d 个基本归纳变量 ===\n\n", 
-    //        loop->header->label, basic_count);
 }
 
 //// ================================== 派生归纳变量识别 ==================================
 
 /**
- * @brief 检查语句是否为派生归纳变量的定义
- * 形如 j = c1 * i + c2，其中 i 是基本归纳变量
+ * @brief 把定义的线性形式拆成 c1 * i + c2 与其余各项，i 为循环的基本归纳变量
+ * 其余各项须是系数为 1 的循环不变变量，写入 invariants（至多两个，不足时为 IR_VAR_NONE）
  */
-static bool is_derived_induction_definition(IR_stmt *stmt,
-                                           LoopInductionVariables_ptr loop_ivs,
-                                           IR_var *derived_var,
-                                           BasicInductionVariable_ptr *basic_iv,
-                                           int *coefficient,
-                                           int *constant) {
-    if (!stmt) return false;
-    
-    // 检查乘法形式：j = c * i 或 j = i * c
-    if (stmt->stmt_type == IR_OP_STMT) {
-        IR_op_stmt *op_stmt = (IR_op_stmt*)stmt;
-        
-        if (op_stmt->op == IR_OP_MUL) {
-            // 情况1: j = c * i
-            if (op_stmt->rs1.is_const && !op_stmt->rs2.is_const) {
-                if (VCALL(loop_ivs->basic_iv_map, exist, op_stmt->rs2.var)) {
-                    *derived_var = op_stmt->rd;
-                    *basic_iv = VCALL(loop_ivs->basic_iv_map, get, op_stmt->rs2.var);
-                    *coefficient = op_stmt->rs1.const_val;
-                    *constant = 0;
-                    return true;
-                }
-            }
-            // 情况2: j = i * c
-            else if (!op_stmt->rs1.is_const && op_stmt->rs2.is_const) {
-                if (VCALL(loop_ivs->basic_iv_map, exist, op_stmt->rs1.var)) {
-                    *derived_var = op_stmt->rd;
-                    *basic_iv = VCALL(loop_ivs->basic_iv_map, get, op_stmt->rs1.var);
-                    *coefficient = op_stmt->rs2.const_val;
-                    *constant = 0;
-                    return true;
-                }
-            }
-        }
-        // 检查加法形式：j = i + c 或 j = c + i  
-        else if (op_stmt->op == IR_OP_ADD) {
-            // 情况1: j = i + c
-            if (!op_stmt->rs1.is_const && op_stmt->rs2.is_const) {
-                if (VCALL(loop_ivs->basic_iv_map, exist, op_stmt->rs1.var)) {
-                    *derived_var = op_stmt->rd;
-                    *basic_iv = VCALL(loop_ivs->basic_iv_map, get, op_stmt->rs1.var);
-                    *coefficient = 1;
-                    *constant = op_stmt->rs2.const_val;
-                    return true;
-                }
-            }
-            // 情况2: j = c + i
-            else if (op_stmt->rs1.is_const && !op_stmt->rs2.is_const) {
-                if (VCALL(loop_ivs->basic_iv_map, exist, op_stmt->rs2.var)) {
-                    *derived_var = op_stmt->rd;
-                    *basic_iv = VCALL(loop_ivs->basic_iv_map, get, op_stmt->rs2.var);
-                    *coefficient = 1;
-                    *constant = op_stmt->rs1.const_val;
-                    return true;
-                }
-            }
-        }
-        // 检查减法形式：j = i - c
-        else if (op_stmt->op == IR_OP_SUB) {
-            if (!op_stmt->rs1.is_const && op_stmt->rs2.is_const) {
-                if (VCALL(loop_ivs->basic_iv_map, exist, op_stmt->rs1.var)) {
-                    *derived_var = op_stmt->rd;
-                    *basic_iv = VCALL(loop_ivs->basic_iv_map, get, op_stmt->rs1.var);
-                    *coefficient = 1;
-                    *constant = -op_stmt->rs2.const_val;
-                    return true;
-                }
-            }
+static bool split_induction_form(LoopInductionVariables_ptr loop_ivs, LinearForm form,
+                                 BasicInductionVariable_ptr *basic_iv, int *coefficient,
+                                 IR_var invariants[2]) {
+    *basic_iv = NULL;
+    invariants[0] = invariants[1] = IR_VAR_NONE;
+    unsigned invariant_cnt = 0;
+    for (unsigned k = 0; k < form.term_cnt; k++) {
+        if (VCALL(loop_ivs->basic_iv_map, exist, form.var[k])) {
+            if (*basic_iv) return false;
+            *basic_iv = VCALL(loop_ivs->basic_iv_map, get, form.var[k]);
+            *coefficient = form.coefficient[k];
+        } else {
+            if (form.coefficient[k] != 1 || !is_invariant_in_loop(loop_ivs, form.var[k]) || invariant_cnt == 2)
+                return false;
+            invariants[invariant_cnt++] = form.var[k];
         }
     }
-    // 检查赋值形式：j = i（系数为1，常数为0）
-    else if (stmt->stmt_type == IR_ASSIGN_STMT) {
-        IR_assign_stmt *assign_stmt = (IR_assign_stmt*)stmt;
-        
-        if (!assign_stmt->rs.is_const) {
-            if (VCALL(loop_ivs->basic_iv_map, exist, assign_stmt->rs.var)) {
-                *derived_var = assign_stmt->rd;
-                *basic_iv = VCALL(loop_ivs->basic_iv_map, get, assign_stmt->rs.var);
-                *coefficient = 1;
-                *constant = 0;
-                return true;
-            }
-        }
+    return *basic_iv != NULL;
+}
+
+/**
+ * @brief 检查变量是否被某条 LOAD/STORE 语句用作地址
+ */
+static bool is_used_as_address(DefUseChain *def_use, IR_var variable) {
+    Set_IR_stmt_ptr *uses = DefUseChain_get_uses(def_use, variable);
+    if (!uses) return false;
+    for_set(IR_stmt_ptr, use_node, *uses) {
+        IR_stmt *stmt = use_node->key;
+        IR_val addr;
+        if (stmt->stmt_type == IR_LOAD_STMT) addr = ((IR_load_stmt*)stmt)->rs_addr;
+        else if (stmt->stmt_type == IR_STORE_STMT) addr = ((IR_store_stmt*)stmt)->rd_addr;
+        else continue;
+        if (!addr.is_const && addr.var == variable) return true;
     }
-    
     return false;
 }
 
-void InductionVariableAnalyzer_analyze_derived_ivs(InductionVariableAnalyzer *analyzer,
-                                                  Loop_ptr loop,
-                                                  LoopInductionVariables_ptr loop_ivs) {
-    if (!analyzer || !loop || !loop_ivs) return;
-    
-    // printf("=== 分析循环 B%u 的派生归纳变量 ===\n", loop->header->label);
-    
-    // 如果没有基本归纳变量，则没有派生归纳变量
-    if (!loop_ivs->basic_ivs.head) {
-        // printf("  没有基本归纳变量，跳过派生归纳变量分析\n");
-        return;
-    }
-    
-    // 遍历循环中的所有基本块和语句寻找派生归纳变量
-    for_set(IR_block_ptr, block_node, loop->blocks) {
-        IR_block_ptr block = block_node->key;
-        
-        // printf("  分析基本块 B%u 中的派生归纳变量...\n", block->label);
+/**
+ * @brief 遍历循环内的定义，记录派生归纳变量（address 为 true 时只记录含不变项的地址归纳变量）
+ */
+static void collect_derived_ivs(InductionVariableAnalyzer *analyzer,
+                                LoopInductionVariables_ptr loop_ivs,
+                                bool address) {
+    for_map(IR_var, List_ptr_IR_stmt_ptr, site_node, loop_ivs->def_sites) {
+        IR_var variable = site_node->key;
+        if (VCALL(loop_ivs->basic_iv_map, exist, variable)) continue;
+        if (address && !is_used_as_address(&analyzer->def_use, variable)) continue;
         
-        for (ListNode_IR_stmt_ptr *stmt_node = block->stmts.head;
-             stmt_node != NULL; stmt_node = stmt_node->nxt) {
-            
-            IR_stmt *stmt = stmt_node->val;
-            IR_var derived_var;
+        for_list(IR_stmt_ptr, def_node, *site_node->val) {
+            LinearForm form;
             BasicInductionVariable_ptr basic_iv;
-            int coefficient, constant;
+            int coefficient;
+            IR_var invariants[2];
+            if (!InductionVariableAnalyzer_get_linear_form(analyzer, def_node->val, &form)) continue;
+            if (!split_induction_form(loop_ivs, form, &basic_iv, &coefficient, invariants)) continue;
+            if ((invariants[0] != IR_VAR_NONE) != address) continue;
+            
+            #ifdef DEBUG
+            printf("  发现派生归纳变量 v%u = %d * v%u + %d (不变项 %u 个)\n", variable, coefficient,
+                   basic_iv->variable, form.constant, (invariants[0] != IR_VAR_NONE) + (invariants[1] != IR_VAR_NONE));
+            #endif
+            DerivedInductionVariable_ptr derived_iv = 
+                (DerivedInductionVariable_ptr)malloc(sizeof(DerivedInductionVariable));
+            DerivedInductionVariable_init(derived_iv, variable, basic_iv, coefficient, form.constant, def_node->val);
+            derived_iv->base = invariants[0];
+            derived_iv->invariant = invariants[1];
+            VCALL(loop_ivs->derived_ivs, push_back, derived_iv);
             
-            if (is_derived_induction_definition(stmt, loop_ivs, &derived_var, 
-                                              &basic_iv, &coefficient, &constant)) {
-                
-                // 检查是否已经存在（避免重复添加）
-                if (!VCALL(loop_ivs->derived_iv_map, exist, derived_var) &&
-                    !VCALL(loop_ivs->basic_iv_map, exist, derived_var)) {
-                    #ifdef DEBUG
-                    printf("  在基本块 B%u 发现派生归纳变量 v%u = %d * v%u + %d\n", 
-                           block->label, derived_var, coefficient, basic_iv->variable, constant);
-                    #endif
-                    // 创建派生归纳变量
-                    DerivedInductionVariable_ptr derived_iv = 
-                        (DerivedInductionVariable_ptr)malloc(sizeof(DerivedInductionVariable));
-                    DerivedInductionVariable_init(derived_iv, derived_var, basic_iv, 
-                                                coefficient, constant, stmt);
-                    
-                    // 添加到循环归纳变量信息中
-                    VCALL(loop_ivs->derived_ivs, push_back, derived_iv);
-                    VCALL(loop_ivs->derived_iv_map, set, derived_var, derived_iv);
-                    VCALL(analyzer->global_derived_iv_map, set, derived_var, derived_iv);
-                } else {
-                    // printf("  变量 v%u 已经被识别为归纳变量，跳过\n", derived_var);
-                }
+            // 循环内只有这一个定义时变量本身才是派生归纳变量
+            if (!address && site_node->val->head == site_node->val->tail) {
+                VCALL(loop_ivs->derived_iv_map, set, variable, derived_iv);
+                VCALL(analyzer->global_derived_iv_map, set, variable, derived_iv);
             }
         }
     }
-    
-    // 统计结果
-    int derived_count = 0;
-    for (ListNode_DerivedInductionVariable_ptr *node = loop_ivs->derived_ivs.head;
-         node != NULL; node = node->nxt) {
-        derived_count++;
-    }
-    
-    // printf("=== 循环 B%u 派生归纳变量分析完成，发现 %d 个派生归纳变量 ===\n\n", 
-    //        loop->header->label, derived_count);
+}
+
+void InductionVariableAnalyzer_analyze_derived_ivs(InductionVariableAnalyzer *analyzer,
+                                                  Loop_ptr loop,
+                                                  LoopInductionVariables_ptr loop_ivs) {
+    if (!analyzer || !loop || !loop_ivs || !loop_ivs->basic_ivs.head) return;
+    collect_derived_ivs(analyzer, loop_ivs, false);
+}
+
+//// ================================== 地址归纳变量识别 ==================================
+
+void InductionVariableAnalyzer_analyze_address_ivs(InductionVariableAnalyzer *analyzer,
+                                                  Loop_ptr loop,
+                                                  LoopInductionVariables_ptr loop_ivs) {
+    if (!analyzer || !loop || !loop_ivs || !loop_ivs->basic_ivs.head) return;
+    collect_derived_ivs(analyzer, loop_ivs, true);
 }
 
 //// ================================== 主分析算法 ==================================
@@ -626,25 +493,40 @@ void InductionVariableAnalyzer_analyze(InductionVariableAnalyzer *analyzer) {
     printf("\n=== 执行归纳变量分析 ===\n");
     printf("函数: %s\n", analyzer->function->func_name);
     #endif 
-    // 遍历所有循环
+    InductionVariableAnalyzer_compute_linear_forms(analyzer);
+    
+    Map_Loop_ptr_LoopInductionVariables_ptr all_ivs;
+    Map_Loop_ptr_LoopInductionVariables_ptr_init(&all_ivs);
+    build_own_def_sites(analyzer, &all_ivs);
+    
+    // all_loops 中内层循环在外层之前, 外层的定义点索引可以直接合并内层的结果
     for_list(Loop_ptr, loop_node, analyzer->loop_analyzer->all_loops){
         
         Loop_ptr loop = loop_node->val;
-        
-        // 为每个循环创建归纳变量信息结构体
-        LoopInductionVariables_ptr loop_ivs = 
-            (LoopInductionVariables_ptr)malloc(sizeof(LoopInductionVariables));
-        LoopInductionVariables_init(loop_ivs, loop);
+        LoopInductionVariables_ptr loop_ivs = VCALL(all_ivs, get, loop);
+        merge_nested_def_sites(&all_ivs, loop_ivs);
+        if (!loop->is_reducible) continue; // 不可约循环没有唯一入口, 不做归纳变量分析
         
         // 分析基本归纳变量
         InductionVariableAnalyzer_analyze_basic_ivs(analyzer, loop, loop_ivs);
         
         // 分析派生归纳变量
         InductionVariableAnalyzer_analyze_derived_ivs(analyzer, loop, loop_ivs);
+        InductionVariableAnalyzer_analyze_address_ivs(analyzer, loop, loop_ivs);
         
         // 添加到分析器的循环列表中
         VCALL(analyzer->loop_ivs, push_back, loop_ivs);
+        VCALL(analyzer->loop_iv_map, insert, loop, loop_ivs);
     }
+    
+    // 不可约循环的索引只用于合并到外层循环
+    for_list(Loop_ptr, loop_node, analyzer->loop_analyzer->all_loops) {
+        if (loop_node->val->is_reducible) continue;
+        LoopInductionVariables_ptr loop_ivs = VCALL(all_ivs, get, loop_node->val);
+        LoopInductionVariables_teardown(loop_ivs);
+        free(loop_ivs);
+    }
+    Map_Loop_ptr_LoopInductionVariables_ptr_teardown(&all_ivs);
     #ifdef DEBUG
     
     printf("=== 归纳变量分析完成 ===\n\n");
@@ -677,11 +559,8 @@ LoopInductionVariables_ptr InductionVariableAnalyzer_get_loop_ivs(
     InductionVariableAnalyzer *analyzer, Loop_ptr loop) {
     if (!analyzer || !loop) return NULL;
     
-    for (ListNode_LoopInductionVariables_ptr *node = analyzer->loop_ivs.head;
-         node != NULL; node = node->nxt) {
-        if (node->val->loop == loop) {
-            return node->val;
-        }
+    if (VCALL(analyzer->loop_iv_map, exist, loop)) {
+        return VCALL(analyzer->loop_iv_map, get, loop);
     }
     return NULL;
 }
@@ -703,9 +582,18 @@ void DerivedInductionVariable_print(DerivedInductionVariable_ptr derived_iv, FIL
     if (!derived_iv || !out) return;
     
     fprintf(out, "    派生归纳变量 v%u:\n", derived_iv->variable);
-    fprintf(out, "      表达式: v%u = %d * v%u + %d\n", 
-            derived_iv->variable, derived_iv->coefficient, 
-            derived_iv->basic_iv->variable, derived_iv->constant);
+    if (derived_iv->base != IR_VAR_NONE && derived_iv->invariant != IR_VAR_NONE)
+        fprintf(out, "      表达式: v%u = v%u + v%u + %d * v%u + %d\n",
+                derived_iv->variable, derived_iv->base, derived_iv->invariant, derived_iv->coefficient,
+                derived_iv->basic_iv->variable, derived_iv->constant);
+    else if (derived_iv->base != IR_VAR_NONE)
+        fprintf(out, "      表达式: v%u = v%u + %d * v%u + %d\n",
+                derived_iv->variable, derived_iv->base, derived_iv->coefficient,
+                derived_iv->basic_iv->variable, derived_iv->constant);
+    else
+        fprintf(out, "      表达式: v%u = %d * v%u + %d\n", 
+                derived_iv->variable, derived_iv->coefficient, 
+                derived_iv->basic_iv->variable, derived_iv->constant);
     fprintf(out, "      基本归纳变量: v%u\n", derived_iv->basic_iv->variable);
     fprintf(out, "      定义语句: ");
     VCALL(*derived_iv->definition_stmt, print, out);
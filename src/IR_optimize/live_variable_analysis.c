@@ -18,9 +18,16 @@ static void LiveVariableAnalysis_teardown(LiveVariableAnalysis *t) {
     // 遍历并删除所有OutFact (变量集合)
     for_map(IR_block_ptr, Set_ptr_IR_var, i, t->mapOutFact)
         DELETE(i->val);
+    // 遍历并删除所有块摘要
+    for_map(IR_block_ptr, Set_ptr_IR_var, i, t->mapUEVar)
+        DELETE(i->val);
+    for_map(IR_block_ptr, Set_ptr_IR_var, i, t->mapVarKill)
+        DELETE(i->val);
     // 释放存储InFact和OutFact的映射本身
     Map_IR_block_ptr_Set_ptr_IR_var_teardown(&t->mapInFact);
     Map_IR_block_ptr_Set_ptr_IR_var_teardown(&t->mapOutFact);
+    Map_IR_block_ptr_Set_ptr_IR_var_teardown(&t->mapUEVar);
+    Map_IR_block_ptr_Set_ptr_IR_var_teardown(&t->mapVarKill);
 }
 
 /**
@@ -157,10 +164,46 @@ void LiveVariableAnalysis_transferStmt (LiveVariableAnalysis *t,
     }
 }
 
+/**
+ * @brief （辅助函数）获取基本块的摘要 UEVar 与 VarKill，首次访问时计算。
+ * UEVar[B]: 在块内被定义之前就被使用的变量；VarKill[B]: 块内被定义的变量。
+ * 正向扫描一遍块内语句即可得到二者。
+ * @param t 指向 LiveVariableAnalysis 实例的指针。
+ * @param block 指向目标基本块的指针。
+ * @param ue_var 输出参数，指向该块的 UEVar 集合。
+ * @param var_kill 输出参数，指向该块的 VarKill 集合。
+ */
+static void LiveVariableAnalysis_block_summary (LiveVariableAnalysis *t,
+                                                IR_block *block,
+                                                Set_IR_var **ue_var,
+                                                Set_IR_var **var_kill) {
+    if(VCALL(t->mapUEVar, exist, block)) {
+        *ue_var = VCALL(t->mapUEVar, get, block);
+        *var_kill = VCALL(t->mapVarKill, get, block);
+        return;
+    }
+    *ue_var = NEW(Set_IR_var);
+    *var_kill = NEW(Set_IR_var);
+    for_list(IR_stmt_ptr, i, block->stmts) {
+        IR_stmt *stmt = i->val;
+        IR_use use = VCALL(*stmt, get_use_vec);
+        for(int k = 0; k < use.use_cnt; ++k) {
+            IR_val use_var = use.use_vec[k];
+            if(!use_var.is_const && use_var.var != IR_VAR_NONE && !VCALL(**var_kill, exist, use_var.var))
+                VCALL(**ue_var, insert, use_var.var);
+        }
+        IR_var def = VCALL(*stmt, get_def);
+        if(def != IR_VAR_NONE)
+            VCALL(**var_kill, insert, def);
+    }
+    VCALL(t->mapUEVar, insert, block, *ue_var);
+    VCALL(t->mapVarKill, insert, block, *var_kill);
+}
+
 /**
  * @brief （核心传递函数）根据基本块的 OUT 集合计算其 IN 集合。
- * 它首先将out_fact复制到临时的new_in_fact，然后按相反的顺序模拟块内每条语句的执行，
- * 更新new_in_fact，最后将new_in_fact与原始的in_fact进行meet。
+ * IN[B] = UEVar[B] U (OUT[B] - VarKill[B])。
+ * 由于求解过程中 IN 集合只增不减，直接把新元素并入原有的 in_fact 即可，无需临时集合。
  * @param t 指向 LiveVariableAnalysis 实例的指针。
  * @param block 指向当前处理的基本块的指针。
  * @param in_fact 指向该块当前 IN 集合的指针 (会被更新)。
@@ -171,19 +214,12 @@ bool LiveVariableAnalysis_transferBlock (LiveVariableAnalysis *t,
                                          IR_block *block,
                                          Set_IR_var *in_fact,
                                          Set_IR_var *out_fact) {
-    // 创建一个新的变量集合作为临时的in_fact，并用out_fact初始化它
-    Set_IR_var *new_in_fact = LiveVariableAnalysis_newInitialFact(t);
-    LiveVariableAnalysis_meetInto(t, out_fact, new_in_fact); // new_in_fact = out_fact
-
-    // 因为是后向分析，所以需要从后向前遍历基本块中的所有语句
-    rfor_list(IR_stmt_ptr, i, block->stmts) { // rfor_list 是反向遍历链表的宏
-        IR_stmt *stmt = i->val;
-        LiveVariableAnalysis_transferStmt(t, stmt, new_in_fact); // 应用语句的传递函数
-    }
-
-    // 将计算得到的new_in_fact与原有的in_fact进行meet
-    bool updated = LiveVariableAnalysis_meetInto(t, new_in_fact, in_fact);
-    DELETE(new_in_fact); // 释放临时的new_in_fact
+    Set_IR_var *ue_var, *var_kill;
+    LiveVariableAnalysis_block_summary(t, block, &ue_var, &var_kill);
+    bool updated = LiveVariableAnalysis_meetInto(t, ue_var, in_fact);
+    for_set(IR_var, var, *out_fact)
+        if(!VCALL(*var_kill, exist, var->key))
+            updated |= VCALL(*in_fact, insert, var->key);
     return updated; // 返回in_fact是否被更新
 }
 
@@ -238,6 +274,8 @@ void LiveVariableAnalysis_init(LiveVariableAnalysis *t) {
     // 初始化存储IN和OUT fact的映射
     Map_IR_block_ptr_Set_ptr_IR_var_init(&t->mapInFact);
     Map_IR_block_ptr_Set_ptr_IR_var_init(&t->mapOutFact);
+    Map_IR_block_ptr_Set_ptr_IR_var_init(&t->mapUEVar);
+    Map_IR_block_ptr_Set_ptr_IR_var_init(&t->mapVarKill);
 }
 
 //// ============================ 优化 (Optimize) ============================
@@ -277,6 +315,8 @@ static bool block_remove_dead_def (LiveVariableAnalysis *t, IR_block *blk) {
             if(!VCALL(*current_live_fact, exist, def)) { 
                 stmt->dead = true; 
                 updated = true; 
+                // 死定义的操作数不因它而活跃, 只需杀死 def (此处 def 本就不活跃)
+                continue;
             }
             // TODO();
         }
@@ -1,7 +1,7 @@
 //
 // Created by Assistant
 // 循环分析实现 (Loop Analysis Implementation)
-// 基于支配节点分析检测自然循环
+// 用 Havlak 算法在一次 DFS 上构造循环嵌套森林
 //
 
 #include "include/loop_analysis.h"
@@ -10,9 +10,6 @@
 #include <stdlib.h>
 #include <string.h>
 
-// Forward declaration for default teardown
-static void IR_stmt_teardown_default(IR_stmt *stmt) { }
-
 //// ================================== 容器类型定义 ==================================
 
 // BackEdge的比较函数
@@ -39,6 +36,8 @@ void Loop_init(Loop *loop, IR_block_ptr header) {
     
     loop->parent_loop = NULL;
     loop->preheader = NULL;
+    List_IR_block_ptr_init(&loop->exit_blocks);
+    List_IR_block_ptr_init(&loop->exit_targets);
     loop->depth = 1;
     loop->is_reducible = true;
     
@@ -52,6 +51,8 @@ void Loop_teardown(Loop *loop) {
     Set_IR_block_ptr_teardown(&loop->blocks);
     List_IR_block_ptr_teardown(&loop->back_edges_sources);
     List_Loop_ptr_teardown(&loop->nested_loops);
+    List_IR_block_ptr_teardown(&loop->exit_blocks);
+    List_IR_block_ptr_teardown(&loop->exit_targets);
     
     loop->header = NULL;
     loop->parent_loop = NULL;
@@ -132,263 +133,301 @@ void LoopAnalyzer_teardown(LoopAnalyzer *analyzer) {
     analyzer->dom_analyzer = NULL;
 }
 
-//// ================================== 回边检测 ==================================
+//// ================================== 循环嵌套森林 ==================================
 
 /**
- * @brief 检测函数中的所有回边
- * 回边是指从基本块指向其支配节点的边
+ * @brief Havlak 算法使用的边表：每个结点一条单链表，可在算法进行中追加边
  */
-static void detect_back_edges(LoopAnalyzer *analyzer) {
-    if (!analyzer || !analyzer->function || !analyzer->dom_analyzer) return;
-    
-    // printf("=== 检测回边 ===\n");
-    
-    // 遍历所有基本块
-    for (ListNode_IR_block_ptr *block_node = analyzer->function->blocks.head; 
-         block_node != NULL; block_node = block_node->nxt) {
-        
-        IR_block_ptr block = block_node->val;
-        
-        // 获取当前块的后继列表
-        List_ptr_IR_block_ptr successors = VCALL(analyzer->function->blk_succ, get, block);
-        if (successors) {
-            // 遍历所有后继
-            for (ListNode_IR_block_ptr *succ_node = successors->head;
-                 succ_node != NULL; succ_node = succ_node->nxt) {
-                
-                IR_block_ptr successor = succ_node->val;
-                
-                // 检查后继是否支配当前块（形成回边）
-                // 回边的定义：从节点A到节点B的边，当且仅当B支配A
-                // 注意：我们需要排除自环，除非它确实是一个自环边
-                if (DominanceAnalyzer_dominates(analyzer->dom_analyzer, successor, block)) {
-                    // 如果是自环，需要特殊处理
-                    if (successor == block) {
-                        // 只有当控制流图中确实存在从节点到自己的边时，才认为是回边
-                        // 这种情况很少见，通常出现在无限循环中
-                        // printf("发现自环回边: B%u -> B%u (自循环)\n", 
-                        //        block->label, successor->label);
-                    } else {
-                        // 正常的回边：后继严格支配当前节点
-                        // printf("发现回边: B%u -> B%u (B%u 支配 B%u)\n", 
-                        //        block->label, successor->label, 
-                        //        successor->label, block->label);
-                    }
-                    
-                    BackEdge back_edge;
-                    back_edge.source = block;
-                    back_edge.target = successor;
-                    VCALL(analyzer->back_edges, push_back, back_edge);
-                }
-            }
+typedef struct {
+    int *head;          // 结点 -> 第一条边，-1 表示空
+    int *next, *val;    // 边 -> 下一条边 / 边的另一端
+    unsigned cnt, cap;
+} LoopEdgeList;
+
+static void LoopEdgeList_init(LoopEdgeList *l, unsigned n) {
+    l->head = (int*)malloc(sizeof(int[n]));
+    for (unsigned i = 0; i < n; i++) l->head[i] = -1;
+    l->cap = n ? 2 * n : 1;
+    l->cnt = 0;
+    l->next = (int*)malloc(sizeof(int[l->cap]));
+    l->val = (int*)malloc(sizeof(int[l->cap]));
+}
+
+static void LoopEdgeList_add(LoopEdgeList *l, int from, int to) {
+    if (l->cnt == l->cap) {
+        l->cap *= 2;
+        l->next = (int*)realloc(l->next, sizeof(int[l->cap]));
+        l->val = (int*)realloc(l->val, sizeof(int[l->cap]));
+    }
+    l->val[l->cnt] = to;
+    l->next[l->cnt] = l->head[from];
+    l->head[from] = (int)l->cnt++;
+}
+
+static void LoopEdgeList_teardown(LoopEdgeList *l) {
+    free(l->head);
+    free(l->next);
+    free(l->val);
+}
+
+typedef enum {
+    LOOP_NODE_NONHEADER,    // 不是循环头
+    LOOP_NODE_SELF,         // 只有自环的循环头
+    LOOP_NODE_REDUCIBLE,    // 可约循环的循环头
+    LOOP_NODE_IRREDUCIBLE,  // 不可约循环的入口（DFS 中最先到达的结点）
+} LoopNodeType;
+
+/**
+ * @brief 循环嵌套森林的中间结果，结点按 CFG 的 DFS 先序编号
+ * w 是 v 的 DFS 祖先当且仅当 pre(w) <= pre(v) <= last[w]
+ */
+typedef struct {
+    unsigned n;                 // 从入口可达的结点数
+    IR_block_ptr *blocks;       // 先序编号 -> 基本块
+    unsigned *last;             // 子树中最大的先序编号
+    int *header;                // 最内层包含该结点的循环头，-1 表示不在循环中
+    LoopNodeType *type;
+    LoopEdgeList back_preds;    // 来自 DFS 后代（含自身）的前驱
+    LoopEdgeList non_back_preds;// 其余前驱；折叠不可约区域时追加区域外的入口
+} LoopForest;
+
+// 分析后新建的块不在支配信息中, 视为不可达
+static int rpo_index_of(LoopAnalyzer *analyzer, IR_block_ptr block) {
+    DominanceAnalyzer *dom = analyzer->dom_analyzer;
+    if (!VCALL(dom->dom_info, exist, block)) return -1;
+    return VCALL(dom->dom_info, get, block).rpo_index;
+}
+
+static bool is_dfs_ancestor(LoopForest *f, int w, int v) {
+    return w <= v && (unsigned)v <= f->last[w];
+}
+
+/**
+ * @brief 从入口做一次迭代 DFS，给每个可达块先序编号并记录子树范围，
+ * 然后把每条边按目标是否为源的 DFS 祖先分为回边和非回边
+ */
+static void number_blocks(LoopAnalyzer *analyzer, LoopForest *f) {
+    DominanceAnalyzer *dom = analyzer->dom_analyzer;
+    IR_function *func = analyzer->function;
+    unsigned n = dom->block_cnt;
+    f->n = n;
+    f->blocks = (IR_block_ptr*)malloc(sizeof(IR_block_ptr[n ? n : 1]));
+    f->last = (unsigned*)malloc(sizeof(unsigned[n ? n : 1]));
+    f->header = (int*)malloc(sizeof(int[n ? n : 1]));
+    f->type = (LoopNodeType*)malloc(sizeof(LoopNodeType[n ? n : 1]));
+    int *rpo_to_pre = (int*)malloc(sizeof(int[n ? n : 1]));
+    for (unsigned i = 0; i < n; i++) {
+        rpo_to_pre[i] = -1;
+        f->header[i] = -1;
+        f->type[i] = LOOP_NODE_NONHEADER;
+    }
+    LoopEdgeList_init(&f->back_preds, n);
+    LoopEdgeList_init(&f->non_back_preds, n);
+    if (n == 0) {
+        free(rpo_to_pre);
+        return;
+    }
+
+    // 显式栈 DFS, 栈中保存块及其下一个待访问的后继
+    IR_block_ptr *stack_blk = (IR_block_ptr*)malloc(sizeof(IR_block_ptr[n]));
+    ListNode_IR_block_ptr **stack_succ = (ListNode_IR_block_ptr**)malloc(sizeof(ListNode_IR_block_ptr*[n]));
+    int *stack_pre = (int*)malloc(sizeof(int[n]));
+    unsigned depth = 0, pre_cnt = 0;
+    IR_block_ptr entry = dom->rpo_blocks[0];
+    rpo_to_pre[0] = (int)pre_cnt;
+    f->blocks[pre_cnt] = entry;
+    stack_blk[depth] = entry;
+    stack_succ[depth] = VCALL(func->blk_succ, get, entry)->head;
+    stack_pre[depth++] = (int)pre_cnt++;
+    while (depth) {
+        ListNode_IR_block_ptr *succ = stack_succ[depth - 1];
+        if (!succ) {
+            depth--;
+            f->last[stack_pre[depth]] = pre_cnt - 1;
+            continue;
         }
+        stack_succ[depth - 1] = succ->nxt;
+        IR_block_ptr next = succ->val;
+        int rpo = rpo_index_of(analyzer, next);
+        if (rpo < 0 || rpo_to_pre[rpo] >= 0) continue;
+        rpo_to_pre[rpo] = (int)pre_cnt;
+        f->blocks[pre_cnt] = next;
+        stack_blk[depth] = next;
+        stack_succ[depth] = VCALL(func->blk_succ, get, next)->head;
+        stack_pre[depth++] = (int)pre_cnt++;
     }
-    
-    // 计算回边数量
-    int edge_count = 0;
-    for (ListNode_BackEdge *node = analyzer->back_edges.head; node != NULL; node = node->nxt) {
-        edge_count++;
+    free(stack_blk);
+    free(stack_succ);
+    free(stack_pre);
+
+    for (unsigned w = 0; w < n; w++) {
+        List_IR_block_ptr *preds = VCALL(func->blk_pred, get, f->blocks[w]);
+        for_list(IR_block_ptr, i, *preds) {
+            int rpo = rpo_index_of(analyzer, i->val);
+            if (rpo < 0 || rpo_to_pre[rpo] < 0) continue; // 不可达的前驱
+            int v = rpo_to_pre[rpo];
+            if (is_dfs_ancestor(f, (int)w, v)) LoopEdgeList_add(&f->back_preds, (int)w, v);
+            else LoopEdgeList_add(&f->non_back_preds, (int)w, v);
+        }
     }
-    
-    // printf("总共发现 %d 条回边\n\n", edge_count);
+    free(rpo_to_pre);
 }
 
-//// ================================== 自然循环构造 ==================================
+static int union_find(int *parent, int x) {
+    int root = x;
+    while (parent[root] != root) root = parent[root];
+    while (parent[x] != root) {
+        int next = parent[x];
+        parent[x] = root;
+        x = next;
+    }
+    return root;
+}
 
 /**
- * @brief 使用深度优先搜索构造自然循环
- * 给定回边，向上搜索所有能到达回边源的节点
+ * @brief Havlak 算法 (含 Ramalingam 的修正)：按先序逆序处理每个结点 w，
+ * 从 w 的回边前驱出发沿非回边前驱反向收集循环体，已处理的内层循环经并查集折叠为其循环头。
+ * 若循环体中某结点有来自 w 的 DFS 子树之外的前驱，则该循环有多个入口，标记为不可约，
+ * 并把这条入口边挂到 w 上，使外层循环折叠 w 时仍能看到它。
  */
-static void construct_natural_loop(LoopAnalyzer *analyzer, BackEdge *back_edge, Loop *loop) {
-    if (!analyzer || !back_edge || !loop) return;
-    
-    // printf("构造自然循环，头节点: B%u, 回边源: B%u\n", 
-    //        back_edge->target->label, back_edge->source->label);
-    
-    // 初始化工作列表，从回边源开始
-    List_IR_block_ptr worklist;
-    List_IR_block_ptr_init(&worklist);
-    
-    // 如果回边源不是循环头，将其加入工作列表
-    if (back_edge->source != back_edge->target) {
-        VCALL(worklist, push_back, back_edge->source);
-        Loop_add_block(loop, back_edge->source);
+static void compute_loop_headers(LoopForest *f) {
+    unsigned n = f->n;
+    int *uf_parent = (int*)malloc(sizeof(int[n ? n : 1]));
+    int *body = (int*)malloc(sizeof(int[n ? n : 1]));
+    int *in_body = (int*)malloc(sizeof(int[n ? n : 1]));
+    for (unsigned i = 0; i < n; i++) {
+        uf_parent[i] = (int)i;
+        in_body[i] = -1;
     }
-    
-    // 深度优先搜索，找到所有能到达回边源的节点
-    while (worklist.head != NULL) {
-        IR_block_ptr current = worklist.tail->val;
-        VCALL(worklist, pop_back);
-        
-        // 获取当前节点的前驱列表
-        List_ptr_IR_block_ptr predecessors = VCALL(analyzer->function->blk_pred, get, current);
-        if (predecessors) {
-            // 遍历所有前驱
-            for (ListNode_IR_block_ptr *pred_node = predecessors->head;
-                 pred_node != NULL; pred_node = pred_node->nxt) {
-                
-                IR_block_ptr predecessor = pred_node->val;
-                
-                // 如果前驱不在循环中，添加到循环和工作列表
-                if (!Loop_contains_block(loop, predecessor)) {
-                    Loop_add_block(loop, predecessor);
-                    VCALL(worklist, push_back, predecessor);
-                    
-                    // printf("  添加节点 B%u 到循环\n", predecessor->label);
+    for (int w = (int)n - 1; w >= 0; w--) {
+        unsigned cnt = 0;
+        for (int e = f->back_preds.head[w]; e >= 0; e = f->back_preds.next[e]) {
+            int v = f->back_preds.val[e];
+            if (v == w) {
+                f->type[w] = LOOP_NODE_SELF;
+                continue;
+            }
+            int x = union_find(uf_parent, v);
+            if (in_body[x] != w) {
+                in_body[x] = w;
+                body[cnt++] = x;
+            }
+        }
+        if (cnt) f->type[w] = LOOP_NODE_REDUCIBLE;
+        for (unsigned i = 0; i < cnt; i++) {
+            int x = body[i];
+            for (int e = f->non_back_preds.head[x]; e >= 0; e = f->non_back_preds.next[e]) {
+                int y = union_find(uf_parent, f->non_back_preds.val[e]);
+                if (!is_dfs_ancestor(f, w, y)) {
+                    f->type[w] = LOOP_NODE_IRREDUCIBLE;
+                    LoopEdgeList_add(&f->non_back_preds, w, y);
+                } else if (y != w && in_body[y] != w) {
+                    in_body[y] = w;
+                    body[cnt++] = y;
                 }
             }
         }
+        for (unsigned i = 0; i < cnt; i++) {
+            f->header[body[i]] = w;
+            uf_parent[body[i]] = w;
+        }
     }
-    
-    List_IR_block_ptr_teardown(&worklist);
-    
-    // 计算循环大小
-    int block_count = 0;
-    SetNode_IR_block_ptr *node = (SetNode_IR_block_ptr*)loop->blocks.root;
-    if (node) {
-        // 简单计算（实际应该遍历整个treap）
-        block_count = 1; // 至少包含头节点
-        // 这里只是估算，实际实现需要遍历整个treap
-    }
-    
-    // printf("循环构造完成，包含约 %d 个基本块\n\n", block_count);
+    free(uf_parent);
+    free(body);
+    free(in_body);
+}
+
+static void LoopForest_teardown(LoopForest *f) {
+    free(f->blocks);
+    free(f->last);
+    free(f->header);
+    free(f->type);
+    LoopEdgeList_teardown(&f->back_preds);
+    LoopEdgeList_teardown(&f->non_back_preds);
 }
 
 //// ================================== 循环检测主算法 ==================================
 
-void LoopAnalyzer_detect_loops(LoopAnalyzer *analyzer) {
-    if (!analyzer || !analyzer->function || !analyzer->dom_analyzer) return;
-    
-    // printf("=== 开始循环检测 ===\n");
-    // printf("函数: %s\n", analyzer->function->func_name);
-    
-    // 1. 检测所有回边
-    detect_back_edges(analyzer);
-    
-    // 2. 为每条回边构造自然循环
-    for (ListNode_BackEdge *edge_node = analyzer->back_edges.head;
-         edge_node != NULL; edge_node = edge_node->nxt) {
-        
-        BackEdge back_edge = edge_node->val;
-        
-        // 检查是否已经为此循环头创建了循环
-        Loop_ptr existing_loop = NULL;
-        for (ListNode_Loop_ptr *loop_node = analyzer->all_loops.head;
-             loop_node != NULL; loop_node = loop_node->nxt) {
-            
-            Loop_ptr loop = loop_node->val;
-            if (loop->header == back_edge.target) {
-                existing_loop = loop;
-                break;
+// 退出块与外部后继：沿最内层循环向外，直到某层循环包含该后继为止
+static void compute_loop_exits(LoopAnalyzer *analyzer) {
+    IR_function *func = analyzer->function;
+    for_list(IR_block_ptr, i, func->blocks) {
+        IR_block_ptr block = i->val;
+        Loop_ptr innermost = LoopAnalyzer_get_innermost_loop(analyzer, block);
+        if (!innermost) continue;
+        List_IR_block_ptr *succs = VCALL(func->blk_succ, get, block);
+        for_list(IR_block_ptr, j, *succs) {
+            for (Loop_ptr loop = innermost; loop && !Loop_contains_block(loop, j->val); loop = loop->parent_loop) {
+                if (!loop->exit_blocks.tail || loop->exit_blocks.tail->val != block)
+                    VCALL(loop->exit_blocks, push_back, block);
+                bool seen = false;
+                for_list(IR_block_ptr, k, loop->exit_targets)
+                    if (k->val == j->val) seen = true;
+                if (!seen) VCALL(loop->exit_targets, push_back, j->val);
             }
         }
-        
-        if (existing_loop) {
-            // 为现有循环添加回边源
-            Loop_add_back_edge_source(existing_loop, back_edge.source);
-            // printf("为现有循环 (头节点 B%u) 添加回边源 B%u\n", 
-                //    existing_loop->header->label, back_edge.source->label);
-        } else {
-            // 创建新循环
-            Loop_ptr new_loop = (Loop_ptr)malloc(sizeof(Loop));
-            if (!new_loop) {
-                // printf("错误: 内存分配失败\n");
-                continue;
-            }
-            
-            Loop_init(new_loop, back_edge.target);
-            Loop_add_back_edge_source(new_loop, back_edge.source);
-            
-            // 构造自然循环
-            construct_natural_loop(analyzer, &back_edge, new_loop);
-            
-            // 添加到分析器的循环列表
-            VCALL(analyzer->all_loops, push_back, new_loop);
-            
-            // printf("创建新循环，头节点: B%u\n", new_loop->header->label);
-        }
     }
-    
-    // 3. 更新块到循环的映射
-    for (ListNode_Loop_ptr *loop_node = analyzer->all_loops.head;
-         loop_node != NULL; loop_node = loop_node->nxt) {
-        
-        Loop_ptr loop = loop_node->val;
-        
-        // 这里需要遍历Set_IR_block_ptr，但treap的遍历比较复杂
-        // 暂时跳过详细映射，主要逻辑已经实现
+}
+
+void LoopAnalyzer_detect_loops(LoopAnalyzer *analyzer) {
+    if (!analyzer || !analyzer->function || !analyzer->dom_analyzer) return;
+    if (!analyzer->dom_analyzer->rpo_blocks) return;
+
+    LoopForest forest;
+    number_blocks(analyzer, &forest);
+    compute_loop_headers(&forest);
+    unsigned n = forest.n;
+    Loop_ptr *loop_of = (Loop_ptr*)malloc(sizeof(Loop_ptr[n ? n : 1]));
+
+    // 先序逆序创建循环, 内层循环排在外层之前
+    for (int w = (int)n - 1; w >= 0; w--) {
+        loop_of[w] = NULL;
+        if (forest.type[w] == LOOP_NODE_NONHEADER) continue;
+        Loop_ptr loop = (Loop_ptr)malloc(sizeof(Loop));
+        Loop_init(loop, forest.blocks[w]);
+        loop->is_reducible = forest.type[w] != LOOP_NODE_IRREDUCIBLE;
+        loop_of[w] = loop;
+        VCALL(analyzer->all_loops, push_back, loop);
     }
-    
-    // 计算循环数量
-    int loop_count = 0;
-    for (ListNode_Loop_ptr *node = analyzer->all_loops.head; node != NULL; node = node->nxt) {
-        loop_count++;
+    // 先序正序连接父子关系, 父循环的深度总是先确定
+    for (unsigned w = 0; w < n; w++) {
+        Loop_ptr loop = loop_of[w];
+        if (!loop) continue;
+        List_IR_block_ptr *preds = VCALL(analyzer->function->blk_pred, get, loop->header);
+        for (int e = forest.back_preds.head[w]; e >= 0; e = forest.back_preds.next[e]) {
+            IR_block_ptr source = forest.blocks[forest.back_preds.val[e]];
+            BackEdge back_edge = {.source = source, .target = loop->header};
+            VCALL(analyzer->back_edges, push_back, back_edge);
+        }
+        // 回边源按前驱表的顺序记录
+        for_list(IR_block_ptr, i, *preds)
+            for (int e = forest.back_preds.head[w]; e >= 0; e = forest.back_preds.next[e])
+                if (forest.blocks[forest.back_preds.val[e]] == i->val) {
+                    Loop_add_back_edge_source(loop, i->val);
+                    break;
+                }
+        if (forest.header[w] >= 0) Loop_set_parent(loop, loop_of[forest.header[w]]);
+        else VCALL(analyzer->top_level_loops, push_back, loop);
     }
-    
-    // printf("=== 循环检测完成 ===\n");
-    // printf("总共发现 %d 个循环\n\n", loop_count);
+    // 每个块记入其最内层循环及所有外层循环
+    for (unsigned v = 0; v < n; v++) {
+        Loop_ptr innermost = loop_of[v] ? loop_of[v] : forest.header[v] >= 0 ? loop_of[forest.header[v]] : NULL;
+        if (!innermost) continue;
+        VCALL(analyzer->block_to_loop, insert, forest.blocks[v], innermost);
+        for (Loop_ptr loop = innermost; loop; loop = loop->parent_loop)
+            Loop_add_block(loop, forest.blocks[v]);
+    }
+    compute_loop_exits(analyzer);
+
+    free(loop_of);
+    LoopForest_teardown(&forest);
 }
 
 //// ================================== 循环层次结构构建 ==================================
 
 void LoopAnalyzer_build_loop_hierarchy(LoopAnalyzer *analyzer) {
-    if (!analyzer) return;
-    
-    // printf("=== 构建循环层次结构 ===\n");
-    
-    // 首先将所有循环标记为顶层循环
-    for (ListNode_Loop_ptr *node = analyzer->all_loops.head; node != NULL; node = node->nxt) {
-        Loop_ptr loop = node->val;
-        VCALL(analyzer->top_level_loops, push_back, loop);
-    }
-    
-    // 检查循环嵌套关系
-    for (ListNode_Loop_ptr *outer_node = analyzer->all_loops.head; 
-         outer_node != NULL; outer_node = outer_node->nxt) {
-        
-        Loop_ptr outer_loop = outer_node->val;
-        
-        for (ListNode_Loop_ptr *inner_node = analyzer->all_loops.head;
-             inner_node != NULL; inner_node = inner_node->nxt) {
-            
-            Loop_ptr inner_loop = inner_node->val;
-            
-            // 跳过自身
-            if (outer_loop == inner_loop) continue;
-            
-            // 简化的嵌套检查 - 检查内层循环的头是否在外层循环中
-            if (Loop_contains_block(outer_loop, inner_loop->header)) {
-                // inner_loop嵌套在outer_loop中
-                
-                // 检查是否已有更合适的父循环
-                if (!inner_loop->parent_loop) {
-                    Loop_set_parent(inner_loop, outer_loop);
-                    
-                    // 从顶层循环列表中移除
-                    ListNode_Loop_ptr *remove_node = analyzer->top_level_loops.head;
-                    while (remove_node) {
-                        if (remove_node->val == inner_loop) {
-                            VCALL(analyzer->top_level_loops, delete, remove_node);
-                            break;
-                        }
-                        remove_node = remove_node->nxt;
-                    }
-                    
-                    // printf("循环 B%u 嵌套在循环 B%u 中，深度: %d\n", 
-                        //    inner_loop->header->label, outer_loop->header->label, inner_loop->depth);
-                }
-            }
-        }
-    }
-    
-    // 计算顶层循环数量
-    int top_count = 0;
-    for (ListNode_Loop_ptr *node = analyzer->top_level_loops.head; node != NULL; node = node->nxt) {
-        top_count++;
-    }
-    
-    // printf("=== 循环层次结构构建完成 ===\n");
-    // printf("顶层循环数量: %d\n\n", top_count);
+    // 嵌套关系已在 LoopAnalyzer_detect_loops 中随循环森林一并建立
+    (void)analyzer;
 }
 
 //// ================================== 查询接口实现 ==================================
@@ -415,149 +454,206 @@ bool Loop_is_nested_in(Loop *inner, Loop *outer) {
 
 void Loop_get_exit_blocks(Loop *loop, List_IR_block_ptr *exits) {
     if (!loop || !exits) return;
-    
-    // 遍历循环中的所有块（简化实现）
-    // 实际需要遍历Set_IR_block_ptr，这里跳过详细实现
-    // printf("获取循环 B%u 的退出块（功能未完全实现）\n", loop->header->label);
+    for_list(IR_block_ptr, i, loop->exit_blocks)
+        VCALL(*exits, push_back, i->val);
 }
 
 void Loop_get_exit_targets(Loop *loop, List_IR_block_ptr *exit_targets) {
     if (!loop || !exit_targets) return;
-    
-    // 遍历循环中的所有块（简化实现）
-    // printf("获取循环 B%u 的退出目标（功能未完全实现）\n", loop->header->label);
+    for_list(IR_block_ptr, i, loop->exit_targets)
+        VCALL(*exit_targets, push_back, i->val);
+}
+
+unsigned Loop_stmt_count(Loop *loop) {
+    unsigned cnt = 0;
+    for_set(IR_block_ptr, i, loop->blocks)
+        for_list(IR_stmt_ptr, j, i->key->stmts) cnt++;
+    return cnt;
+}
+
+IR_block_ptr *Loop_collect_blocks(IR_function *func, Loop *loop, unsigned *n, ListNode_IR_block_ptr **last_node) {
+    unsigned cnt = 0;
+    for_list(IR_block_ptr, i, func->blocks)
+        if (Loop_contains_block(loop, i->val)) cnt++;
+    IR_block_ptr *blocks = (IR_block_ptr*)malloc(sizeof(IR_block_ptr) * cnt);
+    cnt = 0;
+    for_list(IR_block_ptr, i, func->blocks) {
+        if (!Loop_contains_block(loop, i->val)) continue;
+        blocks[cnt++] = i->val;
+        if (last_node) *last_node = i;
+    }
+    *n = cnt;
+    return blocks;
 }
 
 //// ================================== 预备首部创建 ==================================
 
+// 判断基本块执行完最后一条语句后是否会顺序执行到链表中的下一个块
+static bool block_falls_through(IR_block_ptr block) {
+    if (!block->stmts.tail) return true;
+    IR_stmt *last = block->stmts.tail->val;
+    switch (last->stmt_type) {
+        case IR_GOTO_STMT:
+        case IR_RETURN_STMT:
+            return false;
+        case IR_IF_STMT:
+            return ((IR_if_stmt*)last)->false_label == IR_LABEL_NONE;
+        default:
+            return true;
+    }
+}
+
+/**
+ * @brief 选择新预备首部在块链表中的位置，返回其后一个结点（新块插在它前面）
+ * 通常放在循环头之前；若循环头的前一个块是顺序执行到循环头的循环内块，
+ * 放在那里会让每次迭代都经过预备首部，此时改放到某个不会顺序执行下去的块之后
+ */
+static ListNode_IR_block_ptr *preheader_position(LoopAnalyzer *analyzer, Loop *loop, bool *after) {
+    IR_function *func = analyzer->function;
+    ListNode_IR_block_ptr *header_node = NULL;
+    for_list(IR_block_ptr, i, func->blocks)
+        if (i->val == loop->header) {
+            header_node = i;
+            break;
+        }
+    if (!header_node) return NULL;
+    ListNode_IR_block_ptr *prev = header_node->pre;
+    if (!prev || !block_falls_through(prev->val) || !Loop_contains_block(loop, prev->val)) {
+        *after = false;
+        return header_node;
+    }
+    rfor_list(IR_block_ptr, i, func->blocks)
+        if (i->val != func->exit && !block_falls_through(i->val)) {
+            *after = true;
+            return i;
+        }
+    return NULL;
+}
+
+// 外部前驱 pred 原先跳出的循环现在跳到预备首部
+static void retarget_exit_targets(LoopAnalyzer *analyzer, IR_block_ptr pred, Loop *loop) {
+    for (Loop_ptr outer = LoopAnalyzer_get_innermost_loop(analyzer, pred);
+         outer && !Loop_contains_block(outer, loop->header); outer = outer->parent_loop) {
+        bool has_preheader = false;
+        for_list(IR_block_ptr, i, outer->exit_targets)
+            if (i->val == loop->preheader) has_preheader = true;
+        for (ListNode_IR_block_ptr *i = outer->exit_targets.head; i;) {
+            if (i->val != loop->header) {
+                i = i->nxt;
+                continue;
+            }
+            if (has_preheader) i = VCALL(outer->exit_targets, delete, i);
+            else {
+                i->val = loop->preheader;
+                has_preheader = true;
+                i = i->nxt;
+            }
+        }
+    }
+}
+
 void LoopAnalyzer_create_preheaders(LoopAnalyzer *analyzer) {
     if (!analyzer) return;
-    
-    // printf("=== 创建循环预备首部 ===\n");
+    IR_function *func = analyzer->function;
     
     for (ListNode_Loop_ptr *loop_node = analyzer->all_loops.head;
          loop_node != NULL; loop_node = loop_node->nxt) {
         
         Loop_ptr loop = loop_node->val;
+        loop->preheader = NULL;
+        // 不可约循环有多个入口, 没有合适的预备首部
+        if (!loop->is_reducible) continue;
         
-        // 简化的预备首部分析
         // 1. 找到所有来自循环外部的前驱
-        List_ptr_IR_block_ptr preds = VCALL(analyzer->function->blk_pred, get, loop->header);
+        List_ptr_IR_block_ptr preds = VCALL(func->blk_pred, get, loop->header);
         List_IR_block_ptr outside_preds;
         List_IR_block_ptr_init(&outside_preds);
-        if (preds) {
-            for (ListNode_IR_block_ptr *pred_node = preds->head; pred_node; pred_node = pred_node->nxt) {
-                IR_block_ptr pred = pred_node->val;
-                if (!Loop_contains_block(loop, pred)) {
-                    VCALL(outside_preds, push_back, pred);
-                }
-            }
-        }
+        for_list(IR_block_ptr, i, *preds)
+            if (!Loop_contains_block(loop, i->val))
+                VCALL(outside_preds, push_back, i->val);
         if (outside_preds.head == NULL) {
-            loop->preheader = NULL;
-            // printf("循环 B%u 没有外部前驱, 无需预备首部\n", loop->header->label);
-        } else if (outside_preds.head == outside_preds.tail &&
-                   VCALL(analyzer->function->blk_succ, get, outside_preds.head->val)->head == NULL ? 0 :
-                   (VCALL(analyzer->function->blk_succ, get, outside_preds.head->val)->head->val == loop->header &&
-                    VCALL(analyzer->function->blk_succ, get, outside_preds.head->val)->head->nxt == NULL)) {
-            // 唯一外部前驱且只指向header
-            loop->preheader = outside_preds.head->val;
-            // printf("循环 B%u 唯一外部前驱 B%u 作为预备首部\n", loop->header->label, loop->preheader->label);
-        } else {
-            // 创建新的preheader块
-            IR_block_ptr preheader = (IR_block_ptr)malloc(sizeof(IR_block));
-            IR_block_init(preheader, ir_label_generator());
-            
-            // Create goto statement to header using proper initialization
-            IR_goto_stmt *goto_stmt = (IR_goto_stmt*)malloc(sizeof(IR_goto_stmt));
-            IR_goto_stmt_init(goto_stmt, loop->header->label);
-            goto_stmt->blk = loop->header;
-            
-            VCALL(preheader->stmts, push_back, (IR_stmt*)goto_stmt);
-            
-            // Insert preheader at correct position in function's block list
-            // Find the position of the loop header and insert preheader before it
-            ListNode_IR_block_ptr *header_node = NULL;
-            for (ListNode_IR_block_ptr *node = analyzer->function->blocks.head; node; node = node->nxt) {
-                if (node->val == loop->header) {
-                    header_node = node;
-                    break;
-                }
-            }
-            
-            if (header_node) {
-                // Create new node for preheader
-                ListNode_IR_block_ptr *new_node = (ListNode_IR_block_ptr*)malloc(sizeof(ListNode_IR_block_ptr));
-                new_node->val = preheader;
-                
-                // Insert before header_node
-                if (header_node == analyzer->function->blocks.head) {
-                    // Insert at the beginning
-                    new_node->nxt = analyzer->function->blocks.head;
-                    analyzer->function->blocks.head = new_node;
-                } else {
-                    // Find the node before header_node
-                    ListNode_IR_block_ptr *prev = analyzer->function->blocks.head;
-                    while (prev && prev->nxt != header_node) {
-                        prev = prev->nxt;
-                    }
-                    if (prev) {
-                        new_node->nxt = header_node;
-                        prev->nxt = new_node;
-                    }
-                }
-            } else {
-                // Fallback: add to end if header not found
-                VCALL(analyzer->function->blocks, push_back, preheader);
-            }
-            
-            // Initialize CFG entries for the new block
-            VCALL(analyzer->function->blk_pred, insert, preheader, NEW(List_IR_block_ptr));
-            VCALL(analyzer->function->blk_succ, insert, preheader, NEW(List_IR_block_ptr));
-            
-            // Add edge from preheader to header
-            List_IR_block_ptr *preheader_succs = VCALL(analyzer->function->blk_succ, get, preheader);
-            List_IR_block_ptr *header_preds = VCALL(analyzer->function->blk_pred, get, loop->header);
-            VCALL(*preheader_succs, push_back, loop->header);
-            VCALL(*header_preds, push_back, preheader);
-            
-            // Redirect all outside predecessors to point to preheader instead of header
-            for (ListNode_IR_block_ptr *pred_node = outside_preds.head; pred_node; pred_node = pred_node->nxt) {
-                IR_block_ptr pred = pred_node->val;
-                
-                // Update predecessor's successor list: remove header, add preheader
-                List_IR_block_ptr *pred_succs = VCALL(analyzer->function->blk_succ, get, pred);
-                if (pred_succs) {
-                    // Remove header from pred's successors
-                    for (ListNode_IR_block_ptr *succ_node = pred_succs->head; succ_node; succ_node = succ_node->nxt) {
-                        if (succ_node->val == loop->header) {
-                            succ_node->val = preheader;
-                            break;
-                        }
-                    }
-                }
-                
-                // Add pred to preheader's predecessors
-                List_IR_block_ptr *preheader_preds = VCALL(analyzer->function->blk_pred, get, preheader);
-                VCALL(*preheader_preds, push_back, pred);
-                
-                // Remove pred from header's predecessors (but keep back edges)
-                if (!Loop_contains_block(loop, pred)) {
-                    for (ListNode_IR_block_ptr *header_pred = header_preds->head; header_pred; header_pred = header_pred->nxt) {
-                        if (header_pred->val == pred) {
-                            VCALL(*header_preds, delete, header_pred);
-                            break;
-                        }
-                    }
+            List_IR_block_ptr_teardown(&outside_preds);
+            continue;
+        }
+
+        // 2. 唯一外部前驱且只指向循环头, 直接作为预备首部
+        IR_block_ptr only_pred = outside_preds.head->val;
+        List_IR_block_ptr *only_pred_succs = VCALL(func->blk_succ, get, only_pred);
+        if (outside_preds.head == outside_preds.tail && only_pred_succs->head &&
+            only_pred_succs->head == only_pred_succs->tail) {
+            loop->preheader = only_pred;
+            List_IR_block_ptr_teardown(&outside_preds);
+            continue;
+        }
+
+        // 3. 创建新的预备首部, 以 GOTO 循环头结尾
+        bool after = false;
+        ListNode_IR_block_ptr *pos = preheader_position(analyzer, loop, &after);
+        if (!pos) {
+            List_IR_block_ptr_teardown(&outside_preds);
+            continue;
+        }
+        IR_block_ptr preheader = NEW(IR_block, ir_label_generator());
+        VCALL(preheader->stmts, push_back, IR_goto_new(loop->header));
+        if (after) VCALL(func->blocks, insert_back, pos, preheader);
+        else VCALL(func->blocks, insert_front, pos, preheader);
+        VCALL(func->map_blk_label, insert, preheader->label, preheader);
+        loop->preheader = preheader;
+
+        // 4. 维护CFG: 外部前驱 -> 预备首部 -> 循环头, 并重定向外部前驱的跳转
+        List_IR_block_ptr *preheader_preds = NEW(List_IR_block_ptr);
+        List_IR_block_ptr *preheader_succs = NEW(List_IR_block_ptr);
+        VCALL(*preheader_succs, push_back, loop->header);
+        VCALL(func->blk_pred, insert, preheader, preheader_preds);
+        VCALL(func->blk_succ, insert, preheader, preheader_succs);
+        for (ListNode_IR_block_ptr *i = preds->head; i;) {
+            if (Loop_contains_block(loop, i->val)) i = i->nxt;
+            else i = VCALL(*preds, delete, i);
+        }
+        VCALL(*preds, push_back, preheader);
+        for_list(IR_block_ptr, i, outside_preds) {
+            IR_block_ptr pred = i->val;
+            List_IR_block_ptr *pred_succs = VCALL(func->blk_succ, get, pred);
+            bool redirected = false;
+            for_list(IR_block_ptr, j, *pred_succs)
+                if (j->val == loop->header && !redirected) {
+                    j->val = preheader;
+                    redirected = true;
                 }
-            }
-            loop->preheader = preheader;
-            // printf("循环 B%u 创建新预备首部 B%u\n", loop->header->label, preheader->label);
+            VCALL(*preheader_preds, push_back, pred);
+            replace_successor(pred, loop->header, preheader);
+            retarget_exit_targets(analyzer, pred, loop);
+        }
+
+        // 5. 预备首部属于循环的所有外层循环
+        if (loop->parent_loop) {
+            VCALL(analyzer->block_to_loop, insert, preheader, loop->parent_loop);
+            for (Loop_ptr outer = loop->parent_loop; outer; outer = outer->parent_loop)
+                Loop_add_block(outer, preheader);
         }
         List_IR_block_ptr_teardown(&outside_preds);
     }
-    
-    // printf("=== 预备首部创建完成 ===\n\n");
+}
+
+void LoopAnalyzer_refresh_dominators(LoopAnalyzer *analyzer) {
+    DominanceAnalyzer *dom_analyzer = analyzer->dom_analyzer;
+    DominanceAnalyzer_teardown(dom_analyzer);
+    DominanceAnalyzer_init(dom_analyzer, analyzer->function);
+    DominanceAnalyzer_compute_dominators(dom_analyzer);
+}
+
+void LoopAnalyzer_recompute(LoopAnalyzer *analyzer) {
+    IR_function *func = analyzer->function;
+    DominanceAnalyzer *dom_analyzer = analyzer->dom_analyzer;
+    LoopAnalyzer_teardown(analyzer);
+    DominanceAnalyzer_teardown(dom_analyzer);
+    DominanceAnalyzer_init(dom_analyzer, func);
+    DominanceAnalyzer_compute_dominators(dom_analyzer);
+    LoopAnalyzer_init(analyzer, func, dom_analyzer);
+    LoopAnalyzer_detect_loops(analyzer);
+    LoopAnalyzer_build_loop_hierarchy(analyzer);
+    LoopAnalyzer_create_preheaders(analyzer);
+    LoopAnalyzer_refresh_dominators(analyzer);
 }
 
 //// ================================== 结果输出 ==================================
@@ -570,8 +666,8 @@ void Loop_print_details(Loop *loop, FILE *out, int indent) {
         fprintf(out, "  ");
     }
     
-    fprintf(out, "循环 (头节点: B%u, 深度: %d)\n", 
-            loop->header->label, loop->depth);
+    fprintf(out, "循环 (头节点: B%u, 深度: %d%s)\n", 
+            loop->header->label, loop->depth, loop->is_reducible ? "" : ", 不可约");
     
     // 打印回边
     if (loop->back_edges_sources.head) {
@@ -0,0 +1,304 @@
+//
+// Created by Assistant
+// 循环删除 (Loop Deletion)
+//
+
+#include <loop_deletion.h>
+#include <live_variable_analysis.h>
+#include <limits.h>
+#include <stdlib.h>
+
+//// ================================== 辅助函数 ==================================
+
+static bool block_list_is_single(List_IR_block_ptr *list) {
+    return list->head != NULL && list->head == list->tail;
+}
+
+static bool has_side_effect(IR_stmt *stmt) {
+    switch (stmt->stmt_type) {
+        case IR_STORE_STMT:
+        case IR_CALL_STMT:
+        case IR_RETURN_STMT:
+        case IR_READ_STMT:
+        case IR_WRITE_STMT:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+ * @brief 从 blk 出发沿循环内不指向循环头的边搜索，判断一次迭代内是否有环（内层循环或不可约的环）。
+ */
+static bool has_inner_cycle(IR_function *func, Loop_ptr loop, IR_block *blk,
+                            Set_IR_block_ptr *on_path, Set_IR_block_ptr *done) {
+    VCALL(*on_path, insert, blk);
+    bool cycle = false;
+    for_list(IR_block_ptr, i, *VCALL(func->blk_succ, get, blk)) {
+        IR_block *succ = i->val;
+        if (succ == loop->header || !Loop_contains_block(loop, succ) || VCALL(*done, exist, succ)) continue;
+        if (VCALL(*on_path, exist, succ) || has_inner_cycle(func, loop, succ, on_path, done)) {
+            cycle = true;
+            break;
+        }
+    }
+    VCALL(*on_path, delete, blk);
+    VCALL(*done, insert, blk);
+    return cycle;
+}
+
+static bool fits_int(long long value) {
+    return value >= INT_MIN && value <= INT_MAX;
+}
+
+//// ================================== 出口值 ==================================
+
+/**
+ * @brief 判断一次迭代中语句 a（位于块 a_blk）是否先于位置 b（块 b_blk 中的语句 b，NULL 表示块末尾）执行。
+ * @return 1 表示先于，0 表示后于，-1 表示二者的先后不确定。
+ */
+static int executes_before(DominanceAnalyzer *dom, IR_block *a_blk, IR_stmt *a, IR_block *b_blk, IR_stmt *b) {
+    if (a_blk == b_blk) {
+        if (!b) return 1;
+        for_list(IR_stmt_ptr, i, a_blk->stmts) {
+            if (i->val == a) return 1;
+            if (i->val == b) return 0;
+        }
+        return -1;
+    }
+    if (DominanceAnalyzer_dominates(dom, a_blk, b_blk)) return 1;
+    if (DominanceAnalyzer_dominates(dom, b_blk, a_blk)) return 0;
+    return -1;
+}
+
+/**
+ * @brief 块是否位于循环本身（不在内层循环）并且支配所有回边源，即每次完整的迭代恰好执行一次。
+ */
+static bool executes_every_iteration(LoopAnalyzer *loop_analyzer, Loop_ptr loop, IR_block *blk) {
+    if (VCALL(loop_analyzer->block_to_loop, get, blk) != loop) return false;
+    for_list(IR_block_ptr, i, loop->back_edges_sources)
+        if (!DominanceAnalyzer_dominates(loop_analyzer->dom_analyzer, blk, i->val)) return false;
+    return true;
+}
+
+/**
+ * @brief 求基本归纳变量在第 iteration 次迭代（从 0 开始）中位置 (blk, stmt) 处相对进入循环时的增量。
+ * 每条增量都须每次完整的迭代恰好执行一次。
+ */
+static bool iteration_offset(InductionVariableAnalyzer *iv_analyzer, Loop_ptr loop,
+                             BasicInductionVariable_ptr basic_iv, unsigned iteration,
+                             IR_block *blk, IR_stmt *stmt, long long *offset) {
+    LoopAnalyzer *loop_analyzer = iv_analyzer->loop_analyzer;
+    DominanceAnalyzer *dom = loop_analyzer->dom_analyzer;
+    if (!basic_iv->increment_stmt) return false;
+
+    long long total = 0, before = 0;
+    for_list(IR_stmt_ptr, i, basic_iv->increment_stmts) {
+        IR_block *inc_blk = DefUseChain_site_of(&iv_analyzer->def_use, i->val)->blk;
+        if (!executes_every_iteration(loop_analyzer, loop, inc_blk)) return false;
+
+        LinearForm form;
+        if (!InductionVariableAnalyzer_get_linear_form(iv_analyzer, i->val, &form)) return false;
+        int order = executes_before(dom, inc_blk, i->val, blk, stmt);
+        if (order < 0) return false;
+        total += form.constant;
+        if (order) before += form.constant;
+    }
+    *offset = total * iteration + before;
+    return fits_int(*offset);
+}
+
+bool LoopDeletion_exit_value(InductionVariableAnalyzer *iv_analyzer, LoopInductionVariables_ptr loop_ivs,
+                             IR_block_ptr exiting, unsigned trip_count, IR_var var, ExitValue *value) {
+    Loop_ptr loop = loop_ivs->loop;
+    long long offset;
+    value->variable = var;
+
+    // 基本归纳变量：退出块末尾的值
+    if (VCALL(loop_ivs->basic_iv_map, exist, var)) {
+        BasicInductionVariable_ptr basic_iv = VCALL(loop_ivs->basic_iv_map, get, var);
+        if (!iteration_offset(iv_analyzer, loop, basic_iv, trip_count - 1, exiting, NULL, &offset)) return false;
+        value->source = var;
+        value->coefficient = 1;
+        value->constant = (int)offset;
+        return true;
+    }
+
+    // 派生归纳变量：唯一定义最后一次执行时的值，定义在退出块之前时位于最后一次迭代，之后时位于倒数第二次
+    if (!VCALL(loop_ivs->derived_iv_map, exist, var)) return false;
+    DerivedInductionVariable_ptr derived_iv = VCALL(loop_ivs->derived_iv_map, get, var);
+    if (derived_iv->base != IR_VAR_NONE || !derived_iv->definition_stmt) return false;
+    LoopAnalyzer *loop_analyzer = iv_analyzer->loop_analyzer;
+    IR_block *def_blk = DefUseChain_site_of(&iv_analyzer->def_use, derived_iv->definition_stmt)->blk;
+    if (!executes_every_iteration(loop_analyzer, loop, def_blk)) return false;
+    int order = executes_before(loop_analyzer->dom_analyzer, def_blk, derived_iv->definition_stmt, exiting, NULL);
+    if (order < 0 || (order == 0 && trip_count < 2)) return false;
+    unsigned iteration = order ? trip_count - 1 : trip_count - 2;
+    if (!iteration_offset(iv_analyzer, loop, derived_iv->basic_iv, iteration,
+                          def_blk, derived_iv->definition_stmt, &offset))
+        return false;
+    long long constant = (long long)derived_iv->coefficient * offset + derived_iv->constant;
+    if (!fits_int(constant)) return false;
+    value->source = derived_iv->basic_iv->variable;
+    value->coefficient = derived_iv->coefficient;
+    value->constant = (int)constant;
+    return true;
+}
+
+//// ================================== 删除方案 ==================================
+
+bool LoopDeletion_plan(ScalarEvolution *se, InductionVariableAnalyzer *iv_analyzer,
+                       Set_IR_var *live_in, Loop_ptr loop, DeletionPlan *plan) {
+    IR_function *func = se->function;
+    if (!loop->is_reducible || loop->nested_loops.head != NULL || !loop->preheader) return false;
+    if (!block_list_is_single(&loop->exit_blocks) || !block_list_is_single(&loop->exit_targets)) return false;
+    IR_block *exiting = loop->exit_blocks.head->val;
+    IR_block *exit_target = loop->exit_targets.head->val;
+    if (exit_target == func->exit) return false;
+    if (exiting->stmts.tail == NULL || exiting->stmts.tail->val->stmt_type != IR_IF_STMT) return false;
+    IR_stmt *preheader_last = loop->preheader->stmts.tail ? loop->preheader->stmts.tail->val : NULL;
+    if (preheader_last && preheader_last->stmt_type == IR_IF_STMT) return false;
+
+    for_set(IR_block_ptr, i, loop->blocks)
+        for_list(IR_stmt_ptr, j, i->key->stmts)
+            if (has_side_effect(j->val)) return false;
+
+    // 一次迭代内有环时执行次数为常量也不能保证循环终止
+    Set_IR_block_ptr on_path, done;
+    Set_IR_block_ptr_init(&on_path);
+    Set_IR_block_ptr_init(&done);
+    bool cycle = has_inner_cycle(func, loop, loop->header, &on_path, &done);
+    Set_IR_block_ptr_teardown(&on_path);
+    Set_IR_block_ptr_teardown(&done);
+    if (cycle) return false;
+
+    // 常量执行次数已排除 IV 回绕的情形, 恒成立的退出条件不会得到次数
+    unsigned trip_count;
+    if (!ScalarEvolution_get_constant_trip_count(se, loop, &trip_count) || trip_count == 0) return false;
+    LoopInductionVariables_ptr loop_ivs = InductionVariableAnalyzer_get_loop_ivs(iv_analyzer, loop);
+    if (!loop_ivs) return false;
+
+    // 循环内定义且离开循环后仍被读取的变量都须有出口值
+    unsigned value_cnt = 0;
+    ExitValue *values = NULL;
+    bool ok = true;
+    for_map(IR_var, List_ptr_IR_stmt_ptr, i, loop_ivs->def_sites) {
+        if (live_in && !VCALL(*live_in, exist, i->key)) continue;
+        values = (ExitValue*)realloc(values, sizeof(ExitValue) * (value_cnt + 1));
+        if (!LoopDeletion_exit_value(iv_analyzer, loop_ivs, exiting, trip_count, i->key, &values[value_cnt])) {
+            ok = false;
+            break;
+        }
+        value_cnt++;
+    }
+    if (!ok) {
+        free(values);
+        return false;
+    }
+    plan->loop = loop;
+    plan->exit_target = exit_target;
+    plan->trip_count = trip_count;
+    plan->value_cnt = value_cnt;
+    plan->values = values;
+    return true;
+}
+
+//// ================================== 删除 ==================================
+
+static void append_exit_value(IR_block *blk, const ExitValue *value) {
+    IR_val source = {.is_const = false, .var = value->source};
+    IR_val constant = {.is_const = true, .const_val = value->constant};
+    if (value->coefficient == 1) {
+        if (value->variable == value->source && value->constant == 0) return;
+        if (value->constant == 0)
+            VCALL(blk->stmts, push_back, (IR_stmt*)NEW(IR_assign_stmt, value->variable, source));
+        else
+            VCALL(blk->stmts, push_back, (IR_stmt*)NEW(IR_op_stmt, IR_OP_ADD, value->variable, source, constant));
+        return;
+    }
+    IR_val coefficient = {.is_const = true, .const_val = value->coefficient};
+    IR_val variable = {.is_const = false, .var = value->variable};
+    VCALL(blk->stmts, push_back, (IR_stmt*)NEW(IR_op_stmt, IR_OP_MUL, value->variable, source, coefficient));
+    if (value->constant != 0)
+        VCALL(blk->stmts, push_back, (IR_stmt*)NEW(IR_op_stmt, IR_OP_ADD, value->variable, variable, constant));
+}
+
+void LoopDeletion_delete(IR_function *func, const DeletionPlan *plan) {
+    Loop_ptr loop = plan->loop;
+    IR_block *preheader = loop->preheader;
+
+    // 预备首部去掉指向循环头的跳转，先计算派生归纳变量（用到基本归纳变量的初值），再更新基本归纳变量
+    IR_stmt *last = preheader->stmts.tail ? preheader->stmts.tail->val : NULL;
+    if (last && last->stmt_type == IR_GOTO_STMT) {
+        RDELETE(IR_stmt, last);
+        VCALL(preheader->stmts, pop_back);
+    }
+    for (int basic = 0; basic < 2; basic++)
+        for (unsigned i = 0; i < plan->value_cnt; i++)
+            if ((plan->values[i].variable == plan->values[i].source) == basic)
+                append_exit_value(preheader, &plan->values[i]);
+    IR_function_ensure_label(func, plan->exit_target);
+    VCALL(preheader->stmts, push_back, IR_goto_new(plan->exit_target));
+
+    // 删除循环的所有块，循环外只有预备首部指向循环头
+    ListNode_IR_block_ptr *preheader_node = NULL;
+    for (ListNode_IR_block_ptr *node = func->blocks.head; node;) {
+        IR_block *blk = node->val;
+        if (!Loop_contains_block(loop, blk)) {
+            if (blk == preheader) preheader_node = node;
+            node = node->nxt;
+            continue;
+        }
+        node = VCALL(func->blocks, delete, node);
+        if (blk->label != IR_LABEL_NONE) VCALL(func->map_blk_label, delete, blk->label);
+        RDELETE(IR_block, blk);
+    }
+    if (preheader_node && preheader_node->nxt)
+        IR_block_strip_jump_to(preheader, preheader_node->nxt->val->label);
+
+    IR_function_rebuild_graph(func);
+}
+
+//// ================================== 高层接口 ==================================
+
+bool perform_loop_deletion(IR_function *func, DominanceAnalyzer *dom_analyzer, LoopAnalyzer *loop_analyzer) {
+    bool changed = false;
+    while (true) {
+        // 先确定全部方案再统一变换: 各最内层循环互不相交，变换会使分析结果失效
+        LiveVariableAnalysis *live = NEW(LiveVariableAnalysis);
+        worklist_solver((DataflowAnalysis*)live, func);
+        ScalarEvolution se;
+        ScalarEvolution_init(&se, func, loop_analyzer);
+        InductionVariableAnalyzer iv_analyzer;
+        InductionVariableAnalyzer_init(&iv_analyzer, func, loop_analyzer);
+        InductionVariableAnalyzer_analyze(&iv_analyzer);
+
+        unsigned loop_cnt = 0, plan_cnt = 0;
+        for_list(Loop_ptr, i, loop_analyzer->all_loops) loop_cnt++;
+        DeletionPlan *plans = (DeletionPlan*)malloc(sizeof(DeletionPlan) * (loop_cnt + 1));
+        for_list(Loop_ptr, i, loop_analyzer->all_loops) {
+            IR_block *exit_target = i->val->exit_targets.head ? i->val->exit_targets.head->val : NULL;
+            Set_IR_var *live_in = exit_target ? VCALL(*live, getInFact, exit_target) : NULL;
+            if (LoopDeletion_plan(&se, &iv_analyzer, live_in, i->val, &plans[plan_cnt])) plan_cnt++;
+        }
+        InductionVariableAnalyzer_teardown(&iv_analyzer);
+        ScalarEvolution_teardown(&se);
+        DELETE(live);
+
+        for (unsigned i = 0; i < plan_cnt; i++) {
+#ifdef DEBUG
+            printf("delete loop L%u: trip count %u, %u exit values\n", plans[i].loop->header->label,
+                   plans[i].trip_count, plans[i].value_cnt);
+#endif
+            LoopDeletion_delete(func, &plans[i]);
+            free(plans[i].values);
+        }
+        free(plans);
+        if (plan_cnt == 0) break;
+        changed = true;
+
+        // 重新计算失效的支配关系与循环信息，外层循环可能因此成为最内层循环
+        LoopAnalyzer_recompute(loop_analyzer);
+    }
+    return changed;
+}
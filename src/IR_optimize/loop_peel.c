@@ -0,0 +1,225 @@
+//
+// Created by Assistant
+// 循环剥离 (Loop Peeling)
+//
+
+#include <loop_peel.h>
+#include <live_variable_analysis.h>
+#include <assert.h>
+#include <stdlib.h>
+
+//// ================================== 辅助函数 ==================================
+
+static int block_index(IR_block **blocks, unsigned n, IR_block *blk) {
+    for (unsigned i = 0; i < n; i++)
+        if (blocks[i] == blk) return (int)i;
+    return -1;
+}
+
+static CPValue fact_value(Map_IR_var_CPValue *fact, IR_var var) {
+    return VCALL(*fact, exist, var) ? VCALL(*fact, get, var) : get_UNDEF();
+}
+
+/**
+ * @brief 判断 var 在循环内的值是否可能依赖 target：沿循环内的定义追溯其使用的变量（不区分定义的先后）。
+ */
+static bool depends_on(Loop_ptr loop, IR_var var, IR_var target, Set_IR_var *visited) {
+    if (var == target) return true;
+    if (!VCALL(*visited, insert, var)) return false;
+    for_set(IR_block_ptr, i, loop->blocks)
+        for_list(IR_stmt_ptr, j, i->key->stmts) {
+            IR_stmt *stmt = j->val;
+            if (VCALL(*stmt, get_def) != var) continue;
+            IR_use use = VCALL(*stmt, get_use_vec);
+            for (unsigned k = 0; k < use.use_cnt; k++)
+                if (!use.use_vec[k].is_const && depends_on(loop, use.use_vec[k].var, target, visited))
+                    return true;
+        }
+    return false;
+}
+
+/**
+ * @brief 判断 var 是否为循环头处的汇合变量：循环内有定义且定义都不依赖它自己。
+ */
+static bool is_wrap_around(Loop_ptr loop, IR_var var) {
+    bool defined = false, self_dependent = false;
+    Set_IR_var visited;
+    Set_IR_var_init(&visited);
+    for_set(IR_block_ptr, i, loop->blocks)
+        for_list(IR_stmt_ptr, j, i->key->stmts) {
+            IR_stmt *stmt = j->val;
+            if (VCALL(*stmt, get_def) != var) continue;
+            defined = true;
+            IR_use use = VCALL(*stmt, get_use_vec);
+            for (unsigned k = 0; k < use.use_cnt && !self_dependent; k++)
+                if (!use.use_vec[k].is_const && depends_on(loop, use.use_vec[k].var, var, &visited))
+                    self_dependent = true;
+        }
+    Set_IR_var_teardown(&visited);
+    return defined && !self_dependent;
+}
+
+static int var_index(IR_var *vars, unsigned n, IR_var var) {
+    for (unsigned i = 0; i < n; i++)
+        if (vars[i] == var) return (int)i;
+    return -1;
+}
+
+//// ================================== 剥离方案 ==================================
+
+bool LoopPeel_plan(ConstantPropagation *cp, Set_IR_var *live_in, Loop_ptr loop, unsigned budget, PeelPlan *plan) {
+    if (!loop->is_reducible || loop->nested_loops.head != NULL || !loop->preheader) return false;
+    IR_stmt *preheader_last = loop->preheader->stmts.tail ? loop->preheader->stmts.tail->val : NULL;
+    if (preheader_last && preheader_last->stmt_type == IR_IF_STMT) return false;
+    unsigned size = Loop_stmt_count(loop);
+    if (size > LOOP_PEEL_THRESHOLD || size > budget) return false;
+
+    // 汇合变量: 从预备首部进入时是常量, 与回边上的值汇合后不再是常量
+    Map_IR_var_CPValue *entry = VCALL(*cp, getOutFact, loop->preheader);
+    Map_IR_var_CPValue *header = VCALL(*cp, getInFact, loop->header);
+    unsigned cnt = 0;
+    for_set(IR_var, i, *live_in) cnt++;
+    IR_var *vars = (IR_var*)malloc(sizeof(IR_var) * (cnt + 1));
+    cnt = 0;
+    for_set(IR_var, i, *live_in) {
+        IR_var var = i->key;
+        if (fact_value(entry, var).kind != CONST || fact_value(header, var).kind != NAC) continue;
+        if (is_wrap_around(loop, var)) vars[cnt++] = var;
+    }
+    if (cnt == 0) {
+        free(vars);
+        return false;
+    }
+
+    // 定义为另一个汇合变量的值时, 其常量初值要多一次迭代才被回边上的值取代
+    unsigned *depth = (unsigned*)malloc(sizeof(unsigned) * cnt);
+    for (unsigned i = 0; i < cnt; i++) depth[i] = 1;
+    for (unsigned round = 1; round < LOOP_PEEL_MAX_COUNT; round++)
+        for (unsigned i = 0; i < cnt; i++)
+            for_set(IR_block_ptr, j, loop->blocks)
+                for_list(IR_stmt_ptr, k, j->key->stmts) {
+                    if (VCALL(*k->val, get_def) != vars[i]) continue;
+                    IR_use use = VCALL(*k->val, get_use_vec);
+                    for (unsigned u = 0; u < use.use_cnt; u++) {
+                        int idx = use.use_vec[u].is_const ? -1 : var_index(vars, cnt, use.use_vec[u].var);
+                        if (idx >= 0 && depth[idx] + 1 > depth[i]) depth[i] = depth[idx] + 1;
+                    }
+                }
+    unsigned count = 1;
+    for (unsigned i = 0; i < cnt; i++)
+        if (depth[i] > count) count = depth[i];
+    if (count > LOOP_PEEL_MAX_COUNT) count = LOOP_PEEL_MAX_COUNT;
+    free(depth);
+    free(vars);
+
+    while (count > 1 && count * size > budget) count--;
+    plan->loop = loop;
+    plan->count = count;
+    plan->size = size;
+    return true;
+}
+
+//// ================================== 剥离 ==================================
+
+void LoopPeel_peel(IR_function *func, const PeelPlan *plan) {
+    Loop_ptr loop = plan->loop;
+    unsigned n, count = plan->count;
+    IR_block **blocks = Loop_collect_blocks(func, loop, &n, NULL);
+    int header_idx = block_index(blocks, n, loop->header);
+    assert(count >= 1 && header_idx >= 0); // LoopPeel_plan 至少剥离一次迭代
+
+    // 块之间不再依赖链表中的相邻关系
+    for (unsigned i = 0; i < n; i++)
+        IR_function_make_fallthrough_explicit(func, blocks[i]);
+    IR_block *preheader = loop->preheader;
+    IR_function_make_fallthrough_explicit(func, preheader);
+
+    // 复制循环体: copies[k][i] 为第 k 份中的第 i 块, 依次放在预备首部之后
+    ListNode_IR_block_ptr *pos = func->blocks.head;
+    while (pos->val != preheader) pos = pos->nxt;
+    IR_block ***copies = (IR_block***)malloc(sizeof(IR_block**) * count);
+    IR_block *first_header = NULL;  // 第一份中的循环头, 预备首部改为跳向它
+    for (unsigned k = 0; k < count; k++) {
+        copies[k] = (IR_block**)malloc(sizeof(IR_block*) * n);
+        for (unsigned i = 0; i < n; i++) {
+            IR_block *blk = NEW(IR_block, ir_label_generator());
+            VCALL(func->map_blk_label, insert, blk->label, blk);
+            for_list(IR_stmt_ptr, j, blocks[i]->stmts)
+                VCALL(blk->stmts, push_back, IR_stmt_clone(j->val));
+            VCALL(func->blocks, insert_back, pos, blk);
+            pos = pos->nxt;
+            copies[k][i] = blk;
+            if (k == 0 && (int)i == header_idx) first_header = blk;
+        }
+    }
+
+    // 副本内的跳转重定向到同一份中的块, 回边指向下一份的循环头, 最后一份回到原循环
+    for (unsigned k = 0; k < count; k++) {
+        IR_block *next_header = k + 1 == count ? loop->header : copies[k + 1][header_idx];
+        IR_function_ensure_label(func, next_header);
+        for (unsigned i = 0; i < n; i++) {
+            IR_stmt *last = copies[k][i]->stmts.tail->val;
+            IR_label *targets[2] = {NULL, NULL};
+            if (last->stmt_type == IR_GOTO_STMT) {
+                targets[0] = &((IR_goto_stmt*)last)->label;
+            } else if (last->stmt_type == IR_IF_STMT) {
+                targets[0] = &((IR_if_stmt*)last)->true_label;
+                targets[1] = &((IR_if_stmt*)last)->false_label;
+            }
+            for (int t = 0; t < 2; t++) {
+                if (!targets[t]) continue;
+                int idx = block_index(blocks, n, VCALL(func->map_blk_label, get, *targets[t]));
+                if (idx < 0) continue;
+                *targets[t] = idx == header_idx ? next_header->label : copies[k][idx]->label;
+            }
+        }
+    }
+
+    // 预备首部改为进入第一份
+    IR_goto_stmt *entry_goto = (IR_goto_stmt*)preheader->stmts.tail->val;
+    entry_goto->label = first_header->label;
+
+    for (unsigned k = 0; k < count; k++) free(copies[k]);
+    free(copies);
+    free(blocks);
+
+    IR_function_strip_redundant_jumps(func);
+}
+
+//// ================================== 高层接口 ==================================
+
+bool perform_loop_peeling(IR_function *func, DominanceAnalyzer *dom_analyzer, LoopAnalyzer *loop_analyzer) {
+    // 先确定全部方案再统一变换: 各最内层循环互不相交，变换会使分析结果失效
+    ConstantPropagation *cp = NEW(ConstantPropagation);
+    worklist_solver((DataflowAnalysis*)cp, func);
+    LiveVariableAnalysis *live = NEW(LiveVariableAnalysis);
+    worklist_solver((DataflowAnalysis*)live, func);
+
+    unsigned budget = LOOP_PEEL_BUDGET, loop_cnt = 0, plan_cnt = 0;
+    for_list(Loop_ptr, i, loop_analyzer->all_loops) loop_cnt++;
+    PeelPlan *plans = (PeelPlan*)malloc(sizeof(PeelPlan) * (loop_cnt + 1));
+    for_list(Loop_ptr, i, loop_analyzer->all_loops) {
+        Set_IR_var *live_in = VCALL(*live, getInFact, i->val->header);
+        if (!LoopPeel_plan(cp, live_in, i->val, budget, &plans[plan_cnt])) continue;
+        budget -= plans[plan_cnt].count * plans[plan_cnt].size;
+        plan_cnt++;
+    }
+    DELETE(live);
+    DELETE(cp);
+
+    for (unsigned i = 0; i < plan_cnt; i++) {
+#ifdef DEBUG
+        printf("peel loop L%u: %u iterations, %u stmts\n", plans[i].loop->header->label,
+               plans[i].count, plans[i].size);
+#endif
+        LoopPeel_peel(func, &plans[i]);
+    }
+    free(plans);
+    if (plan_cnt == 0) return false;
+
+    // 重新计算失效的支配关系与循环信息; 最后一份之后新建的预备首部紧挨循环头, 去掉其末尾的 GOTO 后再算一次
+    LoopAnalyzer_recompute(loop_analyzer);
+    IR_function_strip_redundant_jumps(func);
+    LoopAnalyzer_recompute(loop_analyzer);
+    return true;
+}
@@ -0,0 +1,231 @@
+//
+// Created by Assistant
+// 循环旋转 (Loop Rotation)
+//
+
+#include <loop_rotate.h>
+
+//// ================================== 辅助函数 ==================================
+
+static void remove_block_from_list(List_IR_block_ptr *list, IR_block *blk) {
+    for_list(IR_block_ptr, i, *list) {
+        if (i->val != blk) continue;
+        VCALL(*list, delete, i);
+        return;
+    }
+}
+
+static unsigned list_length(List_IR_block_ptr *list) {
+    unsigned cnt = 0;
+    for_list(IR_block_ptr, i, *list) cnt++;
+    return cnt;
+}
+
+static bool list_contains(List_IR_block_ptr *list, IR_block *blk) {
+    for_list(IR_block_ptr, i, *list)
+        if (i->val == blk) return true;
+    return false;
+}
+
+/**
+ * @brief 求以 IF 结尾的块的真/假分支目标；假分支顺序执行时取链表中的下一块。
+ */
+static void if_targets(IR_function *func, IR_block *blk, IR_block **true_blk, IR_block **false_blk) {
+    IR_if_stmt *if_stmt = (IR_if_stmt*)blk->stmts.tail->val;
+    *true_blk = VCALL(func->map_blk_label, get, if_stmt->true_label);
+    if (if_stmt->false_label != IR_LABEL_NONE) {
+        *false_blk = VCALL(func->map_blk_label, get, if_stmt->false_label);
+        return;
+    }
+    *false_blk = NULL;
+    for_list(IR_block_ptr, i, func->blocks)
+        if (i->val == blk) {
+            *false_blk = i->nxt ? i->nxt->val : NULL;
+            break;
+        }
+}
+
+/**
+ * @brief 把循环头的语句复制到 blk 末尾（blk 原有的末尾跳转已去掉），并维护 blk 的出边。
+ * 循环头 IF 的两个目标此时都已是显式标签。
+ */
+static void append_header_copy(IR_function *func, IR_block *blk, IR_block *header,
+                               IR_block *true_blk, IR_block *false_blk) {
+    for_list(IR_stmt_ptr, i, header->stmts)
+        VCALL(blk->stmts, push_back, IR_stmt_clone(i->val));
+    IR_if_stmt *if_stmt = (IR_if_stmt*)blk->stmts.tail->val;
+    if_stmt->true_blk = true_blk;
+    if_stmt->false_blk = false_blk;
+
+    List_IR_block_ptr *succs = VCALL(func->blk_succ, get, blk);
+    remove_block_from_list(succs, header);
+    remove_block_from_list(VCALL(func->blk_pred, get, header), blk);
+    VCALL(*succs, push_back, true_blk);
+    VCALL(*succs, push_back, false_blk);
+    List_IR_block_ptr *true_preds = VCALL(func->blk_pred, get, true_blk);
+    VCALL(*true_preds, push_back, blk);
+    List_IR_block_ptr *false_preds = VCALL(func->blk_pred, get, false_blk);
+    VCALL(*false_preds, push_back, blk);
+}
+
+// 操作数在第一次迭代执行循环头 IF 时的值
+static SCEV *first_iteration_value(ScalarEvolution *se, Loop_ptr loop, IR_stmt *stmt, IR_val val) {
+    if (val.is_const) return ScalarEvolution_get_constant(se, val.const_val);
+    SCEV *scev = ScalarEvolution_get_value_at(se, loop->header, stmt, val.var);
+    return ScalarEvolution_evaluate_at_iteration(se, scev, loop, ScalarEvolution_get_constant(se, 0));
+}
+
+static void strip_jump_at(IR_function *func, IR_block *blk) {
+    for_list(IR_block_ptr, i, func->blocks) {
+        if (i->val != blk) continue;
+        if (i->nxt) IR_block_strip_jump_to(blk, i->nxt->val->label);
+        return;
+    }
+}
+
+//// ================================== 单个循环 ==================================
+
+bool LoopRotate_always_entered(ScalarEvolution *se, Loop_ptr loop) {
+    IR_if_stmt *if_stmt = (IR_if_stmt*)loop->header->stmts.tail->val;
+    SCEV *lhs = first_iteration_value(se, loop, (IR_stmt*)if_stmt, if_stmt->rs1);
+    SCEV *rhs = first_iteration_value(se, loop, (IR_stmt*)if_stmt, if_stmt->rs2);
+    if (lhs->kind != SCEV_CONSTANT || rhs->kind != SCEV_CONSTANT) return false;
+    IR_block *true_blk = VCALL(se->function->map_blk_label, get, if_stmt->true_label);
+    return IR_RELOP_eval(if_stmt->relop, lhs->value, rhs->value) == Loop_contains_block(loop, true_blk);
+}
+
+bool LoopRotate_can_rotate(IR_function *func, Loop_ptr loop) {
+    if (!loop->is_reducible || loop->preheader == NULL) return false;
+    List_IR_block_ptr *latches = &loop->back_edges_sources;
+    if (latches->head == NULL || latches->head != latches->tail) return false;
+    IR_block *header = loop->header, *latch = latches->head->val, *preheader = loop->preheader;
+    if (latch == header) return false;
+
+    // 回边源已经是退出块时循环本就是底部判断
+    List_IR_block_ptr *latch_succs = VCALL(func->blk_succ, get, latch);
+    for_list(IR_block_ptr, i, *latch_succs)
+        if (!Loop_contains_block(loop, i->val)) return false;
+
+    unsigned size = 0;
+    for_list(IR_stmt_ptr, i, header->stmts) {
+        if (i->val->stmt_type == IR_PHI_STMT) return false;
+        size++;
+    }
+    if (size == 0 || size > LOOP_ROTATE_HEADER_THRESHOLD) return false;
+    if (header->stmts.tail->val->stmt_type != IR_IF_STMT) return false;
+
+    IR_block *true_blk, *false_blk;
+    if_targets(func, header, &true_blk, &false_blk);
+    if (!true_blk || !false_blk) return false;
+    bool true_in = Loop_contains_block(loop, true_blk);
+    bool false_in = Loop_contains_block(loop, false_blk);
+    if (true_in == false_in) return false;
+    IR_block *body = true_in ? true_blk : false_blk;
+    IR_block *exit = true_in ? false_blk : true_blk;
+    if (body == header || exit == func->exit) return false;
+
+    List_IR_block_ptr *header_preds = VCALL(func->blk_pred, get, header);
+    if (list_length(header_preds) != 2 || !list_contains(header_preds, preheader) ||
+        !list_contains(header_preds, latch))
+        return false;
+    List_IR_block_ptr *preheader_succs = VCALL(func->blk_succ, get, preheader);
+    if (list_length(preheader_succs) != 1) return false;
+    IR_stmt *preheader_last = preheader->stmts.tail ? preheader->stmts.tail->val : NULL;
+    if (preheader_last && (preheader_last->stmt_type == IR_IF_STMT || preheader_last->stmt_type == IR_RETURN_STMT))
+        return false;
+    return list_length(VCALL(func->blk_pred, get, body)) == 1;
+}
+
+bool LoopRotate_rotate(IR_function *func, Loop_ptr loop, bool always_entered) {
+    IR_block *header = loop->header, *preheader = loop->preheader;
+    IR_block *latch = loop->back_edges_sources.head->val;
+    IR_if_stmt *header_if = (IR_if_stmt*)header->stmts.tail->val;
+    IR_block *true_blk, *false_blk;
+    if_targets(func, header, &true_blk, &false_blk);
+    IR_block *body = Loop_contains_block(loop, true_blk) ? true_blk : false_blk;
+
+    // 1. 在回边上插入底部判断块, 先做这一步以便无法拆分时不修改函数
+    IR_block *bottom = IR_function_split_edge(func, latch, header);
+    if (!bottom) return false;
+    while (bottom->stmts.tail) {
+        RDELETE(IR_stmt, bottom->stmts.tail->val);
+        VCALL(bottom->stmts, pop_back);
+    }
+
+    // 2. 循环头的两个出口都改为显式跳转, 复制品可以放在任意位置
+    if (header_if->false_label == IR_LABEL_NONE)
+        header_if->false_label = IR_function_ensure_label(func, false_blk);
+    append_header_copy(func, bottom, header, true_blk, false_blk);
+
+    // 3. 预备首部末尾的跳转换成守卫判断; 第一次判断必然进入循环时只保留判断之前的语句
+    if (preheader->stmts.tail && preheader->stmts.tail->val->stmt_type == IR_GOTO_STMT) {
+        RDELETE(IR_stmt, preheader->stmts.tail->val);
+        VCALL(preheader->stmts, pop_back);
+    }
+    append_header_copy(func, preheader, header, true_blk, false_blk);
+    if (always_entered) {
+        IR_block *exit = body == true_blk ? false_blk : true_blk;
+        RDELETE(IR_stmt, preheader->stmts.tail->val);
+        VCALL(preheader->stmts, pop_back);
+        VCALL(preheader->stmts, push_back, IR_goto_new(body));
+        List_IR_block_ptr *succs = VCALL(func->blk_succ, get, preheader);
+        remove_block_from_list(succs, exit);
+        remove_block_from_list(VCALL(func->blk_pred, get, exit), preheader);
+    }
+
+    // 4. 原循环头不再有前驱, 删除之
+    List_IR_block_ptr *header_succs = VCALL(func->blk_succ, get, header);
+    for_list(IR_block_ptr, i, *header_succs)
+        remove_block_from_list(VCALL(func->blk_pred, get, i->val), header);
+    List_IR_block_ptr *header_preds = VCALL(func->blk_pred, get, header);
+    DELETE(header_preds);
+    DELETE(header_succs);
+    VCALL(func->blk_pred, delete, header);
+    VCALL(func->blk_succ, delete, header);
+    VCALL(func->map_blk_label, delete, header->label);
+    for_list(IR_block_ptr, i, func->blocks) {
+        if (i->val != header) continue;
+        VCALL(func->blocks, delete, i);
+        break;
+    }
+    RDELETE(IR_block, header);
+
+    // 5. 守卫与新循环头之间插入新的预备首部
+    IR_block *new_preheader = always_entered ? NULL : IR_function_split_edge(func, preheader, body);
+
+    // 6. 尽量让守卫、新预备首部与底部判断顺序执行到相邻块
+    strip_jump_at(func, preheader);
+    if (new_preheader) strip_jump_at(func, new_preheader);
+    strip_jump_at(func, bottom);
+    strip_jump_at(func, latch);
+    return true;
+}
+
+//// ================================== 高层接口 ==================================
+
+bool perform_loop_rotation(IR_function *func, DominanceAnalyzer *dom_analyzer, LoopAnalyzer *loop_analyzer) {
+    // 旋转后的循环以回边源为退出块, 不会再被旋转; 每个循环至多旋转一次
+    unsigned rounds = 0;
+    for_list(Loop_ptr, i, loop_analyzer->all_loops) rounds++;
+    bool modified = false;
+    while (rounds--) {
+        Loop_ptr target = NULL;
+        for_list(Loop_ptr, i, loop_analyzer->all_loops)
+            if (LoopRotate_can_rotate(func, i->val)) {
+                target = i->val;
+                break;
+            }
+        if (!target) break;
+        ScalarEvolution se;
+        ScalarEvolution_init(&se, func, loop_analyzer);
+        bool always_entered = LoopRotate_always_entered(&se, target);
+        ScalarEvolution_teardown(&se);
+#ifdef DEBUG
+        printf("rotate loop L%u%s\n", target->header->label, always_entered ? " (guard removed)" : "");
+#endif
+        if (!LoopRotate_rotate(func, target, always_entered)) break;
+        modified = true;
+        LoopAnalyzer_recompute(loop_analyzer);
+    }
+    return modified;
+}
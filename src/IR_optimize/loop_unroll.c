@@ -0,0 +1,240 @@
+//
+// Created by Assistant
+// 循环展开 (Loop Unrolling)
+//
+
+#include <loop_unroll.h>
+#include <assert.h>
+#include <stdlib.h>
+
+//// ================================== 辅助函数 ==================================
+
+static bool block_list_is_single(List_IR_block_ptr *list) {
+    return list->head != NULL && list->head == list->tail;
+}
+
+static int block_index(IR_block **blocks, unsigned n, IR_block *blk) {
+    for (unsigned i = 0; i < n; i++)
+        if (blocks[i] == blk) return (int)i;
+    return -1;
+}
+
+/**
+ * @brief 标记不经过循环头就能到达退出块的循环块，即完全展开后最后一份需要保留的块。
+ */
+static void mark_blocks_reaching_exit(IR_function *func, Loop_ptr loop, IR_block *exiting,
+                                      IR_block **blocks, unsigned n, bool *reach) {
+    for (unsigned i = 0; i < n; i++) reach[i] = false;
+    IR_block **stack = (IR_block**)malloc(sizeof(IR_block*) * n);
+    unsigned top = 0;
+    reach[block_index(blocks, n, exiting)] = true;
+    stack[top++] = exiting;
+    while (top) {
+        IR_block *blk = stack[--top];
+        if (blk == loop->header) continue;
+        List_IR_block_ptr *preds = VCALL(func->blk_pred, get, blk);
+        for_list(IR_block_ptr, i, *preds) {
+            int idx = block_index(blocks, n, i->val);
+            if (idx < 0 || reach[idx]) continue;
+            reach[idx] = true;
+            stack[top++] = i->val;
+        }
+    }
+    free(stack);
+}
+
+//// ================================== 展开方案 ==================================
+
+bool LoopUnroll_plan(ScalarEvolution *se, Loop_ptr loop, UnrollPlan *plan) {
+    if (!loop->is_reducible || loop->nested_loops.head != NULL) return false;
+    if (!block_list_is_single(&loop->back_edges_sources)) return false;
+    if (!block_list_is_single(&loop->exit_blocks) || !block_list_is_single(&loop->exit_targets)) return false;
+    IR_function *func = se->function;
+    if (loop->exit_targets.head->val == func->exit) return false;
+
+    IR_block *exiting = loop->exit_blocks.head->val;
+    if (exiting->stmts.tail == NULL || exiting->stmts.tail->val->stmt_type != IR_IF_STMT) return false;
+
+    // 常量执行次数已排除 IV 回绕的情形, 恒成立的退出条件不会得到次数
+    unsigned trip_count;
+    if (!ScalarEvolution_get_constant_trip_count(se, loop, &trip_count)) return false;
+    if (trip_count == 0) return false;
+
+    unsigned size = Loop_stmt_count(loop);
+    plan->loop = loop;
+    plan->exiting = exiting;
+    plan->trip_count = trip_count;
+    if ((unsigned long long)size * trip_count <= LOOP_UNROLL_FULL_THRESHOLD) {
+        plan->full = true;
+        plan->factor = trip_count;
+    } else {
+        unsigned factor = LOOP_UNROLL_PARTIAL_THRESHOLD / size;
+        if (factor > LOOP_UNROLL_MAX_FACTOR) factor = LOOP_UNROLL_MAX_FACTOR;
+        if (factor < 2 || factor >= trip_count) return false;
+        plan->full = false;
+        plan->factor = factor;
+        return true;
+    }
+
+    // 完全展开时最后一份只保留能到达退出块的部分，它们在循环内的后继也必须在这部分中
+    unsigned n;
+    ListNode_IR_block_ptr *last_node;
+    IR_block **blocks = Loop_collect_blocks(func, loop, &n, &last_node);
+    bool *reach = (bool*)malloc(sizeof(bool) * n);
+    mark_blocks_reaching_exit(func, loop, exiting, blocks, n, reach);
+    bool ok = true;
+    for (unsigned i = 0; i < n && ok; i++) {
+        if (!reach[i] || blocks[i] == exiting) continue;
+        List_IR_block_ptr *succs = VCALL(func->blk_succ, get, blocks[i]);
+        for_list(IR_block_ptr, j, *succs) {
+            int idx = block_index(blocks, n, j->val);
+            if (idx >= 0 && (j->val == loop->header || !reach[idx])) ok = false;
+        }
+    }
+    free(reach);
+    free(blocks);
+    return ok;
+}
+
+//// ================================== 展开 ==================================
+
+void LoopUnroll_unroll(IR_function *func, const UnrollPlan *plan) {
+    Loop_ptr loop = plan->loop;
+    unsigned n, factor = plan->factor;
+    ListNode_IR_block_ptr *pos;
+    IR_block **blocks = Loop_collect_blocks(func, loop, &n, &pos);
+    int header_idx = block_index(blocks, n, loop->header);
+    int exiting_idx = block_index(blocks, n, plan->exiting);
+
+    bool *reach = (bool*)malloc(sizeof(bool) * n);
+    if (plan->full) mark_blocks_reaching_exit(func, loop, plan->exiting, blocks, n, reach);
+    else for (unsigned i = 0; i < n; i++) reach[i] = true;
+
+    // 块之间不再依赖链表中的相邻关系
+    for (unsigned i = 0; i < n; i++)
+        IR_function_make_fallthrough_explicit(func, blocks[i]);
+    IR_if_stmt *exit_if = (IR_if_stmt*)plan->exiting->stmts.tail->val;
+    bool true_stays = Loop_contains_block(loop, exit_if->true_blk);
+    IR_label stay_label = true_stays ? exit_if->true_label : exit_if->false_label;
+    IR_label exit_label = true_stays ? exit_if->false_label : exit_if->true_label;
+
+    // 复制循环体: copies[j][i] 为第 j 份中的第 i 块，第 0 份就是原来的块
+    unsigned last_copy = factor - 1;
+    IR_block ***copies = (IR_block***)malloc(sizeof(IR_block**) * factor);
+    for (unsigned j = 0; j < factor; j++) {
+        copies[j] = (IR_block**)malloc(sizeof(IR_block*) * n);
+        for (unsigned i = 0; i < n; i++) {
+            bool keep = !(plan->full && j == last_copy) || reach[i];
+            if (j == 0) {
+                copies[j][i] = keep ? blocks[i] : NULL;
+                continue;
+            }
+            if (!keep) {
+                copies[j][i] = NULL;
+                continue;
+            }
+            IR_block *blk = NEW(IR_block, ir_label_generator());
+            VCALL(func->map_blk_label, insert, blk->label, blk);
+            for_list(IR_stmt_ptr, k, blocks[i]->stmts)
+                VCALL(blk->stmts, push_back, IR_stmt_clone(k->val));
+            VCALL(func->blocks, insert_back, pos, blk);
+            pos = pos->nxt;
+            copies[j][i] = blk;
+        }
+    }
+
+    // 每份的出口判断: 部分展开时只在可能退出的那一份保留; 完全展开时全部确定
+    unsigned exit_copy = (plan->trip_count - 1) % factor;
+    for (unsigned j = 0; j < factor; j++) {
+        if (!plan->full && j == exit_copy) continue;
+        IR_block *blk = copies[j][exiting_idx];
+        RDELETE(IR_stmt, blk->stmts.tail->val);
+        VCALL(blk->stmts, pop_back);
+        IR_label target = plan->full && j == last_copy ? exit_label : stay_label;
+        VCALL(blk->stmts, push_back, (IR_stmt*)NEW(IR_goto_stmt, target));
+    }
+
+    // 把循环内的跳转重定向到同一份中的块, 回边指向下一份的循环头
+    for (unsigned j = 0; j < factor; j++) {
+        unsigned next_copy = j + 1 == factor ? 0 : j + 1;
+        for (unsigned i = 0; i < n; i++) {
+            IR_block *blk = copies[j][i];
+            if (!blk) continue;
+            IR_stmt *last = blk->stmts.tail->val;
+            IR_label *targets[2] = {NULL, NULL};
+            if (last->stmt_type == IR_GOTO_STMT) {
+                targets[0] = &((IR_goto_stmt*)last)->label;
+            } else if (last->stmt_type == IR_IF_STMT) {
+                targets[0] = &((IR_if_stmt*)last)->true_label;
+                targets[1] = &((IR_if_stmt*)last)->false_label;
+            }
+            for (int k = 0; k < 2; k++) {
+                if (!targets[k]) continue;
+                IR_block *target = VCALL(func->map_blk_label, get, *targets[k]);
+                int idx = block_index(blocks, n, target);
+                if (idx < 0) continue;
+                IR_block *dst = idx == header_idx ? copies[next_copy][idx] : copies[j][idx];
+                assert(dst != NULL);
+                *targets[k] = dst->label;
+            }
+        }
+    }
+
+    // 删除完全展开后不再执行的原块
+    for (unsigned i = 0; i < n; i++) {
+        if (copies[0][i]) continue;
+        for (ListNode_IR_block_ptr *node = func->blocks.head; node; node = node->nxt) {
+            if (node->val != blocks[i]) continue;
+            VCALL(func->blocks, delete, node);
+            break;
+        }
+        VCALL(func->map_blk_label, delete, blocks[i]->label);
+        RDELETE(IR_block, blocks[i]);
+    }
+
+    // 去掉跳向下一块的多余跳转
+    Set_IR_block_ptr touched;
+    Set_IR_block_ptr_init(&touched);
+    for (unsigned j = 0; j < factor; j++)
+        for (unsigned i = 0; i < n; i++)
+            if (copies[j][i]) VCALL(touched, insert, copies[j][i]);
+    for_list(IR_block_ptr, i, func->blocks)
+        if (i->nxt && VCALL(touched, exist, i->val))
+            IR_block_strip_jump_to(i->val, i->nxt->val->label);
+    Set_IR_block_ptr_teardown(&touched);
+
+    for (unsigned j = 0; j < factor; j++) free(copies[j]);
+    free(copies);
+    free(reach);
+    free(blocks);
+
+    IR_function_rebuild_graph(func);
+}
+
+//// ================================== 高层接口 ==================================
+
+bool perform_loop_unrolling(IR_function *func, DominanceAnalyzer *dom_analyzer, LoopAnalyzer *loop_analyzer) {
+    // 先确定全部方案再统一变换: 变换会使标量演化的结果失效，而各最内层循环互不相交
+    ScalarEvolution se;
+    ScalarEvolution_init(&se, func, loop_analyzer);
+    unsigned loop_cnt = 0, plan_cnt = 0;
+    for_list(Loop_ptr, i, loop_analyzer->all_loops) loop_cnt++;
+    UnrollPlan *plans = (UnrollPlan*)malloc(sizeof(UnrollPlan) * (loop_cnt + 1));
+    for_list(Loop_ptr, i, loop_analyzer->all_loops)
+        if (LoopUnroll_plan(&se, i->val, &plans[plan_cnt])) plan_cnt++;
+    ScalarEvolution_teardown(&se);
+
+    for (unsigned i = 0; i < plan_cnt; i++) {
+#ifdef DEBUG
+        printf("unroll loop L%u: trip count %u, %s x%u\n", plans[i].loop->header->label,
+               plans[i].trip_count, plans[i].full ? "full" : "partial", plans[i].factor);
+#endif
+        LoopUnroll_unroll(func, &plans[i]);
+    }
+    free(plans);
+    if (plan_cnt == 0) return false;
+
+    // 重新计算失效的支配关系与循环信息
+    LoopAnalyzer_recompute(loop_analyzer);
+    return true;
+}
@@ -0,0 +1,179 @@
+//
+// Created by Assistant
+// 循环不变条件外提 (Loop Unswitching)
+//
+
+#include <loop_unswitch.h>
+#include <stdlib.h>
+
+//// ================================== 辅助函数 ==================================
+
+static int block_index(IR_block **blocks, unsigned n, IR_block *blk) {
+    for (unsigned i = 0; i < n; i++)
+        if (blocks[i] == blk) return (int)i;
+    return -1;
+}
+
+/**
+ * @brief 把块末尾的跳转替换为 GOTO label。
+ */
+static void replace_terminator(IR_block *blk, IR_label label) {
+    RDELETE(IR_stmt, blk->stmts.tail->val);
+    VCALL(blk->stmts, pop_back);
+    VCALL(blk->stmts, push_back, (IR_stmt*)NEW(IR_goto_stmt, label));
+}
+
+static bool val_equal(IR_val a, IR_val b) {
+    if (a.is_const != b.is_const) return false;
+    return a.is_const ? a.const_val == b.const_val : a.var == b.var;
+}
+
+/**
+ * @brief 比较 IF 的条件与 rs1 relop rs2：相同返回 1，互为否定返回 -1，否则返回 0。
+ */
+static int condition_match(IR_if_stmt *if_stmt, IR_RELOP_TYPE relop, IR_val rs1, IR_val rs2) {
+    IR_RELOP_TYPE other = if_stmt->relop;
+    if (val_equal(if_stmt->rs1, rs2) && val_equal(if_stmt->rs2, rs1))
+        other = IR_RELOP_swap(other);
+    else if (!val_equal(if_stmt->rs1, rs1) || !val_equal(if_stmt->rs2, rs2))
+        return 0;
+    if (other == relop) return 1;
+    if (other == IR_RELOP_negate(relop)) return -1;
+    return 0;
+}
+
+//// ================================== 外提方案 ==================================
+
+static bool is_invariant_operand(LICMAnalyzer *licm, Loop_ptr loop, IR_val val) {
+    return val.is_const || !LICMAnalyzer_is_var_modified_in_loop(licm, val.var, loop);
+}
+
+bool LoopUnswitch_plan(LICMAnalyzer *licm, Loop_ptr loop, unsigned budget, UnswitchPlan *plan) {
+    if (!loop->is_reducible || !loop->preheader) return false;
+    IR_stmt *preheader_last = loop->preheader->stmts.tail ? loop->preheader->stmts.tail->val : NULL;
+    if (preheader_last && preheader_last->stmt_type == IR_IF_STMT) return false;
+    unsigned size = Loop_stmt_count(loop);
+    if (size > LOOP_UNSWITCH_THRESHOLD || size > budget) return false;
+
+    // 按链表顺序选择第一个不变条件，结果与集合的遍历顺序无关
+    for_list(IR_block_ptr, i, licm->function->blocks) {
+        IR_block *blk = i->val;
+        if (!Loop_contains_block(loop, blk) || !blk->stmts.tail) continue;
+        if (blk->stmts.tail->val->stmt_type != IR_IF_STMT) continue;
+        IR_if_stmt *if_stmt = (IR_if_stmt*)blk->stmts.tail->val;
+        if (if_stmt->true_blk == if_stmt->false_blk) continue;
+        if (!Loop_contains_block(loop, if_stmt->true_blk) || !Loop_contains_block(loop, if_stmt->false_blk)) continue;
+        if (!is_invariant_operand(licm, loop, if_stmt->rs1) || !is_invariant_operand(licm, loop, if_stmt->rs2)) continue;
+        plan->loop = loop;
+        plan->branch = blk;
+        plan->size = size;
+        return true;
+    }
+    return false;
+}
+
+//// ================================== 外提 ==================================
+
+void LoopUnswitch_unswitch(IR_function *func, const UnswitchPlan *plan) {
+    Loop_ptr loop = plan->loop;
+    unsigned n;
+    ListNode_IR_block_ptr *pos;
+    IR_block **blocks = Loop_collect_blocks(func, loop, &n, &pos);
+
+    // 块之间不再依赖链表中的相邻关系
+    for (unsigned i = 0; i < n; i++)
+        IR_function_make_fallthrough_explicit(func, blocks[i]);
+    IR_function_make_fallthrough_explicit(func, loop->preheader);
+    IR_if_stmt *branch_if = (IR_if_stmt*)plan->branch->stmts.tail->val;
+    IR_val rs1 = branch_if->rs1, rs2 = branch_if->rs2;
+    IR_RELOP_TYPE relop = branch_if->relop;
+
+    // 复制循环: copies[i] 为第 i 块的副本, 放在原循环之后
+    IR_block **copies = (IR_block**)malloc(sizeof(IR_block*) * n);
+    for (unsigned i = 0; i < n; i++) {
+        IR_block *blk = NEW(IR_block, ir_label_generator());
+        VCALL(func->map_blk_label, insert, blk->label, blk);
+        for_list(IR_stmt_ptr, k, blocks[i]->stmts)
+            VCALL(blk->stmts, push_back, IR_stmt_clone(k->val));
+        VCALL(func->blocks, insert_back, pos, blk);
+        pos = pos->nxt;
+        copies[i] = blk;
+    }
+
+    // 副本内的跳转重定向到副本中的块, 跳出循环的目标不变
+    for (unsigned i = 0; i < n; i++) {
+        IR_stmt *last = copies[i]->stmts.tail->val;
+        IR_label *targets[2] = {NULL, NULL};
+        if (last->stmt_type == IR_GOTO_STMT) {
+            targets[0] = &((IR_goto_stmt*)last)->label;
+        } else if (last->stmt_type == IR_IF_STMT) {
+            targets[0] = &((IR_if_stmt*)last)->true_label;
+            targets[1] = &((IR_if_stmt*)last)->false_label;
+        }
+        for (int k = 0; k < 2; k++) {
+            if (!targets[k]) continue;
+            int idx = block_index(blocks, n, VCALL(func->map_blk_label, get, *targets[k]));
+            if (idx >= 0) *targets[k] = copies[idx]->label;
+        }
+    }
+
+    // 原循环中条件恒成立, 副本中恒不成立; 判断同一条件的其他 IF 一并固定
+    for (unsigned i = 0; i < n; i++) {
+        if (blocks[i]->stmts.tail->val->stmt_type != IR_IF_STMT) continue;
+        IR_if_stmt *if_stmt = (IR_if_stmt*)blocks[i]->stmts.tail->val;
+        IR_if_stmt *copy_if = (IR_if_stmt*)copies[i]->stmts.tail->val;
+        int match = condition_match(if_stmt, relop, rs1, rs2);
+        if (match == 0) continue;
+        IR_label original_target = match > 0 ? if_stmt->true_label : if_stmt->false_label;
+        IR_label copy_target = match > 0 ? copy_if->false_label : copy_if->true_label;
+        replace_terminator(blocks[i], original_target);
+        replace_terminator(copies[i], copy_target);
+    }
+
+    // 预备首部判断一次条件: 成立进入原循环, 否则进入副本
+    IR_block *preheader = loop->preheader;
+    int header_idx = block_index(blocks, n, loop->header);
+    IR_if_stmt *guard = NEW(IR_if_stmt, relop, rs1, rs2, IR_function_ensure_label(func, loop->header), copies[header_idx]->label);
+    RDELETE(IR_stmt, preheader->stmts.tail->val);
+    VCALL(preheader->stmts, pop_back);
+    VCALL(preheader->stmts, push_back, (IR_stmt*)guard);
+
+    free(copies);
+    free(blocks);
+
+    // 删除两个版本中不可达的块, 再去掉跳向下一块的多余跳转
+    IR_function_rebuild_graph(func);
+    IR_function_remove_unreachable_blocks(func);
+    IR_function_strip_redundant_jumps(func);
+}
+
+//// ================================== 高层接口 ==================================
+
+bool perform_loop_unswitching(IR_function *func, DominanceAnalyzer *dom_analyzer, LoopAnalyzer *loop_analyzer) {
+    unsigned budget = LOOP_UNSWITCH_BUDGET;
+    bool changed = false;
+    while (true) {
+        LICMAnalyzer licm;
+        LICMAnalyzer_init(&licm, func, loop_analyzer, dom_analyzer);
+        UnswitchPlan plan;
+        bool found = false;
+        for_list(Loop_ptr, i, loop_analyzer->all_loops)
+            if ((found = LoopUnswitch_plan(&licm, i->val, budget, &plan))) break;
+        LICMAnalyzer_teardown(&licm);
+        if (!found) break;
+
+#ifdef DEBUG
+        printf("unswitch loop L%u: branch in L%u, %u stmts\n", plan.loop->header->label, plan.branch->label, plan.size);
+#endif
+        LoopUnswitch_unswitch(func, &plan);
+        budget -= plan.size;
+        changed = true;
+        LoopAnalyzer_recompute(loop_analyzer);
+    }
+    if (changed) {
+        // 新建的预备首部紧挨循环头, 其末尾的 GOTO 可以去掉, 去掉后仍被识别为预备首部
+        IR_function_strip_redundant_jumps(func);
+        LoopAnalyzer_recompute(loop_analyzer);
+    }
+    return changed;
+}
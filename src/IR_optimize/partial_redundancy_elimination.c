@@ -0,0 +1,758 @@
+//
+// Created by Assistant
+// 部分冗余消除实现 (Partial Redundancy Elimination Implementation)
+// 惰性代码移动: 预期 -> 可用(earliest) -> 可后延(latest) -> 被使用 -> 插入/删除
+//
+
+#include <partial_redundancy_elimination.h>
+#include <stdio.h>
+
+//// ================================== 集合工具 ==================================
+
+static void block_set_map_teardown(Map_IR_block_ptr_Set_ptr_IR_var *map) {
+    for_map(IR_block_ptr, Set_ptr_IR_var, i, *map)
+        RDELETE(Set_IR_var, i->val);
+    Map_IR_block_ptr_Set_ptr_IR_var_teardown(map);
+}
+
+// 获取基本块对应的集合, 不存在时创建空集合
+static Set_IR_var *block_set(Map_IR_block_ptr_Set_ptr_IR_var *map, IR_block *blk) {
+    if (VCALL(*map, exist, blk)) return VCALL(*map, get, blk);
+    Set_IR_var *set = NEW(Set_IR_var);
+    VCALL(*map, insert, blk, set);
+    return set;
+}
+
+static void set_subtract(Set_IR_var *target, Set_IR_var *s) {
+    for_set(IR_var, i, *s)
+        VCALL(*target, delete, i->key);
+}
+
+// 将 fact 展开为普通集合 (TOP 展开为全集) 并合并进 out
+static void fact_union_into(PartialRedundancyElimination *pre, Fact_set_var *fact, Set_IR_var *out) {
+    VCALL(*out, union_with, fact->is_top ? &pre->universe : &fact->set);
+}
+
+// target := src, 返回 target 是否改变
+static bool fact_assign(Fact_set_var *target, Set_IR_var *src) {
+    if (target->is_top) {
+        target->is_top = false;
+        Set_IR_var_teardown(&target->set);
+        Set_IR_var_init(&target->set);
+        VCALL(target->set, union_with, src);
+        return true;
+    }
+    bool updated = VCALL(target->set, intersect_with, src);
+    updated |= VCALL(target->set, union_with, src);
+    return updated;
+}
+
+//// ================================== 规范化 ==================================
+
+static int IR_val_order(IR_val a, IR_val b) {
+    if (a.is_const != b.is_const) return a.is_const ? -1 : 1;
+    if (a.is_const) return a.const_val == b.const_val ? 0 : (a.const_val < b.const_val ? -1 : 1);
+    return a.var == b.var ? 0 : (a.var < b.var ? -1 : 1);
+}
+
+// 交换律运算按操作数顺序规范化, 使 a+b 与 b+a 对应同一表达式
+static Expr normalize_expr(IR_op_stmt *op_stmt) {
+    Expr expr = {.op = op_stmt->op, .rs1 = op_stmt->rs1, .rs2 = op_stmt->rs2};
+    if (IR_OP_is_commutative(expr.op) && IR_val_order(expr.rs1, expr.rs2) > 0) {
+        expr.rs1 = op_stmt->rs2;
+        expr.rs2 = op_stmt->rs1;
+    }
+    return expr;
+}
+
+static bool expr_uses_var(Expr expr, IR_var var) {
+    return (!expr.rs1.is_const && expr.rs1.var == var) ||
+           (!expr.rs2.is_const && expr.rs2.var == var);
+}
+
+static void expr_kill_insert(Map_IR_var_Vec_ptr_IR_var *map, IR_var use_var, IR_var expr_var) {
+    Vec_IR_var *vec;
+    if (!VCALL(*map, exist, use_var)) {
+        vec = NEW(Vec_IR_var);
+        VCALL(*map, insert, use_var, vec);
+    } else vec = VCALL(*map, get, use_var);
+    VCALL(*vec, push_back, expr_var);
+}
+
+static void expr_kill_map_teardown(Map_IR_var_Vec_ptr_IR_var *map) {
+    for_map(IR_var, Vec_ptr_IR_var, i, *map)
+        DELETE(i->val);
+    Map_IR_var_Vec_ptr_IR_var_teardown(map);
+}
+
+static void register_expr(PartialRedundancyElimination *t, Expr expr, IR_var expr_var) {
+    VCALL(t->mapExpr, insert, expr, expr_var);
+    VCALL(t->mapVarExpr, insert, expr_var, expr);
+    VCALL(t->universe, insert, expr_var);
+    if (!expr.rs1.is_const) expr_kill_insert(&t->mapExprKill, expr.rs1.var, expr_var);
+    if (!expr.rs2.is_const && !(expr.rs1.is_const == false && expr.rs1.var == expr.rs2.var))
+        expr_kill_insert(&t->mapExprKill, expr.rs2.var, expr_var);
+}
+
+/**
+ * @brief 找出可以直接充当表达式代表变量的已有变量。
+ * 条件: 所有定义都是同一表达式的计算, 且每次使用都位于同一块内的计算之后、
+ * 中间没有操作数被重新定义 (即使用处的值总等于表达式的当前值)。
+ * 可用表达式分析生成的临时变量满足该条件, 复用它们可以避免引入多余的复制。
+ */
+static void collect_reusable_vars(IR_function *func, Map_IR_var_Expr *reusable) {
+    Set_IR_var impure;
+    Set_IR_var_init(&impure);
+    for_vec(IR_var, param, func->params)
+        VCALL(impure, insert, *param);
+    for_list(IR_block_ptr, i, func->blocks) {
+        for_list(IR_stmt_ptr, j, i->val->stmts) {
+            IR_stmt *stmt = j->val;
+            IR_var def = VCALL(*stmt, get_def);
+            if (def == IR_VAR_NONE) continue;
+            if (stmt->stmt_type != IR_OP_STMT) {
+                VCALL(impure, insert, def);
+                continue;
+            }
+            Expr expr = normalize_expr((IR_op_stmt*)stmt);
+            if (expr_uses_var(expr, def)) VCALL(impure, insert, def);
+            else if (!VCALL(*reusable, exist, def)) VCALL(*reusable, insert, def, expr);
+            else if (Expr_CMP(VCALL(*reusable, get, def), expr) != -1) VCALL(impure, insert, def);
+        }
+    }
+    // 检查使用处是否可能读到过期的值
+    Map_IR_var_Vec_ptr_IR_var kill;
+    Map_IR_var_Vec_ptr_IR_var_init(&kill);
+    for_map(IR_var, Expr, it, *reusable) {
+        if (VCALL(impure, exist, it->key)) continue;
+        if (!it->val.rs1.is_const) expr_kill_insert(&kill, it->val.rs1.var, it->key);
+        if (!it->val.rs2.is_const) expr_kill_insert(&kill, it->val.rs2.var, it->key);
+    }
+    for_list(IR_block_ptr, i, func->blocks) {
+        Set_IR_var fresh;
+        Set_IR_var_init(&fresh);
+        for_list(IR_stmt_ptr, j, i->val->stmts) {
+            IR_stmt *stmt = j->val;
+            IR_use use = VCALL(*stmt, get_use_vec);
+            for (unsigned k = 0; k < use.use_cnt; k++) {
+                IR_var var = use.use_vec[k].var;
+                if (use.use_vec[k].is_const || !VCALL(*reusable, exist, var)) continue;
+                if (!VCALL(fresh, exist, var)) VCALL(impure, insert, var);
+            }
+            IR_var def = VCALL(*stmt, get_def);
+            if (def == IR_VAR_NONE) continue;
+            if (VCALL(kill, exist, def)) {
+                Vec_IR_var *killed = VCALL(kill, get, def);
+                for_vec(IR_var, k, *killed)
+                    VCALL(fresh, delete, *k);
+            }
+            if (stmt->stmt_type == IR_OP_STMT && !VCALL(impure, exist, def))
+                VCALL(fresh, insert, def);
+        }
+        Set_IR_var_teardown(&fresh);
+    }
+    for_set(IR_var, i, impure)
+        VCALL(*reusable, delete, i->key);
+    expr_kill_map_teardown(&kill);
+    Set_IR_var_teardown(&impure);
+}
+
+// 将每条 rd := a op b 改写为 t_e := a op b; rd := t_e, 同一表达式共用 t_e
+static bool canonicalize_exprs(PartialRedundancyElimination *t) {
+    bool updated = false;
+    Map_IR_var_Expr reusable;
+    Map_IR_var_Expr_init(&reusable);
+    collect_reusable_vars(t->func, &reusable);
+    for_list(IR_block_ptr, i, t->func->blocks) {
+        IR_block *blk = i->val;
+        for_list(IR_stmt_ptr, j, blk->stmts) {
+            if (j->val->stmt_type != IR_OP_STMT) continue;
+            IR_op_stmt *op_stmt = (IR_op_stmt*)j->val;
+            Expr expr = normalize_expr(op_stmt);
+            IR_var expr_var;
+            if (VCALL(t->mapExpr, exist, expr)) expr_var = VCALL(t->mapExpr, get, expr);
+            else {
+                expr_var = VCALL(reusable, exist, op_stmt->rd) ? op_stmt->rd : ir_var_generator();
+                register_expr(t, expr, expr_var);
+            }
+            op_stmt->rs1 = expr.rs1;
+            op_stmt->rs2 = expr.rs2;
+            if (op_stmt->rd != expr_var) {
+                VCALL(blk->stmts, insert_back, j,
+                      (IR_stmt*)NEW(IR_assign_stmt, op_stmt->rd,
+                                    (IR_val){.is_const = false, .var = expr_var}));
+                op_stmt->rd = expr_var;
+                updated = true;
+            }
+        }
+    }
+    Map_IR_var_Expr_teardown(&reusable);
+    return updated;
+}
+
+// 规范化的逆过程: 未参与代码移动的 t_e := e; rd := t_e 且 t_e 别无他用时, 折回 rd := e
+static void fold_unused_expr_vars(IR_function *func) {
+    Set_IR_var used, used_multi;
+    Set_IR_var_init(&used);
+    Set_IR_var_init(&used_multi);
+    for_list(IR_block_ptr, i, func->blocks) {
+        for_list(IR_stmt_ptr, j, i->val->stmts) {
+            IR_use use = VCALL(*j->val, get_use_vec);
+            for (unsigned k = 0; k < use.use_cnt; k++) {
+                if (use.use_vec[k].is_const) continue;
+                if (!VCALL(used, insert, use.use_vec[k].var))
+                    VCALL(used_multi, insert, use.use_vec[k].var);
+            }
+        }
+    }
+    for_list(IR_block_ptr, i, func->blocks) {
+        IR_block *blk = i->val;
+        for_list(IR_stmt_ptr, j, blk->stmts) {
+            if (j->val->stmt_type != IR_OP_STMT || !j->nxt || j->nxt->val->stmt_type != IR_ASSIGN_STMT) continue;
+            IR_op_stmt *op_stmt = (IR_op_stmt*)j->val;
+            IR_assign_stmt *assign_stmt = (IR_assign_stmt*)j->nxt->val;
+            if (assign_stmt->rs.is_const || assign_stmt->rs.var != op_stmt->rd) continue;
+            if (VCALL(used_multi, exist, op_stmt->rd)) continue;
+            op_stmt->rd = assign_stmt->rd;
+            assign_stmt->dead = true;
+        }
+        remove_dead_stmt(blk);
+    }
+    Set_IR_var_teardown(&used);
+    Set_IR_var_teardown(&used_multi);
+}
+
+//// ================================== CFG 预处理 ==================================
+
+static void collect_reachable(IR_function *func, IR_block *start, Set_IR_block_ptr *visited,
+                              Map_IR_block_ptr_List_ptr_IR_block_ptr *edges) {
+    List_IR_block_ptr worklist;
+    List_IR_block_ptr_init(&worklist);
+    VCALL(*visited, insert, start);
+    VCALL(worklist, push_back, start);
+    while (worklist.head) {
+        IR_block *blk = worklist.head->val;
+        VCALL(worklist, pop_front);
+        for_list(IR_block_ptr, i, *VCALL(*edges, get, blk)) {
+            if (VCALL(*visited, insert, i->val))
+                VCALL(worklist, push_back, i->val);
+        }
+    }
+    List_IR_block_ptr_teardown(&worklist);
+}
+
+static unsigned list_length(List_IR_block_ptr *list) {
+    unsigned len = 0;
+    for_list(IR_block_ptr, i, *list) len++;
+    return len;
+}
+
+// 拆分所有关键边 (多后继块 -> 多前驱块), 保证插入点总能落在某个块的开头
+static void split_critical_edges(PartialRedundancyElimination *t) {
+    IR_function *func = t->func;
+    List_IR_block_ptr origin;
+    List_IR_block_ptr_init(&origin);
+    for_list(IR_block_ptr, i, func->blocks)
+        VCALL(origin, push_back, i->val);
+    for_list(IR_block_ptr, i, origin) {
+        IR_block *pred = i->val;
+        List_IR_block_ptr *succs = VCALL(func->blk_succ, get, pred);
+        if (list_length(succs) < 2) continue;
+        List_IR_block_ptr targets;
+        List_IR_block_ptr_init(&targets);
+        for_list(IR_block_ptr, j, *succs)
+            if (list_length(VCALL(func->blk_pred, get, j->val)) >= 2)
+                VCALL(targets, push_back, j->val);
+        for_list(IR_block_ptr, j, targets) {
+            IR_block *mid = IR_function_split_edge(func, pred, j->val);
+            if (mid) VCALL(t->split_blocks, push_back, mid);
+        }
+        List_IR_block_ptr_teardown(&targets);
+    }
+    List_IR_block_ptr_teardown(&origin);
+}
+
+static void replace_block_in_list(List_IR_block_ptr *list, IR_block *old_blk, IR_block *new_blk) {
+    for_list(IR_block_ptr, i, *list) {
+        if (i->val == old_blk) {
+            i->val = new_blk;
+            return;
+        }
+    }
+}
+
+// 撤销一次关键边拆分: 删除空的中间块, 恢复 pred -> succ
+static void unsplit_edge(IR_function *func, IR_block *mid) {
+    IR_block *pred = VCALL(func->blk_pred, get, mid)->head->val;
+    IR_block *succ = VCALL(func->blk_succ, get, mid)->head->val;
+    if (mid->label != IR_LABEL_NONE) {
+        IR_stmt *last = pred->stmts.tail->val;
+        if (last->stmt_type == IR_GOTO_STMT) {
+            IR_goto_stmt *goto_stmt = (IR_goto_stmt*)last;
+            goto_stmt->label = succ->label;
+            goto_stmt->blk = succ;
+        } else if (last->stmt_type == IR_IF_STMT) {
+            IR_if_stmt *if_stmt = (IR_if_stmt*)last;
+            if (if_stmt->true_label == mid->label) {
+                if_stmt->true_label = succ->label;
+                if_stmt->true_blk = succ;
+            } else {
+                if_stmt->false_label = succ->label;
+                if_stmt->false_blk = succ;
+            }
+        }
+        VCALL(func->map_blk_label, delete, mid->label);
+    }
+    replace_block_in_list(VCALL(func->blk_succ, get, pred), mid, succ);
+    replace_block_in_list(VCALL(func->blk_pred, get, succ), mid, pred);
+    DELETE(VCALL(func->blk_pred, get, mid));
+    DELETE(VCALL(func->blk_succ, get, mid));
+    VCALL(func->blk_pred, delete, mid);
+    VCALL(func->blk_succ, delete, mid);
+    for_list(IR_block_ptr, i, func->blocks) {
+        if (i->val == mid) {
+            VCALL(func->blocks, delete, i);
+            break;
+        }
+    }
+    RDELETE(IR_block, mid);
+}
+
+//// ================================== 局部属性 ==================================
+
+static void compute_local_properties(PartialRedundancyElimination *t) {
+    for_list(IR_block_ptr, i, t->func->blocks) {
+        IR_block *blk = i->val;
+        Set_IR_var *e_use = block_set(&t->e_use, blk);
+        Set_IR_var *e_kill = block_set(&t->e_kill, blk);
+        for_list(IR_stmt_ptr, j, blk->stmts) {
+            IR_stmt *stmt = j->val;
+            if (stmt->stmt_type == IR_OP_STMT) {
+                IR_var expr_var = ((IR_op_stmt*)stmt)->rd;
+                if (!VCALL(*e_kill, exist, expr_var))
+                    VCALL(*e_use, insert, expr_var);
+            }
+            IR_var def = VCALL(*stmt, get_def);
+            if (def != IR_VAR_NONE && VCALL(t->mapExprKill, exist, def)) {
+                Vec_IR_var *killed = VCALL(t->mapExprKill, get, def);
+                for_vec(IR_var, k, *killed)
+                    VCALL(*e_kill, insert, *k);
+            }
+        }
+    }
+}
+
+//// ================================== 数据流分析 ==================================
+
+static void LazyCodeMotionAnalysis_teardown(LazyCodeMotionAnalysis *t) {
+    for_map(IR_block_ptr, Fact_set_var_ptr, i, t->mapInFact)
+        RDELETE(Fact_set_var, i->val);
+    for_map(IR_block_ptr, Fact_set_var_ptr, i, t->mapOutFact)
+        RDELETE(Fact_set_var, i->val);
+    Map_IR_block_ptr_Fact_set_var_ptr_teardown(&t->mapInFact);
+    Map_IR_block_ptr_Fact_set_var_ptr_teardown(&t->mapOutFact);
+}
+
+static bool LazyCodeMotionAnalysis_isForward(LazyCodeMotionAnalysis *t) { return true; }
+static bool LazyCodeMotionAnalysis_isBackward(LazyCodeMotionAnalysis *t) { return false; }
+
+static Fact_set_var *LazyCodeMotionAnalysis_newEmptyFact(LazyCodeMotionAnalysis *t, IR_function *func) {
+    return NEW(Fact_set_var, false);
+}
+
+static Fact_set_var *LazyCodeMotionAnalysis_newTopFact(LazyCodeMotionAnalysis *t) {
+    return NEW(Fact_set_var, true);
+}
+
+static Fact_set_var *LazyCodeMotionAnalysis_newBottomFact(LazyCodeMotionAnalysis *t) {
+    return NEW(Fact_set_var, false);
+}
+
+static void LazyCodeMotionAnalysis_setInFact(LazyCodeMotionAnalysis *t, IR_block *blk, Fact_set_var *fact) {
+    VCALL(t->mapInFact, set, blk, fact);
+}
+
+static void LazyCodeMotionAnalysis_setOutFact(LazyCodeMotionAnalysis *t, IR_block *blk, Fact_set_var *fact) {
+    VCALL(t->mapOutFact, set, blk, fact);
+}
+
+static Fact_set_var *LazyCodeMotionAnalysis_getInFact(LazyCodeMotionAnalysis *t, IR_block *blk) {
+    return VCALL(t->mapInFact, get, blk);
+}
+
+static Fact_set_var *LazyCodeMotionAnalysis_getOutFact(LazyCodeMotionAnalysis *t, IR_block *blk) {
+    return VCALL(t->mapOutFact, get, blk);
+}
+
+// must 分析: 交集, TOP 为全集
+static bool LazyCodeMotionAnalysis_meetIntersect(LazyCodeMotionAnalysis *t, Fact_set_var *fact, Fact_set_var *target) {
+    if (fact->is_top) return false;
+    if (target->is_top) {
+        target->is_top = false;
+        Set_IR_var_teardown(&target->set);
+        Set_IR_var_init(&target->set);
+        VCALL(target->set, union_with, &fact->set);
+        return true;
+    }
+    return VCALL(target->set, intersect_with, &fact->set);
+}
+
+// may 分析: 并集
+static bool LazyCodeMotionAnalysis_meetUnion(LazyCodeMotionAnalysis *t, Fact_set_var *fact, Fact_set_var *target) {
+    return VCALL(target->set, union_with, &fact->set);
+}
+
+static void LazyCodeMotionAnalysis_printResult(LazyCodeMotionAnalysis *t, IR_function *func) {
+    for_list(IR_block_ptr, i, func->blocks) {
+        IR_block *blk = i->val;
+        Fact_set_var *in_fact = VCALL(*t, getInFact, blk), *out_fact = VCALL(*t, getOutFact, blk);
+        printf("{Block %p} [In(top:%d)]: ", blk, in_fact->is_top);
+        for_set(IR_var, var, in_fact->set) printf("v%u ", var->key);
+        printf(" [Out(top:%d)]: ", out_fact->is_top);
+        for_set(IR_var, var, out_fact->set) printf("v%u ", var->key);
+        printf("\n");
+    }
+}
+
+// 预期表达式: IN[B] = e_use[B] ∪ (OUT[B] - e_kill[B])
+static bool AnticipatedExpressionsAnalysis_transferBlock(AnticipatedExpressionsAnalysis *t, IR_block *blk,
+                                                         Fact_set_var *in_fact, Fact_set_var *out_fact) {
+    PartialRedundancyElimination *pre = t->pre;
+    if (blk == pre->func->exit) return false;
+    Set_IR_var new_in;
+    Set_IR_var_init(&new_in);
+    if (VCALL(pre->reach_exit, exist, blk)) // 无法到达出口的块不做预期, 避免投机插入
+        fact_union_into(pre, out_fact, &new_in);
+    set_subtract(&new_in, block_set(&pre->e_kill, blk));
+    VCALL(new_in, union_with, block_set(&pre->e_use, blk));
+    bool updated = fact_assign(in_fact, &new_in);
+    Set_IR_var_teardown(&new_in);
+    return updated;
+}
+
+// 将可用表达式: OUT[B] = (anticipated.in[B] ∪ IN[B]) - e_kill[B]
+static bool WillBeAvailableExpressionsAnalysis_transferBlock(WillBeAvailableExpressionsAnalysis *t, IR_block *blk,
+                                                             Fact_set_var *in_fact, Fact_set_var *out_fact) {
+    PartialRedundancyElimination *pre = t->pre;
+    Set_IR_var new_out;
+    Set_IR_var_init(&new_out);
+    if (blk != pre->func->entry) fact_union_into(pre, in_fact, &new_out);
+    VCALL(new_out, union_with, block_set(&pre->anticipated_in, blk));
+    set_subtract(&new_out, block_set(&pre->e_kill, blk));
+    bool updated = fact_assign(out_fact, &new_out);
+    Set_IR_var_teardown(&new_out);
+    return updated;
+}
+
+// 可后延表达式: OUT[B] = (earliest[B] ∪ IN[B]) - e_use[B]
+static bool PostponableExpressionsAnalysis_transferBlock(PostponableExpressionsAnalysis *t, IR_block *blk,
+                                                         Fact_set_var *in_fact, Fact_set_var *out_fact) {
+    PartialRedundancyElimination *pre = t->pre;
+    Set_IR_var new_out;
+    Set_IR_var_init(&new_out);
+    if (blk != pre->func->entry) fact_union_into(pre, in_fact, &new_out);
+    VCALL(new_out, union_with, block_set(&pre->earliest, blk));
+    set_subtract(&new_out, block_set(&pre->e_use, blk));
+    bool updated = fact_assign(out_fact, &new_out);
+    Set_IR_var_teardown(&new_out);
+    return updated;
+}
+
+// 被使用表达式: IN[B] = (e_use[B] ∪ OUT[B]) - latest[B]
+static bool UsedExpressionsAnalysis_transferBlock(UsedExpressionsAnalysis *t, IR_block *blk,
+                                                  Fact_set_var *in_fact, Fact_set_var *out_fact) {
+    PartialRedundancyElimination *pre = t->pre;
+    if (blk == pre->func->exit) return false;
+    Set_IR_var new_in;
+    Set_IR_var_init(&new_in);
+    fact_union_into(pre, out_fact, &new_in);
+    VCALL(new_in, union_with, block_set(&pre->e_use, blk));
+    set_subtract(&new_in, block_set(&pre->latest, blk));
+    bool updated = fact_assign(in_fact, &new_in);
+    Set_IR_var_teardown(&new_in);
+    return updated;
+}
+
+static void LazyCodeMotionAnalysis_init_common(LazyCodeMotionAnalysis *t, PartialRedundancyElimination *pre) {
+    t->pre = pre;
+    Map_IR_block_ptr_Fact_set_var_ptr_init(&t->mapInFact);
+    Map_IR_block_ptr_Fact_set_var_ptr_init(&t->mapOutFact);
+}
+
+void AnticipatedExpressionsAnalysis_init(AnticipatedExpressionsAnalysis *t, PartialRedundancyElimination *pre) {
+    const static struct LazyCodeMotionAnalysis_virtualTable vTable = {
+            .teardown        = LazyCodeMotionAnalysis_teardown,
+            .isForward       = LazyCodeMotionAnalysis_isBackward,
+            .newBoundaryFact = LazyCodeMotionAnalysis_newEmptyFact,
+            .newInitialFact  = LazyCodeMotionAnalysis_newTopFact,
+            .setInFact       = LazyCodeMotionAnalysis_setInFact,
+            .setOutFact      = LazyCodeMotionAnalysis_setOutFact,
+            .getInFact       = LazyCodeMotionAnalysis_getInFact,
+            .getOutFact      = LazyCodeMotionAnalysis_getOutFact,
+            .meetInto        = LazyCodeMotionAnalysis_meetIntersect,
+            .transferBlock   = AnticipatedExpressionsAnalysis_transferBlock,
+            .printResult     = LazyCodeMotionAnalysis_printResult
+    };
+    t->vTable = &vTable;
+    LazyCodeMotionAnalysis_init_common(t, pre);
+}
+
+void WillBeAvailableExpressionsAnalysis_init(WillBeAvailableExpressionsAnalysis *t, PartialRedundancyElimination *pre) {
+    const static struct LazyCodeMotionAnalysis_virtualTable vTable = {
+            .teardown        = LazyCodeMotionAnalysis_teardown,
+            .isForward       = LazyCodeMotionAnalysis_isForward,
+            .newBoundaryFact = LazyCodeMotionAnalysis_newEmptyFact,
+            .newInitialFact  = LazyCodeMotionAnalysis_newTopFact,
+            .setInFact       = LazyCodeMotionAnalysis_setInFact,
+            .setOutFact      = LazyCodeMotionAnalysis_setOutFact,
+            .getInFact       = LazyCodeMotionAnalysis_getInFact,
+            .getOutFact      = LazyCodeMotionAnalysis_getOutFact,
+            .meetInto        = LazyCodeMotionAnalysis_meetIntersect,
+            .transferBlock   = WillBeAvailableExpressionsAnalysis_transferBlock,
+            .printResult     = LazyCodeMotionAnalysis_printResult
+    };
+    t->vTable = &vTable;
+    LazyCodeMotionAnalysis_init_common(t, pre);
+}
+
+void PostponableExpressionsAnalysis_init(PostponableExpressionsAnalysis *t, PartialRedundancyElimination *pre) {
+    const static struct LazyCodeMotionAnalysis_virtualTable vTable = {
+            .teardown        = LazyCodeMotionAnalysis_teardown,
+            .isForward       = LazyCodeMotionAnalysis_isForward,
+            .newBoundaryFact = LazyCodeMotionAnalysis_newEmptyFact,
+            .newInitialFact  = LazyCodeMotionAnalysis_newTopFact,
+            .setInFact       = LazyCodeMotionAnalysis_setInFact,
+            .setOutFact      = LazyCodeMotionAnalysis_setOutFact,
+            .getInFact       = LazyCodeMotionAnalysis_getInFact,
+            .getOutFact      = LazyCodeMotionAnalysis_getOutFact,
+            .meetInto        = LazyCodeMotionAnalysis_meetIntersect,
+            .transferBlock   = PostponableExpressionsAnalysis_transferBlock,
+            .printResult     = LazyCodeMotionAnalysis_printResult
+    };
+    t->vTable = &vTable;
+    LazyCodeMotionAnalysis_init_common(t, pre);
+}
+
+void UsedExpressionsAnalysis_init(UsedExpressionsAnalysis *t, PartialRedundancyElimination *pre) {
+    const static struct LazyCodeMotionAnalysis_virtualTable vTable = {
+            .teardown        = LazyCodeMotionAnalysis_teardown,
+            .isForward       = LazyCodeMotionAnalysis_isBackward,
+            .newBoundaryFact = LazyCodeMotionAnalysis_newEmptyFact,
+            .newInitialFact  = LazyCodeMotionAnalysis_newBottomFact,
+            .setInFact       = LazyCodeMotionAnalysis_setInFact,
+            .setOutFact      = LazyCodeMotionAnalysis_setOutFact,
+            .getInFact       = LazyCodeMotionAnalysis_getInFact,
+            .getOutFact      = LazyCodeMotionAnalysis_getOutFact,
+            .meetInto        = LazyCodeMotionAnalysis_meetUnion,
+            .transferBlock   = UsedExpressionsAnalysis_transferBlock,
+            .printResult     = LazyCodeMotionAnalysis_printResult
+    };
+    t->vTable = &vTable;
+    LazyCodeMotionAnalysis_init_common(t, pre);
+}
+
+//// ================================== earliest / latest ==================================
+
+static void compute_earliest(PartialRedundancyElimination *t, WillBeAvailableExpressionsAnalysis *available) {
+    for_list(IR_block_ptr, i, t->func->blocks) {
+        IR_block *blk = i->val;
+        Set_IR_var *earliest = block_set(&t->earliest, blk);
+        VCALL(*earliest, union_with, block_set(&t->anticipated_in, blk));
+        if (blk == t->func->entry) continue;
+        Fact_set_var *avail_in = VCALL(*available, getInFact, blk);
+        if (avail_in->is_top) {
+            Set_IR_var_teardown(earliest);
+            Set_IR_var_init(earliest);
+        } else set_subtract(earliest, &avail_in->set);
+    }
+}
+
+// latest[B] = (earliest[B] ∪ postponable.in[B]) ∩ (e_use[B] ∪ ¬∩_{S∈succ(B)}(earliest[S] ∪ postponable.in[S]))
+static void compute_latest(PartialRedundancyElimination *t) {
+    IR_function *func = t->func;
+    Map_IR_block_ptr_Set_ptr_IR_var candidate;
+    Map_IR_block_ptr_Set_ptr_IR_var_init(&candidate);
+    for_list(IR_block_ptr, i, func->blocks) {
+        Set_IR_var *set = block_set(&candidate, i->val);
+        VCALL(*set, union_with, block_set(&t->earliest, i->val));
+        VCALL(*set, union_with, block_set(&t->postponable_in, i->val));
+    }
+    for_list(IR_block_ptr, i, func->blocks) {
+        IR_block *blk = i->val;
+        Set_IR_var *latest = block_set(&t->latest, blk);
+        Set_IR_var *self = block_set(&candidate, blk);
+        Set_IR_var *e_use = block_set(&t->e_use, blk);
+        List_IR_block_ptr *succs = VCALL(func->blk_succ, get, blk);
+        for_set(IR_var, e, *self) {
+            bool all_succ = succs->head != NULL;
+            for_list(IR_block_ptr, j, *succs) {
+                if (!VCALL(*block_set(&candidate, j->val), exist, e->key)) {
+                    all_succ = false;
+                    break;
+                }
+            }
+            if (VCALL(*e_use, exist, e->key) || !all_succ)
+                VCALL(*latest, insert, e->key);
+        }
+    }
+    block_set_map_teardown(&candidate);
+}
+
+//// ================================== 代码变换 ==================================
+
+static void save_facts(PartialRedundancyElimination *t, LazyCodeMotionAnalysis *analysis,
+                       bool in, Map_IR_block_ptr_Set_ptr_IR_var *target) {
+    for_list(IR_block_ptr, i, t->func->blocks) {
+        IR_block *blk = i->val;
+        Fact_set_var *fact = in ? VCALL(*analysis, getInFact, blk) : VCALL(*analysis, getOutFact, blk);
+        Set_IR_var *set = block_set(target, blk);
+        if (in && blk == t->func->entry && analysis->vTable->isForward(analysis))
+            continue; // 入口块之前没有任何计算
+        fact_union_into(t, fact, set);
+    }
+}
+
+static bool block_transform(PartialRedundancyElimination *t, IR_block *blk) {
+    bool updated = false;
+    Set_IR_var *latest = block_set(&t->latest, blk);
+    Set_IR_var *used_out = block_set(&t->used_out, blk);
+    Set_IR_var *e_use = block_set(&t->e_use, blk);
+
+    // insert = latest ∩ used.out; replace = e_use - (latest - used.out)
+    Set_IR_var insert, replace;
+    Set_IR_var_init(&insert);
+    Set_IR_var_init(&replace);
+    for_set(IR_var, e, *latest)
+        if (VCALL(*used_out, exist, e->key)) VCALL(insert, insert, e->key);
+    for_set(IR_var, e, *e_use)
+        if (!VCALL(*latest, exist, e->key) || VCALL(*used_out, exist, e->key))
+            VCALL(replace, insert, e->key);
+
+    // 同时需要插入和替换的表达式: 块开头的插入与块内原有计算等价, 保持原计算不动
+    ListNode_IR_stmt_ptr *last_inserted = NULL;
+    for_set(IR_var, e, insert) {
+        if (VCALL(replace, exist, e->key)) continue;
+        Expr expr = VCALL(t->mapVarExpr, get, e->key);
+        IR_stmt *stmt = (IR_stmt*)NEW(IR_op_stmt, expr.op, e->key, expr.rs1, expr.rs2);
+        if (last_inserted == NULL) {
+            VCALL(blk->stmts, push_front, stmt);
+            last_inserted = blk->stmts.head;
+        } else {
+            VCALL(blk->stmts, insert_back, last_inserted, stmt);
+            last_inserted = last_inserted->nxt;
+        }
+        updated = true;
+    }
+
+    // 删除已被前面的插入覆盖的向上暴露计算
+    Set_IR_var killed;
+    Set_IR_var_init(&killed);
+    for_list(IR_stmt_ptr, j, blk->stmts) {
+        IR_stmt *stmt = j->val;
+        if (stmt->stmt_type == IR_OP_STMT) {
+            IR_var expr_var = ((IR_op_stmt*)stmt)->rd;
+            if (VCALL(replace, exist, expr_var) && !VCALL(insert, exist, expr_var) &&
+                !VCALL(killed, exist, expr_var)) {
+                stmt->dead = true;
+                updated = true;
+            }
+        }
+        IR_var def = VCALL(*stmt, get_def);
+        if (def != IR_VAR_NONE && VCALL(t->mapExprKill, exist, def)) {
+            Vec_IR_var *killed_vec = VCALL(t->mapExprKill, get, def);
+            for_vec(IR_var, k, *killed_vec)
+                VCALL(killed, insert, *k);
+        }
+    }
+    remove_dead_stmt(blk);
+    Set_IR_var_teardown(&killed);
+    Set_IR_var_teardown(&insert);
+    Set_IR_var_teardown(&replace);
+    return updated;
+}
+
+bool PartialRedundancyElimination_lazy_code_motion(PartialRedundancyElimination *t) {
+    IR_function *func = t->func;
+    bool updated = canonicalize_exprs(t);
+    if (t->universe.root == NULL) return updated;
+
+    split_critical_edges(t);
+    collect_reachable(func, func->entry, &t->reachable, &func->blk_succ);
+    collect_reachable(func, func->exit, &t->reach_exit, &func->blk_pred);
+    compute_local_properties(t);
+
+    AnticipatedExpressionsAnalysis *anticipated = NEW(AnticipatedExpressionsAnalysis, t);
+    worklist_solver((DataflowAnalysis*)anticipated, func);
+    save_facts(t, anticipated, true, &t->anticipated_in);
+    DELETE(anticipated);
+
+    WillBeAvailableExpressionsAnalysis *available = NEW(WillBeAvailableExpressionsAnalysis, t);
+    worklist_solver((DataflowAnalysis*)available, func);
+    compute_earliest(t, available);
+    DELETE(available);
+
+    PostponableExpressionsAnalysis *postponable = NEW(PostponableExpressionsAnalysis, t);
+    worklist_solver((DataflowAnalysis*)postponable, func);
+    save_facts(t, postponable, true, &t->postponable_in);
+    DELETE(postponable);
+
+    compute_latest(t);
+
+    UsedExpressionsAnalysis *used = NEW(UsedExpressionsAnalysis, t);
+    worklist_solver((DataflowAnalysis*)used, func);
+    save_facts(t, used, false, &t->used_out);
+    DELETE(used);
+
+    for_list(IR_block_ptr, i, func->blocks) {
+        IR_block *blk = i->val;
+        if (blk == func->exit || !VCALL(t->reachable, exist, blk)) continue;
+        updated |= block_transform(t, blk);
+    }
+
+    // 未插入任何代码的拆分块没有意义, 恢复原来的边以免多出一次跳转
+    for_list(IR_block_ptr, i, t->split_blocks) {
+        IR_block *mid = i->val;
+        if (mid->stmts.head == NULL ||
+            (mid->stmts.head == mid->stmts.tail && mid->stmts.head->val->stmt_type == IR_GOTO_STMT))
+            unsplit_edge(func, mid);
+    }
+    fold_unused_expr_vars(func);
+    return updated;
+}
+
+//// ================================== 构造与析构 ==================================
+
+void PartialRedundancyElimination_init(PartialRedundancyElimination *t, IR_function *func) {
+    t->func = func;
+    Map_Expr_IR_var_init(&t->mapExpr);
+    Map_IR_var_Expr_init(&t->mapVarExpr);
+    Map_IR_var_Vec_ptr_IR_var_init(&t->mapExprKill);
+    Set_IR_var_init(&t->universe);
+    Set_IR_block_ptr_init(&t->reachable);
+    Set_IR_block_ptr_init(&t->reach_exit);
+    Map_IR_block_ptr_Set_ptr_IR_var_init(&t->e_use);
+    Map_IR_block_ptr_Set_ptr_IR_var_init(&t->e_kill);
+    Map_IR_block_ptr_Set_ptr_IR_var_init(&t->anticipated_in);
+    Map_IR_block_ptr_Set_ptr_IR_var_init(&t->earliest);
+    Map_IR_block_ptr_Set_ptr_IR_var_init(&t->postponable_in);
+    Map_IR_block_ptr_Set_ptr_IR_var_init(&t->latest);
+    Map_IR_block_ptr_Set_ptr_IR_var_init(&t->used_out);
+    List_IR_block_ptr_init(&t->split_blocks);
+}
+
+void PartialRedundancyElimination_teardown(PartialRedundancyElimination *t) {
+    Map_Expr_IR_var_teardown(&t->mapExpr);
+    Map_IR_var_Expr_teardown(&t->mapVarExpr);
+    expr_kill_map_teardown(&t->mapExprKill);
+    Set_IR_var_teardown(&t->universe);
+    Set_IR_block_ptr_teardown(&t->reachable);
+    Set_IR_block_ptr_teardown(&t->reach_exit);
+    block_set_map_teardown(&t->e_use);
+    block_set_map_teardown(&t->e_kill);
+    block_set_map_teardown(&t->anticipated_in);
+    block_set_map_teardown(&t->earliest);
+    block_set_map_teardown(&t->postponable_in);
+    block_set_map_teardown(&t->latest);
+    block_set_map_teardown(&t->used_out);
+    List_IR_block_ptr_teardown(&t->split_blocks);
+}
@@ -0,0 +1,270 @@
+//
+// Created by Assistant
+// 冗余加载消除 (Redundant Load Elimination)
+//
+
+#include <redundant_load_elimination.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+int MemKey_CMP(MemKey a, MemKey b) {
+    if (a.base != b.base)
+        return a.base < b.base;
+    return a.offset == b.offset ? -1 : a.offset < b.offset;
+}
+
+void Fact_mem_value_init(Fact_mem_value *fact, bool is_top) {
+    fact->is_top = is_top;
+    Map_MemKey_IR_val_init(&fact->values);
+}
+
+void Fact_mem_value_teardown(Fact_mem_value *fact) {
+    Map_MemKey_IR_val_teardown(&fact->values);
+}
+
+static bool IR_val_equal(IR_val a, IR_val b) {
+    if (a.is_const != b.is_const) return false;
+    return a.is_const ? a.const_val == b.const_val : a.var == b.var;
+}
+
+static MemLocation key_location(MemKey key) {
+    return (MemLocation){.known_base = true, .known_offset = true, .base = key.base, .offset = key.offset};
+}
+
+//// ============================ Dataflow Analysis ============================
+
+static void RedundantLoadElimination_teardown(RedundantLoadElimination *t) {
+    for_map(IR_block_ptr, Fact_mem_value_ptr, i, t->mapInFact)
+        RDELETE(Fact_mem_value, i->val);
+    for_map(IR_block_ptr, Fact_mem_value_ptr, i, t->mapOutFact)
+        RDELETE(Fact_mem_value, i->val);
+    Map_IR_block_ptr_Fact_mem_value_ptr_teardown(&t->mapInFact);
+    Map_IR_block_ptr_Fact_mem_value_ptr_teardown(&t->mapOutFact);
+    ScalarPromoter_teardown(&t->promoter);
+}
+
+static bool
+RedundantLoadElimination_isForward (RedundantLoadElimination *t) {
+    return true;
+}
+
+static Fact_mem_value*
+RedundantLoadElimination_newBoundaryFact (RedundantLoadElimination *t, IR_function *func) {
+    return NEW(Fact_mem_value, false); // 入口处没有已知的内存值
+}
+
+static Fact_mem_value*
+RedundantLoadElimination_newInitialFact (RedundantLoadElimination *t) {
+    return NEW(Fact_mem_value, true);
+}
+
+static void
+RedundantLoadElimination_setInFact (RedundantLoadElimination *t, IR_block *blk, Fact_mem_value *fact) {
+    VCALL(t->mapInFact, set, blk, fact);
+}
+
+static void
+RedundantLoadElimination_setOutFact (RedundantLoadElimination *t, IR_block *blk, Fact_mem_value *fact) {
+    VCALL(t->mapOutFact, set, blk, fact);
+}
+
+static Fact_mem_value*
+RedundantLoadElimination_getInFact (RedundantLoadElimination *t, IR_block *blk) {
+    return VCALL(t->mapInFact, get, blk);
+}
+
+static Fact_mem_value*
+RedundantLoadElimination_getOutFact (RedundantLoadElimination *t, IR_block *blk) {
+    return VCALL(t->mapOutFact, get, blk);
+}
+
+static bool
+RedundantLoadElimination_meetInto (RedundantLoadElimination *t,
+                                   Fact_mem_value *fact,
+                                   Fact_mem_value *target) {
+    if (fact->is_top) return false;
+    if (target->is_top) {
+        target->is_top = false;
+        for_map(MemKey, IR_val, it, fact->values)
+            VCALL(target->values, insert, it->key, it->val);
+        return true;
+    }
+    // 只保留两边值相同的表项
+    bool updated = false;
+    Map_MemKey_IR_val not_exist;
+    Map_MemKey_IR_val_init(&not_exist);
+    for_map(MemKey, IR_val, it, target->values)
+        if (!VCALL(fact->values, exist, it->key) || !IR_val_equal(VCALL(fact->values, get, it->key), it->val)) {
+            VCALL(not_exist, insert, it->key, it->val);
+            updated = true;
+        }
+    for_map(MemKey, IR_val, it, not_exist)
+        VCALL(target->values, delete, it->key);
+    Map_MemKey_IR_val_teardown(&not_exist);
+    return updated;
+}
+
+// 删除满足条件的表项: 可能与 loc 重叠 (kill_alias), 基址逃逸 (kill_escaped) 或值为变量 var
+static void fact_kill(RedundantLoadElimination *t, Fact_mem_value *fact,
+                      const MemLocation *loc, IR_val addr, bool kill_escaped, IR_var var) {
+    Map_MemKey_IR_val killed;
+    Map_MemKey_IR_val_init(&killed);
+    for_map(MemKey, IR_val, it, fact->values) {
+        bool kill = false;
+        if (loc) kill = ScalarPromoter_may_alias(&t->promoter, *loc, addr, key_location(it->key), addr);
+        if (kill_escaped && VCALL(t->promoter.escaped, exist, it->key.base)) kill = true;
+        if (var != IR_VAR_NONE && !it->val.is_const && it->val.var == var) kill = true;
+        if (kill) VCALL(killed, insert, it->key, it->val);
+    }
+    for_map(MemKey, IR_val, it, killed)
+        VCALL(fact->values, delete, it->key);
+    Map_MemKey_IR_val_teardown(&killed);
+}
+
+// 访问的位置是常量偏移时得到其表项的键
+static bool access_key(RedundantLoadElimination *t, IR_val addr, MemLocation *loc, MemKey *key) {
+    *loc = ScalarPromoter_resolve(&t->promoter, addr);
+    if (!loc->known_base || !loc->known_offset) return false;
+    *key = (MemKey){.base = loc->base, .offset = loc->offset};
+    return true;
+}
+
+void RedundantLoadElimination_transferStmt (RedundantLoadElimination *t,
+                                            IR_stmt *stmt,
+                                            Fact_mem_value *fact) {
+    if (fact->is_top) { // 不可达块的全集, 转为空集后再处理
+        fact->is_top = false;
+        Map_MemKey_IR_val_teardown(&fact->values);
+        Map_MemKey_IR_val_init(&fact->values);
+    }
+    MemLocation loc;
+    MemKey key;
+    switch (stmt->stmt_type) {
+        case IR_STORE_STMT: {
+            IR_store_stmt *store = (IR_store_stmt*)stmt;
+            bool known = access_key(t, store->rd_addr, &loc, &key);
+            fact_kill(t, fact, &loc, store->rd_addr, false, IR_VAR_NONE);
+            if (known) VCALL(fact->values, set, key, store->rs);
+            return;
+        }
+        case IR_LOAD_STMT: {
+            IR_load_stmt *load = (IR_load_stmt*)stmt;
+            bool known = access_key(t, load->rs_addr, &loc, &key);
+            fact_kill(t, fact, NULL, load->rs_addr, false, load->rd);
+            if (known && !VCALL(fact->values, exist, key))
+                VCALL(fact->values, insert, key, ((IR_val){.is_const = false, .var = load->rd}));
+            return;
+        }
+        case IR_CALL_STMT: // 被调用的函数只能经逃逸的地址访问声明
+            fact_kill(t, fact, NULL, (IR_val){.is_const = true, .const_val = 0}, true, VCALL(*stmt, get_def));
+            return;
+        default: {
+            IR_var def = VCALL(*stmt, get_def);
+            if (def != IR_VAR_NONE)
+                fact_kill(t, fact, NULL, (IR_val){.is_const = true, .const_val = 0}, false, def);
+            return;
+        }
+    }
+}
+
+static bool
+RedundantLoadElimination_transferBlock (RedundantLoadElimination *t,
+                                        IR_block *block,
+                                        Fact_mem_value *in_fact,
+                                        Fact_mem_value *out_fact) {
+    Fact_mem_value *new_out_fact = RedundantLoadElimination_newInitialFact(t);
+    RedundantLoadElimination_meetInto(t, in_fact, new_out_fact);
+    for_list(IR_stmt_ptr, i, block->stmts)
+        RedundantLoadElimination_transferStmt(t, i->val, new_out_fact);
+    bool updated = RedundantLoadElimination_meetInto(t, new_out_fact, out_fact);
+    RDELETE(Fact_mem_value, new_out_fact);
+    return updated;
+}
+
+static void print_fact(Fact_mem_value *fact) {
+    if (fact->is_top) {
+        printf("(top)\n");
+        return;
+    }
+    for_map(MemKey, IR_val, it, fact->values) {
+        if (it->val.is_const) printf("{*(v%u + %d) = #%d} ", it->key.base, it->key.offset, it->val.const_val);
+        else printf("{*(v%u + %d) = v%u} ", it->key.base, it->key.offset, it->val.var);
+    }
+    printf("\n");
+}
+
+static void
+RedundantLoadElimination_print_result (RedundantLoadElimination *t, IR_function *func) {
+    printf("Function %s: Redundant Load Elimination Result\n", func->func_name);
+    for_list(IR_block_ptr, i, func->blocks) {
+        IR_block *blk = i->val;
+        printf("=================\n");
+        printf("{Block%s %p}\n", blk == func->entry ? "(Entry)" :
+                                 blk == func->exit ? "(Exit)" : "",
+               blk);
+        IR_block_print(blk, stdout);
+        printf("[In]: ");
+        print_fact(VCALL(*t, getInFact, blk));
+        printf("[Out]: ");
+        print_fact(VCALL(*t, getOutFact, blk));
+        printf("=================\n");
+    }
+}
+
+void RedundantLoadElimination_init(RedundantLoadElimination *t, IR_function *func) {
+    const static struct RedundantLoadElimination_virtualTable vTable = {
+            .teardown        = RedundantLoadElimination_teardown,
+            .isForward       = RedundantLoadElimination_isForward,
+            .newBoundaryFact = RedundantLoadElimination_newBoundaryFact,
+            .newInitialFact  = RedundantLoadElimination_newInitialFact,
+            .setInFact       = RedundantLoadElimination_setInFact,
+            .setOutFact      = RedundantLoadElimination_setOutFact,
+            .getInFact       = RedundantLoadElimination_getInFact,
+            .getOutFact      = RedundantLoadElimination_getOutFact,
+            .meetInto        = RedundantLoadElimination_meetInto,
+            .transferBlock   = RedundantLoadElimination_transferBlock,
+            .printResult     = RedundantLoadElimination_print_result
+    };
+    t->vTable = &vTable;
+    ScalarPromoter_init(&t->promoter, func, NULL);
+    Map_IR_block_ptr_Fact_mem_value_ptr_init(&t->mapInFact);
+    Map_IR_block_ptr_Fact_mem_value_ptr_init(&t->mapOutFact);
+}
+
+//// ============================ Optimize ============================
+
+typedef struct {
+    ListNode_IR_stmt_ptr *node;     // 冗余的 LOAD 所在的节点
+    IR_val value;                   // 位置上的可用值
+} RedundantLoad;
+
+bool RedundantLoadElimination_replace_redundant_load(RedundantLoadElimination *t, IR_function *func) {
+    // 替换会使定义-使用索引中的语句失效, 先找出所有冗余的 LOAD
+    unsigned cnt = 0, cap = 8;
+    RedundantLoad *loads = (RedundantLoad*)malloc(sizeof(RedundantLoad) * cap);
+    for_list(IR_block_ptr, i, func->blocks) {
+        IR_block *blk = i->val;
+        Fact_mem_value *fact = RedundantLoadElimination_newInitialFact(t);
+        RedundantLoadElimination_meetInto(t, VCALL(*t, getInFact, blk), fact);
+        for_list(IR_stmt_ptr, j, blk->stmts) {
+            IR_stmt *stmt = j->val;
+            MemLocation loc;
+            MemKey key;
+            if (stmt->stmt_type == IR_LOAD_STMT && !fact->is_top &&
+                access_key(t, ((IR_load_stmt*)stmt)->rs_addr, &loc, &key) &&
+                VCALL(fact->values, exist, key)) {
+                if (cnt == cap) loads = (RedundantLoad*)realloc(loads, sizeof(RedundantLoad) * (cap *= 2));
+                loads[cnt++] = (RedundantLoad){.node = j, .value = VCALL(fact->values, get, key)};
+            }
+            RedundantLoadElimination_transferStmt(t, stmt, fact);
+        }
+        RDELETE(Fact_mem_value, fact);
+    }
+    for (unsigned i = 0; i < cnt; i++) {
+        IR_load_stmt *load = (IR_load_stmt*)loads[i].node->val;
+        loads[i].node->val = (IR_stmt*)NEW(IR_assign_stmt, load->rd, loads[i].value);
+        RDELETE(IR_stmt, (IR_stmt*)load);
+    }
+    free(loads);
+    return cnt > 0;
+}
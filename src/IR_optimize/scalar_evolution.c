@@ -0,0 +1,636 @@
+//
+// Created by Assistant
+// 标量演化分析实现 (Scalar Evolution Analysis Implementation)
+//
+
+#include <scalar_evolution.h>
+#include <limits.h>
+#include <stdlib.h>
+
+//// ================================== 结点分配 ==================================
+
+static SCEV *scev_alloc(ScalarEvolution *se, SCEV_kind kind) {
+    SCEV *scev = (SCEV*)malloc(sizeof(SCEV));
+    *scev = (SCEV){.kind = kind, .value = 0, .var = IR_VAR_NONE, .op1 = NULL, .op2 = NULL, .loop = NULL};
+    VCALL(se->nodes, push_back, scev);
+    return scev;
+}
+
+static SCEV *scev_binary(ScalarEvolution *se, SCEV_kind kind, SCEV *op1, SCEV *op2, Loop_ptr loop) {
+    SCEV *scev = scev_alloc(se, kind);
+    scev->op1 = op1, scev->op2 = op2, scev->loop = loop;
+    return scev;
+}
+
+static SCEV *scev_unknown(ScalarEvolution *se, IR_var var) {
+    SCEV *scev = scev_alloc(se, SCEV_UNKNOWN);
+    scev->var = var;
+    return scev;
+}
+
+static inline bool is_cnc(SCEV *scev) { return scev->kind == SCEV_COULD_NOT_COMPUTE; }
+
+static inline bool is_const(SCEV *scev, int value) {
+    return scev->kind == SCEV_CONSTANT && scev->value == value;
+}
+
+// 有符号溢出按补码回绕, 避免未定义行为
+static inline int wrap_add(int a, int b) { return (int)((unsigned)a + (unsigned)b); }
+static inline int wrap_mul(int a, int b) { return (int)((unsigned)a * (unsigned)b); }
+
+//// ================================== 表达式性质 ==================================
+
+bool SCEV_is_invariant(SCEV *scev, Loop_ptr loop) {
+    switch (scev->kind) {
+        case SCEV_CONSTANT:
+        case SCEV_UNKNOWN:
+            return true;
+        case SCEV_ADD:
+        case SCEV_MUL:
+            return SCEV_is_invariant(scev->op1, loop) && SCEV_is_invariant(scev->op2, loop);
+        case SCEV_ADD_REC:
+            if (scev->loop == loop || Loop_is_nested_in(scev->loop, loop)) return false;
+            return SCEV_is_invariant(scev->op1, loop) && SCEV_is_invariant(scev->op2, loop);
+        case SCEV_RECURRENCE:
+            return scev->loop != loop && !Loop_is_nested_in(scev->loop, loop);
+        default:
+            return false;
+    }
+}
+
+bool SCEV_equal(SCEV *a, SCEV *b) {
+    if (a == b) return true;
+    if (a->kind != b->kind) return false;
+    switch (a->kind) {
+        case SCEV_CONSTANT: return a->value == b->value;
+        case SCEV_UNKNOWN: return a->var == b->var;
+        case SCEV_ADD:
+        case SCEV_MUL:
+            return SCEV_equal(a->op1, b->op1) && SCEV_equal(a->op2, b->op2);
+        case SCEV_ADD_REC:
+            return a->loop == b->loop && SCEV_equal(a->op1, b->op1) && SCEV_equal(a->op2, b->op2);
+        default:
+            return false; // 占位按结点区分, 无法计算的值互不相等
+    }
+}
+
+static bool contains_recurrence(SCEV *scev) {
+    switch (scev->kind) {
+        case SCEV_RECURRENCE: return true;
+        case SCEV_ADD:
+        case SCEV_MUL:
+        case SCEV_ADD_REC:
+            return contains_recurrence(scev->op1) || contains_recurrence(scev->op2);
+        default: return false;
+    }
+}
+
+//// ================================== 表达式构造 ==================================
+
+SCEV *ScalarEvolution_get_constant(ScalarEvolution *se, int value) {
+    SCEV *scev = scev_alloc(se, SCEV_CONSTANT);
+    scev->value = value;
+    return scev;
+}
+
+SCEV *ScalarEvolution_get_add_rec(ScalarEvolution *se, SCEV *start, SCEV *step, Loop_ptr loop) {
+    if (is_cnc(start) || is_cnc(step)) return &se->could_not_compute;
+    if (is_const(step, 0)) return start;
+    return scev_binary(se, SCEV_ADD_REC, start, step, loop);
+}
+
+SCEV *ScalarEvolution_get_add(ScalarEvolution *se, SCEV *a, SCEV *b) {
+    if (is_cnc(a) || is_cnc(b)) return &se->could_not_compute;
+    if (a->kind == SCEV_CONSTANT && b->kind == SCEV_CONSTANT)
+        return ScalarEvolution_get_constant(se, wrap_add(a->value, b->value));
+    if (is_const(a, 0)) return b;
+    if (is_const(b, 0)) return a;
+    if (a->kind == SCEV_CONSTANT) { SCEV *t = a; a = b; b = t; } // 常量放在右侧
+    if (a->kind == SCEV_ADD_REC && b->kind == SCEV_ADD_REC && a->loop == b->loop) {
+        SCEV *start = ScalarEvolution_get_add(se, a->op1, b->op1);
+        SCEV *step = ScalarEvolution_get_add(se, a->op2, b->op2);
+        return ScalarEvolution_get_add_rec(se, start, step, a->loop);
+    }
+    // 循环不变量并入最内层递推的初值
+    SCEV *rec = NULL, *other = NULL;
+    if (a->kind == SCEV_ADD_REC && SCEV_is_invariant(b, a->loop)) rec = a, other = b;
+    if (b->kind == SCEV_ADD_REC && SCEV_is_invariant(a, b->loop) && (!rec || Loop_is_nested_in(b->loop, rec->loop)))
+        rec = b, other = a;
+    if (rec) {
+        SCEV *start = ScalarEvolution_get_add(se, rec->op1, other);
+        return ScalarEvolution_get_add_rec(se, start, rec->op2, rec->loop);
+    }
+    // (x + c1) + c2 => x + (c1 + c2)
+    if (b->kind == SCEV_CONSTANT && a->kind == SCEV_ADD && a->op2->kind == SCEV_CONSTANT) {
+        SCEV *sum = ScalarEvolution_get_constant(se, wrap_add(a->op2->value, b->value));
+        return ScalarEvolution_get_add(se, a->op1, sum);
+    }
+    return scev_binary(se, SCEV_ADD, a, b, NULL);
+}
+
+SCEV *ScalarEvolution_get_mul(ScalarEvolution *se, SCEV *a, SCEV *b) {
+    if (is_cnc(a) || is_cnc(b)) return &se->could_not_compute;
+    if (a->kind == SCEV_CONSTANT && b->kind == SCEV_CONSTANT)
+        return ScalarEvolution_get_constant(se, wrap_mul(a->value, b->value));
+    if (b->kind == SCEV_CONSTANT) { SCEV *t = a; a = b; b = t; } // 常量放在左侧
+    if (is_const(a, 0)) return a;
+    if (is_const(a, 1)) return b;
+    // 乘以循环不变量分配到递推的初值与步长上
+    SCEV *rec = NULL, *other = NULL;
+    if (b->kind == SCEV_ADD_REC && SCEV_is_invariant(a, b->loop)) rec = b, other = a;
+    else if (a->kind == SCEV_ADD_REC && SCEV_is_invariant(b, a->loop)) rec = a, other = b;
+    if (rec) {
+        SCEV *start = ScalarEvolution_get_mul(se, other, rec->op1);
+        SCEV *step = ScalarEvolution_get_mul(se, other, rec->op2);
+        return ScalarEvolution_get_add_rec(se, start, step, rec->loop);
+    }
+    if (a->kind == SCEV_CONSTANT && b->kind == SCEV_ADD) {
+        SCEV *lhs = ScalarEvolution_get_mul(se, a, b->op1);
+        SCEV *rhs = ScalarEvolution_get_mul(se, a, b->op2);
+        return ScalarEvolution_get_add(se, lhs, rhs);
+    }
+    if (a->kind == SCEV_CONSTANT && b->kind == SCEV_MUL && b->op1->kind == SCEV_CONSTANT) {
+        SCEV *product = ScalarEvolution_get_constant(se, wrap_mul(a->value, b->op1->value));
+        return ScalarEvolution_get_mul(se, product, b->op2);
+    }
+    return scev_binary(se, SCEV_MUL, a, b, NULL);
+}
+
+SCEV *ScalarEvolution_get_minus(ScalarEvolution *se, SCEV *a, SCEV *b) {
+    SCEV *neg = ScalarEvolution_get_mul(se, ScalarEvolution_get_constant(se, -1), b);
+    return ScalarEvolution_get_add(se, a, neg);
+}
+
+/**
+ * @brief 把表达式写成 coef * self + rest 的形式, rest 不含 self。
+ * @return 表达式对 self 不是线性时返回 false。
+ */
+static bool split_recurrence(ScalarEvolution *se, SCEV *scev, SCEV *self, int *coef, SCEV **rest) {
+    if (scev == self) {
+        *coef = 1, *rest = ScalarEvolution_get_constant(se, 0);
+        return true;
+    }
+    int c1, c2;
+    SCEV *r1, *r2;
+    switch (scev->kind) {
+        case SCEV_ADD:
+            if (!split_recurrence(se, scev->op1, self, &c1, &r1)) return false;
+            if (!split_recurrence(se, scev->op2, self, &c2, &r2)) return false;
+            *coef = c1 + c2, *rest = ScalarEvolution_get_add(se, r1, r2);
+            return true;
+        case SCEV_MUL:
+            if (scev->op1->kind == SCEV_CONSTANT) {
+                if (!split_recurrence(se, scev->op2, self, &c2, &r2)) return false;
+                *coef = scev->op1->value * c2, *rest = ScalarEvolution_get_mul(se, scev->op1, r2);
+                return true;
+            }
+            break;
+        case SCEV_COULD_NOT_COMPUTE:
+            return false;
+        default:
+            break;
+    }
+    if (contains_recurrence(scev)) return false;
+    *coef = 0, *rest = scev;
+    return true;
+}
+
+//// ================================== 按需求值 ==================================
+
+static SCEV *header_value(ScalarEvolution *se, Loop_ptr loop, IR_var var);
+
+static LoopSCEVInfo *loop_info_of(ScalarEvolution *se, Loop_ptr loop) {
+    if (VCALL(se->loop_info, exist, loop)) return VCALL(se->loop_info, get, loop);
+    LoopSCEVInfo *info = (LoopSCEVInfo*)malloc(sizeof(LoopSCEVInfo));
+    Map_IR_var_SCEV_ptr_init(&info->header_values);
+    Map_IR_var_SCEV_ptr_init(&info->in_progress);
+    info->trip_count_computed = false;
+    info->backedge_taken = &se->could_not_compute;
+    info->max_backedge_taken = -1;
+    VCALL(se->loop_info, insert, loop, info);
+    return info;
+}
+
+static Loop_ptr innermost_loop(ScalarEvolution *se, IR_block *blk) {
+    return LoopAnalyzer_get_innermost_loop(se->loop_analyzer, blk);
+}
+
+// 在 [head, from] 中自后向前寻找 var 的最后一次定义
+static ListNode_IR_stmt_ptr *last_def_before(ListNode_IR_stmt_ptr *from, IR_var var) {
+    for (ListNode_IR_stmt_ptr *i = from; i; i = i->pre)
+        if (VCALL(*i->val, get_def) == var) return i;
+    return NULL;
+}
+
+static SCEV *evaluate_def(ScalarEvolution *se, IR_block *blk, ListNode_IR_stmt_ptr *node);
+
+/**
+ * @brief 求 var 在 blk 中结点 node 之前（node 为 NULL 时为块末尾）的值。
+ * 在区域 region（NULL 表示整个函数）内沿前驱反向搜索 var 的到达定义，不越过 region 的循环头。
+ */
+static SCEV *value_at(ScalarEvolution *se, IR_var var, IR_block *blk, ListNode_IR_stmt_ptr *node, Loop_ptr region) {
+    IR_block *stop = region ? region->header : NULL;
+    IR_block *def_blk = NULL;
+    ListNode_IR_stmt_ptr *def_node = last_def_before(node ? node->pre : blk->stmts.tail, var);
+    bool from_entry = false, ambiguous = false;
+    if (def_node) def_blk = blk;
+    else {
+        Set_IR_block_ptr visited;
+        Set_IR_block_ptr_init(&visited);
+        List_IR_block_ptr worklist;
+        List_IR_block_ptr_init(&worklist);
+        VCALL(worklist, push_back, blk);
+        bool first = true;
+        while (worklist.head && !ambiguous) {
+            IR_block *cur = worklist.head->val;
+            VCALL(worklist, pop_front);
+            if (!first) {
+                ListNode_IR_stmt_ptr *found = last_def_before(cur->stmts.tail, var);
+                if (found) {
+                    if (def_node && def_node != found) ambiguous = true;
+                    def_node = found, def_blk = cur;
+                    continue;
+                }
+            }
+            first = false;
+            List_IR_block_ptr *preds = VCALL(se->function->blk_pred, get, cur);
+            if (cur == stop || !preds->head) {
+                from_entry = true;
+                continue;
+            }
+            for_list(IR_block_ptr, i, *preds) {
+                if (region && !Loop_contains_block(region, i->val)) continue;
+                if (!VCALL(visited, insert, i->val)) continue;
+                VCALL(worklist, push_back, i->val);
+            }
+        }
+        List_IR_block_ptr_teardown(&worklist);
+        Set_IR_block_ptr_teardown(&visited);
+    }
+    if (ambiguous || (def_node && from_entry)) def_node = NULL, from_entry = false;
+
+    if (!region) {
+        // 顶层只做常量求值
+        if (def_node && !innermost_loop(se, def_blk)) {
+            SCEV *value = evaluate_def(se, def_blk, def_node);
+            if (value->kind == SCEV_CONSTANT) return value;
+        }
+        return scev_unknown(se, var);
+    }
+    if (from_entry) return header_value(se, region, var);
+    if (def_node && innermost_loop(se, def_blk) == region) return evaluate_def(se, def_blk, def_node);
+    return &se->could_not_compute;
+}
+
+static SCEV *value_of(ScalarEvolution *se, IR_val val, IR_block *blk, ListNode_IR_stmt_ptr *node, Loop_ptr region) {
+    if (val.is_const) return ScalarEvolution_get_constant(se, val.const_val);
+    return value_at(se, val.var, blk, node, region);
+}
+
+// 求定义语句所定义的值, 区域为语句所在的最内层循环
+static SCEV *evaluate_def(ScalarEvolution *se, IR_block *blk, ListNode_IR_stmt_ptr *node) {
+    IR_stmt *stmt = node->val;
+    if (VCALL(se->stmt_values, exist, stmt)) return VCALL(se->stmt_values, get, stmt);
+    if (!VCALL(se->evaluating, insert, stmt)) return &se->could_not_compute;
+    Loop_ptr region = innermost_loop(se, blk);
+    SCEV *result = &se->could_not_compute;
+    if (stmt->stmt_type == IR_ASSIGN_STMT) {
+        result = value_of(se, ((IR_assign_stmt*)stmt)->rs, blk, node, region);
+    } else if (stmt->stmt_type == IR_OP_STMT) {
+        IR_op_stmt *op_stmt = (IR_op_stmt*)stmt;
+        SCEV *a = value_of(se, op_stmt->rs1, blk, node, region);
+        SCEV *b = value_of(se, op_stmt->rs2, blk, node, region);
+        switch (op_stmt->op) {
+            case IR_OP_ADD: result = ScalarEvolution_get_add(se, a, b); break;
+            case IR_OP_SUB: result = ScalarEvolution_get_minus(se, a, b); break;
+            case IR_OP_MUL: result = ScalarEvolution_get_mul(se, a, b); break;
+            case IR_OP_DIV:
+                if (a->kind == SCEV_CONSTANT && b->kind == SCEV_CONSTANT && b->value != 0 &&
+                    !(a->value == INT_MIN && b->value == -1))
+                    result = ScalarEvolution_get_constant(se, a->value / b->value);
+                break;
+            case IR_OP_MOD:
+                if (a->kind == SCEV_CONSTANT && b->kind == SCEV_CONSTANT && b->value != 0 && b->value != -1)
+                    result = ScalarEvolution_get_constant(se, a->value % b->value);
+                break;
+            case IR_OP_SHL:
+                // 左移常量位等价于乘 2 的幂
+                if (b->kind == SCEV_CONSTANT && b->value >= 0 && b->value < 31)
+                    result = ScalarEvolution_get_mul(se, a, ScalarEvolution_get_constant(se, 1 << b->value));
+                break;
+            default: break;
+        }
+    }
+    VCALL(se->evaluating, delete, stmt);
+    if (!region && result->kind != SCEV_CONSTANT) result = &se->could_not_compute;
+    if (!contains_recurrence(result)) VCALL(se->stmt_values, insert, stmt, result);
+    return result;
+}
+
+// 进入循环时变量的值: 所有外部前驱末尾的值相同才可确定
+static SCEV *entry_value(ScalarEvolution *se, Loop_ptr loop, IR_var var) {
+    Loop_ptr parent = loop->parent_loop;
+    SCEV *result = NULL;
+    List_IR_block_ptr *preds = VCALL(se->function->blk_pred, get, loop->header);
+    for_list(IR_block_ptr, i, *preds) {
+        if (Loop_contains_block(loop, i->val)) continue;
+        if (parent && !Loop_contains_block(parent, i->val)) continue;
+        SCEV *value = value_at(se, var, i->val, NULL, parent);
+        if (!result) result = value;
+        else if (!SCEV_equal(result, value)) return &se->could_not_compute;
+    }
+    return result ? result : &se->could_not_compute;
+}
+
+/**
+ * @brief 求 var 在循环每次迭代开始时的值。
+ * 以占位代表本次迭代开始时的值，求出每个回边源末尾的值，
+ * 若都等于 占位 + 步长（步长不含占位）则为 {进入循环时的值, +, 步长}。
+ */
+static SCEV *header_value(ScalarEvolution *se, Loop_ptr loop, IR_var var) {
+    LoopSCEVInfo *info = loop_info_of(se, loop);
+    if (VCALL(info->header_values, exist, var)) return VCALL(info->header_values, get, var);
+    if (VCALL(info->in_progress, exist, var)) return VCALL(info->in_progress, get, var);
+    SCEV *result = &se->could_not_compute;
+    if (loop->is_reducible) {
+        SCEV *self = scev_alloc(se, SCEV_RECURRENCE);
+        self->var = var, self->loop = loop;
+        VCALL(info->in_progress, insert, var, self);
+        // 经回边再次求值同一条定义是正常的递推, 由占位截断, 不视为环
+        Set_IR_stmt_ptr outer_evaluating = se->evaluating;
+        Set_IR_stmt_ptr_init(&se->evaluating);
+        SCEV *next = NULL;
+        for_list(IR_block_ptr, i, loop->back_edges_sources) {
+            SCEV *value = value_at(se, var, i->val, NULL, loop);
+            if (!next) next = value;
+            else if (!SCEV_equal(next, value)) next = &se->could_not_compute;
+        }
+        Set_IR_stmt_ptr_teardown(&se->evaluating);
+        se->evaluating = outer_evaluating;
+        VCALL(info->in_progress, delete, var);
+        int coef;
+        SCEV *step;
+        if (next && split_recurrence(se, next, self, &coef, &step) && coef == 1 && !contains_recurrence(step))
+            result = ScalarEvolution_get_add_rec(se, entry_value(se, loop, var), step, loop);
+    }
+    VCALL(info->header_values, insert, var, result);
+    return result;
+}
+
+//// ================================== 执行次数 ==================================
+
+/**
+ * @brief 当 {start, +, step} relop bound 成立时继续循环, 求第一次不成立的迭代序号。
+ * IR 的运算按 32 位回绕, 只有在退出之前 IV 始终不越过 int 范围时结果才成立:
+ * 恒成立的比较（如 <= INT_MAX）与需要回绕才能越过界限的情形都视为无法确定。
+ * @return 无法确定（或不会终止）时返回 -1。
+ */
+static long long constant_exit_iteration(long long start, long long step, IR_RELOP_TYPE relop, long long bound) {
+    long long distance = bound - start, count;
+    switch (relop) {
+        case IR_RELOP_LT:
+            if (distance <= 0) count = 0;
+            else count = step > 0 ? (distance + step - 1) / step : -1;
+            break;
+        case IR_RELOP_LE:
+            if (distance < 0) count = 0;
+            else count = step > 0 ? distance / step + 1 : -1;
+            break;
+        case IR_RELOP_GT:
+            if (distance >= 0) count = 0;
+            else count = step < 0 ? (-distance - step - 1) / -step : -1;
+            break;
+        case IR_RELOP_GE:
+            if (distance > 0) count = 0;
+            else count = step < 0 ? -distance / -step + 1 : -1;
+            break;
+        case IR_RELOP_NE:
+            if (distance == 0) count = 0;
+            else count = step != 0 && distance % step == 0 && distance / step > 0 ? distance / step : -1;
+            break;
+        default: // IR_RELOP_EQ
+            count = distance != 0 ? 0 : 1;
+            break;
+    }
+    if (count < 0 || count > INT_MAX) return -1;
+    // 第 count 次迭代的值是最后一个被比较的值, 它之前的值单调, 只需检查这一个
+    long long last = start + count * step;
+    if (last < INT_MIN || last > INT_MAX) return -1;
+    return count;
+}
+
+// 出口条件为 lhs relop rhs 成立时继续循环, 求该出口处的回边次数
+static SCEV *exit_count_from_compare(ScalarEvolution *se, Loop_ptr loop, SCEV *lhs, IR_RELOP_TYPE relop, SCEV *rhs) {
+    if (!SCEV_is_invariant(rhs, loop)) {
+        SCEV *t = lhs; lhs = rhs; rhs = t;
+        relop = IR_RELOP_swap(relop);
+    }
+    if (!SCEV_is_invariant(rhs, loop)) return &se->could_not_compute;
+    if (SCEV_is_invariant(lhs, loop)) {
+        // 条件在循环内不变: 仅当第一次就退出时可知
+        if (lhs->kind == SCEV_CONSTANT && rhs->kind == SCEV_CONSTANT && !IR_RELOP_eval(relop, lhs->value, rhs->value))
+            return ScalarEvolution_get_constant(se, 0);
+        return &se->could_not_compute;
+    }
+    if (lhs->kind != SCEV_ADD_REC || lhs->loop != loop || lhs->op2->kind != SCEV_CONSTANT ||
+        !SCEV_is_invariant(lhs->op1, loop))
+        return &se->could_not_compute;
+    int step = lhs->op2->value;
+    // 常量次数需要起点与界限都是常量, 才能检查迭代过程中是否回绕
+    if (lhs->op1->kind == SCEV_CONSTANT && rhs->kind == SCEV_CONSTANT) {
+        long long count = constant_exit_iteration(lhs->op1->value, step, relop, rhs->value);
+        if (count < 0) return &se->could_not_compute;
+        return ScalarEvolution_get_constant(se, (int)count);
+    }
+    // 两端的差化简为常量时, 回绕后的界限可能与起点的大小关系相反, 次数并不是该常量
+    SCEV *distance = ScalarEvolution_get_minus(se, rhs, lhs->op1);
+    if (distance->kind == SCEV_CONSTANT) return &se->could_not_compute;
+    // 非常量只处理步长为 ±1, 结果在循环至少回边一次时成立;
+    // <= / >= 要求界限不是 int 的端点, != 可能需要回绕才能到达界限, 不处理
+    SCEV *neg = ScalarEvolution_get_mul(se, ScalarEvolution_get_constant(se, -1), distance);
+    SCEV *one = ScalarEvolution_get_constant(se, 1);
+    switch (relop) {
+        case IR_RELOP_LT: if (step == 1) return distance; break;
+        case IR_RELOP_LE:
+            if (step == 1 && rhs->kind == SCEV_CONSTANT && rhs->value != INT_MAX)
+                return ScalarEvolution_get_add(se, distance, one);
+            break;
+        case IR_RELOP_GT: if (step == -1) return neg; break;
+        case IR_RELOP_GE:
+            if (step == -1 && rhs->kind == SCEV_CONSTANT && rhs->value != INT_MIN)
+                return ScalarEvolution_get_add(se, neg, one);
+            break;
+        default: break;
+    }
+    return &se->could_not_compute;
+}
+
+// 退出块是否在每次迭代中恰好执行一次
+static bool exits_every_iteration(ScalarEvolution *se, Loop_ptr loop, IR_block *blk) {
+    if (innermost_loop(se, blk) != loop) return false;
+    for_list(IR_block_ptr, i, loop->back_edges_sources)
+        if (!DominanceAnalyzer_dominates(se->loop_analyzer->dom_analyzer, blk, i->val)) return false;
+    return true;
+}
+
+static SCEV *exit_count(ScalarEvolution *se, Loop_ptr loop, IR_block *blk) {
+    if (!blk->stmts.tail || blk->stmts.tail->val->stmt_type != IR_IF_STMT) return &se->could_not_compute;
+    IR_if_stmt *if_stmt = (IR_if_stmt*)blk->stmts.tail->val;
+    bool true_inside = Loop_contains_block(loop, if_stmt->true_blk);
+    bool false_inside = Loop_contains_block(loop, if_stmt->false_blk);
+    if (true_inside == false_inside) return &se->could_not_compute;
+    IR_RELOP_TYPE stay = true_inside ? if_stmt->relop : IR_RELOP_negate(if_stmt->relop);
+    SCEV *lhs = value_of(se, if_stmt->rs1, blk, blk->stmts.tail, loop);
+    SCEV *rhs = value_of(se, if_stmt->rs2, blk, blk->stmts.tail, loop);
+    if (is_cnc(lhs) || is_cnc(rhs)) return &se->could_not_compute;
+    return exit_count_from_compare(se, loop, lhs, stay, rhs);
+}
+
+static void compute_trip_count(ScalarEvolution *se, Loop_ptr loop, LoopSCEVInfo *info) {
+    info->trip_count_computed = true;
+    if (!loop->is_reducible) return;
+    SCEV *exact = NULL;
+    bool exact_known = true;
+    long long max = -1;
+    for_list(IR_block_ptr, i, loop->exit_blocks) {
+        if (!exits_every_iteration(se, loop, i->val)) {
+            exact_known = false;
+            continue;
+        }
+        SCEV *count = exit_count(se, loop, i->val);
+        if (is_cnc(count)) {
+            exact_known = false;
+            continue;
+        }
+        if (count->kind == SCEV_CONSTANT && (max < 0 || count->value < max)) max = count->value;
+        if (!exact) exact = count;
+        else if (exact->kind == SCEV_CONSTANT && count->kind == SCEV_CONSTANT) {
+            if (count->value < exact->value) exact = count;
+        } else exact_known = false;
+    }
+    if (exact_known && exact) info->backedge_taken = exact;
+    info->max_backedge_taken = (int)max;
+}
+
+//// ================================== 查询 ==================================
+
+SCEV *ScalarEvolution_get_header_value(ScalarEvolution *se, Loop_ptr loop, IR_var var) {
+    return header_value(se, loop, var);
+}
+
+SCEV *ScalarEvolution_get_value_at(ScalarEvolution *se, IR_block_ptr blk, IR_stmt *stmt, IR_var var) {
+    ListNode_IR_stmt_ptr *node = NULL;
+    if (stmt) {
+        for_list(IR_stmt_ptr, i, blk->stmts)
+            if (i->val == stmt) { node = i; break; }
+        if (!node) return &se->could_not_compute;
+    }
+    return value_at(se, var, blk, node, innermost_loop(se, blk));
+}
+
+SCEV *ScalarEvolution_get_backedge_taken_count(ScalarEvolution *se, Loop_ptr loop) {
+    LoopSCEVInfo *info = loop_info_of(se, loop);
+    if (!info->trip_count_computed) compute_trip_count(se, loop, info);
+    return info->backedge_taken;
+}
+
+bool ScalarEvolution_get_constant_trip_count(ScalarEvolution *se, Loop_ptr loop, unsigned *trip_count) {
+    SCEV *count = ScalarEvolution_get_backedge_taken_count(se, loop);
+    if (count->kind != SCEV_CONSTANT) return false;
+    *trip_count = (unsigned)count->value + 1;
+    return true;
+}
+
+bool ScalarEvolution_get_max_trip_count(ScalarEvolution *se, Loop_ptr loop, unsigned *trip_count) {
+    LoopSCEVInfo *info = loop_info_of(se, loop);
+    if (!info->trip_count_computed) compute_trip_count(se, loop, info);
+    if (info->max_backedge_taken < 0) return false;
+    *trip_count = (unsigned)info->max_backedge_taken + 1;
+    return true;
+}
+
+SCEV *ScalarEvolution_evaluate_at_iteration(ScalarEvolution *se, SCEV *rec, Loop_ptr loop, SCEV *iteration) {
+    if (rec->kind == SCEV_ADD_REC && rec->loop == loop && SCEV_is_invariant(rec->op2, loop)) {
+        SCEV *offset = ScalarEvolution_get_mul(se, rec->op2, iteration);
+        return ScalarEvolution_get_add(se, rec->op1, offset);
+    }
+    return SCEV_is_invariant(rec, loop) ? rec : &se->could_not_compute;
+}
+
+//// ================================== 构造与析构 ==================================
+
+void ScalarEvolution_init(ScalarEvolution *se, IR_function *func, LoopAnalyzer *loop_analyzer) {
+    se->function = func;
+    se->loop_analyzer = loop_analyzer;
+    Map_Loop_ptr_LoopSCEVInfo_ptr_init(&se->loop_info);
+    Map_IR_stmt_ptr_SCEV_ptr_init(&se->stmt_values);
+    Set_IR_stmt_ptr_init(&se->evaluating);
+    List_SCEV_ptr_init(&se->nodes);
+    se->could_not_compute = (SCEV){.kind = SCEV_COULD_NOT_COMPUTE, .value = 0, .var = IR_VAR_NONE,
+                                   .op1 = NULL, .op2 = NULL, .loop = NULL};
+}
+
+void ScalarEvolution_teardown(ScalarEvolution *se) {
+    for_map(Loop_ptr, LoopSCEVInfo_ptr, i, se->loop_info) {
+        Map_IR_var_SCEV_ptr_teardown(&i->val->header_values);
+        Map_IR_var_SCEV_ptr_teardown(&i->val->in_progress);
+        free(i->val);
+    }
+    Map_Loop_ptr_LoopSCEVInfo_ptr_teardown(&se->loop_info);
+    Map_IR_stmt_ptr_SCEV_ptr_teardown(&se->stmt_values);
+    Set_IR_stmt_ptr_teardown(&se->evaluating);
+    for_list(SCEV_ptr, i, se->nodes)
+        free(i->val);
+    List_SCEV_ptr_teardown(&se->nodes);
+}
+
+//// ================================== 结果输出 ==================================
+
+void SCEV_print(SCEV *scev, FILE *out) {
+    switch (scev->kind) {
+        case SCEV_CONSTANT: fprintf(out, "%d", scev->value); break;
+        case SCEV_UNKNOWN: fprintf(out, "v%u", scev->var); break;
+        case SCEV_ADD:
+        case SCEV_MUL:
+            fprintf(out, "(");
+            SCEV_print(scev->op1, out);
+            fprintf(out, scev->kind == SCEV_ADD ? " + " : " * ");
+            SCEV_print(scev->op2, out);
+            fprintf(out, ")");
+            break;
+        case SCEV_ADD_REC:
+            fprintf(out, "{");
+            SCEV_print(scev->op1, out);
+            fprintf(out, ", +, ");
+            SCEV_print(scev->op2, out);
+            fprintf(out, "}<L%u>", scev->loop->header->label);
+            break;
+        case SCEV_RECURRENCE: fprintf(out, "%%v%u", scev->var); break;
+        default: fprintf(out, "<无法计算>"); break;
+    }
+}
+
+void ScalarEvolution_print_result(ScalarEvolution *se, FILE *out) {
+    fprintf(out, "=== 标量演化分析: %s ===\n", se->function->func_name);
+    for_list(Loop_ptr, i, se->loop_analyzer->all_loops) {
+        Loop_ptr loop = i->val;
+        fprintf(out, "循环 L%u (深度 %d): 回边次数 ", loop->header->label, loop->depth);
+        SCEV_print(ScalarEvolution_get_backedge_taken_count(se, loop), out);
+        unsigned max_trip;
+        if (ScalarEvolution_get_max_trip_count(se, loop, &max_trip))
+            fprintf(out, ", 最多执行 %u 次", max_trip);
+        fprintf(out, "\n");
+        Set_IR_var printed;
+        Set_IR_var_init(&printed);
+        for_set(IR_block_ptr, j, loop->blocks) {
+            for_list(IR_stmt_ptr, k, j->key->stmts) {
+                IR_var def = VCALL(*k->val, get_def);
+                if (def == IR_VAR_NONE || !VCALL(printed, insert, def)) continue;
+                fprintf(out, "  v%u = ", def);
+                SCEV_print(ScalarEvolution_get_header_value(se, loop, def), out);
+                fprintf(out, "\n");
+            }
+        }
+        Set_IR_var_teardown(&printed);
+    }
+}
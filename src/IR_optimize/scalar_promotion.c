@@ -0,0 +1,384 @@
+//
+// Created by Assistant
+// 标量提升 (Scalar Promotion)
+//
+
+#include <scalar_promotion.h>
+#include <stdlib.h>
+
+#define RESOLVE_DEPTH 16    // 沿定义链解析地址的最大深度
+
+static const MemLocation unknown_location = {.known_base = false, .known_offset = false,
+                                             .base = IR_VAR_NONE, .offset = 0};
+
+static IR_val var_val(IR_var var) {
+    return (IR_val){.is_const = false, .var = var};
+}
+
+static bool is_param(IR_function *func, IR_var var) {
+    for_vec(IR_var, param, func->params)
+        if (*param == var) return true;
+    return false;
+}
+
+//// ================================== 逃逸分析 ==================================
+
+/**
+ * @brief 从声明地址 addr 出发沿使用链找出所有推导出的变量，遇到地址离开函数控制的使用时返回 true
+ */
+static bool collect_derived(ScalarPromoter *t, IR_var addr) {
+    bool escaped = false;
+    Set_IR_var visited;
+    Set_IR_var_init(&visited);
+    Vec_IR_var worklist;
+    Vec_IR_var_init(&worklist);
+    VCALL(visited, insert, addr);
+    VCALL(worklist, push_back, addr);
+    while (worklist.len) {
+        IR_var var = worklist.arr[worklist.len - 1];
+        VCALL(worklist, pop_back);
+        VCALL(t->derived, insert, var);
+        Set_IR_stmt_ptr *uses = DefUseChain_get_uses(&t->def_use, var);
+        if (!uses) continue;
+        for_set(IR_stmt_ptr, i, *uses) {
+            IR_stmt *stmt = i->key;
+            IR_var next = IR_VAR_NONE;
+            switch (stmt->stmt_type) {
+                case IR_LOAD_STMT:
+                case IR_IF_STMT:
+                    break;
+                case IR_STORE_STMT: {
+                    IR_store_stmt *store = (IR_store_stmt*)stmt;
+                    if (!store->rs.is_const && store->rs.var == var) escaped = true;  // 地址被存入内存
+                    break;
+                }
+                case IR_OP_STMT:
+                    next = ((IR_op_stmt*)stmt)->rd;
+                    break;
+                case IR_ASSIGN_STMT:
+                    next = ((IR_assign_stmt*)stmt)->rd;
+                    break;
+                default:    // 实参、返回值等
+                    escaped = true;
+                    break;
+            }
+            if (next != IR_VAR_NONE && !VCALL(visited, exist, next)) {
+                VCALL(visited, insert, next);
+                VCALL(worklist, push_back, next);
+            }
+        }
+    }
+    Set_IR_var_teardown(&visited);
+    Vec_IR_var_teardown(&worklist);
+    return escaped;
+}
+
+//// ================================== 构造与析构 ==================================
+
+void ScalarPromoter_init(ScalarPromoter *t, IR_function *func, LoopAnalyzer *loop_analyzer) {
+    t->function = func;
+    t->loop_analyzer = loop_analyzer;
+    t->split_edges = false;
+    DefUseChain_init(&t->def_use, func);
+    Map_IR_var_IR_Dec_init(&t->addr_dec);
+    Set_IR_var_init(&t->escaped);
+    Set_IR_var_init(&t->derived);
+    for_map(IR_var, IR_Dec, i, func->map_dec)
+        VCALL(t->addr_dec, insert, i->val.dec_addr, i->val);
+    for_map(IR_var, IR_Dec, i, t->addr_dec)
+        if (collect_derived(t, i->key)) VCALL(t->escaped, insert, i->key);
+}
+
+void ScalarPromoter_teardown(ScalarPromoter *t) {
+    DefUseChain_teardown(&t->def_use);
+    Map_IR_var_IR_Dec_teardown(&t->addr_dec);
+    Set_IR_var_teardown(&t->escaped);
+    Set_IR_var_teardown(&t->derived);
+}
+
+//// ================================== 地址解析 ==================================
+
+static MemLocation resolve_var(ScalarPromoter *t, IR_var var, unsigned depth);
+
+// 地址 + 变量偏移: 只有偏移变量不可能指向声明时才保留基址
+static MemLocation resolve_var_offset(ScalarPromoter *t, IR_val addr, IR_val offset, unsigned depth) {
+    if (addr.is_const || offset.is_const || VCALL(t->derived, exist, offset.var)) return unknown_location;
+    MemLocation loc = resolve_var(t, addr.var, depth);
+    loc.known_offset = false;
+    return loc.known_base ? loc : unknown_location;
+}
+
+static MemLocation resolve_var(ScalarPromoter *t, IR_var var, unsigned depth) {
+    if (VCALL(t->addr_dec, exist, var))
+        return (MemLocation){.known_base = true, .known_offset = true, .base = var, .offset = 0};
+    if (depth == 0 || is_param(t->function, var)) return unknown_location;
+    IR_stmt *def = DefUseChain_single_def(&t->def_use, var);
+    if (!def) return unknown_location;
+
+    if (def->stmt_type == IR_ASSIGN_STMT) {
+        IR_val rs = ((IR_assign_stmt*)def)->rs;
+        return rs.is_const ? unknown_location : resolve_var(t, rs.var, depth - 1);
+    }
+    if (def->stmt_type != IR_OP_STMT) return unknown_location;
+    IR_op_stmt *op = (IR_op_stmt*)def;
+    MemLocation loc;
+    switch (op->op) {
+        case IR_OP_ADD:
+            if (!op->rs1.is_const && op->rs2.is_const) {
+                loc = resolve_var(t, op->rs1.var, depth - 1);
+                loc.offset += op->rs2.const_val;
+                return loc;
+            }
+            if (op->rs1.is_const && !op->rs2.is_const) {
+                loc = resolve_var(t, op->rs2.var, depth - 1);
+                loc.offset += op->rs1.const_val;
+                return loc;
+            }
+            loc = resolve_var_offset(t, op->rs1, op->rs2, depth - 1);
+            return loc.known_base ? loc : resolve_var_offset(t, op->rs2, op->rs1, depth - 1);
+        case IR_OP_SUB:
+            if (!op->rs1.is_const && op->rs2.is_const) {
+                loc = resolve_var(t, op->rs1.var, depth - 1);
+                loc.offset -= op->rs2.const_val;
+                return loc;
+            }
+            return resolve_var_offset(t, op->rs1, op->rs2, depth - 1);
+        default:
+            return unknown_location;
+    }
+}
+
+MemLocation ScalarPromoter_resolve(ScalarPromoter *t, IR_val addr) {
+    if (addr.is_const) return unknown_location;
+    return resolve_var(t, addr.var, RESOLVE_DEPTH);
+}
+
+// 基址未知的访问 addr 是否可能指向声明 base
+static bool unknown_may_point_to(ScalarPromoter *t, IR_val addr, IR_var base) {
+    return addr.is_const || VCALL(t->escaped, exist, base) || VCALL(t->derived, exist, addr.var);
+}
+
+bool ScalarPromoter_may_alias(ScalarPromoter *t, MemLocation a, IR_val a_addr,
+                              MemLocation b, IR_val b_addr) {
+    if (!a.known_base && !b.known_base) return true;
+    if (!a.known_base) return unknown_may_point_to(t, a_addr, b.base);
+    if (!b.known_base) return unknown_may_point_to(t, b_addr, a.base);
+    if (a.base != b.base) return false;
+    if (!a.known_offset || !b.known_offset) return true;
+    return abs(a.offset - b.offset) < 4;
+}
+
+//// ================================== 单个循环 ==================================
+
+typedef struct {
+    IR_stmt *stmt;          // LOAD 或 STORE 语句
+    IR_val addr;            // 访问的地址
+    MemLocation loc;        // 解析结果
+} MemAccess;
+
+typedef struct {
+    IR_block *pred, *succ;
+} ExitEdge;
+
+static bool access_at(const MemAccess *access, IR_var base, int offset) {
+    return access->loc.known_base && access->loc.known_offset &&
+           access->loc.base == base && access->loc.offset == offset;
+}
+
+static MemAccess *collect_accesses(ScalarPromoter *t, Loop_ptr loop, unsigned *n, bool *has_call) {
+    unsigned cap = 8;
+    MemAccess *accesses = (MemAccess*)malloc(sizeof(MemAccess) * cap);
+    *n = 0;
+    *has_call = false;
+    for_set(IR_block_ptr, i, loop->blocks) {
+        for_list(IR_stmt_ptr, j, i->key->stmts) {
+            IR_stmt *stmt = j->val;
+            IR_val addr;
+            if (stmt->stmt_type == IR_LOAD_STMT) addr = ((IR_load_stmt*)stmt)->rs_addr;
+            else if (stmt->stmt_type == IR_STORE_STMT) addr = ((IR_store_stmt*)stmt)->rd_addr;
+            else {
+                if (stmt->stmt_type == IR_CALL_STMT) *has_call = true;
+                continue;
+            }
+            if (*n == cap) accesses = (MemAccess*)realloc(accesses, sizeof(MemAccess) * (cap *= 2));
+            accesses[(*n)++] = (MemAccess){.stmt = stmt, .addr = addr, .loc = ScalarPromoter_resolve(t, addr)};
+        }
+    }
+    return accesses;
+}
+
+/**
+ * @brief 求写回位置：退出目标的前驱都在循环内时写在目标开头，否则拆分每条退出边。
+ * 经 RETURN 离开的边不需要写回（声明随函数返回失效）。无法拆分时返回 false。
+ */
+static bool collect_store_blocks(ScalarPromoter *t, Loop_ptr loop, List_IR_block_ptr *out) {
+    IR_function *func = t->function;
+    unsigned n = 0, cap = 4;
+    ExitEdge *edges = (ExitEdge*)malloc(sizeof(ExitEdge) * cap);
+    for_set(IR_block_ptr, i, loop->blocks) {
+        for_list(IR_block_ptr, j, *VCALL(func->blk_succ, get, i->key)) {
+            if (j->val == func->exit || Loop_contains_block(loop, j->val)) continue;
+            if (n == cap) edges = (ExitEdge*)realloc(edges, sizeof(ExitEdge) * (cap *= 2));
+            edges[n++] = (ExitEdge){.pred = i->key, .succ = j->val};
+        }
+    }
+
+    // 先判断每个目标是否为专用出口, 拆分会改变目标的前驱
+    bool *dedicated = (bool*)malloc(sizeof(bool) * (n + 1));
+    for (unsigned k = 0; k < n; k++) {
+        dedicated[k] = true;
+        for_list(IR_block_ptr, j, *VCALL(func->blk_pred, get, edges[k].succ))
+            if (!Loop_contains_block(loop, j->val)) dedicated[k] = false;
+    }
+
+    bool ok = true;
+    Set_IR_block_ptr seen;
+    Set_IR_block_ptr_init(&seen);
+    for (unsigned k = 0; k < n && ok; k++) {
+        IR_block *succ = edges[k].succ;
+        if (dedicated[k]) {
+            if (VCALL(seen, exist, succ)) continue;
+            VCALL(seen, insert, succ);
+            VCALL(*out, push_back, succ);
+            continue;
+        }
+        IR_block *mid = IR_function_split_edge(func, edges[k].pred, succ);
+        if (!mid) {
+            ok = false;
+            break;
+        }
+        t->split_edges = true;
+        // 新块属于同时包含边两端的外层循环
+        bool innermost = true;
+        for (Loop_ptr outer = loop->parent_loop; outer; outer = outer->parent_loop) {
+            if (!Loop_contains_block(outer, succ)) continue;
+            if (innermost) VCALL(t->loop_analyzer->block_to_loop, insert, mid, outer);
+            innermost = false;
+            Loop_add_block(outer, mid);
+        }
+        VCALL(*out, push_back, mid);
+    }
+    Set_IR_block_ptr_teardown(&seen);
+    free(dedicated);
+    free(edges);
+    return ok;
+}
+
+// 在 blk 末尾生成位置 (base, offset) 的地址, 返回地址操作数
+static IR_val emit_address(ScalarPromoter *t, IR_block *blk, IR_var base, int offset) {
+    if (offset == 0) return var_val(base);
+    IR_var addr = ir_var_generator();
+    DefUseChain_append(&t->def_use, blk, (IR_stmt*)NEW(IR_op_stmt, IR_OP_ADD, addr, var_val(base),
+                                                       ((IR_val){.is_const = true, .const_val = offset})));
+    return var_val(addr);
+}
+
+static void promote_location(ScalarPromoter *t, Loop_ptr loop, MemAccess *accesses, unsigned n,
+                             IR_var base, int offset, List_IR_block_ptr *store_blocks) {
+    IR_var promoted = ir_var_generator();
+#ifdef DEBUG
+    printf("scalar promotion: loop L%u, v%u + %d -> v%u\n", loop->header->label, base, offset, promoted);
+#endif
+
+    // 预备首部读入
+    IR_val addr = emit_address(t, loop->preheader, base, offset);
+    DefUseChain_append(&t->def_use, loop->preheader, (IR_stmt*)NEW(IR_load_stmt, promoted, addr));
+
+    // 循环内的读写改为对新变量的赋值
+    bool stored = false;
+    for (unsigned k = 0; k < n; k++) {
+        if (!access_at(&accesses[k], base, offset)) continue;
+        IR_stmt *stmt = accesses[k].stmt, *copy;
+        if (stmt->stmt_type == IR_LOAD_STMT) {
+            copy = (IR_stmt*)NEW(IR_assign_stmt, ((IR_load_stmt*)stmt)->rd, var_val(promoted));
+        } else {
+            copy = (IR_stmt*)NEW(IR_assign_stmt, promoted, ((IR_store_stmt*)stmt)->rs);
+            stored = true;
+        }
+        DefUseChain_insert_before(&t->def_use, stmt, copy);
+        DefUseChain_erase_stmt(&t->def_use, stmt);
+    }
+    if (!stored) return;
+
+    // 退出时在块开头写回, 地址语句在写回语句之前
+    for_list(IR_block_ptr, i, *store_blocks) {
+        IR_val store_addr = offset == 0 ? var_val(base) : var_val(ir_var_generator());
+        DefUseChain_push_front(&t->def_use, i->val, (IR_stmt*)NEW(IR_store_stmt, store_addr, var_val(promoted)));
+        if (offset != 0)
+            DefUseChain_push_front(&t->def_use, i->val,
+                                   (IR_stmt*)NEW(IR_op_stmt, IR_OP_ADD, store_addr.var, var_val(base),
+                                                 ((IR_val){.is_const = true, .const_val = offset})));
+    }
+}
+
+bool ScalarPromoter_promote_loop(ScalarPromoter *t, Loop_ptr loop) {
+    if (!loop->preheader) return false;
+
+    unsigned n;
+    bool has_call;
+    MemAccess *accesses = collect_accesses(t, loop, &n, &has_call);
+
+    bool modified = false;
+    bool exits_ready = false, exits_ok = false;
+    List_IR_block_ptr store_blocks;
+    List_IR_block_ptr_init(&store_blocks);
+    for (unsigned k = 0; k < n; k++) {
+        MemLocation loc = accesses[k].loc;
+        if (!loc.known_base || !loc.known_offset) continue;
+        IR_var base = loc.base;
+        int offset = loc.offset;
+
+        // 每个位置只在第一次出现时处理
+        bool first = true;
+        for (unsigned j = 0; j < k && first; j++)
+            if (access_at(&accesses[j], base, offset)) first = false;
+        if (!first) continue;
+
+        // 预备首部中的读入必须在声明范围内
+        IR_Dec dec = VCALL(t->addr_dec, get, base);
+        if (offset < 0 || (IR_DEC_size_t)offset + 4 > dec.dec_size) continue;
+        if (has_call && VCALL(t->escaped, exist, base)) continue;
+
+        bool promotable = true, stored = false;
+        for (unsigned j = 0; j < n && promotable; j++) {
+            if (access_at(&accesses[j], base, offset)) {
+                if (accesses[j].stmt->stmt_type == IR_STORE_STMT) stored = true;
+            } else if (ScalarPromoter_may_alias(t, loc, accesses[k].addr, accesses[j].loc, accesses[j].addr)) {
+                promotable = false;
+            }
+        }
+        if (!promotable) continue;
+
+        if (stored && !exits_ready) {
+            exits_ok = collect_store_blocks(t, loop, &store_blocks);
+            exits_ready = true;
+        }
+        if (stored && !exits_ok) continue;
+
+        promote_location(t, loop, accesses, n, base, offset, &store_blocks);
+        modified = true;
+    }
+    List_IR_block_ptr_teardown(&store_blocks);
+    free(accesses);
+    return modified;
+}
+
+//// ================================== 高层接口 ==================================
+
+bool perform_scalar_promotion(IR_function *func, DominanceAnalyzer *dom_analyzer, LoopAnalyzer *loop_analyzer) {
+    if (func->map_dec.root == NULL) return false;
+
+    ScalarPromoter promoter;
+    ScalarPromoter_init(&promoter, func, loop_analyzer);
+    bool modified = false;
+    // all_loops 中内层循环在外层之前
+    for_list(Loop_ptr, i, loop_analyzer->all_loops)
+        if (ScalarPromoter_promote_loop(&promoter, i->val)) modified = true;
+    bool split_edges = promoter.split_edges;
+    ScalarPromoter_teardown(&promoter);
+    if (!split_edges) return modified;
+
+    // 拆分的退出边使支配关系与循环的出口信息失效
+    LoopAnalyzer_recompute(loop_analyzer);
+    return true;
+}
@@ -0,0 +1,338 @@
+//
+// Created by Assistant
+// 静态单赋值形式实现 (Static Single Assignment Form Implementation)
+//
+
+#include <ssa.h>
+
+//// ================================== 工具函数 ==================================
+
+static void stmt_set_def(IR_stmt *stmt, IR_var var) {
+    switch (stmt->stmt_type) {
+        case IR_OP_STMT: ((IR_op_stmt*)stmt)->rd = var; break;
+        case IR_ASSIGN_STMT: ((IR_assign_stmt*)stmt)->rd = var; break;
+        case IR_LOAD_STMT: ((IR_load_stmt*)stmt)->rd = var; break;
+        case IR_CALL_STMT: ((IR_call_stmt*)stmt)->rd = var; break;
+        case IR_READ_STMT: ((IR_read_stmt*)stmt)->rd = var; break;
+        case IR_PHI_STMT: ((IR_phi_stmt*)stmt)->rd = var; break;
+        default: break;
+    }
+}
+
+static unsigned list_length(List_IR_block_ptr *list) {
+    unsigned len = 0;
+    for_list(IR_block_ptr, i, *list) len++;
+    return len;
+}
+
+//// ================================== φ 函数放置 ==================================
+
+/**
+ * @brief SSA 构造的状态。
+ * stacks 对每个参与改名的变量保存其版本栈，栈空时当前版本为原名；
+ * undo_log 按压栈顺序记录变量，离开支配树结点时据此弹栈；
+ * origin 记录新名字（含 φ 目标）对应的原变量。
+ */
+typedef struct {
+    IR_function *func;
+    DominanceAnalyzer dom;
+    Map_IR_var_Vec_ptr_IR_var stacks;
+    Vec_IR_var undo_log;
+    Map_IR_var_IR_var origin;
+} SSABuilder;
+
+static bool is_renamable(SSABuilder *t, IR_var var) {
+    return VCALL(t->stacks, exist, var);
+}
+
+static bool is_reachable(SSABuilder *t, IR_block *blk) {
+    return VCALL(t->dom.dom_info, get, blk).rpo_index >= 0;
+}
+
+// 收集每个可改名变量的定义块, 并为其建立版本栈
+static void collect_def_blocks(SSABuilder *t, Map_IR_var_Set_ptr_IR_block_ptr *def_blocks) {
+    IR_function *func = t->func;
+    Set_IR_var pinned;
+    Set_IR_var_init(&pinned);
+    for_map(IR_var, IR_Dec, i, func->map_dec) {
+        VCALL(pinned, insert, i->key);
+        VCALL(pinned, insert, i->val.dec_addr);
+    }
+    for_list(IR_block_ptr, i, func->blocks) {
+        if (!is_reachable(t, i->val)) continue;
+        for_list(IR_stmt_ptr, j, i->val->stmts) {
+            IR_var def = VCALL(*j->val, get_def);
+            if (def == IR_VAR_NONE || VCALL(pinned, exist, def)) continue;
+            Set_IR_block_ptr *blocks;
+            if (VCALL(*def_blocks, exist, def)) blocks = VCALL(*def_blocks, get, def);
+            else {
+                blocks = NEW(Set_IR_block_ptr);
+                VCALL(*def_blocks, insert, def, blocks);
+                VCALL(t->stacks, insert, def, NEW(Vec_IR_var));
+            }
+            VCALL(*blocks, insert, i->val);
+        }
+    }
+    Set_IR_var_teardown(&pinned);
+}
+
+static IR_phi_stmt *new_phi(IR_function *func, IR_block *blk, IR_var var) {
+    List_IR_block_ptr *preds = VCALL(func->blk_pred, get, blk);
+    unsigned argc = list_length(preds), k = 0;
+    IR_val *argv = (IR_val*)malloc(sizeof(IR_val[argc ? argc : 1]));
+    IR_block **pred_arr = (IR_block**)malloc(sizeof(IR_block*[argc ? argc : 1]));
+    for_list(IR_block_ptr, i, *preds) {
+        argv[k] = (IR_val){.is_const = false, .var = var};
+        pred_arr[k++] = i->val;
+    }
+    return NEW(IR_phi_stmt, var, argc, argv, pred_arr);
+}
+
+// 在 DF+(定义块) 中变量入口活跃的块开头放置 φ 函数 (剪枝 SSA)
+static unsigned place_phis(SSABuilder *t, Map_IR_var_Set_ptr_IR_block_ptr *def_blocks) {
+    IR_function *func = t->func;
+    LiveVariableAnalysis *live = NEW(LiveVariableAnalysis);
+    worklist_solver((DataflowAnalysis*)live, func);
+    unsigned phi_cnt = 0;
+    for_map(IR_var, Set_ptr_IR_block_ptr, i, *def_blocks) {
+        List_IR_block_ptr targets;
+        List_IR_block_ptr_init(&targets);
+        DominanceAnalyzer_iterated_frontier(&t->dom, i->val, &targets);
+        for_list(IR_block_ptr, j, targets) {
+            Set_IR_var *live_in = VCALL(*live, getInFact, j->val);
+            if (!VCALL(*live_in, exist, i->key)) continue;
+            VCALL(j->val->stmts, push_front, (IR_stmt*)new_phi(func, j->val, i->key));
+            phi_cnt++;
+        }
+        List_IR_block_ptr_teardown(&targets);
+    }
+    DELETE(live);
+    return phi_cnt;
+}
+
+//// ================================== 变量改名 ==================================
+
+static IR_var current_version(SSABuilder *t, IR_var var) {
+    Vec_IR_var *stack = VCALL(t->stacks, get, var);
+    return stack->len ? stack->arr[stack->len - 1] : var;
+}
+
+static IR_var origin_of(SSABuilder *t, IR_var var) {
+    return VCALL(t->origin, exist, var) ? VCALL(t->origin, get, var) : var;
+}
+
+static void push_version(SSABuilder *t, IR_stmt *stmt, IR_var var) {
+    IR_var version = ir_var_generator();
+    Vec_IR_var *stack = VCALL(t->stacks, get, var);
+    VCALL(*stack, push_back, version);
+    VCALL(t->undo_log, push_back, var);
+    VCALL(t->origin, insert, version, var);
+    stmt_set_def(stmt, version);
+}
+
+static void rename_block(SSABuilder *t, IR_block *blk) {
+    for_list(IR_stmt_ptr, i, blk->stmts) {
+        IR_stmt *stmt = i->val;
+        if (stmt->stmt_type != IR_PHI_STMT) {
+            IR_use use = VCALL(*stmt, get_use_vec);
+            for (unsigned k = 0; k < use.use_cnt; k++)
+                if (!use.use_vec[k].is_const && is_renamable(t, use.use_vec[k].var))
+                    use.use_vec[k].var = current_version(t, use.use_vec[k].var);
+        }
+        IR_var def = VCALL(*stmt, get_def);
+        if (def != IR_VAR_NONE && is_renamable(t, def)) push_version(t, stmt, def);
+    }
+    // 填写后继块中 φ 函数在 blk 这条入边上的参数
+    List_IR_block_ptr *succs = VCALL(t->func->blk_succ, get, blk);
+    for_list(IR_block_ptr, i, *succs) {
+        for_list(IR_stmt_ptr, j, i->val->stmts) {
+            if (j->val->stmt_type != IR_PHI_STMT) break;
+            IR_phi_stmt *phi = (IR_phi_stmt*)j->val;
+            IR_var var = current_version(t, origin_of(t, phi->rd));
+            for (unsigned k = 0; k < phi->argc; k++)
+                if (phi->preds[k] == blk) phi->argv[k] = (IR_val){.is_const = false, .var = var};
+        }
+    }
+}
+
+typedef struct {
+    IR_block *blk;
+    ListNode_IR_block_ptr *next_child; // 下一个待访问的支配树子结点
+    unsigned log_base;                 // 进入该块时 undo_log 的长度
+} RenameFrame;
+
+// 用显式栈先序遍历支配树, 离开结点时弹出它压入的版本
+static void rename_variables(SSABuilder *t) {
+    RenameFrame *frames = (RenameFrame*)malloc(sizeof(RenameFrame[t->dom.block_cnt]));
+    unsigned depth = 0;
+    IR_block *root = t->dom.entry_block;
+    rename_block(t, root);
+    frames[depth++] = (RenameFrame){root, VCALL(t->dom.dom_info, get, root).children_in_dom_tree.head, 0};
+    while (depth) {
+        RenameFrame *top = &frames[depth - 1];
+        if (top->next_child) {
+            IR_block *child = top->next_child->val;
+            top->next_child = top->next_child->nxt;
+            unsigned base = t->undo_log.len;
+            rename_block(t, child);
+            frames[depth++] = (RenameFrame){child, VCALL(t->dom.dom_info, get, child).children_in_dom_tree.head, base};
+            continue;
+        }
+        while (t->undo_log.len > top->log_base) {
+            Vec_IR_var *stack = VCALL(t->stacks, get, t->undo_log.arr[t->undo_log.len - 1]);
+            VCALL(*stack, pop_back);
+            VCALL(t->undo_log, pop_back);
+        }
+        depth--;
+    }
+    free(frames);
+}
+
+//// ================================== SSA 构造 ==================================
+
+unsigned SSA_construct(IR_function *func) {
+    SSABuilder t;
+    t.func = func;
+    DominanceAnalyzer_init(&t.dom, func);
+    if (!t.dom.entry_block) {
+        DominanceAnalyzer_teardown(&t.dom);
+        return 0;
+    }
+    DominanceAnalyzer_compute_dominators(&t.dom);
+    DominanceAnalyzer_build_dominator_tree(&t.dom);
+    DominanceAnalyzer_compute_frontiers(&t.dom);
+    Map_IR_var_Vec_ptr_IR_var_init(&t.stacks);
+    Vec_IR_var_init(&t.undo_log);
+    Map_IR_var_IR_var_init(&t.origin);
+
+    Map_IR_var_Set_ptr_IR_block_ptr def_blocks;
+    Map_IR_var_Set_ptr_IR_block_ptr_init(&def_blocks);
+    collect_def_blocks(&t, &def_blocks);
+    unsigned phi_cnt = place_phis(&t, &def_blocks);
+    rename_variables(&t);
+
+    for_map(IR_var, Set_ptr_IR_block_ptr, i, def_blocks)
+        RDELETE(Set_IR_block_ptr, i->val);
+    Map_IR_var_Set_ptr_IR_block_ptr_teardown(&def_blocks);
+    for_map(IR_var, Vec_ptr_IR_var, i, t.stacks)
+        RDELETE(Vec_IR_var, i->val);
+    Map_IR_var_Vec_ptr_IR_var_teardown(&t.stacks);
+    Vec_IR_var_teardown(&t.undo_log);
+    Map_IR_var_IR_var_teardown(&t.origin);
+    DominanceAnalyzer_teardown(&t.dom);
+    return phi_cnt;
+}
+
+//// ================================== SSA 析构 ==================================
+
+typedef struct {
+    IR_var dst;
+    IR_val src;
+} ParallelCopy;
+
+static bool is_pending_src(ParallelCopy *copies, unsigned cnt, IR_var var) {
+    for (unsigned i = 0; i < cnt; i++)
+        if (!copies[i].src.is_const && copies[i].src.var == var) return true;
+    return false;
+}
+
+/**
+ * @brief 将一组并行复制 (各 dst 互不相同) 串行化后依次交给 emit。
+ * 每次取出一个 dst 不再被其余复制读取的复制；全部复制都处于环上时，
+ * 先把某个 dst 的旧值保存到临时变量，并让读取它的复制改读临时变量，从而打破环。
+ */
+static void emit_copy(IR_block *blk, ListNode_IR_stmt_ptr *pos, IR_var dst, IR_val src) {
+    IR_stmt *stmt = (IR_stmt*)NEW(IR_assign_stmt, dst, src);
+    if (pos) VCALL(blk->stmts, insert_front, pos, stmt);
+    else VCALL(blk->stmts, push_back, stmt);
+}
+
+static void sequentialize_copies(ParallelCopy *copies, unsigned cnt, IR_block *blk, ListNode_IR_stmt_ptr *pos) {
+    for (unsigned i = 0; i < cnt;) {
+        if (!copies[i].src.is_const && copies[i].src.var == copies[i].dst) copies[i] = copies[--cnt];
+        else i++;
+    }
+    while (cnt) {
+        bool emitted = false;
+        for (unsigned i = 0; i < cnt; i++) {
+            if (is_pending_src(copies, cnt, copies[i].dst)) continue;
+            emit_copy(blk, pos, copies[i].dst, copies[i].src);
+            copies[i] = copies[--cnt];
+            emitted = true;
+            break;
+        }
+        if (emitted) continue;
+        IR_var saved = copies[0].dst, tmp = ir_var_generator();
+        emit_copy(blk, pos, tmp, (IR_val){.is_const = false, .var = saved});
+        for (unsigned i = 0; i < cnt; i++)
+            if (!copies[i].src.is_const && copies[i].src.var == saved) copies[i].src.var = tmp;
+    }
+}
+
+// 复制插在跳转语句之前; 块不以跳转结尾时追加在末尾
+static ListNode_IR_stmt_ptr *copy_position(IR_block *blk) {
+    if (!blk->stmts.tail) return NULL;
+    IR_stmt_type type = blk->stmts.tail->val->stmt_type;
+    return type == IR_GOTO_STMT || type == IR_IF_STMT ? blk->stmts.tail : NULL;
+}
+
+static unsigned distinct_successor_count(IR_function *func, IR_block *blk) {
+    List_IR_block_ptr *succs = VCALL(func->blk_succ, get, blk);
+    unsigned cnt = 0;
+    for_list(IR_block_ptr, i, *succs) {
+        bool seen = false;
+        for (ListNode_IR_block_ptr *j = succs->head; j != i; j = j->nxt)
+            if (j->val == i->val) seen = true;
+        if (!seen) cnt++;
+    }
+    return cnt;
+}
+
+static void destruct_block(IR_function *func, IR_block *blk) {
+    unsigned phi_cnt = 0;
+    IR_phi_stmt *first = NULL;
+    for_list(IR_stmt_ptr, i, blk->stmts) {
+        if (i->val->stmt_type != IR_PHI_STMT) break;
+        if (!first) first = (IR_phi_stmt*)i->val;
+        phi_cnt++;
+    }
+    if (!phi_cnt) return;
+    ParallelCopy *copies = (ParallelCopy*)malloc(sizeof(ParallelCopy[phi_cnt]));
+    for (unsigned k = 0; k < first->argc; k++) {
+        IR_block *pred = first->preds[k];
+        bool handled = false;
+        for (unsigned p = 0; p < k; p++)
+            if (first->preds[p] == pred) handled = true;
+        if (handled) continue; // 同一前驱的两条边 (IF 两个分支指向同一块) 参数相同
+        unsigned cnt = 0;
+        for_list(IR_stmt_ptr, i, blk->stmts) {
+            if (i->val->stmt_type != IR_PHI_STMT) break;
+            IR_phi_stmt *phi = (IR_phi_stmt*)i->val;
+            copies[cnt++] = (ParallelCopy){phi->rd, phi->argv[k]};
+        }
+        // 关键边上的复制不能放在前驱中, 否则会影响前驱的其他后继
+        IR_block *target = pred;
+        if (distinct_successor_count(func, pred) > 1) {
+            IR_block *mid = IR_function_split_edge(func, pred, blk);
+            if (mid) target = mid;
+        }
+        sequentialize_copies(copies, cnt, target, copy_position(target));
+    }
+    free(copies);
+    for_list(IR_stmt_ptr, i, blk->stmts) {
+        if (i->val->stmt_type != IR_PHI_STMT) break;
+        i->val->dead = true;
+    }
+    remove_dead_stmt(blk);
+}
+
+void SSA_destruct(IR_function *func) {
+    // 拆边会向块链表中插入新块, 先记下原有的块
+    List_IR_block_ptr origin;
+    List_IR_block_ptr_init(&origin);
+    for_list(IR_block_ptr, i, func->blocks)
+        VCALL(origin, push_back, i->val);
+    for_list(IR_block_ptr, i, origin)
+        destruct_block(func, i->val);
+    List_IR_block_ptr_teardown(&origin);
+}
@@ -7,72 +7,15 @@
 #include "include/induction_variable_analysis.h"
 #include "include/loop_analysis.h"
 #include "include/dominance_analysis.h"
+#include "include/scalar_evolution.h"
 #include <IR.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <limits.h>
+#include <assert.h>
 #include <container/list.h>
 #include <container/treap.h>
 
-// 前向声明辅助函数
-static void replace_variable_in_stmt(IR_stmt *stmt, IR_var old_var, IR_var new_var);
-static void replace_variable_in_IR_val(IR_val *val, IR_var old_var, IR_var new_var);
-static void remove_useless_derived_iv_definitions(LoopInductionVariables_ptr loop_ivs, List_StrengthReductionVariable_ptr sr_vars);
-
-/**
- * @brief 替换派生变量的使用
- */
-void replace_derived_variable_uses(
-    DerivedInductionVariable_ptr derived_iv,
-    StrengthReductionVariable_ptr sr_var,
-    LoopInductionVariables_ptr loop_ivs) {
-    
-    if (!sr_var || !derived_iv || !loop_ivs) {
-        // printf("Error: NULL parameter in replace_derived_variable_uses\n");
-        return;
-    }
-    
-    // printf("  Replacing uses of v%u with v%u in loop\n",
-    //        derived_iv->variable,
-    //        sr_var->new_variable);
-    
-    Loop_ptr loop = loop_ivs->loop;
-    if (!loop) {
-        // printf("Error: Loop is NULL in replace_derived_variable_uses\n");
-        return;
-    }
-    
-    // 遍历循环中的所有块和语句，替换对derived_iv->variable的使用
-    for_set(IR_block_ptr, block_node, loop->blocks) {
-        IR_block_ptr block = block_node->key;
-        if (!block) {
-            // printf("Warning: NULL block found in loop->blocks during replacement\n");
-            continue;
-        }
-        
-        // Additional safety check for block validity
-        if (block == (IR_block_ptr)0xdeadbeef || 
-            block == (IR_block_ptr)0xbaadf00d) {
-            // printf("Warning: Invalid block pointer detected: %p\n", block);
-            continue;
-        }
-        
-        // 遍历基本块中的所有语句
-        for_list(IR_stmt_ptr, stmt_i, block->stmts) {
-            IR_stmt *stmt = stmt_i->val;
-            
-            // 跳过定义语句本身
-            if (stmt == derived_iv->definition_stmt) {
-                continue;
-            }
-            
-            // 替换语句中对derived_iv->variable的使用
-            replace_variable_in_stmt(stmt, derived_iv->variable, sr_var->new_variable);
-        }
-    }
-    
-    // printf("  Completed variable replacement\n");
-}
-
 /**
  * @brief 为派生归纳变量创建强度削减变量
  */
@@ -102,10 +45,22 @@ StrengthReductionVariable_ptr create_strength_reduction_variable(
     return sr_var;
 }
 
+/**
+ * @brief 向循环前序块追加语句，前序块以跳转结尾时插在跳转之前
+ */
+static void append_to_preheader(DefUseChain *def_use, IR_block_ptr preheader, IR_stmt *stmt) {
+    ListNode_IR_stmt_ptr *tail = preheader->stmts.tail;
+    if (tail && (tail->val->stmt_type == IR_GOTO_STMT || tail->val->stmt_type == IR_IF_STMT))
+        DefUseChain_insert_before(def_use, tail->val, stmt);
+    else
+        DefUseChain_push_back(def_use, preheader, stmt);
+}
+
 /**
  * @brief 在循环前序块中创建初始化语句
  */
-static void create_initialization_in_preheader(StrengthReductionVariable_ptr sr_var, 
+static void create_initialization_in_preheader(DefUseChain *def_use,
+                                               StrengthReductionVariable_ptr sr_var, 
                                                DerivedInductionVariable_ptr derived_iv, 
                                                Loop_ptr loop) {
     if (!sr_var || !derived_iv || !loop) {
@@ -169,12 +124,30 @@ static void create_initialization_in_preheader(StrengthReductionVariable_ptr sr_
         }
         
         // 将乘法语句添加到前序块
-        VCALL(loop->preheader->stmts, push_back, (IR_stmt*)mul_stmt);
+        append_to_preheader(def_use, loop->preheader, (IR_stmt*)mul_stmt);
     }
     
     // 将初始化语句添加到前序块
     if (sr_var->initialization_stmt != NULL) {
-        VCALL(loop->preheader->stmts, push_back, sr_var->initialization_stmt);
+        append_to_preheader(def_use, loop->preheader, sr_var->initialization_stmt);
+    }
+    
+    // 地址归纳变量再加上基址与下标中的不变项：sr_var = sr_var + base (+ inv)
+    if (derived_iv->base != IR_VAR_NONE) {
+        IR_val sr_val = {.is_const = false, .var = sr_var->new_variable};
+        IR_val base_val = {.is_const = false, .var = derived_iv->base};
+        IR_op_stmt *add_stmt = (IR_op_stmt*)malloc(sizeof(IR_op_stmt));
+        IR_op_stmt_init(add_stmt, IR_OP_ADD, sr_var->new_variable, sr_val, base_val);
+        sr_var->initialization_stmt = (IR_stmt*)add_stmt;
+        append_to_preheader(def_use, loop->preheader, sr_var->initialization_stmt);
+    }
+    if (derived_iv->invariant != IR_VAR_NONE) {
+        IR_val sr_val = {.is_const = false, .var = sr_var->new_variable};
+        IR_val inv_val = {.is_const = false, .var = derived_iv->invariant};
+        IR_op_stmt *add_stmt = (IR_op_stmt*)malloc(sizeof(IR_op_stmt));
+        IR_op_stmt_init(add_stmt, IR_OP_ADD, sr_var->new_variable, sr_val, inv_val);
+        sr_var->initialization_stmt = (IR_stmt*)add_stmt;
+        append_to_preheader(def_use, loop->preheader, sr_var->initialization_stmt);
     }
     
     // printf("Added initialization for v%u in preheader\n", sr_var->new_variable);
@@ -182,8 +155,9 @@ static void create_initialization_in_preheader(StrengthReductionVariable_ptr sr_
 
 /**
  * @brief 在循环内创建增量语句
+ * 在基本归纳变量的每条增量 i = i + c_k 之后插入 sr_var = sr_var + coefficient * c_k
  */
-static void create_increment_in_loop(StrengthReductionVariable_ptr sr_var, Loop_ptr loop) {
+static void create_increment_in_loop(InductionVariableAnalyzer *analyzer, StrengthReductionVariable_ptr sr_var, Loop_ptr loop) {
     if (!sr_var || !loop) {
         printf("Error: NULL sr_var or loop in create_increment_in_loop\n");
         return;
@@ -197,62 +171,115 @@ static void create_increment_in_loop(StrengthReductionVariable_ptr sr_var, Loop_
     }
     
     BasicInductionVariable_ptr basic_iv = derived_iv->basic_iv;
-    IR_block_ptr target_block = basic_iv->increment_block;
-    IR_stmt *basic_increment_stmt = basic_iv->increment_stmt;
-    
-    if (!target_block || !basic_increment_stmt) {
-        printf("Error: NULL target_block or basic_increment_stmt\n");
-        return;
+    sr_var->increment_block = basic_iv->increment_block;
+    for_list(IR_stmt_ptr, inc_node, basic_iv->increment_stmts) {
+        IR_stmt *basic_increment_stmt = inc_node->val;
+        LinearForm form;
+        bool linear = InductionVariableAnalyzer_get_linear_form(analyzer, basic_increment_stmt, &form);
+        assert(linear); // 由 increments_are_linear 事先检查
+        (void)linear;
+        
+        // 直接使用 sr_var = sr_var + increment，不引入临时变量
+        IR_val sr_var_val = {.is_const = false, .var = sr_var->new_variable};
+        IR_val increment_val = {.is_const = true, .const_val = derived_iv->coefficient * form.constant};
+        IR_stmt *inc_stmt = (IR_stmt*)NEW(IR_op_stmt, IR_OP_ADD, sr_var->new_variable, sr_var_val, increment_val);
+        if (!sr_var->increment_stmt) sr_var->increment_stmt = inc_stmt;
+        
+        // 在基本归纳变量更新语句之后插入派生归纳变量的增量语句
+        DefUseChain_insert_after(&analyzer->def_use, basic_increment_stmt, inc_stmt);
     }
     
-    sr_var->increment_block = target_block;
-    
-    // 创建直接增量语句，不引入临时变量
-    IR_val sr_var_val = {.is_const = false, .var = sr_var->new_variable};
-    IR_val increment_val = {.is_const = true, .const_val = sr_var->increment_value};
-    
-    // 直接使用 sr_var = sr_var + increment
-    IR_op_stmt *inc_stmt = (IR_op_stmt*)malloc(sizeof(IR_op_stmt));
-    IR_op_stmt_init(inc_stmt, IR_OP_ADD, sr_var->new_variable, sr_var_val, increment_val);
-    sr_var->increment_stmt = (IR_stmt*)inc_stmt;
-    
-    // 在基本归纳变量更新语句之后插入派生归纳变量的增量语句
-    // 首先找到基本归纳变量更新语句在链表中的位置
-    ListNode_IR_stmt_ptr *target_node = NULL;
-    for (ListNode_IR_stmt_ptr *node = target_block->stmts.head; node != NULL; node = node->nxt) {
-        if (node->val == basic_increment_stmt) {
-            target_node = node;
-            break;
-        }
+    // printf("Added increment for v%u after basic IV update in block B%u\n", 
+    //        sr_var->new_variable, sr_var->increment_block->label);
+}
+
+/**
+ * @brief 定义语句被替换或删除前，清除引用它的派生归纳变量
+ * 派生归纳变量只记录循环内的定义，只需查看语句所在块的最内层循环及其各外层循环
+ */
+static void forget_definition_stmt(InductionVariableAnalyzer *analyzer, IR_stmt *definition_stmt) {
+    IR_block_ptr blk = DefUseChain_site_of(&analyzer->def_use, definition_stmt)->blk;
+    for (Loop_ptr loop = LoopAnalyzer_get_innermost_loop(analyzer->loop_analyzer, blk); loop; loop = loop->parent_loop) {
+        LoopInductionVariables_ptr loop_ivs = InductionVariableAnalyzer_get_loop_ivs(analyzer, loop);
+        if (!loop_ivs) continue;
+        for_list(DerivedInductionVariable_ptr, div_node, loop_ivs->derived_ivs)
+            if (div_node->val->definition_stmt == definition_stmt)
+                div_node->val->definition_stmt = NULL;
     }
-    
-    if (!target_node) {
-        printf("Error: Could not find basic increment statement in target block\n");
-        return;
+}
+
+/**
+ * @brief 把派生归纳变量的定义 j = c1 * i + c2 (+ base + inv) 改为 j = sr_var (+ 常数差)
+ * 增量语句紧跟在基本归纳变量的每条更新之后，sr_var 在循环内任何位置都等于它所对应的线性函数，
+ * 因此直接替换定义语句即可，不需要分析各个使用读到的是哪一次迭代的值
+ */
+static void replace_derived_definition(InductionVariableAnalyzer *analyzer,
+                                       DerivedInductionVariable_ptr derived_iv,
+                                       StrengthReductionVariable_ptr sr_var) {
+    IR_stmt *definition_stmt = derived_iv->definition_stmt;
+    IR_val sr_val = {.is_const = false, .var = sr_var->new_variable};
+    int delta = derived_iv->constant - sr_var->original_derived_iv->constant;
+    IR_stmt *copy_stmt;
+    if (delta == 0)
+        copy_stmt = (IR_stmt*)NEW(IR_assign_stmt, derived_iv->variable, sr_val);
+    else {
+        IR_val delta_val = {.is_const = true, .const_val = delta};
+        copy_stmt = (IR_stmt*)NEW(IR_op_stmt, IR_OP_ADD, derived_iv->variable, sr_val, delta_val);
     }
-    
-    // 创建新的链表节点
-    ListNode_IR_stmt_ptr *new_node = (ListNode_IR_stmt_ptr*)malloc(sizeof(ListNode_IR_stmt_ptr));
-    new_node->val = sr_var->increment_stmt;
-    
-    // 将新节点插入到基本归纳变量更新语句之后
-    new_node->nxt = target_node->nxt;
-    new_node->pre = target_node;
-    
-    if (target_node->nxt) {
-        target_node->nxt->pre = new_node;
-    } else {
-        // target_node是最后一个节点，更新tail
-        target_block->stmts.tail = new_node;
+    DefUseChain_insert_before(&analyzer->def_use, definition_stmt, copy_stmt);
+    forget_definition_stmt(analyzer, definition_stmt);
+    DefUseChain_erase_stmt(&analyzer->def_use, definition_stmt);
+    derived_iv->definition_stmt = copy_stmt;
+}
+
+/**
+ * @brief 查找与派生归纳变量只差常数项的强度削减变量（同一基本归纳变量、系数、基址与不变项）
+ */
+static StrengthReductionVariable_ptr find_reusable_variable(List_StrengthReductionVariable_ptr sr_vars,
+                                                            DerivedInductionVariable_ptr derived_iv) {
+    for_list(StrengthReductionVariable_ptr, sr_node, sr_vars) {
+        DerivedInductionVariable_ptr other = sr_node->val->original_derived_iv;
+        if (other->basic_iv == derived_iv->basic_iv && other->coefficient == derived_iv->coefficient &&
+            other->base == derived_iv->base && other->invariant == derived_iv->invariant)
+            return sr_node->val;
     }
-    
-    target_node->nxt = new_node;
-    
-    // printf("Added increment for v%u after basic IV update in block B%u\n", 
-    //        sr_var->new_variable, target_block->label);
+    return NULL;
 }
 
+/**
+ * @brief 检查基本归纳变量的每条增量都是 i = i + c 的线性形式，插入任何增量语句之前调用
+ */
+static bool increments_are_linear(InductionVariableAnalyzer *analyzer, BasicInductionVariable_ptr basic_iv) {
+    for_list(IR_stmt_ptr, inc_node, basic_iv->increment_stmts) {
+        LinearForm form;
+        if (!InductionVariableAnalyzer_get_linear_form(analyzer, inc_node->val, &form)) {
+#ifdef DEBUG
+            printf("strength reduction: increment of v%u has no linear form\n", basic_iv->variable);
+#endif
+            return false;
+        }
+    }
+    return true;
+}
 
+/**
+ * @brief 为派生归纳变量的一个定义执行强度削减，能复用已有的强度削减变量时不再新建
+ */
+static void reduce_derived_definition(InductionVariableAnalyzer *analyzer,
+                                      DerivedInductionVariable_ptr derived_iv,
+                                      LoopInductionVariables_ptr loop_ivs,
+                                      List_StrengthReductionVariable_ptr *sr_vars) {
+    StrengthReductionVariable_ptr sr_var = find_reusable_variable(*sr_vars, derived_iv);
+    if (!sr_var) {
+        if (!increments_are_linear(analyzer, derived_iv->basic_iv)) return;
+        sr_var = create_strength_reduction_variable(analyzer, derived_iv, loop_ivs);
+        if (!sr_var) return;
+        create_initialization_in_preheader(&analyzer->def_use, sr_var, derived_iv, loop_ivs->loop);
+        create_increment_in_loop(analyzer, sr_var, loop_ivs->loop);
+        VCALL(*sr_vars, push_back, sr_var);
+    }
+    replace_derived_definition(analyzer, derived_iv, sr_var);
+}
 
 /**
  * @brief 对循环执行强度削减优化
@@ -282,10 +309,29 @@ List_StrengthReductionVariable_ptr perform_strength_reduction(
     List_StrengthReductionVariable_ptr sr_vars;
     List_StrengthReductionVariable_ptr_init(&sr_vars);
     
+    // 先处理地址归纳变量：a = base + c1 * i + c2 改为随 i 递增的指针变量
+    // 这样作为下标的派生归纳变量往往不再被使用，下面不必再为它创建变量
+    for_list(DerivedInductionVariable_ptr, div_node, loop_ivs->derived_ivs) {
+        DerivedInductionVariable_ptr derived_iv = div_node->val;
+        if (derived_iv->base == IR_VAR_NONE || !derived_iv->definition_stmt) continue;
+        if (!derived_iv->basic_iv->increment_stmt) continue;
+        reduce_derived_definition(analyzer, derived_iv, loop_ivs, &sr_vars);
+    }
+    
     // 为每个派生归纳变量创建强度削减变量
     for_list(DerivedInductionVariable_ptr, div_node, loop_ivs->derived_ivs){
         DerivedInductionVariable_ptr derived_iv = div_node->val;
         
+        // 定义语句已在处理其他循环时被删除
+        if (!derived_iv->definition_stmt) continue;
+        if (derived_iv->base != IR_VAR_NONE) continue;
+        
+        // 基本归纳变量的增量已被线性函数测试替换删除
+        if (!derived_iv->basic_iv->increment_stmt) continue;
+        
+        // 已经没有使用（如只作为地址归纳变量的下标）的变量留给死代码消除
+        if (DefUseChain_use_count(&analyzer->def_use, derived_iv->variable) == 0) continue;
+        
         // 只对系数不为1的派生归纳变量进行强度削减
         if (derived_iv->coefficient == 1) {
             // printf("Skipping strength reduction for v%u (coefficient = 1)\n",
@@ -299,30 +345,341 @@ List_StrengthReductionVariable_ptr perform_strength_reduction(
         //        derived_iv->basic_iv->variable,
         //        derived_iv->constant);
         
-        // 创建强度削减变量
-        StrengthReductionVariable_ptr sr_var = create_strength_reduction_variable(analyzer, derived_iv, loop_ivs);
-        if (!sr_var) continue;
+        reduce_derived_definition(analyzer, derived_iv, loop_ivs, &sr_vars);
+    }
+    
+    // printf("=== Strength Reduction Complete ===\n\n");
+    return sr_vars;
+}
+
+//// ================================== 线性函数测试替换 ==================================
+
+/**
+ * @brief 变量在循环内（含内层循环）是否没有定义
+ */
+static bool is_undefined_in_loop(DefUseChain *def_use, Loop_ptr loop, IR_var var) {
+    Set_IR_stmt_ptr *defs = DefUseChain_get_defs(def_use, var);
+    if (!defs) return true;
+    for_set(IR_stmt_ptr, def_node, *defs)
+        if (VCALL(loop->blocks, exist, DefUseChain_site_of(def_use, def_node->key)->blk))
+            return false;
+    return true;
+}
+
+/**
+ * @brief 判断 IF 是否为 i relop n（或 n relop i）且 n 在循环内不变，
+ * 成功时把比较规范化为 i relop n 的形式返回
+ */
+static bool match_basic_iv_test(DefUseChain *def_use, Loop_ptr loop, IR_if_stmt *if_stmt, IR_var var,
+                                IR_RELOP_TYPE *relop, IR_val *bound) {
+    bool lhs = !if_stmt->rs1.is_const && if_stmt->rs1.var == var;
+    bool rhs = !if_stmt->rs2.is_const && if_stmt->rs2.var == var;
+    if (lhs == rhs) return false;
+    *relop = lhs ? if_stmt->relop : IR_RELOP_swap(if_stmt->relop);
+    *bound = lhs ? if_stmt->rs2 : if_stmt->rs1;
+    return bound->is_const || is_undefined_in_loop(def_use, loop, bound->var);
+}
+
+/**
+ * @brief 离开循环后变量的值是否还可能被读取
+ * 从退出边的目标出发沿控制流搜索，遇到使用则活跃，遇到重新定义则该路径结束；
+ * 重新进入本循环时经过的循环内语句不计（调用前已确认其中只剩下将被删除的语句）
+ */
+static bool is_live_after_loop(IR_function *func, Loop_ptr loop, IR_var var) {
+    Set_IR_block_ptr visited;
+    Set_IR_block_ptr_init(&visited);
+    List_IR_block_ptr worklist;
+    List_IR_block_ptr_init(&worklist);
+    for_set(IR_block_ptr, blk_node, loop->blocks)
+        for_list(IR_block_ptr, succ, *VCALL(func->blk_succ, get, blk_node->key))
+            if (!VCALL(loop->blocks, exist, succ->val) && VCALL(visited, insert, succ->val))
+                VCALL(worklist, push_back, succ->val);
+    
+    bool live = false;
+    while (worklist.head && !live) {
+        IR_block_ptr blk = worklist.head->val;
+        VCALL(worklist, delete, worklist.head);
+        bool killed = false;
+        if (!VCALL(loop->blocks, exist, blk)) {
+            for_list(IR_stmt_ptr, stmt_node, blk->stmts) {
+                IR_stmt *stmt = stmt_node->val;
+                IR_use use = VCALL(*stmt, get_use_vec);
+                for (unsigned k = 0; k < use.use_cnt; k++)
+                    if (!use.use_vec[k].is_const && use.use_vec[k].var == var) live = true;
+                if (live) break;
+                if (VCALL(*stmt, get_def) == var) {
+                    killed = true;
+                    break;
+                }
+            }
+        }
+        if (live || killed) continue;
+        for_list(IR_block_ptr, succ, *VCALL(func->blk_succ, get, blk))
+            if (VCALL(visited, insert, succ->val))
+                VCALL(worklist, push_back, succ->val);
+    }
+    
+    List_IR_block_ptr_teardown(&worklist);
+    Set_IR_block_ptr_teardown(&visited);
+    return live;
+}
+
+/**
+ * @brief 语句是否为基本归纳变量的某条增量
+ */
+static bool is_increment_stmt(BasicInductionVariable_ptr basic_iv, IR_stmt *stmt) {
+    for_list(IR_stmt_ptr, inc_node, basic_iv->increment_stmts)
+        if (inc_node->val == stmt) return true;
+    return false;
+}
+
+/**
+ * @brief 基本归纳变量在循环内的使用能否随增量一起删除：
+ * 各条 i = i + c 本身，间接形式 t = i + c; i = t 中只被增量语句使用的 t = i + c，
+ * 以及结果在循环内没有使用、离开循环后也不再被读取的计算（如地址归纳变量替换后剩下的下标 t = i * 4）
+ */
+static bool is_removable_use(InductionVariableAnalyzer *analyzer, Loop_ptr loop,
+                             BasicInductionVariable_ptr basic_iv, IR_stmt *stmt) {
+    DefUseChain *def_use = &analyzer->def_use;
+    if (is_increment_stmt(basic_iv, stmt)) return true;
+    if (stmt->stmt_type != IR_OP_STMT && stmt->stmt_type != IR_ASSIGN_STMT) return false;
+    IR_var temp_var = VCALL(*stmt, get_def);
+    if (temp_var == basic_iv->variable) return false;
+    Set_IR_stmt_ptr *uses = DefUseChain_get_uses(def_use, temp_var);
+    if (!uses) return true;
+    if (DefUseChain_use_count(def_use, temp_var) == 1 && stmt->stmt_type == IR_OP_STMT)
+        for_set(IR_stmt_ptr, use_node, *uses)
+            if (is_increment_stmt(basic_iv, use_node->key)) return true;
+    for_set(IR_stmt_ptr, use_node, *uses)
+        if (VCALL(loop->blocks, exist, DefUseChain_site_of(def_use, use_node->key)->blk))
+            return false;
+    return !is_live_after_loop(analyzer->function, loop, temp_var);
+}
+
+/**
+ * @brief 求出循环内的测试能看到的 i 的取值范围 [lo, hi]，不能确定时返回 false
+ * i 的循环头值须为常量初值、常量步长的递推，循环执行次数为常量，且各条增量与步长同号：
+ * 这样每次迭代内 i 单调地从 i_k 变到 i_{k+1}，测试看到的值都在 start 与 start + trip * step 之间
+ */
+static bool basic_iv_value_range(InductionVariableAnalyzer *analyzer, ScalarEvolution *se, Loop_ptr loop,
+                                 BasicInductionVariable_ptr basic_iv, long long *lo, long long *hi) {
+    SCEV *rec = ScalarEvolution_get_header_value(se, loop, basic_iv->variable);
+    if (rec->kind != SCEV_ADD_REC || rec->loop != loop ||
+        rec->op1->kind != SCEV_CONSTANT || rec->op2->kind != SCEV_CONSTANT) return false;
+    unsigned trip_count;
+    if (!ScalarEvolution_get_constant_trip_count(se, loop, &trip_count)) return false;
+    for_list(IR_stmt_ptr, inc_node, basic_iv->increment_stmts) {
+        LinearForm form;
+        if (!InductionVariableAnalyzer_get_linear_form(analyzer, inc_node->val, &form) ||
+            (long long)form.constant * rec->op2->value <= 0) return false;
+    }
+    long long start = rec->op1->value;
+    long long end = start + (long long)trip_count * rec->op2->value;
+    *lo = start < end ? start : end;
+    *hi = start < end ? end : start;
+    return true;
+}
+
+// c1 * value + c2 是否在 int 范围内
+static bool linear_value_fits(DerivedInductionVariable_ptr derived_iv, long long value) {
+    if (value < INT_MIN || value > INT_MAX) return false;
+    long long result = derived_iv->coefficient * value + derived_iv->constant;
+    return result >= INT_MIN && result <= INT_MAX;
+}
+
+/**
+ * @brief 强度削减变量在 i 的整个取值范围内是否都不回绕
+ * c1 * i + c2 是 i 的单调函数，只需检查两端；带基址或不变项时其值无法确定，不能证明
+ */
+static bool replacement_cannot_wrap(DerivedInductionVariable_ptr derived_iv, long long lo, long long hi) {
+    if (derived_iv->base != IR_VAR_NONE || derived_iv->invariant != IR_VAR_NONE) return false;
+    return linear_value_fits(derived_iv, lo) && linear_value_fits(derived_iv, hi);
+}
+
+/**
+ * @brief 选择用来替换测试的强度削减变量（须对应同一个基本归纳变量，且在 i 的取值范围 [lo, hi] 内不回绕）
+ * 优先选择除自身增量外还有其他使用的变量，替换后其余只为测试而存在的变量随之成为死代码
+ */
+static StrengthReductionVariable_ptr select_replacement_variable(DefUseChain *def_use,
+                                                                 BasicInductionVariable_ptr basic_iv,
+                                                                 List_StrengthReductionVariable_ptr sr_vars,
+                                                                 long long lo, long long hi) {
+    StrengthReductionVariable_ptr selected = NULL;
+    int selected_rank = -1;
+    for_list(StrengthReductionVariable_ptr, sr_node, sr_vars) {
+        DerivedInductionVariable_ptr derived_iv = sr_node->val->original_derived_iv;
+        if (derived_iv->basic_iv != basic_iv || derived_iv->coefficient == 0) continue;
+        if (!replacement_cannot_wrap(derived_iv, lo, hi)) continue;
+        int rank = DefUseChain_use_count(def_use, sr_node->val->new_variable) > 1;
+        if (rank > selected_rank) {
+            selected = sr_node->val;
+            selected_rank = rank;
+        }
+    }
+    return selected;
+}
+
+/**
+ * @brief 替换后的边界 c1 * n + c2 是否在 int 范围内
+ * 变量边界须在测试处求值为常量（在循环内不变，预备首部中算出的是同一个值）
+ */
+static bool replacement_bound_fits(ScalarEvolution *se, IR_block_ptr blk, IR_if_stmt *if_stmt,
+                                   DerivedInductionVariable_ptr derived_iv, IR_val bound) {
+    if (bound.is_const) return linear_value_fits(derived_iv, bound.const_val);
+    SCEV *value = ScalarEvolution_get_value_at(se, blk, (IR_stmt*)if_stmt, bound.var);
+    return value->kind == SCEV_CONSTANT && linear_value_fits(derived_iv, value->value);
+}
+
+/**
+ * @brief 计算替换后的比较边界 c1 * n + c2 (+ base + inv)
+ * n 为常量且没有基址时直接折叠为常量，否则在预备首部生成计算语句
+ */
+static IR_val create_replacement_bound(DefUseChain *def_use, Loop_ptr loop,
+                                       DerivedInductionVariable_ptr derived_iv, IR_val bound) {
+    IR_val const_bound = {.is_const = true};
+    if (bound.is_const) {
+        const_bound.const_val = derived_iv->coefficient * bound.const_val + derived_iv->constant;
+        if (derived_iv->base == IR_VAR_NONE && derived_iv->invariant == IR_VAR_NONE) return const_bound;
+    }
+    
+    IR_var bound_var = ir_var_generator();
+    IR_val bound_val = {.is_const = false, .var = bound_var};
+    IR_block_ptr preheader = loop->preheader;
+    if (bound.is_const)
+        DefUseChain_append(def_use, preheader, (IR_stmt*)NEW(IR_assign_stmt, bound_var, const_bound));
+    else {
+        IR_val coeff_val = {.is_const = true, .const_val = derived_iv->coefficient};
+        IR_val constant_val = {.is_const = true, .const_val = derived_iv->constant};
+        if (derived_iv->coefficient == 1)
+            DefUseChain_append(def_use, preheader, (IR_stmt*)NEW(IR_assign_stmt, bound_var, bound));
+        else
+            DefUseChain_append(def_use, preheader, (IR_stmt*)NEW(IR_op_stmt, IR_OP_MUL, bound_var, bound, coeff_val));
+        if (derived_iv->constant != 0)
+            DefUseChain_append(def_use, preheader, (IR_stmt*)NEW(IR_op_stmt, IR_OP_ADD, bound_var, bound_val, constant_val));
+    }
+    if (derived_iv->base != IR_VAR_NONE) {
+        IR_val base_val = {.is_const = false, .var = derived_iv->base};
+        DefUseChain_append(def_use, preheader, (IR_stmt*)NEW(IR_op_stmt, IR_OP_ADD, bound_var, bound_val, base_val));
+    }
+    if (derived_iv->invariant != IR_VAR_NONE) {
+        IR_val inv_val = {.is_const = false, .var = derived_iv->invariant};
+        DefUseChain_append(def_use, preheader, (IR_stmt*)NEW(IR_op_stmt, IR_OP_ADD, bound_var, bound_val, inv_val));
+    }
+    return bound_val;
+}
+
+/**
+ * @brief 基本归纳变量的增量被删除前，清除与它共用增量语句的基本归纳变量
+ * （外层循环的同一变量的增量包含内层循环的增量）；只需查看各条增量所在块的最内层循环及其各外层循环
+ */
+static void forget_increment_stmts(InductionVariableAnalyzer *analyzer, Set_IR_stmt_ptr *erased) {
+    for_set(IR_stmt_ptr, inc_node, *erased) {
+        IR_block_ptr blk = DefUseChain_site_of(&analyzer->def_use, inc_node->key)->blk;
+        for (Loop_ptr loop = LoopAnalyzer_get_innermost_loop(analyzer->loop_analyzer, blk); loop; loop = loop->parent_loop) {
+            LoopInductionVariables_ptr loop_ivs = InductionVariableAnalyzer_get_loop_ivs(analyzer, loop);
+            if (!loop_ivs) continue;
+            for_list(BasicInductionVariable_ptr, biv_node, loop_ivs->basic_ivs) {
+                BasicInductionVariable_ptr basic_iv = biv_node->val;
+                if (!is_increment_stmt(basic_iv, inc_node->key)) continue;
+                basic_iv->increment_stmt = NULL;
+                List_IR_stmt_ptr_teardown(&basic_iv->increment_stmts);
+                List_IR_stmt_ptr_init(&basic_iv->increment_stmts);
+            }
+        }
+    }
+}
+
+/**
+ * @brief 对循环执行线性函数测试替换
+ */
+bool perform_linear_function_test_replacement(InductionVariableAnalyzer *analyzer,
+                                              LoopInductionVariables_ptr loop_ivs,
+                                              List_StrengthReductionVariable_ptr sr_vars) {
+    DefUseChain *def_use = &analyzer->def_use;
+    Loop_ptr loop = loop_ivs->loop;
+    bool updated = false;
+    
+    for_list(BasicInductionVariable_ptr, biv_node, loop_ivs->basic_ivs) {
+        BasicInductionVariable_ptr basic_iv = biv_node->val;
+        if (!basic_iv->increment_stmt) continue;
         
-        // 在前序块中创建初始化
-        create_initialization_in_preheader(sr_var, derived_iv, loop);
+        // 之前的改写删除了语句, 标量演化的缓存随之失效, 因此在当前的函数上重新分析 (强度削减不改变控制流)
+        ScalarEvolution se;
+        ScalarEvolution_init(&se, analyzer->function, analyzer->loop_analyzer);
         
-        // 在循环体中创建增量更新
-        create_increment_in_loop(sr_var, loop);
+        // 只有证明 c1 * i + c2 与 c1 * n + c2 都不回绕时 i relop n 才与改写后的比较等价
+        long long lo, hi;
+        StrengthReductionVariable_ptr sr_var = NULL;
+        if (basic_iv_value_range(analyzer, &se, loop, basic_iv, &lo, &hi))
+            sr_var = select_replacement_variable(def_use, basic_iv, sr_vars, lo, hi);
+        DerivedInductionVariable_ptr derived_iv = sr_var ? sr_var->original_derived_iv : NULL;
         
-        // 替换原变量的使用
-        replace_derived_variable_uses(derived_iv, sr_var, loop_ivs);
+        // 循环内除可删除的使用外只允许出现在可替换的测试中，否则替换后 i 仍然活跃，没有收益
+        List_IR_stmt_ptr tests, removable;
+        List_IR_stmt_ptr_init(&tests);
+        List_IR_stmt_ptr_init(&removable);
+        bool replaceable = sr_var != NULL;
+        if (replaceable) {
+            for_set(IR_stmt_ptr, use_node, *DefUseChain_get_uses(def_use, basic_iv->variable)) {
+                IR_stmt *stmt = use_node->key;
+                if (!VCALL(loop->blocks, exist, DefUseChain_site_of(def_use, stmt)->blk)) continue;
+                IR_RELOP_TYPE relop;
+                IR_val bound;
+                if (is_removable_use(analyzer, loop, basic_iv, stmt))
+                    VCALL(removable, push_back, stmt);
+                else if (stmt->stmt_type == IR_IF_STMT &&
+                         match_basic_iv_test(def_use, loop, (IR_if_stmt*)stmt, basic_iv->variable, &relop, &bound) &&
+                         replacement_bound_fits(&se, DefUseChain_site_of(def_use, stmt)->blk, (IR_if_stmt*)stmt,
+                                                derived_iv, bound))
+                    VCALL(tests, push_back, stmt);
+                else {
+                    replaceable = false;
+                    break;
+                }
+            }
+        }
+        ScalarEvolution_teardown(&se);
         
-        // 将强度削减变量添加到列表中
-        VCALL(sr_vars, push_back, sr_var);
-    }
-    
-    // 删除无用的派生归纳变量定义语句
-    if (sr_vars.head != NULL) {
-        remove_useless_derived_iv_definitions(loop_ivs, sr_vars);
+        if (replaceable && tests.head && !is_live_after_loop(analyzer->function, loop, basic_iv->variable)) {
+            // i relop n 改写为 sr relop' c1 * n + c2，系数为负时比较方向相反
+            IR_val sr_val = {.is_const = false, .var = sr_var->new_variable};
+            for_list(IR_stmt_ptr, test_node, tests) {
+                IR_if_stmt *if_stmt = (IR_if_stmt*)test_node->val;
+                IR_RELOP_TYPE relop;
+                IR_val bound;
+                match_basic_iv_test(def_use, loop, if_stmt, basic_iv->variable, &relop, &bound);
+                IR_val new_bound = create_replacement_bound(def_use, loop, derived_iv, bound);
+                if (derived_iv->coefficient < 0) relop = IR_RELOP_swap(relop);
+                IR_if_stmt *new_if = NEW(IR_if_stmt, relop, sr_val, new_bound,
+                                         if_stmt->true_label, if_stmt->false_label);
+                new_if->true_blk = if_stmt->true_blk;
+                new_if->false_blk = if_stmt->false_blk;
+                DefUseChain_insert_before(def_use, (IR_stmt*)if_stmt, (IR_stmt*)new_if);
+                DefUseChain_erase_stmt(def_use, (IR_stmt*)if_stmt);
+            }
+            
+            // i 只剩下自身的增量，离开循环后也不再被读取：先删除其余可删除的使用，再删除各条增量（间接形式为 i = t）
+            for_list(IR_stmt_ptr, stmt_node, removable) {
+                if (is_increment_stmt(basic_iv, stmt_node->val)) continue;
+                forget_definition_stmt(analyzer, stmt_node->val);
+                DefUseChain_erase_stmt(def_use, stmt_node->val);
+            }
+            Set_IR_stmt_ptr erased;
+            Set_IR_stmt_ptr_init(&erased);
+            for_list(IR_stmt_ptr, inc_node, basic_iv->increment_stmts)
+                VCALL(erased, insert, inc_node->val);
+            forget_increment_stmts(analyzer, &erased);
+            for_set(IR_stmt_ptr, inc_node, erased) {
+                forget_definition_stmt(analyzer, inc_node->key);
+                DefUseChain_erase_stmt(def_use, inc_node->key);
+            }
+            Set_IR_stmt_ptr_teardown(&erased);
+            updated = true;
+        }
+        List_IR_stmt_ptr_teardown(&tests);
+        List_IR_stmt_ptr_teardown(&removable);
     }
-    
-    // printf("=== Strength Reduction Complete ===\n\n");
-    return sr_vars;
+    return updated;
 }
 
 /**
@@ -356,6 +713,9 @@ void perform_strength_reduction_for_function(IR_function_ptr function, LoopAnaly
         
         // 可以选择保存结果或进一步处理
         if (sr_vars.head != NULL) {
+            // 用强度削减变量改写循环测试，删除只为测试而保留的基本归纳变量
+            perform_linear_function_test_replacement(&iv_analyzer, loop_ivs, sr_vars);
+            
             // 计算列表大小
             int count = 0;
             for_list(StrengthReductionVariable_ptr, sr_node, sr_vars) {
@@ -363,6 +723,8 @@ void perform_strength_reduction_for_function(IR_function_ptr function, LoopAnaly
             }
             // printf("Created %d strength reduction variables for this loop\n", count);
             // 暂时清理内存
+            for_list(StrengthReductionVariable_ptr, sr_node, sr_vars)
+                free(sr_node->val);
             List_StrengthReductionVariable_ptr_teardown(&sr_vars);
         }
     }
@@ -384,166 +746,3 @@ void StrengthReductionVariable_print(StrengthReductionVariable_ptr sr_var, FILE
     fprintf(out, "  Initialization: %s\n", sr_var->initialization_stmt ? "Yes" : "No");
     fprintf(out, "  Increment: %s\n", sr_var->increment_stmt ? "Yes" : "No");
 }
-
-/**
- * @brief 在语句中替换变量使用
- */
-static void replace_variable_in_stmt(IR_stmt *stmt, IR_var old_var, IR_var new_var) {
-    if (!stmt) return;
-    
-    switch (stmt->stmt_type) {
-        case IR_OP_STMT: {
-            IR_op_stmt *op_stmt = (IR_op_stmt*)stmt;
-            replace_variable_in_IR_val(&op_stmt->rs1, old_var, new_var);
-            replace_variable_in_IR_val(&op_stmt->rs2, old_var, new_var);
-            break;
-        }
-        case IR_ASSIGN_STMT: {
-            IR_assign_stmt *assign_stmt = (IR_assign_stmt*)stmt;
-            replace_variable_in_IR_val(&assign_stmt->rs, old_var, new_var);
-            break;
-        }
-        case IR_LOAD_STMT: {
-            IR_load_stmt *load_stmt = (IR_load_stmt*)stmt;
-            replace_variable_in_IR_val(&load_stmt->rs_addr, old_var, new_var);
-            break;
-        }
-        case IR_STORE_STMT: {
-            IR_store_stmt *store_stmt = (IR_store_stmt*)stmt;
-            replace_variable_in_IR_val(&store_stmt->rd_addr, old_var, new_var);
-            replace_variable_in_IR_val(&store_stmt->rs, old_var, new_var);
-            break;
-        }
-        case IR_IF_STMT: {
-            IR_if_stmt *if_stmt = (IR_if_stmt*)stmt;
-            replace_variable_in_IR_val(&if_stmt->rs1, old_var, new_var);
-            replace_variable_in_IR_val(&if_stmt->rs2, old_var, new_var);
-            break;
-        }
-        case IR_RETURN_STMT: {
-            IR_return_stmt *return_stmt = (IR_return_stmt*)stmt;
-            replace_variable_in_IR_val(&return_stmt->rs, old_var, new_var);
-            break;
-        }
-        case IR_CALL_STMT: {
-            IR_call_stmt *call_stmt = (IR_call_stmt*)stmt;
-            for (unsigned i = 0; i < call_stmt->argc; i++) {
-                replace_variable_in_IR_val(&call_stmt->argv[i], old_var, new_var);
-            }
-            break;
-        }
-        case IR_WRITE_STMT: {
-            IR_write_stmt *write_stmt = (IR_write_stmt*)stmt;
-            replace_variable_in_IR_val(&write_stmt->rs, old_var, new_var);
-            break;
-        }
-        default:
-            break;
-    }
-}
-
-/**
- * @brief 在IR_val中替换变量使用
- */
-static void replace_variable_in_IR_val(IR_val *val, IR_var old_var, IR_var new_var) {
-    if (!val || val->is_const) return;
-    
-    if (val->var == old_var) {
-        val->var = new_var;
-        // printf("    Replaced variable use: v%u -> v%u\n", old_var, new_var);
-    }
-}
-
-/**
- * @brief 删除无用的派生归纳变量定义语句
- */
-static void remove_useless_derived_iv_definitions(
-    LoopInductionVariables_ptr loop_ivs,
-    List_StrengthReductionVariable_ptr sr_vars) {
-    
-    if (!loop_ivs || !sr_vars.head) {
-        printf("Warning: NULL loop_ivs or empty sr_vars in remove_useless_derived_iv_definitions\n");
-        return;
-    }
-    
-    // printf("  Removing useless derived induction variable definitions...\n");
-    
-    Loop_ptr loop = loop_ivs->loop;
-    if (!loop) {
-        printf("Error: NULL loop in remove_useless_derived_iv_definitions\n");
-        return;
-    }
-    
-    // 遍历所有已进行强度削减的派生归纳变量
-    for_list(StrengthReductionVariable_ptr, sr_node, sr_vars) {
-        StrengthReductionVariable_ptr sr_var = sr_node->val;
-        if (!sr_var) {
-            printf("Warning: NULL sr_var in remove_useless_derived_iv_definitions\n");
-            continue;
-        }
-        
-        DerivedInductionVariable_ptr derived_iv = sr_var->original_derived_iv;
-        
-        if (!derived_iv || !derived_iv->definition_stmt) {
-            printf("Warning: NULL derived_iv or definition_stmt\n");
-            continue;
-        }
-        
-        // printf("    Removing definition of v%u (replaced by v%u)\n", 
-            //    derived_iv->variable, sr_var->new_variable);
-        
-        // 找到包含该定义语句的基本块
-        IR_block *def_block = NULL;
-        for_set(IR_block_ptr, block_node, loop->blocks) {
-            IR_block_ptr block = block_node->key;
-            if (!block) {
-                printf("Warning: NULL block in loop->blocks during removal\n");
-                continue;
-            }
-            
-            // 在该块中查找定义语句
-            for_list(IR_stmt_ptr, stmt_node, block->stmts) {
-                if (stmt_node->val == derived_iv->definition_stmt) {
-                    def_block = block;
-                    break;
-                }
-            }
-            if (def_block) break;
-        }
-        
-        if (!def_block) {
-            // printf("    Warning: Could not find definition block for v%u\n", derived_iv->variable);
-            continue;
-        }
-        
-        // 从基本块的语句列表中删除该语句
-        ListNode_IR_stmt_ptr *prev = NULL;
-        ListNode_IR_stmt_ptr *current = def_block->stmts.head;
-        
-        while (current) {
-            if (current->val == derived_iv->definition_stmt) {
-                // 找到了要删除的语句
-                if (prev) {
-                    prev->nxt = current->nxt;
-                } else {
-                    def_block->stmts.head = current->nxt;
-                }
-                
-                if (current->nxt) {
-                    current->nxt->pre = prev;
-                } else {
-                    def_block->stmts.tail = prev;
-                }
-                
-                // 释放语句节点的内存
-                free(current);
-                // printf("    Successfully removed definition statement for v%u\n", derived_iv->variable);
-                break;
-            }
-            prev = current;
-            current = current->nxt;
-        }
-    }
-    
-    // printf("  Completed removal of useless definitions\n");
-}
\ No newline at end of file
@@ -42,7 +42,7 @@ static IR_function *now_function = NULL;
 %token<IR_op_type> OP
 %token IF
 %token<IR_relop_type> RELOP
-%token ADDR_OF
+%token<IR_op_type> ADDR_OF
 %token GOTO
 %token RETURN
 %token DEC
@@ -86,6 +86,7 @@ IR_stmt     : IR_var ASSIGN IR_val                      { $$ = (IR_stmt*)NEW(IR_
             | val_deref ASSIGN IR_val_rs                { $$ = (IR_stmt*)NEW(IR_store_stmt, $1, $3); }
             | IR_var ASSIGN IR_val_rs OP IR_val_rs      { $$ = (IR_stmt*)NEW(IR_op_stmt, $4, $1, $3, $5); }
             | IR_var ASSIGN IR_val_rs STAR IR_val_rs    { $$ = (IR_stmt*)NEW(IR_op_stmt, $4, $1, $3, $5); }
+            | IR_var ASSIGN IR_val_rs ADDR_OF IR_val_rs { $$ = (IR_stmt*)NEW(IR_op_stmt, $4, $1, $3, $5); }
             | GOTO IR_label                             { $$ = (IR_stmt*)NEW(IR_goto_stmt, $2); }
             | IF IR_val_rs RELOP IR_val_rs GOTO IR_label
                                                         { $$ = (IR_stmt*)NEW(IR_if_stmt, $3, $2, $4, $6, IR_LABEL_NONE); }
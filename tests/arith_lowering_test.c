@@ -0,0 +1,43 @@
+//
+// Created by Assistant
+// 乘除常量降级测试 (Arithmetic Lowering Test)
+//
+
+#include "test_util.h"
+#include <arith_lowering.h>
+
+#if !IR_OUT_EXTENDED_OPS
+#error "arith_lowering_test 需要以 -DIR_OUT_EXTENDED_OPS=1 编译"
+#endif
+
+static const int inputs[] = {-2147483647 - 1, 2147483647, -2147483647, -1, 0, 1, -7, 7, 640, -641,
+                             123456789, -123456789, -100, 99};
+
+static void lower(IR_function *func) {
+    perform_arith_lowering(func);
+}
+
+static void run_lowering(IR_program *program) {
+    test_run_function_pass(program, lower);
+}
+
+static unsigned count_ops(IR_function *func, IR_OP_TYPE op) {
+    unsigned cnt = 0;
+    for_list(IR_block_ptr, i, func->blocks)
+        for_list(IR_stmt_ptr, j, i->val->stmts)
+            if (j->val->stmt_type == IR_OP_STMT && ((IR_op_stmt*)j->val)->op == op) cnt++;
+    return cnt;
+}
+
+int main() {
+    // 包括 INT_MIN 被除数、负除数、魔数为负需要加回被除数的 7 与除以 ±(2^31 - 1);
+    // 余数的符号与被除数相同
+    IR_program *program = test_check_equivalence("tests/ir/div_const.ir", run_lowering,
+                                                 inputs, sizeof(inputs) / sizeof(inputs[0]), 1);
+    IR_function *func = test_find_function(program, "main");
+    CHECK(count_ops(func, IR_OP_DIV) == 0);
+    CHECK(count_ops(func, IR_OP_MOD) == 0);
+    CHECK(count_ops(func, IR_OP_MULH) == 11);
+    RDELETE(IR_program, ir_program_global);
+    return TEST_RESULT();
+}
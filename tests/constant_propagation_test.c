@@ -0,0 +1,41 @@
+//
+// Created by Assistant
+// 常量传播测试 (Constant Propagation Test)
+//
+
+#include "test_util.h"
+#include <constant_propagation.h>
+
+static const int inputs[] = {-5, 0, 3, 100};
+
+static void propagate_constants(IR_function *func) {
+    ConstantPropagation *constantPropagation = NEW(ConstantPropagation);
+    worklist_solver((DataflowAnalysis*)constantPropagation, func);
+    ConstantPropagation_constant_folding(constantPropagation, func);
+    DELETE(constantPropagation);
+}
+
+static void run_cp(IR_program *program) {
+    test_run_function_pass(program, propagate_constants);
+}
+
+static unsigned count_stmts(IR_function *func, IR_stmt_type type) {
+    unsigned cnt = 0;
+    for_list(IR_block_ptr, i, func->blocks)
+        for_list(IR_stmt_ptr, j, i->val->stmts)
+            if (j->val->stmt_type == type) cnt++;
+    return cnt;
+}
+
+int main() {
+    // 条件为常量的三个 IF 分别折叠为跳转与两次顺序执行, WRITE #111 与 never 块随之不可达并被删除;
+    // 循环条件依赖输入, 保留
+    IR_program *program = test_check_equivalence("tests/ir/constant_branch.ir", run_cp,
+                                                 inputs, sizeof(inputs) / sizeof(inputs[0]), 1);
+    IR_function *func = test_find_function(program, "main");
+    CHECK(count_stmts(func, IR_IF_STMT) == 1);
+    CHECK(count_stmts(func, IR_WRITE_STMT) == 2);
+    CHECK(count_stmts(func, IR_RETURN_STMT) == 1);
+    RDELETE(IR_program, ir_program_global);
+    return TEST_RESULT();
+}
@@ -0,0 +1,49 @@
+//
+// Created by Assistant
+// 复制合并测试 (Copy Coalescing Test)
+//
+
+#include "test_util.h"
+#include <copy_coalescing.h>
+
+// a, b
+static const int inputs[][2] = {{3, 4}, {4, 3}, {-5, 2}, {0, 0}, {6, -7}};
+
+// 与优化流程一致, 合并到不再有更新为止
+static void coalesce_copies(IR_function *func) {
+    while (true) {
+        CopyCoalescing copyCoalescing;
+        CopyCoalescing_init(&copyCoalescing, func);
+        bool updated = CopyCoalescing_coalesce(&copyCoalescing);
+        CopyCoalescing_teardown(&copyCoalescing);
+        if (!updated) break;
+    }
+}
+
+static void run_coalescing(IR_program *program) {
+    test_run_function_pass(program, coalesce_copies);
+}
+
+// 变量之间的复制语句数（不含常量赋值）
+static unsigned count_copies(IR_function *func) {
+    unsigned cnt = 0;
+    for_list(IR_block_ptr, i, func->blocks)
+        for_list(IR_stmt_ptr, j, i->val->stmts)
+            if (j->val->stmt_type == IR_ASSIGN_STMT && !((IR_assign_stmt*)j->val)->rs.is_const) cnt++;
+    return cnt;
+}
+
+int main() {
+    // chain 的复制链与 same_value 中值相同的两个复制都并入参数 a;
+    // swap_loop 中交换的三个变量同时活跃, overwritten 与 same_source 中 a 的复制在 a 被重新定义后仍活跃,
+    // 复制都保留
+    IR_program *program = test_check_equivalence("tests/ir/copy_coalescing.ir", run_coalescing,
+                                                 &inputs[0][0], sizeof(inputs) / sizeof(inputs[0]), 2);
+    CHECK(count_copies(test_find_function(program, "chain")) == 0);
+    CHECK(count_copies(test_find_function(program, "same_value")) == 0);
+    CHECK(count_copies(test_find_function(program, "swap_loop")) == 3);
+    CHECK(count_copies(test_find_function(program, "overwritten")) == 1);
+    CHECK(count_copies(test_find_function(program, "same_source")) == 3);
+    RDELETE(IR_program, ir_program_global);
+    return TEST_RESULT();
+}
@@ -0,0 +1,45 @@
+//
+// Created by Assistant
+// 激进死代码消除测试 (Aggressive Dead Code Elimination Test)
+//
+
+#include "test_util.h"
+#include <dead_code_elimination.h>
+
+// a, b
+static const int inputs[][2] = {{3, 4}, {4, 3}, {-5, 2}, {0, 0}, {6, -7}};
+
+static void eliminate_dead_code(IR_function *func) {
+    AggressiveDeadCodeElimination(func);
+}
+
+static void run_adce(IR_program *program) {
+    test_run_function_pass(program, eliminate_dead_code);
+}
+
+static unsigned count_stmts(IR_function *func, IR_stmt_type type) {
+    unsigned cnt = 0;
+    for_list(IR_block_ptr, i, func->blocks)
+        for_list(IR_stmt_ptr, j, i->val->stmts)
+            if (j->val->stmt_type == type) cnt++;
+    return cnt;
+}
+
+int main() {
+    // dead_cycle 中 k 只在循环中自我使用, 两条运算与初始化都被删除;
+    // dead_chain 只剩 x := a - b; stored 的值经 STORE 写入内存而保留, 未使用的 LOAD 被删除;
+    // any_live_use 的 x 与 y 各有一处活跃使用, 所有定义都保留（之后的 y := a * a 留给活跃变量分析删除）
+    IR_program *program = test_check_equivalence("tests/ir/dead_code.ir", run_adce,
+                                                 &inputs[0][0], sizeof(inputs) / sizeof(inputs[0]), 2);
+    IR_function *dead_cycle = test_find_function(program, "dead_cycle");
+    CHECK(count_stmts(dead_cycle, IR_OP_STMT) == 2);
+    CHECK(count_stmts(dead_cycle, IR_ASSIGN_STMT) == 2);
+    CHECK(count_stmts(test_find_function(program, "dead_chain"), IR_OP_STMT) == 1);
+    IR_function *stored = test_find_function(program, "stored");
+    CHECK(count_stmts(stored, IR_OP_STMT) == 4);
+    CHECK(count_stmts(stored, IR_STORE_STMT) == 2);
+    CHECK(count_stmts(stored, IR_LOAD_STMT) == 2);
+    CHECK(count_stmts(test_find_function(program, "any_live_use"), IR_OP_STMT) == 4);
+    RDELETE(IR_program, ir_program_global);
+    return TEST_RESULT();
+}
@@ -0,0 +1,36 @@
+//
+// Created by Assistant
+// 单次使用临时变量合并测试 (Single-Use Temporary Elimination Test)
+//
+
+#include "test_util.h"
+#include <IR_optimize.h>
+
+// a, b
+static const int inputs[][2] = {{3, 4}, {4, 3}, {-5, 2}, {0, 0}, {7, -7}};
+
+static void run_temp_elimination(IR_program *program) {
+    test_run_function_pass(program, eliminate_single_use_temps);
+}
+
+static unsigned count_stmts(IR_function *func, IR_stmt_type type) {
+    unsigned cnt = 0;
+    for_list(IR_block_ptr, i, func->blocks)
+        for_list(IR_stmt_ptr, j, i->val->stmts)
+            if (j->val->stmt_type == type) cnt++;
+    return cnt;
+}
+
+int main() {
+    // merged 的两个临时变量都只使用一次, 复制被合并; self_update 合并为 x := x * b;
+    // used_twice 与 used_on_branch 的临时变量还有其他使用, other_copy 复制的不是临时变量, 复制保留
+    IR_program *program = test_check_equivalence("tests/ir/single_use_temps.ir", run_temp_elimination,
+                                                 &inputs[0][0], sizeof(inputs) / sizeof(inputs[0]), 2);
+    CHECK(count_stmts(test_find_function(program, "merged"), IR_ASSIGN_STMT) == 0);
+    CHECK(count_stmts(test_find_function(program, "self_update"), IR_ASSIGN_STMT) == 1);
+    CHECK(count_stmts(test_find_function(program, "used_twice"), IR_ASSIGN_STMT) == 1);
+    CHECK(count_stmts(test_find_function(program, "used_on_branch"), IR_ASSIGN_STMT) == 1);
+    CHECK(count_stmts(test_find_function(program, "other_copy"), IR_ASSIGN_STMT) == 1);
+    RDELETE(IR_program, ir_program_global);
+    return TEST_RESULT();
+}
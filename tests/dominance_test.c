@@ -0,0 +1,234 @@
+//
+// Created by Assistant
+// 支配关系差分测试 (Dominance Differential Test)
+//
+
+#include "test_util.h"
+#include <dominance_analysis.h>
+
+static unsigned rand_state;
+
+static unsigned next_rand(void) {
+    rand_state = rand_state * 1103515245u + 12345u;
+    return rand_state >> 16;
+}
+
+/**
+ * @brief 按默认算法计算（后）支配关系，再与两种算法分别重新计算的结果比较。
+ * @return 可达块数。
+ */
+static unsigned check_engines_agree(IR_function *func, bool post_dominance, unsigned block_cnt, unsigned seed) {
+    DominanceAnalyzer dom;
+    if (post_dominance) DominanceAnalyzer_init_post(&dom, func);
+    else DominanceAnalyzer_init(&dom, func);
+    DominanceAnalyzer_compute_dominators(&dom);
+    if (!DominanceAnalyzer_verify(&dom)) {
+        fprintf(stderr, "%s: %u blocks, seed %u\n", post_dominance ? "post-dominance" : "dominance",
+                block_cnt, seed);
+        test_failures++;
+    }
+    unsigned reachable = dom.block_cnt;
+    DominanceAnalyzer_teardown(&dom);
+    return reachable;
+}
+
+/**
+ * @brief 从根出发沿（反向）CFG 的边遍历，不经过 removed（为 NULL 时不删除块），把到达的块加入 reached。
+ * 正向分析的根为入口；后支配分析沿前驱走，根为与虚拟出口相连的块（函数出口与无限循环中选出的块）。
+ */
+static void reach_avoiding(DominanceAnalyzer *dom, IR_block_ptr removed, Set_IR_block_ptr *reached) {
+    IR_function *func = dom->function;
+    Map_IR_block_ptr_List_ptr_IR_block_ptr *next_map = dom->post_dominance ? &func->blk_pred : &func->blk_succ;
+    unsigned n = 0;
+    for_list(IR_block_ptr, i, func->blocks) n++;
+    IR_block_ptr *worklist = (IR_block_ptr*)malloc(n * sizeof(IR_block_ptr));
+    unsigned top = 0;
+    for_list(IR_block_ptr, i, func->blocks) {
+        bool root = dom->post_dominance ? VCALL(dom->dom_info, get, i->val).linked_to_root : i->val == func->entry;
+        if (root && i->val != removed && VCALL(*reached, insert, i->val)) worklist[top++] = i->val;
+    }
+    while (top > 0) {
+        IR_block_ptr blk = worklist[--top];
+        for_list(IR_block_ptr, j, *VCALL(*next_map, get, blk))
+            if (j->val != removed && VCALL(*reached, insert, j->val)) worklist[top++] = j->val;
+    }
+    free(worklist);
+}
+
+/**
+ * @brief 遍历每个块的支配节点链，并检查支配树中的孩子集合：
+ * 链上恰为按定义支配该块的所有块，且依次为块自身与直接支配节点；每个块出现在其直接支配节点的孩子集合中。
+ * @param oracle oracle[a * n + b] 为按定义 A (后)支配 B，下标为 RPO 编号
+ * @return 不一致的次数。
+ */
+static unsigned check_tree_queries(DominanceAnalyzer *dom, const bool *oracle) {
+    unsigned n = dom->block_cnt, mismatches = 0, child_cnt = 0, tree_cnt = 0;
+    DominanceAnalyzer_build_dominator_tree(dom);
+    for (unsigned b = 0; b < n; b++) {
+        IR_block_ptr blk = dom->rpo_blocks[b];
+        if (!blk) continue;
+        unsigned expected = 0, visited = 0;
+        for (unsigned a = 0; a < n; a++) expected += oracle[a * n + b];
+        DominatorIterator it = DominanceAnalyzer_dominators_begin(dom, blk);
+        IR_block_ptr prev = NULL;
+        for (IR_block_ptr d; (d = DominatorIterator_next(&it)) != NULL; prev = d) {
+            int d_index = VCALL(dom->dom_info, get, d).rpo_index;
+            if (visited == 0 ? d != blk : d != DominanceAnalyzer_get_immediate_dominator(dom, prev)) mismatches++;
+            if (d_index < 0 || !oracle[d_index * n + b]) mismatches++;
+            visited++;
+        }
+        if (visited != expected) mismatches++;
+        IR_block_ptr idom = DominanceAnalyzer_get_immediate_dominator(dom, blk);
+        if (idom) {
+            tree_cnt++;
+            if (!VCALL(*DominanceAnalyzer_get_dominated_blocks(dom, idom), exist, blk)) mismatches++;
+        }
+        for_set(IR_block_ptr, c, *DominanceAnalyzer_get_dominated_blocks(dom, blk)) child_cnt++;
+    }
+    return mismatches + (child_cnt != tree_cnt);
+}
+
+/**
+ * @brief 比较结果链表与期望的块集合 expected（以 RPO 编号为下标）：不重复、按 RPO 升序、元素恰好相同。
+ * @return 不一致的次数。
+ */
+static unsigned compare_block_list(DominanceAnalyzer *dom, List_IR_block_ptr *list, const bool *expected) {
+    unsigned n = dom->block_cnt, mismatches = 0, expected_cnt = 0, listed = 0;
+    int last = -1;
+    for (unsigned b = 0; b < n; b++) expected_cnt += expected[b];
+    for_list(IR_block_ptr, i, *list) {
+        int index = VCALL(dom->dom_info, get, i->val).rpo_index;
+        if (index <= last || !expected[index]) mismatches++;
+        last = index;
+        listed++;
+    }
+    return mismatches + (listed != expected_cnt);
+}
+
+/**
+ * @brief 按定义检查支配边界与迭代支配边界：
+ * B 属于 DF(A) 当且仅当 A 支配 B 在（反向）CFG 中的某个前驱且不严格支配 B；
+ * DF+(S) 为从 DF(S) 出发反复并入其中各块的支配边界得到的不动点。S 取若干随机块集合。
+ * @return 不一致的次数。
+ */
+static unsigned check_frontiers(DominanceAnalyzer *dom, const bool *oracle, unsigned seed) {
+    IR_function *func = dom->function;
+    Map_IR_block_ptr_List_ptr_IR_block_ptr *pred_map = dom->post_dominance ? &func->blk_succ : &func->blk_pred;
+    unsigned n = dom->block_cnt, mismatches = 0;
+    bool *frontier = (bool*)calloc(n * n, sizeof(bool)); // frontier[a * n + b]: B 属于 DF(A)
+    for (unsigned b = 0; b < n; b++) {
+        IR_block_ptr blk = dom->rpo_blocks[b];
+        if (!blk) continue;
+        for_list(IR_block_ptr, p, *VCALL(*pred_map, get, blk)) {
+            int p_index = VCALL(dom->dom_info, get, p->val).rpo_index;
+            if (p_index < 0) continue;
+            for (unsigned a = 0; a < n; a++)
+                if (oracle[a * n + p_index] && (a == b || !oracle[a * n + b])) frontier[a * n + b] = true;
+        }
+    }
+    DominanceAnalyzer_compute_frontiers(dom);
+    for (unsigned a = 0; a < n; a++) {
+        if (!dom->rpo_blocks[a]) continue;
+        List_IR_block_ptr list;
+        List_IR_block_ptr_init(&list);
+        DominanceAnalyzer_get_frontier(dom, dom->rpo_blocks[a], &list);
+        mismatches += compare_block_list(dom, &list, &frontier[a * n]);
+        List_IR_block_ptr_teardown(&list);
+    }
+
+    rand_state = seed;
+    bool *expected = (bool*)malloc(n * sizeof(bool));
+    for (unsigned round = 0; round < 8; round++) {
+        Set_IR_block_ptr def_blocks;
+        Set_IR_block_ptr_init(&def_blocks);
+        for (unsigned b = 0; b < n; b++) {
+            expected[b] = false;
+            if (dom->rpo_blocks[b] && next_rand() % 8 == 0) VCALL(def_blocks, insert, dom->rpo_blocks[b]);
+        }
+        for (bool changed = true; changed;) {
+            changed = false;
+            for (unsigned a = 0; a < n; a++) {
+                if (!dom->rpo_blocks[a] || !(expected[a] || VCALL(def_blocks, exist, dom->rpo_blocks[a]))) continue;
+                for (unsigned b = 0; b < n; b++)
+                    if (frontier[a * n + b] && !expected[b]) expected[b] = changed = true;
+            }
+        }
+        List_IR_block_ptr list;
+        List_IR_block_ptr_init(&list);
+        DominanceAnalyzer_iterated_frontier(dom, &def_blocks, &list);
+        mismatches += compare_block_list(dom, &list, expected);
+        List_IR_block_ptr_teardown(&list);
+        Set_IR_block_ptr_teardown(&def_blocks);
+    }
+    free(expected);
+    free(frontier);
+    return mismatches;
+}
+
+/**
+ * @brief 与按定义计算的结果比较：A (后)支配 B 当且仅当删去 A 后从根无法到达 B。
+ * 分析器中的可达块也应恰为从根可达的块，支配节点链、支配树与（迭代）支配边界也与定义一致。
+ */
+static void check_against_oracle(IR_function *func, bool post_dominance, unsigned block_cnt, unsigned seed) {
+    DominanceAnalyzer dom;
+    if (post_dominance) DominanceAnalyzer_init_post(&dom, func);
+    else DominanceAnalyzer_init(&dom, func);
+    DominanceAnalyzer_compute_dominators(&dom);
+    Set_IR_block_ptr reachable;
+    Set_IR_block_ptr_init(&reachable);
+    reach_avoiding(&dom, NULL, &reachable);
+    unsigned mismatches = 0, n = dom.block_cnt;
+    bool *oracle = (bool*)calloc(n * n, sizeof(bool));
+    for_list(IR_block_ptr, i, func->blocks)
+        if ((VCALL(dom.dom_info, get, i->val).rpo_index >= 0) != VCALL(reachable, exist, i->val)) mismatches++;
+    for_set(IR_block_ptr, a, reachable) {
+        Set_IR_block_ptr reached;
+        Set_IR_block_ptr_init(&reached);
+        reach_avoiding(&dom, a->key, &reached);
+        int a_index = VCALL(dom.dom_info, get, a->key).rpo_index;
+        for_set(IR_block_ptr, b, reachable) {
+            bool dominates = b->key == a->key || !VCALL(reached, exist, b->key);
+            int b_index = VCALL(dom.dom_info, get, b->key).rpo_index;
+            if (a_index >= 0 && b_index >= 0) oracle[a_index * n + b_index] = dominates;
+            if (b->key != a->key && DominanceAnalyzer_dominates(&dom, a->key, b->key) != dominates)
+                mismatches++;
+        }
+        Set_IR_block_ptr_teardown(&reached);
+    }
+    if (mismatches == 0) mismatches = check_tree_queries(&dom, oracle);
+    if (mismatches == 0) mismatches = check_frontiers(&dom, oracle, seed);
+    if (mismatches) {
+        fprintf(stderr, "%s differs from oracle at %u pairs: %u blocks, seed %u\n",
+                post_dominance ? "post-dominance" : "dominance", mismatches, block_cnt, seed);
+        test_failures++;
+    }
+    free(oracle);
+    Set_IR_block_ptr_teardown(&reachable);
+    DominanceAnalyzer_teardown(&dom);
+}
+
+int main() {
+    // 超过 DOMINANCE_SEMI_NCA_THRESHOLD 的函数默认使用 Semi-NCA, 较小的使用迭代算法
+    const unsigned sizes[] = {64, 900, DOMINANCE_SEMI_NCA_THRESHOLD + 1, 3000, 8000};
+    IR_program *program = NEW(IR_program);
+    unsigned max_reachable = 0;
+    for (unsigned i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+        for (unsigned seed = 1; seed <= 4; seed++) {
+            IR_function *func = test_random_function(sizes[i], seed * 7919u + i);
+            VCALL(program->functions, push_back, func);
+            unsigned reachable = check_engines_agree(func, false, sizes[i], seed);
+            if (reachable > max_reachable) max_reachable = reachable;
+            check_engines_agree(func, true, sizes[i], seed);
+        }
+    CHECK(max_reachable >= DOMINANCE_SEMI_NCA_THRESHOLD);
+    // 按定义逐对检查的代价为平方级, 只用较小的函数
+    for (unsigned block_cnt = 8; block_cnt <= 256; block_cnt *= 2)
+        for (unsigned seed = 1; seed <= 8; seed++) {
+            IR_function *func = test_random_function(block_cnt, seed * 104729u + block_cnt);
+            VCALL(program->functions, push_back, func);
+            check_against_oracle(func, false, block_cnt, seed);
+            check_against_oracle(func, true, block_cnt, seed);
+        }
+    RDELETE(IR_program, program);
+    return TEST_RESULT();
+}
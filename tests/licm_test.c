@@ -0,0 +1,45 @@
+//
+// Created by Assistant
+// 循环不变代码外提测试 (LICM Test)
+//
+
+#include "test_util.h"
+#include <licm.h>
+
+#define FUNC_CNT 6
+
+// n, a, b: 第二组循环不执行且 b 为 0, 外提除法会引入除零
+static const int inputs[][3] = {{4, 7, 2}, {0, 5, 0}, {1, -4, 3}, {3, 2147483647, -1}, {6, -9, 4}};
+
+static const char *func_names[FUNC_CNT] = {"hoist", "multi_def", "use_before_def", "use_not_dominated",
+                                          "live_out", "trapping_div"};
+
+static bool licm(IR_function *func, DominanceAnalyzer *dom_analyzer, LoopAnalyzer *loop_analyzer) {
+    LICMAnalyzer licm_analyzer;
+    LICMAnalyzer_init(&licm_analyzer, func, loop_analyzer, dom_analyzer);
+    bool changed = LICMAnalyzer_optimize(&licm_analyzer);
+    LICMAnalyzer_teardown(&licm_analyzer);
+    return changed;
+}
+
+static void run_licm(IR_program *program) {
+    test_run_loop_pass(program, licm);
+}
+
+int main() {
+    unsigned weight_before[FUNC_CNT];
+    IR_program *program = test_parse("tests/ir/licm.ir");
+    for (unsigned k = 0; k < FUNC_CNT; k++)
+        weight_before[k] = test_loop_weight(test_find_function(program, func_names[k]));
+
+    // 只有 hoist 中的乘法与除以常量可以外提（从内层一直外提到外层之外）;
+    // 其余函数分别是: 变量在循环中有两处定义, 同一块中的使用在定义之前, 另一块中的使用不被定义支配,
+    // 值在不被定义支配的出口之后被使用, 以及除数可能为零的除法
+    program = test_check_equivalence("tests/ir/licm.ir", run_licm,
+                                     &inputs[0][0], sizeof(inputs) / sizeof(inputs[0]), 3);
+    CHECK(test_loop_weight(test_find_function(program, "hoist")) == weight_before[0] - 4);
+    for (unsigned k = 1; k < FUNC_CNT; k++)
+        CHECK(test_loop_weight(test_find_function(program, func_names[k])) == weight_before[k]);
+    RDELETE(IR_program, ir_program_global);
+    return TEST_RESULT();
+}
@@ -0,0 +1,96 @@
+//
+// Created by Assistant
+// 活跃变量分析测试 (Live Variable Analysis Test)
+//
+
+#include "test_util.h"
+#include <live_variable_analysis.h>
+
+// a, b
+static const int inputs[][2] = {{3, 4}, {4, 3}, {-5, 2}, {0, 0}, {6, -7}};
+
+static bool same_set(Set_IR_var *a, Set_IR_var *b) {
+    unsigned a_cnt = 0, b_cnt = 0;
+    for_set(IR_var, i, *a) {
+        if (!VCALL(*b, exist, i->key)) return false;
+        a_cnt++;
+    }
+    for_set(IR_var, i, *b) b_cnt++;
+    return a_cnt == b_cnt;
+}
+
+/**
+ * @brief 检查求解结果满足逐语句定义的数据流方程：
+ * OUT[B] 为各后继 IN 的并，IN[B] 为从 OUT[B] 出发逆序对每条语句执行传递函数的结果。
+ * 块的传递函数使用预先计算的 UEVar/VarKill 摘要，与逐语句模拟应一致。
+ */
+static void check_equations(IR_function *func) {
+    LiveVariableAnalysis *liveVariableAnalysis = NEW(LiveVariableAnalysis);
+    worklist_solver((DataflowAnalysis*)liveVariableAnalysis, func);
+    for_list(IR_block_ptr, i, func->blocks) {
+        IR_block *blk = i->val;
+        Set_IR_var *in_fact = VCALL(*liveVariableAnalysis, getInFact, blk);
+        Set_IR_var *out_fact = VCALL(*liveVariableAnalysis, getOutFact, blk);
+        Set_IR_var expected_out, expected_in;
+        Set_IR_var_init(&expected_out);
+        for_list(IR_block_ptr, j, *VCALL(func->blk_succ, get, blk)) {
+            Set_IR_var *succ_in = VCALL(*liveVariableAnalysis, getInFact, j->val);
+            VCALL(expected_out, union_with, succ_in);
+        }
+        Set_IR_var_init(&expected_in);
+        VCALL(expected_in, union_with, out_fact);
+        rfor_list(IR_stmt_ptr, j, blk->stmts)
+            LiveVariableAnalysis_transferStmt(liveVariableAnalysis, j->val, &expected_in);
+        if (blk != func->exit && !same_set(&expected_out, out_fact)) {
+            fprintf(stderr, "%s: OUT of block L%u differs from the union of its successors\n",
+                    func->func_name, blk->label);
+            test_failures++;
+        }
+        if (!same_set(&expected_in, in_fact)) {
+            fprintf(stderr, "%s: IN of block L%u differs from the statement-wise transfer\n",
+                    func->func_name, blk->label);
+            test_failures++;
+        }
+        Set_IR_var_teardown(&expected_in);
+        Set_IR_var_teardown(&expected_out);
+    }
+    DELETE(liveVariableAnalysis);
+}
+
+// 与优化流程一致, 删除死定义直到不再有更新
+static void remove_dead_defs(IR_function *func) {
+    while (true) {
+        LiveVariableAnalysis *liveVariableAnalysis = NEW(LiveVariableAnalysis);
+        worklist_solver((DataflowAnalysis*)liveVariableAnalysis, func);
+        bool updated = LiveVariableAnalysis_remove_dead_def(liveVariableAnalysis, func);
+        DELETE(liveVariableAnalysis);
+        if (!updated) break;
+    }
+}
+
+static void run_dead_def_removal(IR_program *program) {
+    test_run_function_pass(program, check_equations);
+    test_run_function_pass(program, remove_dead_defs);
+}
+
+static unsigned count_stmts(IR_function *func, IR_stmt_type type) {
+    unsigned cnt = 0;
+    for_list(IR_block_ptr, i, func->blocks)
+        for_list(IR_stmt_ptr, j, i->val->stmts)
+            if (j->val->stmt_type == type) cnt++;
+    return cnt;
+}
+
+int main() {
+    // overwritten 中被覆盖的 x := a * b 与成串的死定义 t、u 都被删除;
+    // loop_carried 中的 d 被删除, 但 p 在循环中自我使用, 对活跃变量分析而言仍活跃;
+    // branch_live 中 y 的初值只在一条分支上活跃, 保留
+    IR_program *program = test_check_equivalence("tests/ir/liveness.ir", run_dead_def_removal,
+                                                 &inputs[0][0], sizeof(inputs) / sizeof(inputs[0]), 2);
+    CHECK(count_stmts(test_find_function(program, "overwritten"), IR_OP_STMT) == 1);
+    CHECK(count_stmts(test_find_function(program, "loop_carried"), IR_OP_STMT) == 3);
+    CHECK(count_stmts(test_find_function(program, "branch_live"), IR_OP_STMT) == 3);
+    test_run_function_pass(program, check_equations);
+    RDELETE(IR_program, ir_program_global);
+    return TEST_RESULT();
+}
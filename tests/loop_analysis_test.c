@@ -0,0 +1,125 @@
+//
+// Created by Assistant
+// 循环嵌套森林差分测试 (Loop Nesting Forest Differential Test)
+//
+
+#include "test_util.h"
+#include <dominance_analysis.h>
+
+/**
+ * @brief 按定义求以 header 为头的自然循环：header 加上不经过 header 就能（沿前驱）到达某个回边源的可达块，
+ * 回边源为 header 的前驱中被 header 支配的块。
+ * @return 回边数，为 0 时 header 不是自然循环的头。
+ */
+static unsigned natural_loop(DominanceAnalyzer *dom, IR_block_ptr header, Set_IR_block_ptr *blocks) {
+    IR_function *func = dom->function;
+    unsigned n = 0, back_edge_cnt = 0, top = 0;
+    for_list(IR_block_ptr, i, func->blocks) n++;
+    IR_block_ptr *worklist = (IR_block_ptr*)malloc(n * sizeof(IR_block_ptr));
+    VCALL(*blocks, insert, header);
+    for_list(IR_block_ptr, i, *VCALL(func->blk_pred, get, header))
+        if (DominanceAnalyzer_dominates(dom, header, i->val)) {
+            back_edge_cnt++;
+            if (VCALL(*blocks, insert, i->val)) worklist[top++] = i->val;
+        }
+    while (top > 0) {
+        IR_block_ptr blk = worklist[--top];
+        for_list(IR_block_ptr, i, *VCALL(func->blk_pred, get, blk))
+            if (VCALL(dom->dom_info, get, i->val).rpo_index >= 0 && VCALL(*blocks, insert, i->val))
+                worklist[top++] = i->val;
+    }
+    free(worklist);
+    return back_edge_cnt;
+}
+
+static bool same_blocks(Set_IR_block_ptr *a, Set_IR_block_ptr *b) {
+    unsigned a_cnt = 0, b_cnt = 0;
+    for_set(IR_block_ptr, i, *a) {
+        if (!VCALL(*b, exist, i->key)) return false;
+        a_cnt++;
+    }
+    for_set(IR_block_ptr, i, *b) b_cnt++;
+    return a_cnt == b_cnt;
+}
+
+/**
+ * @brief 与按定义计算的结果比较：
+ * 每个自然循环的头都是某个循环的头；可约循环的块恰为其自然循环，不可约循环中有头不支配的块；
+ * 循环嵌套在父循环之内且深度逐层加一，每个块的最内层循环包含它，且更内层的循环都不包含它。
+ * @return 是否含有不可约循环。
+ */
+static bool check_against_oracle(IR_function *func, unsigned block_cnt, unsigned seed) {
+    DominanceAnalyzer dom;
+    LoopAnalyzer loops;
+    DominanceAnalyzer_init(&dom, func);
+    DominanceAnalyzer_compute_dominators(&dom);
+    LoopAnalyzer_init(&loops, func, &dom);
+    LoopAnalyzer_detect_loops(&loops);
+    LoopAnalyzer_build_loop_hierarchy(&loops);
+    unsigned mismatches = 0;
+    bool irreducible = false;
+
+    Map_IR_block_ptr_Loop_ptr by_header;
+    Map_IR_block_ptr_Loop_ptr_init(&by_header);
+    for_list(Loop_ptr, i, loops.all_loops) {
+        Loop_ptr loop = i->val;
+        if (!VCALL(by_header, insert, loop->header, loop)) mismatches++; // 每个头只对应一个循环
+        Set_IR_block_ptr natural;
+        Set_IR_block_ptr_init(&natural);
+        unsigned back_edge_cnt = natural_loop(&dom, loop->header, &natural);
+        if (loop->is_reducible) {
+            if (back_edge_cnt == 0 || !same_blocks(&natural, &loop->blocks)) mismatches++;
+        } else {
+            irreducible = true;
+            bool dominated = true;
+            for_set(IR_block_ptr, j, loop->blocks)
+                if (!DominanceAnalyzer_dominates(&dom, loop->header, j->key)) dominated = false;
+            if (dominated) mismatches++;
+        }
+        Set_IR_block_ptr_teardown(&natural);
+        Loop_ptr parent = loop->parent_loop;
+        if (parent) {
+            if (loop->depth != parent->depth + 1) mismatches++;
+            for_set(IR_block_ptr, j, loop->blocks)
+                if (!Loop_contains_block(parent, j->key)) mismatches++;
+        } else if (loop->depth != 1) mismatches++;
+    }
+    for_list(IR_block_ptr, i, func->blocks) {
+        IR_block_ptr blk = i->val;
+        if (VCALL(dom.dom_info, get, blk).rpo_index < 0) continue;
+        Set_IR_block_ptr natural;
+        Set_IR_block_ptr_init(&natural);
+        if (natural_loop(&dom, blk, &natural) > 0 && !VCALL(by_header, exist, blk)) mismatches++;
+        Set_IR_block_ptr_teardown(&natural);
+        Loop_ptr innermost = LoopAnalyzer_get_innermost_loop(&loops, blk);
+        for_list(Loop_ptr, j, loops.all_loops) {
+            bool contains = Loop_contains_block(j->val, blk);
+            bool expected = innermost && (j->val == innermost || Loop_is_nested_in(innermost, j->val));
+            if (contains != expected) mismatches++;
+        }
+    }
+    if (mismatches) {
+        fprintf(stderr, "loop forest differs from oracle at %u places: %u blocks, seed %u\n",
+                mismatches, block_cnt, seed);
+        test_failures++;
+    }
+    Map_IR_block_ptr_Loop_ptr_teardown(&by_header);
+    LoopAnalyzer_teardown(&loops);
+    DominanceAnalyzer_teardown(&dom);
+    return irreducible;
+}
+
+int main() {
+    IR_program *program = NEW(IR_program);
+    unsigned irreducible_cnt = 0;
+    for (unsigned block_cnt = 8; block_cnt <= 256; block_cnt *= 2)
+        for (unsigned seed = 1; seed <= 8; seed++) {
+            IR_function *func = test_random_function(block_cnt, seed * 7877u + block_cnt);
+            VCALL(program->functions, push_back, func);
+            irreducible_cnt += check_against_oracle(func, block_cnt, seed);
+        }
+    // 随机 CFG 中应有不可约区域, 否则上面没有覆盖到不可约的情形
+    CHECK(irreducible_cnt > 0);
+    RDELETE(IR_program, program);
+    return TEST_RESULT();
+}
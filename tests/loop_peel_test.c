@@ -0,0 +1,65 @@
+//
+// Created by Assistant
+// 循环剥离测试 (Loop Peeling Test)
+//
+
+#include "test_util.h"
+#include <loop_peel.h>
+#include <constant_propagation.h>
+
+static const int inputs[] = {-3, 0, 1, 2, 7, 40};
+
+// 与优化流程一致, 剥离出的迭代由之后的常量传播化简
+static void propagate_constants(IR_function *func) {
+    ConstantPropagation *constantPropagation = NEW(ConstantPropagation);
+    worklist_solver((DataflowAnalysis*)constantPropagation, func);
+    ConstantPropagation_constant_folding(constantPropagation, func);
+    DELETE(constantPropagation);
+}
+
+static void run_peeling(IR_program *program) {
+    test_run_loop_pass(program, perform_loop_peeling);
+    test_run_function_pass(program, propagate_constants);
+}
+
+static unsigned count_stmts(IR_function *func, IR_stmt_type type) {
+    unsigned cnt = 0;
+    for_list(IR_block_ptr, i, func->blocks)
+        for_list(IR_stmt_ptr, j, i->val->stmts)
+            if (j->val->stmt_type == type) cnt++;
+    return cnt;
+}
+
+static unsigned count_all_stmts(IR_function *func) {
+    unsigned cnt = 0;
+    for_list(IR_block_ptr, i, func->blocks)
+        for_list(IR_stmt_ptr, j, i->val->stmts) cnt++;
+    return cnt;
+}
+
+// 循环外的语句数（fixture 中没有嵌套循环, 循环内每条语句在 test_loop_weight 中计 1）
+static unsigned count_stmts_outside_loops(IR_function *func) {
+    return count_all_stmts(func) - test_loop_weight(func);
+}
+
+int main() {
+    // 两个函数的退出条件都只由汇合变量决定: 剥离出的迭代中条件为常量, IF 被折叠,
+    // 每个函数只剩循环中的一个 IF; prev2 在 prev 之后一次迭代才不是常量, 需要剥离两次。
+    // 剥离的每份迭代在循环外留下循环体中的运算语句 (3 条与 4 条)
+    const char *func_names[2] = {"peel_once", "peel_twice"};
+    const unsigned copied_ops[2] = {3, 2 * 4};
+    unsigned outside_before[2];
+    IR_program *program = test_parse("tests/ir/loop_peel.ir");
+    for (unsigned k = 0; k < 2; k++)
+        outside_before[k] = count_stmts_outside_loops(test_find_function(program, func_names[k]));
+    program = test_check_equivalence("tests/ir/loop_peel.ir", run_peeling,
+                                     inputs, sizeof(inputs) / sizeof(inputs[0]), 1);
+    for (unsigned k = 0; k < 2; k++) {
+        IR_function *func = test_find_function(program, func_names[k]);
+        CHECK(count_stmts(func, IR_IF_STMT) == 1);
+        CHECK(test_count_loops(func) == 1);
+        CHECK(count_stmts_outside_loops(func) >= outside_before[k] + copied_ops[k]);
+    }
+    RDELETE(IR_program, ir_program_global);
+    return TEST_RESULT();
+}
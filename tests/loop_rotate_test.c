@@ -0,0 +1,82 @@
+//
+// Created by Assistant
+// 循环旋转测试 (Loop Rotation Test)
+//
+
+#include "test_util.h"
+#include <loop_rotate.h>
+
+static const int inputs[] = {-2, 0, 1, 2, 5, 12};
+
+static void run_rotation(IR_program *program) {
+    test_run_loop_pass(program, perform_loop_rotation);
+}
+
+static unsigned count_stmts(IR_function *func, IR_stmt_type type) {
+    unsigned cnt = 0;
+    for_list(IR_block_ptr, i, func->blocks)
+        for_list(IR_stmt_ptr, j, i->val->stmts)
+            if (j->val->stmt_type == type) cnt++;
+    return cnt;
+}
+
+static unsigned count_all_stmts(IR_function *func) {
+    unsigned cnt = 0;
+    for_list(IR_block_ptr, i, func->blocks)
+        for_list(IR_stmt_ptr, j, i->val->stmts) cnt++;
+    return cnt;
+}
+
+static bool is_latch(Loop_ptr loop, IR_block *blk) {
+    for_list(IR_block_ptr, i, loop->back_edges_sources)
+        if (i->val == blk) return true;
+    return false;
+}
+
+// 有回边源以外的块离开循环（顶部判断）的循环数; 重新解析后单块循环的循环头同时是回边源
+static unsigned count_top_tested_loops(IR_function *func) {
+    DominanceAnalyzer dom;
+    LoopAnalyzer loops;
+    DominanceAnalyzer_init(&dom, func);
+    DominanceAnalyzer_compute_dominators(&dom);
+    LoopAnalyzer_init(&loops, func, &dom);
+    LoopAnalyzer_detect_loops(&loops);
+    unsigned cnt = 0;
+    for_list(Loop_ptr, i, loops.all_loops)
+        for_list(IR_block_ptr, j, i->val->exit_blocks)
+            if (!is_latch(i->val, j->val)) {
+                cnt++;
+                break;
+            }
+    LoopAnalyzer_teardown(&loops);
+    DominanceAnalyzer_teardown(&dom);
+    return cnt;
+}
+
+int main() {
+    // guarded 与 nested 的循环旋转为守卫 + 底部判断; counted 第一次判断必然进入循环, 不生成守卫;
+    // big_header 的循环头超过阈值, bottom_tested 本就是底部判断, two_exits 的回边源已是退出块, 都不被修改
+    IR_program *program = test_parse("tests/ir/loop_rotate.ir");
+    unsigned big_size = count_all_stmts(test_find_function(program, "big_header"));
+    unsigned bottom_size = count_all_stmts(test_find_function(program, "bottom_tested"));
+    unsigned two_exits_size = count_all_stmts(test_find_function(program, "two_exits"));
+    program = test_check_equivalence("tests/ir/loop_rotate.ir", run_rotation,
+                                     inputs, sizeof(inputs) / sizeof(inputs[0]), 1);
+    IR_function *guarded = test_find_function(program, "guarded");
+    CHECK(test_count_loops(guarded) == 1);
+    CHECK(count_top_tested_loops(guarded) == 0);
+    CHECK(count_stmts(guarded, IR_IF_STMT) == 2);
+    IR_function *counted = test_find_function(program, "counted");
+    CHECK(test_count_loops(counted) == 1);
+    CHECK(count_top_tested_loops(counted) == 0);
+    CHECK(count_stmts(counted, IR_IF_STMT) == 1);
+    IR_function *nested = test_find_function(program, "nested");
+    CHECK(test_count_loops(nested) == 2);
+    CHECK(count_top_tested_loops(nested) == 0);
+    CHECK(count_all_stmts(test_find_function(program, "big_header")) == big_size);
+    CHECK(count_top_tested_loops(test_find_function(program, "big_header")) == 1);
+    CHECK(count_all_stmts(test_find_function(program, "bottom_tested")) == bottom_size);
+    CHECK(count_all_stmts(test_find_function(program, "two_exits")) == two_exits_size);
+    RDELETE(IR_program, ir_program_global);
+    return TEST_RESULT();
+}
@@ -0,0 +1,33 @@
+//
+// Created by Assistant
+// 循环展开测试 (Loop Unrolling Test)
+//
+
+#include "test_util.h"
+#include <loop_unroll.h>
+
+#define STEP_LIMIT 100000
+
+/**
+ * @brief 展开前后执行结果相同，并检查展开后剩下的循环个数。
+ */
+static void check_unroll(const char *path, unsigned loops_after) {
+    IR_program *program = test_parse(path);
+    IR_exec before = {.step_limit = STEP_LIMIT}, after = {.step_limit = STEP_LIMIT};
+    IR_exec_status status_before = IR_exec_program(program, &before);
+    test_run_loop_pass(program, perform_loop_unrolling);
+    IR_exec_status status_after = IR_exec_program(program, &after);
+    if (!IR_exec_same(status_before, &before, status_after, &after)) {
+        fprintf(stderr, "%s: behavior changed by loop unrolling\n", path);
+        test_failures++;
+    }
+    CHECK(test_count_loops(test_find_function(program, "main")) == loops_after);
+}
+
+int main() {
+    // IV 回绕, 循环不终止, 不能完全展开
+    check_unroll("tests/ir/loop_wrap_write.ir", 1);
+    check_unroll("tests/ir/loop_unroll.ir", 0);
+    RDELETE(IR_program, ir_program_global);
+    return TEST_RESULT();
+}
@@ -0,0 +1,36 @@
+//
+// Created by Assistant
+// 循环条件外提测试 (Loop Unswitching Test)
+//
+
+#include "test_util.h"
+#include <loop_unswitch.h>
+
+// n, flag
+static const int inputs[][2] = {{5, 1}, {5, 0}, {0, 1}, {7, -3}, {6, 3}, {4, 2}};
+
+static void run_unswitching(IR_program *program) {
+    test_run_loop_pass(program, perform_loop_unswitching);
+}
+
+static unsigned count_all_stmts(IR_function *func) {
+    unsigned cnt = 0;
+    for_list(IR_block_ptr, i, func->blocks)
+        for_list(IR_stmt_ptr, j, i->val->stmts) cnt++;
+    return cnt;
+}
+
+int main() {
+    // 只有 invariant_cond 的条件在循环中不变且两个目标都在循环内, 外提后得到两个循环;
+    // variant_cond 的条件变量在循环中被修改, exit_cond 的条件跳出循环, 都不被复制
+    IR_program *program = test_parse("tests/ir/loop_unswitch.ir");
+    unsigned variant_size = count_all_stmts(test_find_function(program, "variant_cond"));
+    unsigned exit_size = count_all_stmts(test_find_function(program, "exit_cond"));
+    program = test_check_equivalence("tests/ir/loop_unswitch.ir", run_unswitching,
+                                     &inputs[0][0], sizeof(inputs) / sizeof(inputs[0]), 2);
+    CHECK(test_count_loops(test_find_function(program, "invariant_cond")) == 2);
+    CHECK(count_all_stmts(test_find_function(program, "variant_cond")) == variant_size);
+    CHECK(count_all_stmts(test_find_function(program, "exit_cond")) == exit_size);
+    RDELETE(IR_program, ir_program_global);
+    return TEST_RESULT();
+}
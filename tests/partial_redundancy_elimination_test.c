@@ -0,0 +1,82 @@
+//
+// Created by Assistant
+// 部分冗余消除测试 (Partial Redundancy Elimination Test)
+//
+
+#include "test_util.h"
+#include <partial_redundancy_elimination.h>
+
+// c, a, b
+static const int inputs[][3] = {{1, 3, 4}, {0, 3, 4}, {-1, -5, 7}, {5, -7, 3}, {0, 2, 0}, {3, 2, 0}};
+
+static void eliminate_partial_redundancy(IR_function *func) {
+    PartialRedundancyElimination pre;
+    PartialRedundancyElimination_init(&pre, func);
+    PartialRedundancyElimination_lazy_code_motion(&pre);
+    PartialRedundancyElimination_teardown(&pre);
+}
+
+static void run_pre(IR_program *program) {
+    test_run_function_pass(program, eliminate_partial_redundancy);
+}
+
+static unsigned count_ops(IR_function *func, IR_OP_TYPE op) {
+    unsigned cnt = 0;
+    for_list(IR_block_ptr, i, func->blocks)
+        for_list(IR_stmt_ptr, j, i->val->stmts)
+            if (j->val->stmt_type == IR_OP_STMT && ((IR_op_stmt*)j->val)->op == op) cnt++;
+    return cnt;
+}
+
+// 以 RETURN 结尾的块中运算符为 op 的语句数
+static unsigned count_ops_before_return(IR_function *func, IR_OP_TYPE op) {
+    unsigned cnt = 0;
+    for_list(IR_block_ptr, i, func->blocks) {
+        IR_block *blk = i->val;
+        if (!blk->stmts.tail || blk->stmts.tail->val->stmt_type != IR_RETURN_STMT) continue;
+        for_list(IR_stmt_ptr, j, blk->stmts)
+            if (j->val->stmt_type == IR_OP_STMT && ((IR_op_stmt*)j->val)->op == op) cnt++;
+    }
+    return cnt;
+}
+
+// 循环内（含内层循环）运算符为 op 的语句数
+static unsigned count_ops_in_loops(IR_function *func, IR_OP_TYPE op) {
+    DominanceAnalyzer dom;
+    LoopAnalyzer loops;
+    DominanceAnalyzer_init(&dom, func);
+    DominanceAnalyzer_compute_dominators(&dom);
+    LoopAnalyzer_init(&loops, func, &dom);
+    LoopAnalyzer_detect_loops(&loops);
+    LoopAnalyzer_build_loop_hierarchy(&loops);
+    unsigned cnt = 0;
+    for_list(IR_block_ptr, i, func->blocks) {
+        if (!LoopAnalyzer_get_innermost_loop(&loops, i->val)) continue;
+        for_list(IR_stmt_ptr, j, i->val->stmts)
+            if (j->val->stmt_type == IR_OP_STMT && ((IR_op_stmt*)j->val)->op == op) cnt++;
+    }
+    LoopAnalyzer_teardown(&loops);
+    DominanceAnalyzer_teardown(&dom);
+    return cnt;
+}
+
+int main() {
+    // full 的汇合点完全冗余, partial 在 c > 0 的路径上插入计算后汇合点的计算被删除;
+    // invariant 的 do-while 循环体必然执行, a * b 移到循环之前;
+    // guarded_div 的循环可能一次也不执行, 外提 a / b 不是向下安全的, 留在循环内;
+    // spin 的一个分支是无法到达出口的死循环, a / b 不能提到分支之前
+    IR_program *program = test_check_equivalence("tests/ir/partial_redundancy.ir", run_pre,
+                                                 &inputs[0][0], sizeof(inputs) / sizeof(inputs[0]), 3);
+    IR_function *full = test_find_function(program, "full");
+    CHECK(count_ops(full, IR_OP_MUL) == 2);
+    CHECK(count_ops_before_return(full, IR_OP_MUL) == 0);
+    IR_function *partial = test_find_function(program, "partial");
+    CHECK(count_ops(partial, IR_OP_MUL) == 2);
+    CHECK(count_ops_before_return(partial, IR_OP_MUL) == 0);
+    CHECK(count_ops(test_find_function(program, "killed"), IR_OP_MUL) == 2);
+    CHECK(count_ops_in_loops(test_find_function(program, "invariant"), IR_OP_MUL) == 0);
+    CHECK(count_ops_in_loops(test_find_function(program, "guarded_div"), IR_OP_DIV) == 1);
+    CHECK(count_ops_before_return(test_find_function(program, "spin"), IR_OP_DIV) == 1);
+    RDELETE(IR_program, ir_program_global);
+    return TEST_RESULT();
+}
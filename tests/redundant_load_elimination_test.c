@@ -0,0 +1,38 @@
+//
+// Created by Assistant
+// 冗余加载消除测试 (Redundant Load Elimination Test)
+//
+
+#include "test_util.h"
+#include <redundant_load_elimination.h>
+
+static const int inputs[][2] = {{5, 7}, {-1, 65536}, {123456, -3}, {0, 0}};
+
+static void eliminate_redundant_loads(IR_function *func) {
+    RedundantLoadElimination *redundantLoadElimination = NEW(RedundantLoadElimination, func);
+    worklist_solver((DataflowAnalysis*)redundantLoadElimination, func);
+    RedundantLoadElimination_replace_redundant_load(redundantLoadElimination, func);
+    DELETE(redundantLoadElimination);
+}
+
+static void run_rle(IR_program *program) {
+    test_run_function_pass(program, eliminate_redundant_loads);
+}
+
+static unsigned count_loads(IR_function *func) {
+    unsigned cnt = 0;
+    for_list(IR_block_ptr, i, func->blocks)
+        for_list(IR_stmt_ptr, j, i->val->stmts)
+            if (j->val->stmt_type == IR_LOAD_STMT) cnt++;
+    return cnt;
+}
+
+int main() {
+    // 只有调用前的 *t 与未逃逸的 *tc 可以转发; 调用后的 *t, 被 +2 处的写入部分覆盖的 *t,
+    // 以及保存值的变量在重新加载前被重新定义的 *tc 都必须保留
+    IR_program *program = test_check_equivalence("tests/ir/redundant_load.ir", run_rle,
+                                                 &inputs[0][0], sizeof(inputs) / sizeof(inputs[0]), 2);
+    CHECK(count_loads(test_find_function(program, "main")) == 3);
+    RDELETE(IR_program, ir_program_global);
+    return TEST_RESULT();
+}
@@ -0,0 +1,51 @@
+//
+// Created by Assistant
+// 标量提升测试 (Scalar Promotion Test)
+//
+
+#include "test_util.h"
+#include <scalar_promotion.h>
+
+#define FUNC_CNT 5
+
+// n, m: n 为负时 split_exit 不进入循环, 直接返回 m; m 较小时从循环中部提前退出
+static const int inputs[][2] = {{5, 100}, {0, 3}, {-2, 7}, {6, 4}, {3, -70000}, {9, 2147483647}};
+
+static const char *func_names[FUNC_CNT] = {"promote", "split_exit", "escaped_dec", "call_in_loop", "overlap"};
+
+static void run_promotion(IR_program *program) {
+    test_run_loop_pass(program, perform_scalar_promotion);
+}
+
+// 循环中的读写语句数
+static unsigned count_loop_accesses(IR_function *func) {
+    DominanceAnalyzer dom;
+    LoopAnalyzer loops;
+    DominanceAnalyzer_init(&dom, func);
+    DominanceAnalyzer_compute_dominators(&dom);
+    LoopAnalyzer_init(&loops, func, &dom);
+    LoopAnalyzer_detect_loops(&loops);
+    LoopAnalyzer_build_loop_hierarchy(&loops);
+    unsigned cnt = 0;
+    for_list(IR_block_ptr, i, func->blocks) {
+        if (!LoopAnalyzer_get_innermost_loop(&loops, i->val)) continue;
+        for_list(IR_stmt_ptr, j, i->val->stmts)
+            if (j->val->stmt_type == IR_LOAD_STMT || j->val->stmt_type == IR_STORE_STMT) cnt++;
+    }
+    LoopAnalyzer_teardown(&loops);
+    DominanceAnalyzer_teardown(&dom);
+    return cnt;
+}
+
+int main() {
+    // promote 中偏移 0 与 4 的两个位置互不重叠, 都被提升; split_exit 的出口还有循环外的前驱,
+    // 写回需要拆分两条退出边。其余函数不能提升: 地址被存入内存后经未知指针访问,
+    // 地址逃逸且循环中有函数调用, 以及偏移 0 与 2 处的访问部分重叠
+    IR_program *program = test_check_equivalence("tests/ir/scalar_promotion.ir", run_promotion,
+                                                 &inputs[0][0], sizeof(inputs) / sizeof(inputs[0]), 2);
+    const unsigned accesses_after[FUNC_CNT] = {0, 0, 4, 2, 4};
+    for (unsigned k = 0; k < FUNC_CNT; k++)
+        CHECK(count_loop_accesses(test_find_function(program, func_names[k])) == accesses_after[k]);
+    RDELETE(IR_program, ir_program_global);
+    return TEST_RESULT();
+}
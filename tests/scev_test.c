@@ -0,0 +1,70 @@
+//
+// Created by Assistant
+// 标量演化执行次数测试 (Scalar Evolution Trip Count Test)
+//
+
+#include "test_util.h"
+#include <scalar_evolution.h>
+
+/**
+ * @brief 分析函数中唯一的循环，返回是否得到常量执行次数。
+ */
+static bool constant_trip_count(IR_function *func, unsigned *trip_count) {
+    DominanceAnalyzer dom;
+    LoopAnalyzer loops;
+    ScalarEvolution se;
+    DominanceAnalyzer_init(&dom, func);
+    DominanceAnalyzer_compute_dominators(&dom);
+    LoopAnalyzer_init(&loops, func, &dom);
+    LoopAnalyzer_detect_loops(&loops);
+    LoopAnalyzer_build_loop_hierarchy(&loops);
+    LoopAnalyzer_create_preheaders(&loops);
+    LoopAnalyzer_refresh_dominators(&loops);
+    ScalarEvolution_init(&se, func, &loops);
+    CHECK(loops.all_loops.head != NULL && loops.all_loops.head == loops.all_loops.tail);
+    bool known = loops.all_loops.head &&
+                 ScalarEvolution_get_constant_trip_count(&se, loops.all_loops.head->val, trip_count);
+    ScalarEvolution_teardown(&se);
+    LoopAnalyzer_teardown(&loops);
+    DominanceAnalyzer_teardown(&dom);
+    return known;
+}
+
+static void expect_unknown(IR_program *program, const char *func_name) {
+    IR_function *func = test_find_function(program, func_name);
+    unsigned trip_count = 0;
+    CHECK(func != NULL);
+    if (func && constant_trip_count(func, &trip_count)) {
+        fprintf(stderr, "%s: unexpected trip count %u\n", func_name, trip_count);
+        test_failures++;
+    }
+}
+
+static void expect_count(IR_program *program, const char *func_name, unsigned expected) {
+    IR_function *func = test_find_function(program, func_name);
+    unsigned trip_count = 0;
+    CHECK(func != NULL);
+    if (func && (!constant_trip_count(func, &trip_count) || trip_count != expected)) {
+        fprintf(stderr, "%s: expected trip count %u, got %u\n", func_name, expected, trip_count);
+        test_failures++;
+    }
+}
+
+int main() {
+    // IV 按 32 位回绕, 恒成立或要回绕才能越过界限的比较没有常量执行次数
+    IR_program *program = test_parse("tests/ir/loop_wrap.ir");
+    expect_unknown(program, "main");
+
+    program = test_parse("tests/ir/scev_trip_count.ir");
+    expect_unknown(program, "up_to_max");
+    expect_unknown(program, "down_to_min");
+    expect_unknown(program, "step_past_bound");
+    expect_unknown(program, "ne_never_equal");
+    // 最后一个被比较的值恰好在 int 范围内
+    expect_count(program, "up_to_max_minus_one", 7);
+    expect_count(program, "count_ten", 10);
+    expect_count(program, "down_by_three", 715827889);
+
+    RDELETE(IR_program, ir_program_global);
+    return TEST_RESULT();
+}
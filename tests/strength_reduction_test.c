@@ -0,0 +1,90 @@
+//
+// Created by Assistant
+// 强度削减与线性函数测试替换测试 (Strength Reduction and LFTR Test)
+//
+
+#include "test_util.h"
+#include <induction_variable_analysis.h>
+#include <dead_code_elimination.h>
+
+static const int inputs[][1] = {{-2200}, {0}, {3}, {-5}, {4}, {2147483647}, {-2147483647}};
+
+static bool reduce(IR_function *func, DominanceAnalyzer *dom_analyzer, LoopAnalyzer *loop_analyzer) {
+    perform_strength_reduction_for_function(func, loop_analyzer);
+    return true;
+}
+
+static void run_strength_reduction(IR_program *program) {
+    test_run_loop_pass(program, reduce);
+}
+
+// 与优化流程一致, 削减后不再使用的缩放下标由死代码删除清除
+static void run_address_reduction(IR_program *program) {
+    test_run_loop_pass(program, reduce);
+    for_vec(IR_function_ptr, i, program->functions)
+        AggressiveDeadCodeElimination(*i);
+}
+
+/**
+ * @brief 统计循环内（含内层循环）运算符为 op 的语句。
+ */
+static unsigned count_ops_in_loops(IR_function *func, IR_OP_TYPE op) {
+    DominanceAnalyzer dom;
+    LoopAnalyzer loops;
+    DominanceAnalyzer_init(&dom, func);
+    DominanceAnalyzer_compute_dominators(&dom);
+    LoopAnalyzer_init(&loops, func, &dom);
+    LoopAnalyzer_detect_loops(&loops);
+    LoopAnalyzer_build_loop_hierarchy(&loops);
+    unsigned cnt = 0;
+    for_list(IR_block_ptr, i, func->blocks) {
+        if (!LoopAnalyzer_get_innermost_loop(&loops, i->val)) continue;
+        for_list(IR_stmt_ptr, j, i->val->stmts)
+            if (j->val->stmt_type == IR_OP_STMT && ((IR_op_stmt*)j->val)->op == op) cnt++;
+    }
+    LoopAnalyzer_teardown(&loops);
+    DominanceAnalyzer_teardown(&dom);
+    return cnt;
+}
+
+/**
+ * @brief 统计函数中与常量 bound 比较的 IF。
+ */
+static unsigned count_tests_against(IR_function *func, int bound) {
+    unsigned cnt = 0;
+    for_list(IR_block_ptr, i, func->blocks)
+        for_list(IR_stmt_ptr, j, i->val->stmts) {
+            if (j->val->stmt_type != IR_IF_STMT) continue;
+            IR_if_stmt *if_stmt = (IR_if_stmt*)j->val;
+            if ((if_stmt->rs1.is_const && if_stmt->rs1.const_val == bound) ||
+                (if_stmt->rs2.is_const && if_stmt->rs2.const_val == bound)) cnt++;
+        }
+    return cnt;
+}
+
+int main() {
+    const unsigned input_set_cnt = sizeof(inputs) / sizeof(inputs[0]);
+
+    // 初值由 READ 读入, 无法证明 v1 * 1000000 不回绕: 乘法被削减, 但保留测试 v1 >= 5
+    IR_program *program = test_check_equivalence("tests/ir/lftr_wrap.ir", run_strength_reduction,
+                                                 &inputs[0][0], input_set_cnt, 1);
+    CHECK(count_tests_against(test_find_function(program, "main"), 5) == 1);
+
+    // 第一个循环改写为 t' >= 400; 第二个循环 k * 1000000 在 k = 3000 时回绕, 保留 k >= 3000
+    program = test_check_equivalence("tests/ir/lftr.ir", run_strength_reduction,
+                                     &inputs[0][0], input_set_cnt, 1);
+    IR_function *func = test_find_function(program, "main");
+    CHECK(count_tests_against(func, 400) == 1);
+    CHECK(count_tests_against(func, 3000) == 1);
+
+    // 前两个循环的地址 base + c1 * i + c2 改为指针归纳变量, 循环内不再有乘法与地址加法;
+    // 第三个循环的下标 k * k 不是线性的, 两个乘法与地址加法都保留;
+    // 第四个循环的基址 base + m 在循环内被修改, 只削减下标 w * 4, 两个地址加法都保留
+    program = test_check_equivalence("tests/ir/sr_address.ir", run_address_reduction,
+                                     &inputs[0][0], input_set_cnt, 1);
+    CHECK(count_ops_in_loops(test_find_function(program, "main"), IR_OP_MUL) == 3);
+    CHECK(count_ops_in_loops(test_find_function(program, "main"), IR_OP_ADD) == 11);
+
+    RDELETE(IR_program, ir_program_global);
+    return TEST_RESULT();
+}
@@ -0,0 +1,359 @@
+//
+// Created by Assistant
+// 测试公共设施 (Test Utilities)
+//
+
+#include "test_util.h"
+#include <IR_parse.h>
+#include <string.h>
+#include <unistd.h>
+
+unsigned test_failures = 0;
+
+//// ================================== 读入 ==================================
+
+IR_program *test_parse(const char *path) {
+    if (ir_program_global != NULL) {
+        RDELETE(IR_program, ir_program_global);
+        ir_program_global = NULL;
+    }
+    IR_parse(path);
+    return ir_program_global;
+}
+
+IR_function *test_find_function(IR_program *program, const char *func_name) {
+    for_vec(IR_function_ptr, i, program->functions)
+        if (strcmp((*i)->func_name, func_name) == 0) return *i;
+    return NULL;
+}
+
+//// ================================== 循环变换 ==================================
+
+bool test_run_loop_pass(IR_program *program, LoopPass pass) {
+    bool changed = false;
+    for_vec(IR_function_ptr, i, program->functions) {
+        DominanceAnalyzer dom;
+        LoopAnalyzer loops;
+        DominanceAnalyzer_init(&dom, *i);
+        DominanceAnalyzer_compute_dominators(&dom);
+        LoopAnalyzer_init(&loops, *i, &dom);
+        LoopAnalyzer_detect_loops(&loops);
+        LoopAnalyzer_build_loop_hierarchy(&loops);
+        LoopAnalyzer_create_preheaders(&loops);
+        LoopAnalyzer_refresh_dominators(&loops);
+        if (pass(*i, &dom, &loops)) changed = true;
+        LoopAnalyzer_teardown(&loops);
+        DominanceAnalyzer_teardown(&dom);
+    }
+    return changed;
+}
+
+unsigned test_count_loops(IR_function *func) {
+    DominanceAnalyzer dom;
+    LoopAnalyzer loops;
+    DominanceAnalyzer_init(&dom, func);
+    DominanceAnalyzer_compute_dominators(&dom);
+    LoopAnalyzer_init(&loops, func, &dom);
+    LoopAnalyzer_detect_loops(&loops);
+    unsigned cnt = 0;
+    for_list(Loop_ptr, i, loops.all_loops) cnt++;
+    LoopAnalyzer_teardown(&loops);
+    DominanceAnalyzer_teardown(&dom);
+    return cnt;
+}
+
+unsigned test_loop_weight(IR_function *func) {
+    DominanceAnalyzer dom;
+    LoopAnalyzer loops;
+    DominanceAnalyzer_init(&dom, func);
+    DominanceAnalyzer_compute_dominators(&dom);
+    LoopAnalyzer_init(&loops, func, &dom);
+    LoopAnalyzer_detect_loops(&loops);
+    LoopAnalyzer_build_loop_hierarchy(&loops);
+    unsigned weight = 0;
+    for_list(IR_block_ptr, i, func->blocks) {
+        Loop_ptr loop = LoopAnalyzer_get_innermost_loop(&loops, i->val);
+        if (!loop) continue;
+        for_list(IR_stmt_ptr, j, i->val->stmts) weight += (unsigned)loop->depth;
+    }
+    LoopAnalyzer_teardown(&loops);
+    DominanceAnalyzer_teardown(&dom);
+    return weight;
+}
+
+void test_run_function_pass(IR_program *program, FunctionPass pass) {
+    for_vec(IR_function_ptr, i, program->functions)
+        pass(*i);
+}
+
+//// ================================== 随机 CFG ==================================
+
+static unsigned random_cfg_state;
+
+static unsigned random_cfg_next(void) {
+    random_cfg_state = random_cfg_state * 1103515245u + 12345u;
+    return random_cfg_state >> 16;
+}
+
+IR_function *test_random_function(unsigned block_cnt, unsigned seed) {
+    random_cfg_state = seed;
+    IR_function *func = NEW(IR_function, "main");
+    IR_label *labels = (IR_label*)malloc(sizeof(IR_label) * block_cnt);
+    for (unsigned k = 0; k < block_cnt; k++) labels[k] = ir_label_generator();
+    IR_var x = ir_var_generator();
+    IR_function_push_stmt(func, (IR_stmt*)NEW(IR_read_stmt, x));
+    for (unsigned k = 0; k < block_cnt; k++) {
+        IR_function_push_label(func, labels[k]);
+        IR_val x_val = {.is_const = false, .var = x}, k_val = {.is_const = true, .const_val = (int)k};
+        IR_function_push_stmt(func, (IR_stmt*)NEW(IR_op_stmt, IR_OP_ADD, x, x_val, k_val));
+        unsigned target_idx = random_cfg_next() % block_cnt;
+        if (target_idx == k + 1) continue; // 跳向下一块会被 IR_function_push_label 去掉
+        IR_label target = labels[target_idx];
+        switch (random_cfg_next() % 4) {
+            case 0:
+            case 1:
+                IR_function_push_stmt(func, (IR_stmt*)NEW(IR_if_stmt, IR_RELOP_LT, x_val, k_val, target, IR_LABEL_NONE));
+                break;
+            case 2:
+                IR_function_push_stmt(func, (IR_stmt*)NEW(IR_goto_stmt, target));
+                break;
+            default:
+                break;
+        }
+    }
+    IR_function_push_stmt(func, (IR_stmt*)NEW(IR_return_stmt, (IR_val){.is_const = false, .var = x}));
+    IR_function_closure(func);
+    free(labels);
+    return func;
+}
+
+//// ================================== 解释执行 ==================================
+
+DEF_MAP(IR_var, int)
+
+#define MEM_SIZE (1u << 22)     // 4MB 的栈, DEC 的空间在其中按调用分配
+#define MEM_BASE 4096           // 地址从非零处开始
+
+static unsigned char mem[MEM_SIZE]; // 按字节编址, 4 字节的访问可以不对齐, 部分重叠的访问互相可见
+static unsigned mem_top;        // 已分配的字节数
+
+static IR_program *exec_program;
+
+static int val_of(Map_IR_var_int *vars, IR_val val) {
+    if (val.is_const) return val.const_val;
+    return VCALL(*vars, exist, val.var) ? VCALL(*vars, get, val.var) : 0;
+}
+
+static unsigned char *mem_at(int addr) {
+    unsigned offset = (unsigned)addr - MEM_BASE;
+    if (addr < MEM_BASE || offset > mem_top || mem_top - offset < 4) return NULL;
+    return &mem[offset];
+}
+
+static bool eval_op(IR_OP_TYPE op, int a, int b, int *result) {
+    unsigned ua = (unsigned)a, ub = (unsigned)b;
+    switch (op) {
+        case IR_OP_ADD: *result = (int)(ua + ub); return true;
+        case IR_OP_SUB: *result = (int)(ua - ub); return true;
+        case IR_OP_MUL: *result = (int)(ua * ub); return true;
+        case IR_OP_DIV:
+            if (b == 0) return false;
+            *result = b == -1 ? (int)(0u - ua) : a / b; return true;
+        case IR_OP_MOD:
+            if (b == 0) return false;
+            *result = b == -1 ? 0 : a % b; return true;
+        case IR_OP_SHL: *result = (int)(ua << (b & 31)); return true;
+        case IR_OP_SHR: *result = (int)(ua >> (b & 31)); return true;
+        case IR_OP_SAR: *result = a >> (b & 31); return true;
+        case IR_OP_AND: *result = a & b; return true;
+        case IR_OP_OR:  *result = a | b; return true;
+        case IR_OP_MULH: *result = (int)(((long long)a * b) >> 32); return true;
+        default:        *result = a ^ b; return true;
+    }
+}
+
+static IR_exec_status exec_function(IR_exec *exec, IR_function *func, unsigned argc, const int *argv, int *ret);
+
+// 执行一条非跳转语句
+static IR_exec_status exec_stmt(IR_exec *exec, Map_IR_var_int *vars, IR_stmt *stmt) {
+    switch (stmt->stmt_type) {
+        case IR_OP_STMT: {
+            IR_op_stmt *op = (IR_op_stmt*)stmt;
+            int result;
+            if (!eval_op(op->op, val_of(vars, op->rs1), val_of(vars, op->rs2), &result)) return IR_EXEC_ERROR;
+            VCALL(*vars, set, op->rd, result);
+            return IR_EXEC_OK;
+        }
+        case IR_ASSIGN_STMT: {
+            IR_assign_stmt *assign = (IR_assign_stmt*)stmt;
+            VCALL(*vars, set, assign->rd, val_of(vars, assign->rs));
+            return IR_EXEC_OK;
+        }
+        case IR_LOAD_STMT: {
+            IR_load_stmt *load = (IR_load_stmt*)stmt;
+            unsigned char *cell = mem_at(val_of(vars, load->rs_addr));
+            if (!cell) return IR_EXEC_ERROR;
+            int value;
+            memcpy(&value, cell, sizeof(int));
+            VCALL(*vars, set, load->rd, value);
+            return IR_EXEC_OK;
+        }
+        case IR_STORE_STMT: {
+            IR_store_stmt *store = (IR_store_stmt*)stmt;
+            unsigned char *cell = mem_at(val_of(vars, store->rd_addr));
+            if (!cell) return IR_EXEC_ERROR;
+            int value = val_of(vars, store->rs);
+            memcpy(cell, &value, sizeof(int));
+            return IR_EXEC_OK;
+        }
+        case IR_CALL_STMT: {
+            IR_call_stmt *call = (IR_call_stmt*)stmt;
+            IR_function *callee = test_find_function(exec_program, call->func_name);
+            if (!callee) return IR_EXEC_ERROR;
+            int *args = (int*)malloc(sizeof(int) * (call->argc + 1));
+            for (unsigned i = 0; i < call->argc; i++) args[i] = val_of(vars, call->argv[i]);
+            int result = 0;
+            IR_exec_status status = exec_function(exec, callee, call->argc, args, &result);
+            free(args);
+            if (status == IR_EXEC_OK && call->rd != IR_VAR_NONE) VCALL(*vars, set, call->rd, result);
+            return status;
+        }
+        case IR_READ_STMT: {
+            if (exec->input_pos >= exec->input_cnt) return IR_EXEC_ERROR;
+            VCALL(*vars, set, ((IR_read_stmt*)stmt)->rd, exec->input[exec->input_pos++]);
+            return IR_EXEC_OK;
+        }
+        case IR_WRITE_STMT: {
+            if (exec->output_cnt < IR_EXEC_MAX_OUTPUT)
+                exec->output[exec->output_cnt] = val_of(vars, ((IR_write_stmt*)stmt)->rs);
+            exec->output_cnt++;
+            return IR_EXEC_OK;
+        }
+        default: // φ 函数只出现在 SSA 形式中, 不能直接执行
+            return IR_EXEC_ERROR;
+    }
+}
+
+static IR_exec_status exec_function(IR_exec *exec, IR_function *func, unsigned argc, const int *argv, int *ret) {
+    if (argc != func->params.len) return IR_EXEC_ERROR;
+    unsigned frame = mem_top;
+    Map_IR_var_int vars;
+    Map_IR_var_int_init(&vars);
+    for (unsigned i = 0; i < argc; i++) VCALL(vars, set, func->params.arr[i], argv[i]);
+    IR_exec_status status = IR_EXEC_OK;
+    for_map(IR_var, IR_Dec, i, func->map_dec) {
+        if (mem_top + i->val.dec_size > MEM_SIZE) { status = IR_EXEC_ERROR; break; }
+        VCALL(vars, set, i->val.dec_addr, (int)(MEM_BASE + mem_top));
+        memset(mem + mem_top, 0, i->val.dec_size);
+        mem_top += (i->val.dec_size + 3) & ~3u;
+    }
+
+    *ret = 0;
+    IR_block *blk = func->entry;
+    while (status == IR_EXEC_OK) {
+        IR_block *next = NULL;
+        for_list(IR_stmt_ptr, i, blk->stmts) {
+            IR_stmt *stmt = i->val;
+            if (++exec->steps > exec->step_limit) { status = IR_EXEC_STEP_LIMIT; break; }
+            if (stmt->stmt_type == IR_GOTO_STMT) {
+                next = ((IR_goto_stmt*)stmt)->blk;
+                break;
+            }
+            if (stmt->stmt_type == IR_IF_STMT) {
+                IR_if_stmt *if_stmt = (IR_if_stmt*)stmt;
+                bool taken = IR_RELOP_eval(if_stmt->relop, val_of(&vars, if_stmt->rs1), val_of(&vars, if_stmt->rs2));
+                next = taken ? if_stmt->true_blk : if_stmt->false_blk;
+                break;
+            }
+            if (stmt->stmt_type == IR_RETURN_STMT) {
+                *ret = val_of(&vars, ((IR_return_stmt*)stmt)->rs);
+                blk = NULL;
+                break;
+            }
+            status = exec_stmt(exec, &vars, stmt);
+            if (status != IR_EXEC_OK) break;
+        }
+        if (status != IR_EXEC_OK || blk == NULL || blk == func->exit) break;
+        if (!next) { // 顺序执行到唯一的后继
+            List_IR_block_ptr *succs = VCALL(func->blk_succ, get, blk);
+            if (!succs->head) break;
+            next = succs->head->val;
+        }
+        blk = next;
+    }
+    Map_IR_var_int_teardown(&vars);
+    mem_top = frame;
+    return status;
+}
+
+IR_exec_status IR_exec_program(IR_program *program, IR_exec *exec) {
+    exec->input_pos = exec->output_cnt = 0;
+    exec->steps = 0;
+    exec_program = program;
+    mem_top = 0;
+    IR_function *main_func = test_find_function(program, "main");
+    if (!main_func) return IR_EXEC_ERROR;
+    int ret;
+    return exec_function(exec, main_func, 0, NULL, &ret);
+}
+
+bool IR_exec_same(IR_exec_status status1, const IR_exec *exec1,
+                  IR_exec_status status2, const IR_exec *exec2) {
+    if (status1 != status2) return false;
+    // 都超出上限时两边执行的语句不同, 只比较共同的前缀
+    unsigned cnt = exec1->output_cnt < exec2->output_cnt ? exec1->output_cnt : exec2->output_cnt;
+    if (status1 != IR_EXEC_STEP_LIMIT && exec1->output_cnt != exec2->output_cnt) return false;
+    if (cnt > IR_EXEC_MAX_OUTPUT) cnt = IR_EXEC_MAX_OUTPUT;
+    return memcmp(exec1->output, exec2->output, sizeof(int) * cnt) == 0;
+}
+
+//// ================================== 等价性检查 ==================================
+
+#define TEST_STEP_LIMIT 1000000
+
+// 用每组输入执行变换后的程序, 与变换前的结果比较
+static void check_same_behavior(const char *path, const char *message, IR_program *program,
+                                const IR_exec *before, const IR_exec_status *status_before,
+                                const int *inputs, unsigned set_cnt, unsigned input_cnt) {
+    for (unsigned k = 0; k < set_cnt; k++) {
+        IR_exec after = {.input = inputs + k * input_cnt, .input_cnt = input_cnt, .step_limit = TEST_STEP_LIMIT};
+        IR_exec_status status_after = IR_exec_program(program, &after);
+        if (IR_exec_same(status_before[k], &before[k], status_after, &after)) continue;
+        fprintf(stderr, "%s: %s (input", path, message);
+        for (unsigned j = 0; j < input_cnt; j++) fprintf(stderr, " %d", inputs[k * input_cnt + j]);
+        fprintf(stderr, ")\n");
+        test_failures++;
+    }
+}
+
+IR_program *test_check_equivalence(const char *path, ProgramTransform transform,
+                                   const int *inputs, unsigned set_cnt, unsigned input_cnt) {
+    IR_program *program = test_parse(path);
+    IR_exec *before = (IR_exec*)malloc(sizeof(IR_exec) * set_cnt);
+    IR_exec_status *status_before = (IR_exec_status*)malloc(sizeof(IR_exec_status) * set_cnt);
+    for (unsigned k = 0; k < set_cnt; k++) {
+        before[k] = (IR_exec){.input = inputs + k * input_cnt, .input_cnt = input_cnt, .step_limit = TEST_STEP_LIMIT};
+        status_before[k] = IR_exec_program(program, &before[k]);
+    }
+    transform(program);
+    check_same_behavior(path, "behavior changed", program, before, status_before, inputs, set_cnt, input_cnt);
+
+    // 输出的是打印出的程序: 打印后重新解析再比较一次, 发现只改了内存中的跳转目标等不一致
+    char printed_path[] = "/tmp/test_printed_XXXXXX";
+    int fd = mkstemp(printed_path);
+    FILE *out = fd < 0 ? NULL : fdopen(fd, "w");
+    if (out == NULL) {
+        fprintf(stderr, "%s: cannot create a temporary file\n", path);
+        test_failures++;
+    } else {
+        IR_program_print(program, out);
+        fclose(out);
+        program = test_parse(printed_path);
+        unlink(printed_path);
+        check_same_behavior(path, "printed program behaves differently", program, before, status_before,
+                            inputs, set_cnt, input_cnt);
+    }
+    free(before);
+    free(status_before);
+    return program;
+}
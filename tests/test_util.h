@@ -0,0 +1,138 @@
+//
+// Created by Assistant
+// 测试公共设施 (Test Utilities)
+//
+
+#ifndef CODE_TEST_UTIL_H
+#define CODE_TEST_UTIL_H
+
+#include <IR.h>
+#include <loop_analysis.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+//// ================================== 断言 ==================================
+
+extern unsigned test_failures; // 失败的检查数
+
+/**
+ * @brief 检查条件，不成立时打印位置并记录失败，不中断测试。
+ */
+#define CHECK(cond) do { \
+        if (!(cond)) { \
+            fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+            test_failures++; \
+        } \
+    } while (0)
+
+/**
+ * @brief 测试程序的返回值：有失败的检查时为 1。
+ */
+#define TEST_RESULT() (test_failures ? (fprintf(stderr, "%u check(s) failed\n", test_failures), 1) : 0)
+
+//// ================================== 读入 ==================================
+
+/**
+ * @brief 解析测试用的 IR 文件（路径相对于仓库根目录），释放之前的程序。
+ * @return 解析得到的程序，即 ir_program_global。
+ */
+extern IR_program *test_parse(const char *path);
+
+/**
+ * @brief 按函数名查找函数，不存在时返回 NULL。
+ */
+extern IR_function *test_find_function(IR_program *program, const char *func_name);
+
+//// ================================== 循环变换 ==================================
+
+/**
+ * @brief 循环变换的统一形式，与 perform_loop_deletion 等高层接口一致。
+ */
+typedef bool (*LoopPass)(IR_function *func, DominanceAnalyzer *dom_analyzer, LoopAnalyzer *loop_analyzer);
+
+/**
+ * @brief 对程序的每个函数建立支配关系与循环信息（含预备首部）后执行循环变换。
+ * @return 是否有函数被修改。
+ */
+extern bool test_run_loop_pass(IR_program *program, LoopPass pass);
+
+/**
+ * @brief 函数中自然循环的个数。
+ */
+extern unsigned test_count_loops(IR_function *func);
+
+/**
+ * @brief 函数中各语句所在最内层循环的嵌套深度之和（循环外的语句计 0），
+ * 语句被移出循环或从内层移到外层时减小。
+ */
+extern unsigned test_loop_weight(IR_function *func);
+
+/**
+ * @brief 逐个函数执行的变换，如数据流分析加上据此进行的改写。
+ */
+typedef void (*FunctionPass)(IR_function *func);
+
+/**
+ * @brief 对程序的每个函数执行变换。
+ */
+extern void test_run_function_pass(IR_program *program, FunctionPass pass);
+
+//// ================================== 随机 CFG ==================================
+
+/**
+ * @brief 生成有 block_cnt 个带标签的块的随机 CFG：块末尾为跳向任意块的 IF、GOTO 或顺序执行，
+ * 含回边、不可约循环、不可达块与无法到达出口的无限循环。相同的 seed 生成相同的 CFG。
+ */
+extern IR_function *test_random_function(unsigned block_cnt, unsigned seed);
+
+//// ================================== 解释执行 ==================================
+
+#define IR_EXEC_MAX_OUTPUT 256
+
+typedef enum {
+    IR_EXEC_OK,             // 正常返回
+    IR_EXEC_STEP_LIMIT,     // 执行的语句数超过上限（视为不终止）
+    IR_EXEC_ERROR           // 除零、越界访问、缺少输入等
+} IR_exec_status;
+
+/**
+ * @brief 解释执行的输入输出与计数。
+ * 运算按 32 位补码回绕，与目标机器一致。
+ */
+typedef struct {
+    const int *input;               // READ 依次读取的值
+    unsigned input_cnt, input_pos;
+    int output[IR_EXEC_MAX_OUTPUT]; // WRITE 写出的值（超出部分只计数）
+    unsigned output_cnt;
+    unsigned long steps, step_limit; // 已执行的语句数与上限
+} IR_exec;
+
+/**
+ * @brief 从 main 开始解释执行程序。
+ * @param exec 调用前设置 input、input_cnt 与 step_limit，其余字段由本函数清零。
+ */
+extern IR_exec_status IR_exec_program(IR_program *program, IR_exec *exec);
+
+/**
+ * @brief 两次执行的状态与输出是否完全相同。
+ */
+extern bool IR_exec_same(IR_exec_status status1, const IR_exec *exec1,
+                         IR_exec_status status2, const IR_exec *exec2);
+
+//// ================================== 等价性检查 ==================================
+
+/**
+ * @brief 测试中对整个程序进行的变换。
+ */
+typedef void (*ProgramTransform)(IR_program *program);
+
+/**
+ * @brief 解析 path，用每组输入执行后进行变换，再用同样的输入执行并比较，
+ * 行为不同时打印文件与输入并记录失败。变换后的程序还会打印出来重新解析后再比较一次。
+ * @param inputs 共 set_cnt 组输入，每组 input_cnt 个值，依次供 READ 读取
+ * @return 重新解析得到的变换后的程序（即 ir_program_global），供调用者继续检查其结构。
+ */
+extern IR_program *test_check_equivalence(const char *path, ProgramTransform transform,
+                                          const int *inputs, unsigned set_cnt, unsigned input_cnt);
+
+#endif //CODE_TEST_UTIL_H